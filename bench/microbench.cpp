@@ -0,0 +1,400 @@
+/****************************************************************************************************************************************************
+* File: microbench.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+* 10/14/2026   Kerby Kaska     Build against protocol.cpp and transport.cpp instead of including main.cpp. The dispatch of
+*                              the server is measured by the benchmark mode of pgm1 (--bench) instead.
+* 10/14/2026   Kerby Kaska     Measure the dispatch of the server again, linked against dispatch.cpp.
+*
+* Description: Microbenchmarks of the hot paths of the program, measured in one process without the queues in between:
+*              the command lookup and dispatch, the framing and formatting of the requests and replies, and a round trip
+*              through every Transport. The suite is linked against the same protocol.cpp, transport.cpp, and
+*              dispatch.cpp as pgm1, so the functions are measured exactly as they are built into it. Build and run it with:
+*
+*                  make bench
+*
+*              or on its own with an iteration count (default MICROBENCH_ITERATIONS):
+*
+*                  make microbench && ./microbench 1000000
+*
+* Procedures:
+* main                 - runs every microbenchmark, and prints the nanoseconds per operation of each one to the console
+*
+* bench_lookup         - microbenchmark of find_command() over every command name, and an unknown one
+*
+* bench_dispatch       - microbenchmark of execute_command() dispatching a command, as a server worker does
+*
+* bench_framing        - microbenchmark of framing a command with frame_request() and reading it back with read_frame()
+*
+* bench_formatting     - microbenchmarks of rendering the binary uname reply, and compressing and expanding the help reply
+*
+* bench_transport      - microbenchmark of a send and receive of a framed command through a Transport
+*
+* print_result         - utility method to print the result of a microbenchmark as a row of the report
+*
+* encode_uname         - utility method to encode the binary CMD_GET_UNAME_FIELDS reply of this host, as the server does
+****************************************************************************************************************************************************/
+
+#include "../protocol.h"
+#include "../transport.h"
+#include "../dispatch.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <errno.h>
+#include <sys/utsname.h>
+
+/********************************************************************************************************************************
+ * Microbenchmark Constants:
+ * MICROBENCH_ITERATIONS        const unsigned int    default number of iterations of every microbenchmark
+ * MAX_MICROBENCH_ITERATIONS    const unsigned int    largest number of iterations accepted on the command line
+ * MICROBENCH_TEXT_COMMAND      const char*           unknown command looked up and framed as text
+ * MICROBENCH_NAME_WIDTH        const int             width of the name column of the report
+ *******************************************************************************************************************************/
+static const unsigned int MICROBENCH_ITERATIONS        = 200000;
+static const unsigned int MAX_MICROBENCH_ITERATIONS    = 100000000;
+static const char* MICROBENCH_TEXT_COMMAND             = "unknown-command!";
+static const int MICROBENCH_NAME_WIDTH                 = 36;
+
+/********************************************************************************************************************************
+ * Microbenchmark State:
+ * microbenchSink       volatile size_t      sum of the results of every measured call, so none of them is optimized away
+ * microbenchStats      WorkerStats          statistics counters of execute_command(), which a server worker keeps in the
+ *                                           shared serverStats instead
+ *******************************************************************************************************************************/
+static volatile size_t microbenchSink = 0;
+static WorkerStats microbenchStats;
+
+/********************************************************************************************************************************
+ * static void print_result(const char* name, uint64_t operations, uint64_t nanoseconds)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Widen the name column to MICROBENCH_NAME_WIDTH, so every name lines up with the header.
+ *
+ * Description: Utility method to print the result of a microbenchmark as a row of the report: its name, the number of
+ *      operations measured, and the mean nanoseconds per operation.
+ *
+ * Parameters:
+ *      name           I/P    const char*    the name of the microbenchmark
+ *      operations     I/P    uint64_t       the number of operations measured
+ *      nanoseconds    I/P    uint64_t       the nanoseconds all of the operations took
+ *******************************************************************************************************************************/
+static void print_result(const char* name, uint64_t operations, uint64_t nanoseconds)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "%-*s %12llu %12.1f\n", MICROBENCH_NAME_WIDTH, name,
+        static_cast<unsigned long long>(operations),
+        (operations > 0) ? static_cast<double>(nanoseconds) / operations : 0.0);
+    std::cout << line;
+}
+
+/********************************************************************************************************************************
+ * static size_t encode_uname(char* output, size_t outputSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to encode the binary CMD_GET_UNAME_FIELDS reply of this host with every field, the way the
+ *      server encodes it (see encode_uname_entry()), so the client rendering of it can be measured without a server.
+ *
+ * Parameters:
+ *      output          O/P    char*     the buffer to encode the reply into
+ *      outputSize      I/P    size_t    the size of output in bytes
+ *      encode_uname    O/P    size_t    the number of bytes of the reply in output
+ *******************************************************************************************************************************/
+static size_t encode_uname(char* output, size_t outputSize)
+{
+    utsname name;
+    if (uname(&name) == -1)
+    {
+        const char* error = strerror(errno);
+        return encode_uname_entry(output, outputSize, 0, UNAME_FIELD_ERROR, error, strlen(error));
+    }
+    const char* values[UNAME_FIELD_COUNT] = { name.sysname, name.nodename, name.release, name.version, name.machine,
+                                              name.domainname };
+    size_t outputLength = 0;
+    for (unsigned int field = 0; field < UNAME_FIELD_COUNT; ++field)
+    {
+        outputLength = encode_uname_entry(output, outputSize, outputLength, field, values[field], 
+                                          strnlen(values[field], sizeof(name.sysname)));
+    }
+    return outputLength;
+}
+
+/********************************************************************************************************************************
+ * static void bench_lookup(unsigned int iterations)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Measure find_builtin_command() over the COMMAND_NAMES.
+ * 10/14/2026   Kerby Kaska     Measure find_command(), the lookup of both the clients and the server.
+ *
+ * Description: Measures find_command() looking up the name of every command in COMMAND_NAMES, and an unknown
+ *      command, iterations times each. The lookup is one hash and at most one comparison, so every name should cost
+ *      about as much as the others.
+ *
+ * Parameters:
+ *      iterations    I/P    unsigned int    the number of times every name is looked up
+ *******************************************************************************************************************************/
+static void bench_lookup(unsigned int iterations)
+{
+    std::vector<std::string> names;
+    for (unsigned int opcode = OPCODE_TEXT + 1; opcode < OPCODE_COUNT; ++opcode)
+    {
+        names.push_back(COMMAND_NAMES[opcode].name);
+    }
+    names.push_back(MICROBENCH_TEXT_COMMAND);
+
+    const uint64_t startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        for (size_t name = 0; name < names.size(); ++name)
+        {
+            microbenchSink += find_command(names[name].data(), names[name].size());
+        }
+    }
+    print_result("lookup (every command)", static_cast<uint64_t>(iterations) * names.size(),
+                 monotonic_nanoseconds() - startTime);
+}
+
+/********************************************************************************************************************************
+ * static void bench_dispatch(const char* name, uint16_t opcode, const char* payload, size_t payloadLength,
+ *                            unsigned int iterations)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Measures execute_command() dispatching a command iterations times, as a server worker does once it has
+ *      read the frame: through the responseCache and memoCache where the command is cacheable or idempotent, and through
+ *      its handler otherwise.
+ *
+ * Parameters:
+ *      name             I/P    const char*     the name of the microbenchmark
+ *      opcode           I/P    uint16_t        the opcode of the command, as it is framed
+ *      payload          I/P    const char*     the payload of the command (not NUL-terminated)
+ *      payloadLength    I/P    size_t          the number of bytes in payload
+ *      iterations       I/P    unsigned int    the number of times the command is dispatched
+ *******************************************************************************************************************************/
+static void bench_dispatch(const char* name, uint16_t opcode, const char* payload, size_t payloadLength,
+                           unsigned int iterations)
+{
+    std::vector<char> output(QUEUE_MAX_MESSAGE_SIZE);
+    bool running = true;
+    const uint64_t startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        microbenchSink += execute_command(opcode, payload, payloadLength, &output[0], output.size(), &running);
+    }
+    print_result(name, iterations, monotonic_nanoseconds() - startTime);
+}
+
+/********************************************************************************************************************************
+ * static void bench_framing(const char* name, const char* command, unsigned int iterations)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Frame with frame_request(), looking the command up like the clients do.
+ *
+ * Description: Measures the client looking up and framing a command with frame_request() and the server reading the
+ *      frame back with read_frame(), iterations times.
+ *
+ * Parameters:
+ *      name          I/P    const char*     the name of the microbenchmark
+ *      command       I/P    const char*     the command to frame, as the user enters it
+ *      iterations    I/P    unsigned int    the number of times the command is framed
+ *******************************************************************************************************************************/
+static void bench_framing(const char* name, const char* command, unsigned int iterations)
+{
+    std::vector<char> buffer(queueConfig.messageSize);
+    const size_t commandLength = strlen(command);
+    MessageHeader header;
+    uint16_t opcode;
+    const uint64_t startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        const size_t frameLength = frame_request(command, commandLength, find_command(command, commandLength), i, 0, 0, 0,
+            &buffer[0], buffer.size(), true, &opcode);
+        if (read_frame(&buffer[0], frameLength, 0, &header))
+        {
+            microbenchSink += header.payloadLength + header.opcode;
+        }
+    }
+    print_result(name, iterations, monotonic_nanoseconds() - startTime);
+}
+
+/********************************************************************************************************************************
+ * static void bench_formatting(unsigned int iterations)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Encode the replies here (see encode_uname()), rather than through the handlers of the server.
+ *
+ * Description: Measures the formatting of the replies, iterations times each: the client rendering the binary
+ *      CMD_GET_UNAME_FIELDS reply as text (see render_uname()), and the server compressing the CMD_GET_HELP reply
+ *      against the compressionDictionary (see compress_payload()) and the client expanding it again.
+ *
+ * Parameters:
+ *      iterations    I/P    unsigned int    the number of times every reply is formatted
+ *******************************************************************************************************************************/
+static void bench_formatting(unsigned int iterations)
+{
+    std::vector<char> reply(QUEUE_MAX_MESSAGE_SIZE);
+    std::vector<char> output(QUEUE_MAX_MESSAGE_SIZE);
+
+    const size_t unameLength = encode_uname(&reply[0], reply.size());
+    uint64_t startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        size_t textLength = 0;
+        render_uname(&reply[0], unameLength, &output[0], output.size(), &textLength);
+        microbenchSink += textLength;
+    }
+    print_result("render uname", iterations, monotonic_nanoseconds() - startTime);
+
+    const size_t helpLength = copy_bytes(&reply[0], reply.size(), MESSAGE_HELP, MESSAGE_HELP_LENGTH);
+    size_t compressedLength = 0;
+    startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        compressedLength = compress_payload(&reply[0], helpLength, &output[0]);
+        microbenchSink += compressedLength;
+    }
+    print_result("compress help", iterations, monotonic_nanoseconds() - startTime);
+
+    std::vector<char> expanded(QUEUE_MAX_MESSAGE_SIZE);
+    startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations && compressedLength > 0; ++i)
+    {
+        microbenchSink += expand_payload(&output[0], compressedLength, &expanded[0], expanded.size());
+    }
+    print_result("expand help", (compressedLength > 0) ? iterations : 0, monotonic_nanoseconds() - startTime);
+}
+
+/********************************************************************************************************************************
+ * static bool bench_transport(const Transport* candidate, unsigned int iterations)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Send with the priority class of the command in COMMAND_NAMES.
+ *
+ * Description: Measures a send and a receive of a framed command on the command channel of a Transport, iterations
+ *      times. Both ends are this process, so the result is the cost of the transport itself, without a context switch
+ *      to a server worker. The channels are opened before and closed after the measurement. On error, an error message
+ *      is printed to the console.
+ *
+ * Parameters:
+ *      candidate          I/P    const Transport*    the transport to measure
+ *      iterations         I/P    unsigned int        the number of round trips
+ *      bench_transport    O/P    bool                true on success, false on error
+ *******************************************************************************************************************************/
+static bool bench_transport(const Transport* candidate, unsigned int iterations)
+{
+    transport = candidate;
+    if (!transport->open())
+    {
+        return false;
+    }
+    std::vector<char> message(queueConfig.messageSize);
+    std::vector<char> buffer(queueConfig.messageSize);
+    uint16_t opcode;
+    const size_t messageLength = frame_request(CMD_GET_HOST_NAME, strlen(CMD_GET_HOST_NAME), OPCODE_GET_HOST_NAME, 0, 0,
+        0, 0, &message[0], message.size(), true, &opcode);
+    const unsigned int priority = queueConfig.messagePriority + COMMAND_NAMES[opcode].priority;
+
+    bool failed = false;
+    const uint64_t startTime = monotonic_nanoseconds();
+    for (unsigned int i = 0; i < iterations && !failed; ++i)
+    {
+        const ssize_t receiveLength =
+            (transport->send(CHANNEL_COMMAND, &message[0], messageLength, priority, -1) == -1) ? -1 :
+            transport->receive(CHANNEL_COMMAND, &buffer[0], buffer.size(), NULL, -1);
+        if (receiveLength == -1)
+        {
+            perror("microbench::transport()");
+            failed = true;
+        }
+        microbenchSink += receiveLength;
+    }
+    const uint64_t nanoseconds = monotonic_nanoseconds() - startTime;
+    char name[64];
+    snprintf(name, sizeof(name), "transport %s (send + receive)", transport->name);
+    if (!failed)
+    {
+        print_result(name, iterations, nanoseconds);
+    }
+    const int result = close_queues();
+    commandQueue = -1; // NOTE: close_queues() leaves the closed descriptors behind, the next transport must not close them
+    responseQueue = -1;
+    return !failed && result == EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * int main(int argc, char* argv[])
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Parse the iterations here, and no longer run the dispatch microbenchmarks of the server.
+ * 10/14/2026   Kerby Kaska     Run the dispatch microbenchmarks again, against dispatch.cpp.
+ *
+ * Description: Runs every microbenchmark with the given number of iterations (default MICROBENCH_ITERATIONS), with the
+ *      default queue configuration, and prints the report to the console, one row for each microbenchmark.
+ *
+ * Parameters:
+ *     argc    I/P    int      number of provided command line arguments
+ *     argv    I/P    char**   provided command line arguments (the number of iterations, optional)
+ *     main    O/P    int      EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+int main(int argc, char* argv[])
+{
+    unsigned int iterations = MICROBENCH_ITERATIONS;
+    if (argc == 2)
+    {
+        char* end = NULL;
+        errno = 0;
+        const unsigned long value = strtoul(argv[1], &end, 10);
+        iterations = (errno == 0 && end != argv[1] && *end == '\0' && argv[1][0] != '-' && value >= 1 && 
+                      value <= MAX_MICROBENCH_ITERATIONS) ? static_cast<unsigned int>(value) : 0;
+    }
+    if (argc > 2 || iterations == 0)
+    {
+        std::cerr << "Usage: microbench [iterations] (1 to " << MAX_MICROBENCH_ITERATIONS << ")" << std::endl;
+        return EXIT_FAILURE;
+    }
+    build_compression_dictionary();
+    workerStats = &microbenchStats; // NOTE: execute_command() counts every command, like a server worker does
+
+    char line[128];
+    snprintf(line, sizeof(line), "%-*s %12s %12s\n", MICROBENCH_NAME_WIDTH, "microbenchmark", "operations", "ns/op");
+    std::cout << line;
+    bench_lookup(iterations);
+    bench_dispatch("dispatch gethostname (cached)", OPCODE_GET_HOST_NAME, NULL, 0, iterations);
+    bench_dispatch("dispatch uname (memoized)", OPCODE_GET_UNAME_FIELDS, NULL, 0, iterations);
+    bench_dispatch("dispatch help", OPCODE_GET_HELP, NULL, 0, iterations);
+    bench_dispatch("dispatch unknown (text)", OPCODE_TEXT, MICROBENCH_TEXT_COMMAND, strlen(MICROBENCH_TEXT_COMMAND),
+                   iterations);
+    bench_framing("frame gethostname", CMD_GET_HOST_NAME, iterations);
+    bench_framing("frame unknown (text)", MICROBENCH_TEXT_COMMAND, iterations);
+    bench_formatting(iterations);
+    for (size_t i = 0; i < TRANSPORT_COUNT; ++i)
+    {
+        if (!bench_transport(TRANSPORTS[i], iterations))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1101 @@
+/****************************************************************************************************************************************************
+* File: dispatch.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the command handlers, COMMAND_TABLE, the plugins, the caches, and the
+*                              statistics report of the server out of main.cpp.
+*
+* Description: The command dispatch of pgm1 (see dispatch.h). A server worker executes every command it is sent with
+*      execute_command(), and every client looks the commands it frames up with the same find_command().
+*
+* Procedures:
+* handle_*             - command handlers of COMMAND_TABLE, one for each opcode (and handle_bad_command for unknown commands)
+*
+* signal_supervisor    - utility method to signal the supervisor of a forked process, only while it is still its parent
+*
+* matches_command_names - checks at compile time that COMMAND_TABLE matches the COMMAND_NAMES of protocol.h
+*
+* command_entry        - utility method to look up the entry of an opcode in COMMAND_TABLE or the pluginTable
+*
+* has_blocking_command - utility method to check whether the server workers need an AsyncExecutor
+*
+* find_command         - looks up the opcode of a command name in constant time through the perfect hash commandIndex
+*
+* rebuild_command_index - searches for a perfect hash of the names of the built-in and plugin commands at startup
+*
+* load_plugin          - loads a plugin shared object (ARG_PLUGIN) and registers its commands
+*
+* cached_response      - serves a cacheable command from the responseCache, rendering it on a miss
+*
+* memo_hash            - utility method to hash the opcode and arguments of a memoized response
+*
+* find_memoized, memoize_response
+*                      - look up and store the responses of idempotent commands in the sharded LRU memoCache
+*
+* sum_stats            - utility method to sum up the WorkerStats of every server worker
+*
+* format_stats         - formats the statistics report of the whole server pool
+*
+* select_uname_fields  - utility method to keep only the requested fields of a binary CMD_GET_UNAME_FIELDS response
+*
+* execute_command      - executes a command by opcode (or by name for text commands) and copies its result into a buffer
+****************************************************************************************************************************************************/
+
+#include "dispatch.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/utsname.h>
+
+/********************************************************************************************************************************
+ * Dispatch Constants:
+ * PLUGIN_HASH_SEARCH_LIMIT  const uint32_t       number of seeds tried at startup to find a perfect hash with the plugins
+ * CACHE_TTL_SECONDS         const time_t         number of seconds a cached response is served before it is rendered again
+ * CACHE_RESPONSE_SIZE       const unsigned int   number of bytes reserved for each cached response
+ * MEMO_SHARDS               const unsigned int   number of shards of the memoCache, each its own LRU (must be a power of two)
+ * MEMO_SHARD_ENTRIES        const unsigned int   number of memoized responses in each shard of the memoCache
+ *******************************************************************************************************************************/
+static constexpr uint32_t PLUGIN_HASH_SEARCH_LIMIT      = 1u << 20;
+static constexpr time_t CACHE_TTL_SECONDS               = 60;
+static constexpr unsigned int CACHE_RESPONSE_SIZE       = 1024;
+static constexpr unsigned int MEMO_SHARDS               = 16;
+static constexpr unsigned int MEMO_SHARD_ENTRIES        = 8;
+
+/********************************************************************************************************************************
+ * Message Constants:
+ * MESSAGE_BAD_COMMAND      const char*           message format used to format the message returned for an unknown command
+ * MESSAGE_BAD_OPCODE       const char*           message format used to format the message returned for an unknown opcode
+ * MESSAGE_UNAME            const char*           message format used to format the message returned for CMD_GET_UNAME
+ *******************************************************************************************************************************/
+static const char* MESSAGE_BAD_COMMAND  = "Unknown command: \"%.*s\"";
+static const char* MESSAGE_BAD_OPCODE   = "Unknown opcode: %u";
+static const char* MESSAGE_UNAME        = " System: %s\n"
+                                          "   Node: %s\n"
+                                          "Release: %s\n"
+                                          "Version: %s\n"
+                                          "Machine: %s\n"
+                                          " Domain: %s";
+
+/********************************************************************************************************************************
+ * Statistics (see dispatch.h):
+ *******************************************************************************************************************************/
+WorkerStats* serverStats = NULL;
+unsigned int serverStatsCount = 0;
+WorkerStats* workerStats = NULL;
+
+/********************************************************************************************************************************
+ * struct ResponseCache
+ * Description: Pre-rendered response bytes of the cacheable commands (the system information commands, and plugin commands,
+ *     which almost never change), so a server worker can serve them without any system call or formatting. The whole
+ *     cache is invalidated once its TTL (CACHE_TTL_SECONDS) expires, or when responseCacheStale is set by CMD_REFRESH or 
+ *     by a SIGHUP (see hangup_handler).
+ *
+ * Members:
+ * valid                    bool[]                true if the response of the opcode has been rendered since the last invalidation
+ * lengths                  size_t[]              number of bytes in the rendered response of each opcode
+ * responses                char[][]              rendered response of each opcode
+ * expiry                   timespec              CLOCK_MONOTONIC_COARSE time at which the whole cache expires
+ *******************************************************************************************************************************/
+struct ResponseCache
+{
+    bool valid[MAX_OPCODES];
+    size_t lengths[MAX_OPCODES];
+    char responses[MAX_OPCODES][CACHE_RESPONSE_SIZE];
+    timespec expiry;
+};
+
+/********************************************************************************************************************************
+ * Response Cache:
+ * responseCache        ResponseCache            pre-rendered responses of this server worker
+ * responseCacheStale   volatile sig_atomic_t    (see dispatch.h)
+ *******************************************************************************************************************************/
+static ResponseCache responseCache;
+volatile sig_atomic_t responseCacheStale = 1;
+
+/********************************************************************************************************************************
+ * struct MemoShard
+ * Description: One shard of the memoCache, a least recently used cache of MEMO_SHARD_ENTRIES responses. The shard of a
+ *     request is picked by its hash, so a lookup only ever compares the few entries of one shard, and evicting the least
+ *     recently used entry of a shard never disturbs the rest of the cache.
+ *
+ * Members:
+ * entries                  MemoEntry[]           the memoized responses of the shard
+ * clock                    uint64_t              counter stamped on an entry whenever it is used (see MemoEntry::lastUse)
+ *******************************************************************************************************************************/
+struct MemoShard
+{
+    MemoEntry entries[MEMO_SHARD_ENTRIES];
+    uint64_t clock;
+};
+
+/********************************************************************************************************************************
+ * Memo Cache:
+ * memoCache            MemoShard[]              memoized responses of the idempotent commands of this server worker. It is
+ *                                               only ever used by the server loop (blocking commands are looked up before
+ *                                               they are queued, and memoized once they complete), so it needs no lock
+ * memoCacheStale       volatile sig_atomic_t    (see dispatch.h)
+ *******************************************************************************************************************************/
+static MemoShard memoCache[MEMO_SHARDS];
+volatile sig_atomic_t memoCacheStale = 0;
+
+/********************************************************************************************************************************
+ * Plugin State:
+ * pluginTable          CommandEntry[]           the commands registered by plugins, indexed by opcode - OPCODE_COUNT
+ * pluginDescriptions   const char*[]            the description of every command in pluginTable, listed by CMD_GET_HELP
+ * pluginCommandCount   unsigned int             number of commands in pluginTable
+ *
+ * NOTE: these are filled in by load_plugin() before any process is forked, and never change afterwards
+ *******************************************************************************************************************************/
+static CommandEntry pluginTable[MAX_PLUGIN_COMMANDS];
+static const char* pluginDescriptions[MAX_PLUGIN_COMMANDS];
+static unsigned int pluginCommandCount = 0;
+
+/********************************************************************************************************************************
+ * Process State (see dispatch.h):
+ *******************************************************************************************************************************/
+pid_t supervisorProcessID = 0;
+
+/********************************************************************************************************************************
+ * static size_t handle_get_domain_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                                      bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ *
+ * Description: Command handler for CMD_GET_DOMAIN_NAME. Copies the system domain name into the output buffer.
+ *      On failure, an error message is copied to the output buffer instead.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_get_domain_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                                     bool* running)
+{
+    if (getdomainname(output, outputSize) == -1)
+    {
+        return copy_message(output, outputSize, strerror(errno));
+    }
+    return strnlen(output, outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_get_host_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                                    bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ *
+ * Description: Command handler for CMD_GET_HOST_NAME. Copies the system host name into the output buffer.
+ *      On failure, an error message is copied to the output buffer instead.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_get_host_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                                   bool* running)
+{
+    if (gethostname(output, outputSize) == -1)
+    {
+        return copy_message(output, outputSize, strerror(errno));
+    }
+    return strnlen(output, outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_get_uname(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                                bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ *
+ * Description: Command handler for CMD_GET_UNAME. Formats all 6 components of the system Unix name with MESSAGE_UNAME
+ *      into the output buffer. On failure, an error message is copied to the output buffer instead.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_get_uname(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                               bool* running)
+{
+    utsname name;
+    if (uname(&name) == -1)
+    {
+        return copy_message(output, outputSize, strerror(errno));
+    }
+
+    // format and copy the uname response to the output buffer
+    return format_length(snprintf(output, outputSize, MESSAGE_UNAME, 
+        name.sysname, name.nodename, name.release, name.version, 
+        name.machine, name.domainname), outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_get_uname_fields(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                                       bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_GET_UNAME_FIELDS. Copies all 6 components of the system Unix name into the output
+ *      buffer as binary entries (see UnameField), without formatting them. The response is cached with every field, and 
+ *      execute_command() selects the fields a request asks for out of it (see select_uname_fields()). On failure, a single
+ *      UNAME_FIELD_ERROR entry with the error message is copied to the output buffer instead.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_get_uname_fields(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                                      bool* running)
+{
+    utsname name;
+    if (uname(&name) == -1)
+    {
+        const char* error = strerror(errno);
+        return encode_uname_entry(output, outputSize, 0, UNAME_FIELD_ERROR, error, strlen(error));
+    }
+
+    const char* values[UNAME_FIELD_COUNT] = { name.sysname, name.nodename, name.release, name.version, name.machine, 
+                                              name.domainname };
+    size_t outputLength = 0;
+    for (unsigned int field = 0; field < UNAME_FIELD_COUNT; ++field)
+    {
+        // NOTE: the utsname fields are all the same size, and NUL-terminated unless they fill it
+        outputLength = encode_uname_entry(output, outputSize, outputLength, field, values[field], 
+                                          strnlen(values[field], sizeof(name.sysname)));
+    }
+    return outputLength;
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_get_help(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                               bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ *
+ * Description: Command handler for CMD_GET_HELP. Copies the pre-encoded MESSAGE_HELP into the output buffer, followed by 
+ *      the commands registered by plugins (if any).
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_get_help(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                              bool* running)
+{
+    size_t outputLength = copy_bytes(output, outputSize, MESSAGE_HELP, MESSAGE_HELP_LENGTH);
+    for (unsigned int i = 0; i < pluginCommandCount; ++i)
+    {
+        outputLength += format_length(snprintf(output + outputLength, outputSize - outputLength, "\n > %s - %s", 
+            pluginTable[i].name, pluginDescriptions[i]), outputSize - outputLength);
+    }
+    return outputLength;
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_exit(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ *
+ * Description: Command handler for CMD_EXIT. Copies the pre-encoded MESSAGE_EXIT into the output buffer, and sets running 
+ *      to false so the server loop will exit.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_exit(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+{
+    *running = false; // stop looping so the server will exit
+    return copy_bytes(output, outputSize, MESSAGE_EXIT, MESSAGE_EXIT_LENGTH);
+}
+
+/********************************************************************************************************************************
+ * bool signal_supervisor(int signalNumber)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Sends signalNumber to the supervisor of this forked client or server worker. Only the supervisorProcessID
+ *      recorded before the fork is signalled, and only while it is still the parent process: once the supervisor is 
+ *      dead, this process is reparented and its pid may even be reused, so nothing is signalled, and errno is set to 
+ *      ESRCH.
+ *
+ * Parameters:
+ *      signalNumber         I/P    int     the signal to send to the supervisor
+ *      signal_supervisor    O/P    bool    true if the signal was sent, false on error
+ *******************************************************************************************************************************/
+bool signal_supervisor(int signalNumber)
+{
+    if (supervisorProcessID == 0 || getppid() != supervisorProcessID)
+    {
+        errno = ESRCH;
+        return false;
+    }
+    return kill(supervisorProcessID, signalNumber) == 0;
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_refresh(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Signal the supervisor with signal_supervisor(), never whichever process adopted the worker.
+ *
+ * Description: Command handler for CMD_REFRESH. Invalidates the responseCache (and memoCache) of this worker, and sends a
+ *      SIGHUP to the supervisor (see signal_supervisor()), which forwards it to every other worker of the pool so their caches
+ *      are invalidated as well. Copies the pre-encoded MESSAGE_REFRESH into the output buffer.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_refresh(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+{
+    responseCacheStale = 1;
+    memoCacheStale = 1;
+    signal_supervisor(SIGHUP); // NOTE: a worker without a supervisor has no pool to forward it to
+    return copy_bytes(output, outputSize, MESSAGE_REFRESH, MESSAGE_REFRESH_LENGTH);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_stats(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_STATS. Copies the statistics report of the whole server pool into the output 
+ *      buffer (see format_stats()).
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_stats(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, bool* running)
+{
+    return format_stats(output, outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_bad_command(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+ *                                  bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of execute_command().
+ * 10/14/2026   Kerby Kaska     Format into the whole output buffer, the result no longer has to leave room for anything.
+ *
+ * Description: Command handler for text commands that do not match any entry of COMMAND_TABLE. Formats MESSAGE_BAD_COMMAND
+ *      with the unrecognized command (given as the arguments) into the output buffer.
+ *
+ * Parameters: (see CommandHandler)
+ *******************************************************************************************************************************/
+static size_t handle_bad_command(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                                 bool* running)
+{
+    // format and copy invalid command message, including the given message, into output buffer
+    // NOTE: the received command is not NUL-terminated, so its length is passed to the "%.*s" format
+    return format_length(snprintf(output, outputSize,
+        MESSAGE_BAD_COMMAND, static_cast<int>(argumentsLength), arguments), outputSize);
+}
+
+/********************************************************************************************************************************
+ * Command Table:
+ * COMMAND_TABLE            const CommandEntry[]  handler of every opcode, indexed by opcode (OPCODE_TEXT has no handler)
+ *
+ * NOTE: to add a command, add its opcode to Opcode, its name to the command constants and COMMAND_NAMES (see 
+ *       protocol.h), and its handler here. The perfect hash of COMMAND_INDEX is found again at compile time, so no other
+ *       code has to change. The commands without arguments are already served from the responseCache, so only
+ *       CMD_GET_UNAME_FIELDS (whose field selection is redone for every request) is memoized by its arguments, for as
+ *       long as its cached response lives.
+ *******************************************************************************************************************************/
+static constexpr CommandEntry COMMAND_TABLE[OPCODE_COUNT] = 
+{
+    { NULL,                 0,                                  NULL,                   false,  PRIORITY_BULK,    false, 0 }, // OPCODE_TEXT
+    { CMD_GET_DOMAIN_NAME,  string_length(CMD_GET_DOMAIN_NAME), handle_get_domain_name, true,   PRIORITY_NORMAL,  false, 0 }, // OPCODE_GET_DOMAIN_NAME
+    { CMD_GET_HOST_NAME,    string_length(CMD_GET_HOST_NAME),   handle_get_host_name,   true,   PRIORITY_CONTROL, false, 0 }, // OPCODE_GET_HOST_NAME
+    { CMD_GET_UNAME,        string_length(CMD_GET_UNAME),       handle_get_uname,       true,   PRIORITY_NORMAL,  false, 0 }, // OPCODE_GET_UNAME
+    { CMD_GET_HELP,         string_length(CMD_GET_HELP),        handle_get_help,        false,  PRIORITY_NORMAL,  false, 0 }, // OPCODE_GET_HELP
+    { CMD_EXIT,             string_length(CMD_EXIT),            handle_exit,            false,  PRIORITY_CONTROL, false, 0 }, // OPCODE_EXIT
+    { CMD_REFRESH,          string_length(CMD_REFRESH),         handle_refresh,         false,  PRIORITY_CONTROL, false, 0 }, // OPCODE_REFRESH
+    { CMD_STATS,            string_length(CMD_STATS),           handle_stats,           false,  PRIORITY_CONTROL, false, 0 }, // OPCODE_STATS
+    { CMD_GET_UNAME_FIELDS, string_length(CMD_GET_UNAME_FIELDS),handle_get_uname_fields,true,   PRIORITY_NORMAL,  false, CACHE_TTL_SECONDS }, // OPCODE_GET_UNAME_FIELDS
+};
+
+/********************************************************************************************************************************
+ * static constexpr bool matches_command_names(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Checks at compile time that every entry of COMMAND_TABLE has the name and priority class of its opcode in
+ *      COMMAND_NAMES, which the clients of libpgm1 frame and prioritize their commands by.
+ *
+ * Parameters:
+ *      matches_command_names    O/P    bool    true if COMMAND_TABLE matches COMMAND_NAMES
+ *******************************************************************************************************************************/
+static constexpr bool matches_command_names()
+{
+    for (unsigned int opcode = 0; opcode < OPCODE_COUNT; ++opcode)
+    {
+        if (COMMAND_TABLE[opcode].name != COMMAND_NAMES[opcode].name || 
+            COMMAND_TABLE[opcode].nameLength != COMMAND_NAMES[opcode].nameLength || 
+            COMMAND_TABLE[opcode].priority != COMMAND_NAMES[opcode].priority)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(matches_command_names(), "COMMAND_TABLE must match the COMMAND_NAMES of protocol.h");
+
+/********************************************************************************************************************************
+ * Dispatch State:
+ * commandCount         unsigned int             number of opcodes in use (OPCODE_COUNT plus the pluginCommandCount)
+ * commandHashSeed      uint32_t                 seed which makes hash_command() a perfect hash of every command in use
+ * commandIndex         CommandIndex             perfect hash index from the names of every command in use to their opcodes
+ *
+ * NOTE: these start out as the compile-time COMMAND_HASH_SEED and COMMAND_INDEX, and are only rebuilt by load_plugin()
+ *******************************************************************************************************************************/
+unsigned int commandCount = OPCODE_COUNT;
+static uint32_t commandHashSeed = COMMAND_HASH_SEED;
+static CommandIndex commandIndex = COMMAND_INDEX;
+
+/********************************************************************************************************************************
+ * const CommandEntry& command_entry(unsigned int opcode)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to look up the entry of an opcode in use, in COMMAND_TABLE for a built-in command, or in the
+ *      pluginTable for a plugin command.
+ *
+ * Parameters:
+ *      opcode           I/P    unsigned int           an opcode below commandCount
+ *      command_entry    O/P    const CommandEntry&    the entry of the opcode
+ *******************************************************************************************************************************/
+const CommandEntry& command_entry(unsigned int opcode)
+{
+    return (opcode < OPCODE_COUNT) ? COMMAND_TABLE[opcode] : pluginTable[opcode - OPCODE_COUNT];
+}
+
+/********************************************************************************************************************************
+ * bool has_blocking_command(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether any command in use is blocking, so the server workers need an AsyncExecutor.
+ *
+ * Parameters:
+ *      has_blocking_command    O/P    bool    true if any command in use is blocking
+ *******************************************************************************************************************************/
+bool has_blocking_command()
+{
+    for (unsigned int opcode = OPCODE_TEXT + 1; opcode < commandCount; ++opcode)
+    {
+        if (command_entry(opcode).blocking)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/********************************************************************************************************************************
+ * uint16_t find_command(const char* name, size_t nameLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Replaces the chain of strcmp() calls in the server loop.
+ * 10/14/2026   Kerby Kaska     Look up the commandIndex, which includes the commands of plugins.
+ *
+ * Description: Looks up the opcode of a command name in constant time, with one hash of the name and one comparison
+ *      against the only command which can occupy its slot of the commandIndex.
+ *
+ * Parameters:
+ *      name            I/P    const char*    the command name bytes (not NUL-terminated)
+ *      nameLength      I/P    size_t         the number of bytes in name
+ *      find_command    O/P    uint16_t       the opcode of the command, or OPCODE_TEXT if it is not a known command
+ *******************************************************************************************************************************/
+uint16_t find_command(const char* name, size_t nameLength)
+{
+    const uint16_t opcode = commandIndex.opcodes[hash_command(name, nameLength, commandHashSeed) & (COMMAND_INDEX_SIZE - 1)];
+    const CommandEntry& entry = command_entry(opcode);
+    if (opcode == OPCODE_TEXT || entry.nameLength != nameLength || memcmp(entry.name, name, nameLength) != 0)
+    {
+        return OPCODE_TEXT;
+    }
+    return opcode;
+}
+
+/********************************************************************************************************************************
+ * static bool rebuild_command_index(unsigned int count)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Searches for a seed which makes hash_command() a perfect hash of the names of the first count opcodes (the
+ *      built-in commands and the plugin commands registered so far), the same way find_perfect_seed() does at compile 
+ *      time, and installs it with its index as the commandHashSeed and commandIndex. On success, commandCount is set to 
+ *      count, so the new commands can be dispatched. Otherwise, the dispatch state is left as it was.
+ *
+ * Parameters:
+ *      count                    I/P    unsigned int  the number of opcodes to index
+ *      rebuild_command_index    O/P    bool          true on success, false if no perfect seed was found
+ *******************************************************************************************************************************/
+static bool rebuild_command_index(unsigned int count)
+{
+    for (uint32_t seed = 0; seed < PLUGIN_HASH_SEARCH_LIMIT; ++seed)
+    {
+        CommandIndex index = {};
+        unsigned int opcode = OPCODE_TEXT + 1;
+        while (opcode < count)
+        {
+            const CommandEntry& entry = command_entry(opcode);
+            const uint32_t slot = hash_command(entry.name, entry.nameLength, seed) & (COMMAND_INDEX_SIZE - 1);
+            if (index.opcodes[slot] != OPCODE_TEXT)
+            {
+                break; // collision, try the next seed
+            }
+            index.opcodes[slot] = opcode;
+            ++opcode;
+        }
+        if (opcode == count)
+        {
+            commandIndex = index;
+            commandHashSeed = seed;
+            commandCount = count;
+            return true;
+        }
+    }
+    return false;
+}
+
+/********************************************************************************************************************************
+ * bool load_plugin(const char* path)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Loads a plugin shared object (ARG_PLUGIN) with dlopen(), and registers every command of its PluginModule
+ *      in the pluginTable, with the next free opcode. The commandIndex is rebuilt after each one, so a plugin command is 
+ *      looked up by name (and dispatched by opcode) at the same cost as a built-in command. A plugin is never unloaded. On
+ *      error (a missing entry point, another ABI version, an invalid or duplicate command), an error message is printed to
+ *      the console.
+ *
+ * Parameters:
+ *      path           I/P    const char*    the path of the plugin, as given to dlopen()
+ *      load_plugin    O/P    bool           true on success, false on error
+ *******************************************************************************************************************************/
+bool load_plugin(const char* path)
+{
+    void* library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL)
+    {
+        std::cerr << "plugin::dlopen() - " << dlerror() << "\n";
+        return false;
+    }
+    PluginEntryPoint entryPoint = reinterpret_cast<PluginEntryPoint>(dlsym(library, PLUGIN_ENTRY_POINT));
+    if (entryPoint == NULL)
+    {
+        std::cerr << "plugin::dlsym() - " << dlerror() << "\n";
+        dlclose(library);
+        return false;
+    }
+    const PluginModule* module = entryPoint();
+    if (module == NULL || module->abiVersion != PLUGIN_ABI_VERSION)
+    {
+        std::cerr << "plugin::load_plugin() - " << path << " was not built against plugin ABI version " 
+                  << PLUGIN_ABI_VERSION << ".\n";
+        dlclose(library);
+        return false;
+    }
+    if (module->commandCount > MAX_PLUGIN_COMMANDS - pluginCommandCount)
+    {
+        std::cerr << "plugin::load_plugin() - " << path << " exceeds the limit of " << MAX_PLUGIN_COMMANDS 
+                  << " plugin commands.\n";
+        dlclose(library);
+        return false;
+    }
+
+    // NOTE: from here on the library stays loaded, even on error, since the commands registered so far point into it
+    for (uint32_t i = 0; i < module->commandCount; ++i)
+    {
+        const PluginCommand& command = module->commands[i];
+        const size_t nameLength = (command.name != NULL) ? strlen(command.name) : 0;
+        if (nameLength == 0 || command.handler == NULL || command.priority > PLUGIN_PRIORITY_CONTROL)
+        {
+            std::cerr << "plugin::load_plugin() - " << path << " has an invalid command (" << i << ").\n";
+            return false;
+        }
+        if (find_command(command.name, nameLength) != OPCODE_TEXT)
+        {
+            std::cerr << "plugin::load_plugin() - " << path << " registers \"" << command.name << "\" again.\n";
+            return false;
+        }
+
+        CommandEntry& entry = pluginTable[pluginCommandCount];
+        entry.name = command.name;
+        entry.nameLength = nameLength;
+        entry.handler = command.handler;
+        entry.cacheable = command.cacheable && !command.blocking; // NOTE: the executor never serves from the cache
+        entry.blocking = command.blocking;
+        entry.memoizeSeconds = command.memoizeSeconds;
+        entry.priority = static_cast<PriorityClass>(command.priority);
+        pluginDescriptions[pluginCommandCount] = (command.description != NULL) ? command.description : "";
+        if (!rebuild_command_index(commandCount + 1))
+        {
+            std::cerr << "plugin::load_plugin() - no perfect hash found for \"" << command.name 
+                      << "\", increase COMMAND_INDEX_SIZE.\n";
+            return false;
+        }
+        ++pluginCommandCount;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static size_t cached_response(uint16_t opcode, char* output, size_t outputSize, bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Serves a cacheable command from the responseCache. The whole cache is invalidated first
+ *      if responseCacheStale is set or its TTL has expired (checked with the cheap CLOCK_MONOTONIC_COARSE clock). On a miss,
+ *      the handler renders the response straight into the cache, and the pre-rendered bytes are then copied to output.
+ *
+ * NOTE: a cached response holds up to CACHE_RESPONSE_SIZE bytes, which is more than the smallest message size, so it is
+ *       streamed in chunks like any other result too large for a message (see serve_message())
+ *
+ * Parameters:
+ *      opcode             I/P    uint16_t    the opcode of a cacheable command
+ *      output             O/P    char*       the buffer to copy the response into
+ *      outputSize         I/P    size_t      the size of output in bytes
+ *      running            O/P    bool*       passed through to the handler on a miss
+ *      cached_response    O/P    size_t      the number of bytes of the response copied into output
+ *******************************************************************************************************************************/
+static size_t cached_response(uint16_t opcode, char* output, size_t outputSize, bool* running)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    if (responseCacheStale || now.tv_sec >= responseCache.expiry.tv_sec)
+    {
+        responseCacheStale = 0;
+        memset(responseCache.valid, 0, sizeof(responseCache.valid));
+        responseCache.expiry.tv_sec = now.tv_sec + CACHE_TTL_SECONDS;
+    }
+
+    if (!responseCache.valid[opcode])
+    {
+        const size_t renderSize = (outputSize < CACHE_RESPONSE_SIZE) ? outputSize : CACHE_RESPONSE_SIZE;
+        responseCache.lengths[opcode] = command_entry(opcode).handler(NULL, 0, responseCache.responses[opcode], 
+            renderSize, running);
+        responseCache.valid[opcode] = true;
+    }
+    return copy_bytes(output, outputSize, responseCache.responses[opcode], responseCache.lengths[opcode]);
+}
+
+/********************************************************************************************************************************
+ * static inline uint64_t memo_hash(uint16_t opcode, const char* arguments, size_t argumentsLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to hash the key of a memoized response, its opcode and arguments (64-bit FNV-1a). The low
+ *      bits pick the shard of the memoCache.
+ *
+ * Parameters:
+ *      opcode             I/P    uint16_t       the opcode of the command
+ *      arguments          I/P    const char*    the arguments of the command (not NUL-terminated)
+ *      argumentsLength    I/P    size_t         the number of bytes in arguments
+ *      memo_hash          O/P    uint64_t       the hash of the opcode and arguments
+ *******************************************************************************************************************************/
+static inline uint64_t memo_hash(uint16_t opcode, const char* arguments, size_t argumentsLength)
+{
+    uint64_t hash = (14695981039346656037ull ^ opcode) * 1099511628211ull;
+    for (size_t i = 0; i < argumentsLength; ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(arguments[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/********************************************************************************************************************************
+ * const MemoEntry* find_memoized(uint16_t opcode, const char* arguments, size_t argumentsLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Looks up the memoized response to an idempotent command (see CommandEntry::memoizeSeconds) in its shard of
+ *      the memoCache, and marks it as the most recently used entry of the shard. The whole cache is emptied first if
+ *      memoCacheStale is set. An expired response is never served, and is left for memoize_response() to replace.
+ *
+ * Parameters:
+ *      opcode             I/P    uint16_t            the opcode of the command
+ *      arguments          I/P    const char*         the arguments of the command (not NUL-terminated)
+ *      argumentsLength    I/P    size_t              the number of bytes in arguments
+ *      find_memoized      O/P    const MemoEntry*    the memoized response, or NULL if there is none (or it has expired)
+ *******************************************************************************************************************************/
+const MemoEntry* find_memoized(uint16_t opcode, const char* arguments, size_t argumentsLength)
+{
+    if (memoCacheStale)
+    {
+        memoCacheStale = 0;
+        for (unsigned int shard = 0; shard < MEMO_SHARDS; ++shard)
+        {
+            for (unsigned int i = 0; i < MEMO_SHARD_ENTRIES; ++i)
+            {
+                memoCache[shard].entries[i].opcode = OPCODE_TEXT;
+            }
+        }
+    }
+    if (argumentsLength > MEMO_ARGUMENTS_SIZE)
+    {
+        return NULL; // NOTE: never memoized
+    }
+
+    const uint64_t hash = memo_hash(opcode, arguments, argumentsLength);
+    MemoShard& shard = memoCache[hash & (MEMO_SHARDS - 1)];
+    for (unsigned int i = 0; i < MEMO_SHARD_ENTRIES; ++i)
+    {
+        MemoEntry& entry = shard.entries[i];
+        if (entry.hash == hash && entry.opcode == opcode && entry.argumentsLength == argumentsLength &&
+            memcmp(entry.arguments, arguments, argumentsLength) == 0)
+        {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+            if (now.tv_sec >= entry.expiry)
+            {
+                return NULL;
+            }
+            entry.lastUse = ++shard.clock;
+            return &entry;
+        }
+    }
+    return NULL;
+}
+
+/********************************************************************************************************************************
+ * void memoize_response(uint16_t opcode, const char* arguments, size_t argumentsLength, const char* response,
+ *                       size_t responseLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Memoizes the response to an idempotent command in its shard of the memoCache for the memoizeSeconds of the
+ *      command, replacing its expired response (if any), an empty entry, or else the least recently used entry of the
+ *      shard. Responses larger than MEMO_RESPONSE_SIZE (and arguments larger than MEMO_ARGUMENTS_SIZE) are not memoized.
+ *
+ * Parameters:
+ *      opcode             I/P    uint16_t       the opcode of the command
+ *      arguments          I/P    const char*    the arguments of the command (not NUL-terminated)
+ *      argumentsLength    I/P    size_t         the number of bytes in arguments
+ *      response           I/P    const char*    the response of the command
+ *      responseLength     I/P    size_t         the number of bytes in response
+ *******************************************************************************************************************************/
+void memoize_response(uint16_t opcode, const char* arguments, size_t argumentsLength, const char* response,
+                      size_t responseLength)
+{
+    if (argumentsLength > MEMO_ARGUMENTS_SIZE || responseLength > MEMO_RESPONSE_SIZE)
+    {
+        return;
+    }
+
+    // replace the entry of the same request, or an empty one, or else the least recently used one
+    const uint64_t hash = memo_hash(opcode, arguments, argumentsLength);
+    MemoShard& shard = memoCache[hash & (MEMO_SHARDS - 1)];
+    MemoEntry* victim = &shard.entries[0];
+    for (unsigned int i = 0; i < MEMO_SHARD_ENTRIES; ++i)
+    {
+        MemoEntry& entry = shard.entries[i];
+        if (entry.hash == hash && entry.opcode == opcode && entry.argumentsLength == argumentsLength &&
+            memcmp(entry.arguments, arguments, argumentsLength) == 0)
+        {
+            victim = &entry;
+            break;
+        }
+        if (victim->opcode != OPCODE_TEXT && (entry.opcode == OPCODE_TEXT || entry.lastUse < victim->lastUse))
+        {
+            victim = &entry;
+        }
+    }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    victim->hash = hash;
+    victim->expiry = now.tv_sec + command_entry(opcode).memoizeSeconds;
+    victim->lastUse = ++shard.clock;
+    victim->opcode = opcode;
+    victim->argumentsLength = argumentsLength;
+    victim->responseLength = responseLength;
+    memcpy(victim->arguments, arguments, argumentsLength);
+    memcpy(victim->response, response, responseLength);
+}
+
+/********************************************************************************************************************************
+ * static void sum_stats(StatsTotals* totals)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to sum up the WorkerStats of every server worker of the pool. The workers keep running 
+ *      while they are read, so the totals are a snapshot which may be a few requests behind.
+ *
+ * Parameters:
+ *      totals    O/P    StatsTotals*    the totals of every server worker
+ *******************************************************************************************************************************/
+static void sum_stats(StatsTotals* totals)
+{
+    memset(totals, 0, sizeof(*totals));
+    for (unsigned int i = 0; i < serverStatsCount; ++i)
+    {
+        const WorkerStats& stats = serverStats[i];
+        totals->messagesIn += stats.messagesIn.load(std::memory_order_relaxed);
+        totals->bytesIn += stats.bytesIn.load(std::memory_order_relaxed);
+        totals->messagesOut += stats.messagesOut.load(std::memory_order_relaxed);
+        totals->bytesOut += stats.bytesOut.load(std::memory_order_relaxed);
+        totals->queueFull += stats.queueFull.load(std::memory_order_relaxed);
+        totals->repliesDropped += stats.repliesDropped.load(std::memory_order_relaxed);
+        totals->requestsExpired += stats.requestsExpired.load(std::memory_order_relaxed);
+        totals->requestsShed += stats.requestsShed.load(std::memory_order_relaxed);
+        totals->repliesCompressed += stats.repliesCompressed.load(std::memory_order_relaxed);
+        totals->compressionSaved += stats.compressionSaved.load(std::memory_order_relaxed);
+        totals->repliesStreamed += stats.repliesStreamed.load(std::memory_order_relaxed);
+        totals->chunksStreamed += stats.chunksStreamed.load(std::memory_order_relaxed);
+        totals->memoHits += stats.memoHits.load(std::memory_order_relaxed);
+        totals->memoMisses += stats.memoMisses.load(std::memory_order_relaxed);
+        totals->depthSamples += stats.depthSamples.load(std::memory_order_relaxed);
+        totals->depthTotal += stats.depthTotal.load(std::memory_order_relaxed);
+        totals->depthMax = std::max<unsigned long long>(totals->depthMax, stats.depthMax.load(std::memory_order_relaxed));
+        for (unsigned int opcode = 0; opcode < commandCount; ++opcode)
+        {
+            totals->requests[opcode] += stats.requests[opcode].load(std::memory_order_relaxed);
+            totals->handlerSamples[opcode] += stats.handlerSamples[opcode].load(std::memory_order_relaxed);
+            totals->handlerNanoseconds[opcode] += stats.handlerNanoseconds[opcode].load(std::memory_order_relaxed);
+        }
+        for (unsigned int priority = 0; priority < PRIORITY_CLASS_COUNT; ++priority)
+        {
+            totals->priorityMessages[priority] += stats.priorityMessages[priority].load(std::memory_order_relaxed);
+            totals->prioritySamples[priority] += stats.prioritySamples[priority].load(std::memory_order_relaxed);
+            totals->priorityNanoseconds[priority] += stats.priorityNanoseconds[priority].load(std::memory_order_relaxed);
+            totals->priorityMaxNanoseconds[priority] = std::max<unsigned long long>(
+                totals->priorityMaxNanoseconds[priority], stats.priorityMaxNanoseconds[priority].load(std::memory_order_relaxed));
+        }
+    }
+}
+
+/********************************************************************************************************************************
+ * size_t format_stats(char* output, size_t outputSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Report the expired and shed requests.
+ * 10/14/2026   Kerby Kaska     Report the compressed replies.
+ * 10/14/2026   Kerby Kaska     Report the streamed replies.
+ * 10/14/2026   Kerby Kaska     Report the hit rate of the memoCache.
+ *
+ * Description: Formats the statistics report of the whole server pool (see sum_stats()) into the output buffer: the
+ *      traffic counters, the expired and shed requests, the compressed and streamed replies, the hits and misses of the
+ *      memoized commands, the sampled command queue depth, the requests and mean handler time of every command that has
+ *      been executed, and the messages and mean (and longest) service time of every priority class. The report is cut
+ *      short if it does not fit in the output buffer.
+ *
+ * Parameters:
+ *      output          O/P    char*      the buffer to format the report into
+ *      outputSize      I/P    size_t     the size of output in bytes
+ *      format_stats    O/P    size_t     the number of bytes of the report in output
+ *******************************************************************************************************************************/
+size_t format_stats(char* output, size_t outputSize)
+{
+    StatsTotals totals;
+    sum_stats(&totals);
+    const unsigned long long memoLookups = totals.memoHits + totals.memoMisses;
+
+    size_t length = format_length(snprintf(output, outputSize, 
+        "Server statistics (%u worker(s)):\n"
+        " messages in: %llu (%llu bytes), out: %llu (%llu bytes)\n"
+        " reply queue full: %llu, replies dropped: %llu\n"
+        " requests expired: %llu, requests shed: %llu\n"
+        " replies compressed: %llu (%llu bytes saved), replies streamed: %llu (%llu chunks)\n"
+        " memoized responses: %llu hits, %llu misses (%.1f%% hit rate)\n"
+        " command queue depth: mean %.1f, max %llu (%llu samples)\n"
+        " %-16s %10s %14s\n", serverStatsCount, totals.messagesIn, totals.bytesIn, totals.messagesOut, totals.bytesOut,
+        totals.queueFull, totals.repliesDropped, totals.requestsExpired, totals.requestsShed, totals.repliesCompressed,
+        totals.compressionSaved, totals.repliesStreamed, totals.chunksStreamed, totals.memoHits, totals.memoMisses,
+        (memoLookups > 0) ? 100.0 * totals.memoHits / memoLookups : 0.0,
+        (totals.depthSamples > 0) ? static_cast<double>(totals.depthTotal) / totals.depthSamples : 0.0, totals.depthMax, 
+        totals.depthSamples, "command", "requests", "handler (ns)"), outputSize);
+    for (unsigned int opcode = 0; opcode < commandCount; ++opcode)
+    {
+        if (totals.requests[opcode] == 0)
+        {
+            continue;
+        }
+        const double handlerNanoseconds = (totals.handlerSamples[opcode] > 0) ? 
+            static_cast<double>(totals.handlerNanoseconds[opcode]) / totals.handlerSamples[opcode] : 0.0;
+        length += format_length(snprintf(output + length, outputSize - length, " %-16s %10llu %14.0f\n", 
+            (opcode == OPCODE_TEXT) ? "(unknown)" : command_entry(opcode).name, totals.requests[opcode], 
+            handlerNanoseconds), outputSize - length);
+    }
+    length += format_length(snprintf(output + length, outputSize - length, " %-16s %10s %14s %10s", "priority", 
+        "messages", "service (us)", "max (us)"), outputSize - length);
+    for (unsigned int priority = 0; priority < PRIORITY_CLASS_COUNT; ++priority)
+    {
+        const double serviceMicroseconds = (totals.prioritySamples[priority] > 0) ? 
+            totals.priorityNanoseconds[priority] / 1000.0 / totals.prioritySamples[priority] : 0.0;
+        length += format_length(snprintf(output + length, outputSize - length, "\n %-16s %10llu %14.1f %10.1f", 
+            PRIORITY_CLASS_NAMES[priority], totals.priorityMessages[priority], serviceMicroseconds, 
+            totals.priorityMaxNanoseconds[priority] / 1000.0), outputSize - length);
+    }
+    return length;
+}
+
+/********************************************************************************************************************************
+ * static size_t select_uname_fields(char* response, size_t responseLength, uint8_t fieldMask)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to keep only the requested fields of a binary CMD_GET_UNAME_FIELDS response, moving them to
+ *      the front of the response in place. A UNAME_FIELD_ERROR entry is always kept.
+ *
+ * Parameters:
+ *      response               I/P    char*       the binary response with every field (see UnameField)
+ *      responseLength         I/P    size_t      the number of bytes in response
+ *      fieldMask              I/P    uint8_t     the bit (1 << field) of every field to keep
+ *      select_uname_fields    O/P    size_t      the number of bytes of the selected fields in response
+ *******************************************************************************************************************************/
+static size_t select_uname_fields(char* response, size_t responseLength, uint8_t fieldMask)
+{
+    size_t selectedLength = 0;
+    size_t offset = 0;
+    while (offset + UNAME_ENTRY_HEADER_SIZE <= responseLength)
+    {
+        const uint8_t field = static_cast<uint8_t>(response[offset]);
+        const size_t entryLength = UNAME_ENTRY_HEADER_SIZE + static_cast<uint8_t>(response[offset + 1]);
+        if (offset + entryLength > responseLength)
+        {
+            break;
+        }
+        if (field == UNAME_FIELD_ERROR || (field < UNAME_FIELD_COUNT && (fieldMask & (1u << field)) != 0))
+        {
+            memmove(response + selectedLength, response + offset, entryLength);
+            selectedLength += entryLength;
+        }
+        offset += entryLength;
+    }
+    return selectedLength;
+}
+
+/********************************************************************************************************************************
+ * size_t execute_command(uint16_t opcode, const char* payload, size_t payloadLength, char* output, size_t outputSize, 
+ *                        bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved the command processing out of the server loop in main().
+ * 10/14/2026   Kerby Kaska     Dispatch through COMMAND_TABLE by opcode instead of a chain of strcmp() calls.
+ * 10/14/2026   Kerby Kaska     Serve cacheable commands from the responseCache.
+ * 10/14/2026   Kerby Kaska     Count every command in the workerStats, and time 1 in STATS_SAMPLE_INTERVAL of them.
+ * 10/14/2026   Kerby Kaska     Select the requested fields of the cached CMD_GET_UNAME_FIELDS response.
+ * 10/14/2026   Kerby Kaska     Serve idempotent commands from the memoCache.
+ *
+ * Description: Executes the given command and copies its result into the output buffer. Commands framed with an opcode
+ *      are dispatched straight through COMMAND_TABLE, and the payload holds their arguments. Commands framed as text
+ *      (OPCODE_TEXT) are looked up by name with find_command() first, and unknown commands get MESSAGE_BAD_COMMAND.
+ *      Idempotent commands are answered from the memoCache when the same arguments were seen before, without calling
+ *      their handler at all, and their response is memoized otherwise (counted as memo hits and misses in the
+ *      workerStats). Cacheable commands are served from the responseCache instead of running their handler. Every command is counted
+ *      in the workerStats by its opcode (unknown commands as OPCODE_TEXT), and the handler of 1 in STATS_SAMPLE_INTERVAL
+ *      commands is timed, so the clock is only read once in a while.
+ *
+ * Parameters:
+ *      opcode             I/P    uint16_t       the opcode from the MessageHeader of the command
+ *      payload            I/P    const char*    the received payload bytes (not NUL-terminated)
+ *      payloadLength      I/P    size_t         the number of bytes in payload
+ *      output             O/P    char*          the buffer to copy the result of the command into
+ *      outputSize         I/P    size_t         the size of output in bytes
+ *      running            O/P    bool*          set to false if the server loop should exit
+ *      execute_command    O/P    size_t         the number of bytes of the result copied into output
+ *******************************************************************************************************************************/
+size_t execute_command(uint16_t opcode, const char* payload, size_t payloadLength, char* output, size_t outputSize, 
+                       bool* running)
+{
+    // text command, look up its opcode by name (the whole payload is the command name, so there are no arguments)
+    if (opcode == OPCODE_TEXT)
+    {
+        opcode = find_command(payload, payloadLength);
+        if (opcode != OPCODE_TEXT)
+        {
+            payloadLength = 0;
+        }
+    }
+    else if (opcode >= commandCount)
+    {
+        return format_length(snprintf(output, outputSize, MESSAGE_BAD_OPCODE, opcode), outputSize);
+    }
+
+    // count the command, and time its handler once every STATS_SAMPLE_INTERVAL commands
+    WorkerStats* stats = workerStats;
+    const uint64_t requestCount = stats->requests[opcode].load(std::memory_order_relaxed);
+    stats->requests[opcode].store(requestCount + 1, std::memory_order_relaxed);
+    const bool timed = (requestCount & (STATS_SAMPLE_INTERVAL - 1)) == 0;
+    const uint64_t startTime = timed ? monotonic_nanoseconds() : 0;
+
+    // an idempotent command seen before with the same arguments is answered without its handler
+    const bool memoized = command_entry(opcode).memoizeSeconds != 0;
+    const MemoEntry* memo = memoized ? find_memoized(opcode, payload, payloadLength) : NULL;
+
+    size_t resultLength;
+    if (memo != NULL)
+    {
+        resultLength = copy_bytes(output, outputSize, memo->response, memo->responseLength);
+        stats_add(&stats->memoHits, 1);
+    }
+    else if (opcode == OPCODE_TEXT)
+    {
+        resultLength = handle_bad_command(payload, payloadLength, output, outputSize, running);
+    }
+    else if (command_entry(opcode).cacheable)
+    {
+        resultLength = cached_response(opcode, output, outputSize, running);
+        if (opcode == OPCODE_GET_UNAME_FIELDS && payloadLength > 0)
+        {
+            // NOTE: the cache holds every field, the request selects the ones it needs out of the copy
+            resultLength = select_uname_fields(output, resultLength, static_cast<uint8_t>(payload[0]));
+        }
+    }
+    else
+    {
+        resultLength = command_entry(opcode).handler(payload, payloadLength, output, outputSize, running);
+    }
+
+    if (memoized && memo == NULL)
+    {
+        memoize_response(opcode, payload, payloadLength, output, resultLength);
+        stats_add(&stats->memoMisses, 1);
+    }
+
+    if (timed)
+    {
+        stats_add(&stats->handlerSamples[opcode], 1);
+        stats_add(&stats->handlerNanoseconds[opcode], monotonic_nanoseconds() - startTime);
+    }
+    return resultLength;
+}
@@ -0,0 +1,321 @@
+/****************************************************************************************************************************************************
+* File: dispatch.h
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the command dispatch of the server out of main.cpp.
+*
+* Description: The commands pgm1 serves, and how a server worker executes them: the COMMAND_TABLE of the built-in
+*      commands and the pluginTable of the plugin commands, the perfect hash every command name is looked up through
+*      (find_command(), shared by the server and every client), the responseCache and memoCache, and the WorkerStats
+*      every command is counted in. pgm1, libpgm1, and the microbenchmarks all build from it, so the clients look
+*      commands up (and the microbenchmarks execute them) exactly like the server does.
+****************************************************************************************************************************************************/
+
+#ifndef PGM1_DISPATCH_H
+#define PGM1_DISPATCH_H
+
+#include "protocol.h"
+#include "transport.h"
+#include "plugin.h"
+#include <atomic>
+#include <signal.h>
+#include <type_traits>
+
+/********************************************************************************************************************************
+ * Priority Constants:
+ * PRIORITY_CLASS_NAMES     const char*[]         name of each priority class in the reports, indexed by class
+ *******************************************************************************************************************************/
+static const char* const PRIORITY_CLASS_NAMES[PRIORITY_CLASS_COUNT] = { "bulk", "normal", "control" };
+
+/********************************************************************************************************************************
+ * Statistics Constants:
+ * STATS_SAMPLE_INTERVAL    const uint64_t        1 in this many commands (and messages) is timed (a power of two)
+ *******************************************************************************************************************************/
+static const uint64_t STATS_SAMPLE_INTERVAL         = 64;
+static_assert((STATS_SAMPLE_INTERVAL & (STATS_SAMPLE_INTERVAL - 1)) == 0, "STATS_SAMPLE_INTERVAL must be a power of two");
+
+/********************************************************************************************************************************
+ * Dispatch Constants:
+ * MAX_PLUGINS               const unsigned int   largest number of plugins accepted for ARG_PLUGIN
+ * MAX_PLUGIN_COMMANDS       const unsigned int   largest number of commands registered by all plugins together
+ * MAX_OPCODES               const unsigned int   number of opcodes of the built-in commands and the plugin commands together
+ * MEMO_ARGUMENTS_SIZE       const unsigned int   largest number of bytes of arguments a memoized response is keyed by
+ * MEMO_RESPONSE_SIZE        const unsigned int   largest number of bytes of a memoized response
+ *******************************************************************************************************************************/
+static constexpr unsigned int MAX_PLUGINS               = 8;
+static constexpr unsigned int MAX_PLUGIN_COMMANDS       = 16;
+static constexpr unsigned int MAX_OPCODES               = OPCODE_COUNT + MAX_PLUGIN_COMMANDS;
+static constexpr unsigned int MEMO_ARGUMENTS_SIZE       = 64;
+static constexpr unsigned int MEMO_RESPONSE_SIZE        = 1024;
+
+/********************************************************************************************************************************
+ * typedef CommandHandler
+ * Description: Signature of every command handler in COMMAND_TABLE. Handlers copy their result into the output buffer and
+ *     return the number of bytes copied (never more than outputSize). This is also the PluginHandler of plugin commands.
+ *
+ * Parameters:
+ *      arguments          I/P    const char*    the arguments of the command (not NUL-terminated)
+ *      argumentsLength    I/P    size_t         the number of bytes in arguments
+ *      output             O/P    char*          the buffer to copy the result of the command into
+ *      outputSize         I/P    size_t         the size of output in bytes
+ *      running            O/P    bool*          set to false if the server loop should exit
+ *      CommandHandler     O/P    size_t         the number of bytes of the result copied into output
+ *******************************************************************************************************************************/
+typedef size_t (*CommandHandler)(const char* arguments, size_t argumentsLength, char* output, size_t outputSize, 
+                                 bool* running);
+static_assert(std::is_same<CommandHandler, PluginHandler>::value, "plugin handlers must be called like built-in ones");
+static_assert(PLUGIN_PRIORITY_CONTROL == static_cast<uint16_t>(PRIORITY_CONTROL), "PluginPriority must match PriorityClass");
+
+/********************************************************************************************************************************
+ * struct CommandEntry
+ * Description: Entry of COMMAND_TABLE, which maps an opcode to its command name and handler.
+ *
+ * Members:
+ * name                     const char*           command string to be entered by the user (one of the command constants)
+ * nameLength               size_t                number of bytes in name
+ * handler                  CommandHandler        handler executing the command on the server
+ * cacheable                bool                  true if the response rarely changes and is served from the responseCache
+ *                                                (the handler must ignore its arguments and have no side effects)
+ * priority                 PriorityClass         priority class the command is sent with
+ * blocking                 bool                  true if the handler may be slow or block, so it runs on the AsyncExecutor
+ *                                                instead of the server loop (the response is then never cached)
+ * memoizeSeconds           unsigned int          number of seconds the response to the same arguments is served from the
+ *                                                memoCache, or 0 if the command is not idempotent (it is always executed)
+ *******************************************************************************************************************************/
+struct CommandEntry
+{
+    const char* name;
+    size_t nameLength;
+    CommandHandler handler;
+    bool cacheable;
+    PriorityClass priority;
+    bool blocking;
+    unsigned int memoizeSeconds;
+};
+
+/********************************************************************************************************************************
+ * struct WorkerStats
+ * Description: Statistics of a single server worker, kept in shared memory so that any worker (CMD_STATS) and the
+ *     supervisor (ARG_STATS_FILE) can report the totals of the whole pool. Each worker is the only writer of its own slot,
+ *     so the counters are updated with relaxed loads and stores instead of locked read-modify-write instructions (see 
+ *     stats_add()), and readers may see a counter that is a few requests behind. Handler and service times are only 
+ *     measured for 1 in STATS_SAMPLE_INTERVAL requests, and the command queue depth for 1 in STATS_DEPTH_INTERVAL 
+ *     messages, so the clock and mq_getattr() stay off the hot path. Every slot starts on its own cache line.
+ *
+ * Members:
+ * messagesIn               std::atomic<uint64_t> number of (batched) command messages received
+ * bytesIn                  std::atomic<uint64_t> number of bytes of the command messages received
+ * messagesOut              std::atomic<uint64_t> number of (batched) reply messages sent
+ * bytesOut                 std::atomic<uint64_t> number of bytes of the reply messages sent
+ * queueFull                std::atomic<uint64_t> number of times a reply queue was full (EAGAIN)
+ * repliesDropped           std::atomic<uint64_t> number of replies dropped (the client exited, or its outbox was full, or it
+ *                                                did not read its replies for REPLY_SEND_TIMEOUT milliseconds)
+ * requestsExpired          std::atomic<uint64_t> number of requests dropped unanswered because their deadline had passed
+ * requestsShed             std::atomic<uint64_t> number of requests answered with MESSAGE_SHED instead of being executed
+ * repliesCompressed        std::atomic<uint64_t> number of replies sent compressed (FRAME_COMPRESSED)
+ * compressionSaved         std::atomic<uint64_t> number of payload bytes saved by compressing the replies
+ * repliesStreamed          std::atomic<uint64_t> number of results too large for a message, streamed in chunks
+ * chunksStreamed           std::atomic<uint64_t> number of chunks sent of the streamed results
+ * memoHits                 std::atomic<uint64_t> number of idempotent commands answered from the memoCache
+ * memoMisses               std::atomic<uint64_t> number of idempotent commands whose handler had to run
+ * depthSamples             std::atomic<uint64_t> number of command queue depth samples
+ * depthTotal               std::atomic<uint64_t> sum of the command queue depth samples
+ * depthMax                 std::atomic<uint64_t> largest command queue depth sampled
+ * requests                 std::atomic<uint64_t>[] number of commands executed, by opcode (OPCODE_TEXT for unknown commands)
+ * handlerSamples           std::atomic<uint64_t>[] number of timed commands, by opcode
+ * handlerNanoseconds       std::atomic<uint64_t>[] total handler time of the timed commands, by opcode
+ * priorityMessages         std::atomic<uint64_t>[] number of messages served, by PriorityClass
+ * prioritySamples          std::atomic<uint64_t>[] number of timed messages, by PriorityClass
+ * priorityNanoseconds      std::atomic<uint64_t>[] total time from receiving a timed message to sending its last reply
+ * priorityMaxNanoseconds   std::atomic<uint64_t>[] longest time from receiving a timed message to sending its last reply
+ *******************************************************************************************************************************/
+struct WorkerStats
+{
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> messagesIn;
+    std::atomic<uint64_t> bytesIn;
+    std::atomic<uint64_t> messagesOut;
+    std::atomic<uint64_t> bytesOut;
+    std::atomic<uint64_t> queueFull;
+    std::atomic<uint64_t> repliesDropped;
+    std::atomic<uint64_t> requestsExpired;
+    std::atomic<uint64_t> requestsShed;
+    std::atomic<uint64_t> repliesCompressed;
+    std::atomic<uint64_t> compressionSaved;
+    std::atomic<uint64_t> repliesStreamed;
+    std::atomic<uint64_t> chunksStreamed;
+    std::atomic<uint64_t> memoHits;
+    std::atomic<uint64_t> memoMisses;
+    std::atomic<uint64_t> depthSamples;
+    std::atomic<uint64_t> depthTotal;
+    std::atomic<uint64_t> depthMax;
+    std::atomic<uint64_t> requests[MAX_OPCODES];
+    std::atomic<uint64_t> handlerSamples[MAX_OPCODES];
+    std::atomic<uint64_t> handlerNanoseconds[MAX_OPCODES];
+    std::atomic<uint64_t> priorityMessages[PRIORITY_CLASS_COUNT];
+    std::atomic<uint64_t> prioritySamples[PRIORITY_CLASS_COUNT];
+    std::atomic<uint64_t> priorityNanoseconds[PRIORITY_CLASS_COUNT];
+    std::atomic<uint64_t> priorityMaxNanoseconds[PRIORITY_CLASS_COUNT];
+};
+
+/********************************************************************************************************************************
+ * struct StatsTotals
+ * Description: Plain totals of the WorkerStats of every server worker, summed up by sum_stats() to be reported.
+ *
+ * Members: (see WorkerStats, depthMax and priorityMaxNanoseconds are the largest of every worker instead of the sum)
+ *******************************************************************************************************************************/
+struct StatsTotals
+{
+    unsigned long long messagesIn;
+    unsigned long long bytesIn;
+    unsigned long long messagesOut;
+    unsigned long long bytesOut;
+    unsigned long long queueFull;
+    unsigned long long repliesDropped;
+    unsigned long long requestsExpired;
+    unsigned long long requestsShed;
+    unsigned long long repliesCompressed;
+    unsigned long long compressionSaved;
+    unsigned long long repliesStreamed;
+    unsigned long long chunksStreamed;
+    unsigned long long memoHits;
+    unsigned long long memoMisses;
+    unsigned long long depthSamples;
+    unsigned long long depthTotal;
+    unsigned long long depthMax;
+    unsigned long long requests[MAX_OPCODES];
+    unsigned long long handlerSamples[MAX_OPCODES];
+    unsigned long long handlerNanoseconds[MAX_OPCODES];
+    unsigned long long priorityMessages[PRIORITY_CLASS_COUNT];
+    unsigned long long prioritySamples[PRIORITY_CLASS_COUNT];
+    unsigned long long priorityNanoseconds[PRIORITY_CLASS_COUNT];
+    unsigned long long priorityMaxNanoseconds[PRIORITY_CLASS_COUNT];
+};
+
+/********************************************************************************************************************************
+ * struct MemoEntry
+ * Description: Response of an idempotent command memoized in the memoCache, keyed by its opcode and arguments.
+ *
+ * Members:
+ * hash                     uint64_t              memo_hash() of the opcode and arguments, compared before the arguments
+ * expiry                   time_t                CLOCK_MONOTONIC_COARSE second at which the response expires
+ * lastUse                  uint64_t              clock of the shard when the response was last stored or served (for LRU)
+ * opcode                   uint16_t              the opcode of the command, or OPCODE_TEXT for an empty entry
+ * argumentsLength          uint16_t              number of bytes in arguments
+ * responseLength           uint16_t              number of bytes in response
+ * arguments                char[]                the arguments of the command
+ * response                 char[]                the response of the command
+ *******************************************************************************************************************************/
+struct MemoEntry
+{
+    uint64_t hash;
+    time_t expiry;
+    uint64_t lastUse;
+    uint16_t opcode;
+    uint16_t argumentsLength;
+    uint16_t responseLength;
+    char arguments[MEMO_ARGUMENTS_SIZE];
+    char response[MEMO_RESPONSE_SIZE];
+};
+
+/********************************************************************************************************************************
+ * Dispatch State:
+ * commandCount         unsigned int             number of opcodes in use (OPCODE_COUNT plus the pluginCommandCount)
+ *******************************************************************************************************************************/
+extern unsigned int commandCount;
+
+/********************************************************************************************************************************
+ * Statistics:
+ * serverStats          WorkerStats*         the statistics of every server worker, in shared memory mapped by the supervisor
+ * serverStatsCount     unsigned int         number of WorkerStats in serverStats
+ * workerStats          WorkerStats*         the statistics of this server worker (its slot of serverStats)
+ *******************************************************************************************************************************/
+extern WorkerStats* serverStats;
+extern unsigned int serverStatsCount;
+extern WorkerStats* workerStats;
+
+/********************************************************************************************************************************
+ * Cache State:
+ * responseCacheStale   volatile sig_atomic_t    set to 1 (by CMD_REFRESH or SIGHUP) to invalidate the responseCache before its 
+ *                                               next use, starts out as 1 so the cache expiry is set on first use
+ * memoCacheStale       volatile sig_atomic_t    set to 1 (by CMD_REFRESH or SIGHUP) to empty the memoCache before its next use
+ *
+ * NOTE: these are global so that hangup_handler() can set them
+ *******************************************************************************************************************************/
+extern volatile sig_atomic_t responseCacheStale;
+extern volatile sig_atomic_t memoCacheStale;
+
+/********************************************************************************************************************************
+ * Process State:
+ * supervisorProcessID  pid_t                process ID of the supervisor of the forked client and server workers, recorded
+ *                                           before they are forked (see signal_supervisor()), or 0 without a supervisor
+ *******************************************************************************************************************************/
+extern pid_t supervisorProcessID;
+
+/********************************************************************************************************************************
+ * static void stats_add(std::atomic<uint64_t>* counter, uint64_t value)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to add to a counter of the WorkerStats of this worker. Only its own worker ever writes to
+ *      the counter, so a relaxed load and store is enough (no locked instruction, and no lock), while readers in other
+ *      processes still never see a torn value.
+ *
+ * Parameters:
+ *      counter    I/O    std::atomic<uint64_t>*    the counter to add to
+ *      value      I/P    uint64_t                  the value to add
+ *******************************************************************************************************************************/
+static inline void stats_add(std::atomic<uint64_t>* counter, uint64_t value)
+{
+    counter->store(counter->load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/********************************************************************************************************************************
+ * static void stats_max(std::atomic<uint64_t>* counter, uint64_t value)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to raise a maximum of the WorkerStats of this worker to value (see stats_add()).
+ *
+ * Parameters:
+ *      counter    I/O    std::atomic<uint64_t>*    the maximum to raise
+ *      value      I/P    uint64_t                  the value to raise it to, if it is larger
+ *******************************************************************************************************************************/
+static inline void stats_max(std::atomic<uint64_t>* counter, uint64_t value)
+{
+    if (value > counter->load(std::memory_order_relaxed))
+    {
+        counter->store(value, std::memory_order_relaxed);
+    }
+}
+
+/********************************************************************************************************************************
+ * Dispatch Procedures (see dispatch.cpp):
+ * command_entry            utility method to look up the CommandEntry of an opcode in use
+ * has_blocking_command     utility method to check whether any command in use runs on the AsyncExecutor
+ * find_command             looks up the opcode of a command name (built-in or plugin) through the perfect hash 
+ *                          commandIndex
+ * load_plugin              loads a plugin (ARG_PLUGIN) and registers its commands
+ * find_memoized, memoize_response
+ *                          look up and store the memoized response of an idempotent command in the memoCache
+ * format_stats             formats the statistics report of the whole server pool
+ * execute_command          executes a command and copies its result into an output buffer
+ * signal_supervisor        utility method to signal the supervisor of a forked process, only while it is still its parent
+ *******************************************************************************************************************************/
+const CommandEntry& command_entry(unsigned int opcode);
+bool has_blocking_command();
+uint16_t find_command(const char* name, size_t nameLength);
+bool load_plugin(const char* path);
+const MemoEntry* find_memoized(uint16_t opcode, const char* arguments, size_t argumentsLength);
+void memoize_response(uint16_t opcode, const char* arguments, size_t argumentsLength, const char* response,
+                      size_t responseLength);
+size_t format_stats(char* output, size_t outputSize);
+size_t execute_command(uint16_t opcode, const char* payload, size_t payloadLength, char* output, size_t outputSize, 
+                       bool* running);
+bool signal_supervisor(int signalNumber);
+
+#endif
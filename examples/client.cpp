@@ -0,0 +1,103 @@
+/****************************************************************************************************************************************************
+* File: client.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+*
+* Description: Example application embedding the pgm1 client (see pgm1.h). Connects to a running server, through its command
+*              queue or the gateway endpoint given as the first argument, and makes the same requests with each of the calls
+*              of the library: one at a time, as futures in flight together, and as a batch. Build it with
+*              make client-example, and run it against pgm1 --server (add --listen unix:/tmp/pgm1.sock for the gateway):
+*
+*                  ./client-example
+*                  ./client-example unix:/tmp/pgm1.sock
+*
+* Procedures:
+* main                 - connects to the server and makes the example requests
+* print_reply          - utility method to print the reply of a request
+****************************************************************************************************************************************************/
+
+#include "../pgm1.h"
+#include <iostream>
+#include <stdlib.h>
+
+/********************************************************************************************************************************
+ * Example Constants:
+ * EXAMPLE_COMMANDS         const char*[]         the commands requested
+ * EXAMPLE_COMMAND_COUNT    const size_t          the number of EXAMPLE_COMMANDS
+ * EXAMPLE_TIMEOUT          const unsigned int    milliseconds every request is waited for
+ *******************************************************************************************************************************/
+static const char* EXAMPLE_COMMANDS[]        = { "gethostname", "getdomainname", "uname", "uname-fields", "nonexistent" };
+static const size_t EXAMPLE_COMMAND_COUNT    = sizeof(EXAMPLE_COMMANDS) / sizeof(EXAMPLE_COMMANDS[0]);
+static const unsigned int EXAMPLE_TIMEOUT    = 2000;
+
+/********************************************************************************************************************************
+ * static void print_reply(const char* call, const Pgm1Reply& reply)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to print the reply of a request, with the call of the library it was made with.
+ *
+ * Parameters:
+ *      call     I/P    const char*         the call the request was made with
+ *      reply    I/P    const Pgm1Reply&    the reply of the request
+ *******************************************************************************************************************************/
+static void print_reply(const char* call, const Pgm1Reply& reply)
+{
+    std::cout << call << " #" << reply.requestID << " (opcode " << reply.opcode << ")" << (reply.ok ? ": " : " failed: ")
+              << reply.result << "\n";
+}
+
+/********************************************************************************************************************************
+ * int main(int argc, char* argv[])
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Connects to the server (through the endpoint given as the first argument, if any), and requests
+ *      EXAMPLE_COMMANDS with call(), then with submit(), then with call_batch().
+ *
+ * Parameters:
+ *      argc    I/P    int        the number of arguments
+ *      argv    I/P    char*[]    the arguments, of which the first is the optional gateway endpoint
+ *      main    O/P    int        EXIT_SUCCESS, or EXIT_FAILURE if the server could not be reached
+ *******************************************************************************************************************************/
+int main(int argc, char* argv[])
+{
+    Pgm1ClientConfig config;
+    config.endpoint = (argc > 1) ? argv[1] : NULL;
+    config.timeout = EXAMPLE_TIMEOUT;
+    Pgm1Client client;
+    if (!client.connect(config))
+    {
+        std::cerr << "main() - " << client.error() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> commands(EXAMPLE_COMMANDS, EXAMPLE_COMMANDS + EXAMPLE_COMMAND_COUNT);
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        print_reply("call", client.call(commands[i]));
+    }
+
+    std::vector<std::future<Pgm1Reply> > futures;
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        futures.push_back(client.submit(commands[i]));
+    }
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        print_reply("submit", futures[i].get());
+    }
+
+    std::vector<Pgm1Reply> replies = client.call_batch(commands);
+    for (size_t i = 0; i < replies.size(); ++i)
+    {
+        print_reply("call_batch", replies[i]);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,951 @@
+/****************************************************************************************************************************************************
+* File: pgm1.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+* 10/14/2026   Kerby Kaska     Build from the protocol shared with pgm1 (protocol.cpp) instead of the whole program, so the
+*                              library is a client only. Every client names its own reply queue (see claim_library_instance).
+* 10/14/2026   Kerby Kaska     Look the commands up with the find_command() of the server (dispatch.cpp).
+* 10/14/2026   Kerby Kaska     Send at the priority of the client configuration, defaulting to PGM1_PRIORITY like pgm1.
+*
+* Description: Implementation of libpgm1 (see pgm1.h). The library is built from the protocol of pgm1 (see protocol.h), and
+*              looks the commands up through the dispatch of pgm1 (see dispatch.h), so it frames, expands, and renders 
+*              exactly like pgm1 does. It never changes any state of the program (no plugin is ever loaded, so the 
+*              lookup only reads the built-in commands): every client keeps its connection in a Pgm1Client::State of its
+*              own, so any number of them run side by side in the same process.
+*
+* Procedures:
+* Pgm1Client::connect, Pgm1Client::close
+*                      - connect to the command queue or gateway of a server (starting the receiver thread), and disconnect
+*
+* Pgm1Client::call, Pgm1Client::submit, Pgm1Client::submit_batch, Pgm1Client::call_batch
+*                      - send commands to the server, and wait for (or return the futures of) their replies
+*
+* claim_library_instance, release_library_instance
+*                      - utility methods to hand out the instance numbers the private reply queues of the clients are named by
+*
+* run_library_receiver - receiver thread of a client, matching every reply to its request and failing the expired requests
+*
+* receive_library_replies - utility method to receive what the server has sent, and hand every whole message to the client
+*
+* handle_library_message - utility method to collect every frame of a reply message into the reply of its request
+*
+* send_library_message - utility method to send a message of framed commands through the connection of a client
+*
+* complete_library_request, fail_library_requests
+*                      - utility methods to resolve the future of a request, and to fail every request still in flight
+*
+* expire_library_requests - utility method to fail every request which has not been answered within the timeout
+*
+* library_error        - utility method to describe a failed system call, as the error of connect()
+****************************************************************************************************************************************************/
+
+#include "../protocol.h"
+#include "../dispatch.h"
+#include "../pgm1.h"
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+/********************************************************************************************************************************
+ * Library Constants:
+ * LIBRARY_POLL_INTERVAL    const int             milliseconds the receiver thread waits for a reply before it checks for
+ *                                                expired requests, and whether the client is closing
+ * LIBRARY_MAX_INSTANCES    const unsigned int    number of clients of a process which can be connected through the command
+ *                                                queue at once, each one with a private reply queue of its own
+ * LIBRARY_INSTANCE_SHIFT   const unsigned int    bit position of the instance number in the client ID, above the process
+ *                                                ID (the kernel never hands out process IDs of more than 22 bits)
+ * MESSAGE_CORRUPT_REPLY    const char*           result of a request whose reply could not be expanded or rendered (or is
+ *                                                out of order)
+ * MESSAGE_UNFRAMED         const char*           result of a request which does not fit in a message even when truncated
+ *******************************************************************************************************************************/
+static const int LIBRARY_POLL_INTERVAL       = 100;
+static const unsigned int LIBRARY_MAX_INSTANCES = 512;
+static const unsigned int LIBRARY_INSTANCE_SHIFT = 22;
+static const char* MESSAGE_CORRUPT_REPLY     = "Received a corrupt reply.";
+static const char* MESSAGE_UNFRAMED          = "The command does not fit in a message.";
+
+/********************************************************************************************************************************
+ * Library State:
+ * libraryOnce              pthread_once_t        initializes the process state the clients share (the compressionDictionary)
+ * libraryInstanceLock      std::mutex            guards libraryInstances
+ * libraryInstances         bool[]                true for every instance number held by a client connected through the
+ *                                                command queue (see claim_library_instance())
+ *******************************************************************************************************************************/
+static pthread_once_t libraryOnce = PTHREAD_ONCE_INIT;
+static std::mutex libraryInstanceLock;
+static bool libraryInstances[LIBRARY_MAX_INSTANCES];
+
+/********************************************************************************************************************************
+ * struct LibraryRequest
+ * Description: Request of a Pgm1Client in flight, from the time it is framed to the last chunk of its reply.
+ *
+ * Members:
+ * promise                  std::promise<Pgm1Reply> resolved with the reply once it is complete (or with the failure)
+ * reply                    Pgm1Reply             the reply collected so far
+ * sequence                 uint16_t              sequence number of the next chunk of a streamed reply
+ * expiry                   uint32_t              CLOCK_MONOTONIC time in milliseconds the request fails at (see
+ *                                                monotonic_milliseconds()), or 0 for no timeout
+ *******************************************************************************************************************************/
+struct LibraryRequest
+{
+    std::promise<Pgm1Reply> promise;
+    Pgm1Reply reply;
+    uint16_t sequence;
+    uint32_t expiry;
+};
+
+/********************************************************************************************************************************
+ * struct Pgm1Client::State
+ * Description: Connection of a Pgm1Client, and its requests in flight.
+ *
+ * Members:
+ * config                   Pgm1ClientConfig      the configuration the client connected with
+ * descriptor               int                   the gateway connection, or -1 for the command queue
+ * commandQueue             mqd_t                 the command queue of the server, or -1 for a gateway connection
+ * replyQueue               mqd_t                 the private reply queue of the client, or -1 for a gateway connection
+ * replyQueueName           char[]                name of replyQueue, which the client unlinks on close
+ * clientID                 int32_t               client ID naming replyQueue (the process ID and instance), or 0 for a gateway
+ * instance                 int                   instance number held in libraryInstances, or -1 for none
+ * messageSize              size_t                size of the largest message sent and received
+ * input                    std::vector<char>     bytes received from the gateway, of which the last message may be partial
+ * inputLength              size_t                number of bytes in input
+ * expandBuffer             std::vector<char>     buffer the compressed replies are expanded into
+ * textBuffer               std::vector<char>     buffer the binary uname replies are rendered into
+ * sendLock                 std::mutex            guards the framing and sending of messages (and nextRequestID)
+ * nextRequestID            uint32_t              request ID of the next request
+ * windowSize               size_t                the number of requests kept in flight at once, the queue depth of the server
+ *                                                (like the pipelined client), so it never has to drop a reply for a full queue
+ * pendingLock              std::mutex            guards pending
+ * pending                  std::map<...>         the requests in flight, by request ID
+ * pendingDone              std::condition_variable signalled when a request is resolved, so submit_batch() can send more
+ * receiver                 pthread_t             the receiver thread (see run_library_receiver())
+ * receiving                bool                  true while the receiver thread runs (joined on close)
+ * connected                std::atomic<bool>     true from connect() until close(), or until the connection is lost
+ * error                    std::string           the reason the last connect() failed
+ *******************************************************************************************************************************/
+struct Pgm1Client::State
+{
+    Pgm1ClientConfig config;
+    int descriptor;
+    mqd_t commandQueue;
+    mqd_t replyQueue;
+    char replyQueueName[REPLY_QUEUE_NAME_SIZE];
+    int32_t clientID;
+    int instance;
+    size_t messageSize;
+    std::vector<char> input;
+    size_t inputLength;
+    std::vector<char> expandBuffer;
+    std::vector<char> textBuffer;
+    std::mutex sendLock;
+    uint32_t nextRequestID;
+    size_t windowSize;
+    std::mutex pendingLock;
+    std::map<uint32_t, LibraryRequest> pending;
+    std::condition_variable pendingDone;
+    pthread_t receiver;
+    bool receiving;
+    std::atomic<bool> connected;
+    std::string error;
+};
+
+/********************************************************************************************************************************
+ * Pgm1ClientConfig::Pgm1ClientConfig(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added the priority, defaulting to ENV_PRIORITY like the client.
+ *
+ * Description: Sets the client configuration to the defaults: the command queue of the standalone server, no timeout,
+ *      the default message size, uncompressed replies, and the message priority of ENV_PRIORITY when it is set (else
+ *      QUEUE_MESSAGE_PRIORITY), like pgm1 does. An invalid ENV_PRIORITY is kept out of range, so connect() rejects it
+ *      like the client refuses to start.
+ *******************************************************************************************************************************/
+Pgm1ClientConfig::Pgm1ClientConfig()
+    : endpoint(NULL), timeout(0), messageSize(QUEUE_MESSAGE_SIZE), compress(false), priority(QUEUE_MESSAGE_PRIORITY)
+{
+    const char* text = getenv(ENV_PRIORITY);
+    if (text != NULL && !parse_count(text, 0, QUEUE_PRIORITY_LIMIT, &priority))
+    {
+        priority = QUEUE_PRIORITY_LIMIT + 1;
+    }
+}
+
+/********************************************************************************************************************************
+ * static std::string library_error(const char* call)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to describe a failed system call like perror() does, as the error of connect(), since a
+ *      library must leave the console to the application.
+ *
+ * Parameters:
+ *      call             I/P    const char*    the failed call
+ *      library_error    O/P    std::string    the call, followed by the description of errno
+ *******************************************************************************************************************************/
+static std::string library_error(const char* call)
+{
+    return std::string(call) + ": " + strerror(errno);
+}
+
+/********************************************************************************************************************************
+ * static int claim_library_instance(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to hand out the lowest instance number no other client of the process holds, so a client
+ *      connecting through the command queue names its private reply queue after the process ID and its own instance
+ *      (see LIBRARY_INSTANCE_SHIFT), apart from every other client of the process. The instance number is held until
+ *      release_library_instance().
+ *
+ * Parameters:
+ *      claim_library_instance    O/P    int    the instance number, or -1 if all LIBRARY_MAX_INSTANCES are held
+ *******************************************************************************************************************************/
+static int claim_library_instance()
+{
+    std::lock_guard<std::mutex> guard(libraryInstanceLock);
+    for (unsigned int instance = 0; instance < LIBRARY_MAX_INSTANCES; ++instance)
+    {
+        if (!libraryInstances[instance])
+        {
+            libraryInstances[instance] = true;
+            return instance;
+        }
+    }
+    return -1;
+}
+
+/********************************************************************************************************************************
+ * static void release_library_instance(int instance)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to give back an instance number handed out by claim_library_instance(), once the private
+ *      reply queue named after it is unlinked, so the next client to connect can use it.
+ *
+ * Parameters:
+ *      instance    I/P    int    the instance number
+ *******************************************************************************************************************************/
+static void release_library_instance(int instance)
+{
+    std::lock_guard<std::mutex> guard(libraryInstanceLock);
+    libraryInstances[instance] = false;
+}
+
+/********************************************************************************************************************************
+ * static void complete_library_request(std::map<uint32_t, LibraryRequest>::iterator request, bool ok, const char* failure,
+ *                                      Pgm1Client::State* state)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to resolve the future of a request with its reply (or with its failure, replacing what was
+ *      collected of the reply so far), and to forget the request. Must be called with the pendingLock held.
+ *
+ * Parameters:
+ *      request    I/P    std::map<...>::iterator    the request to resolve
+ *      ok         I/P    bool                       true if the reply is complete, false if the request failed
+ *      failure    I/P    const char*                the reason the request failed (ignored if ok)
+ *      state      I/P    Pgm1Client::State*         the state of the client the request belongs to
+ *******************************************************************************************************************************/
+static void complete_library_request(std::map<uint32_t, LibraryRequest>::iterator request, bool ok, const char* failure,
+                                     Pgm1Client::State* state)
+{
+    Pgm1Reply& reply = request->second.reply;
+    reply.ok = ok;
+    if (!ok)
+    {
+        reply.result = failure;
+    }
+    request->second.promise.set_value(reply);
+    state->pending.erase(request);
+    state->pendingDone.notify_all();
+}
+
+/********************************************************************************************************************************
+ * static void fail_library_requests(Pgm1Client::State* state, const char* failure)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to fail every request of a client still in flight, once the connection is lost or closed.
+ *
+ * Parameters:
+ *      state      I/P    Pgm1Client::State*    the state of the client
+ *      failure    I/P    const char*           the reason the requests failed
+ *******************************************************************************************************************************/
+static void fail_library_requests(Pgm1Client::State* state, const char* failure)
+{
+    std::lock_guard<std::mutex> guard(state->pendingLock);
+    while (!state->pending.empty())
+    {
+        complete_library_request(state->pending.begin(), false, failure, state);
+    }
+}
+
+/********************************************************************************************************************************
+ * static void expire_library_requests(Pgm1Client::State* state)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to fail every request of a client which has not been answered within the timeout of the
+ *      client (see Pgm1ClientConfig), as MESSAGE_TIMED_OUT. A late reply to it is dropped.
+ *
+ * Parameters:
+ *      state    I/P    Pgm1Client::State*    the state of the client
+ *******************************************************************************************************************************/
+static void expire_library_requests(Pgm1Client::State* state)
+{
+    if (state->config.timeout == 0)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(state->pendingLock);
+    std::map<uint32_t, LibraryRequest>::iterator request = state->pending.begin();
+    while (request != state->pending.end())
+    {
+        std::map<uint32_t, LibraryRequest>::iterator next = request;
+        ++next;
+        if (remaining_timeout(request->second.expiry) == 0)
+        {
+            complete_library_request(request, false, MESSAGE_TIMED_OUT, state);
+        }
+        request = next;
+    }
+}
+
+/********************************************************************************************************************************
+ * static void handle_library_message(Pgm1Client::State* state, const char* message, size_t messageLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Render a streamed binary reply once its last chunk has arrived.
+ *
+ * Description: Utility method to collect every frame of a (batched) reply message into the reply of its request,
+ *      expanded like the clients of pgm1 do. A binary reply is rendered once whole. A request is complete once the last chunk of its reply (see
+ *      stream_reply()) has arrived. Replies to requests no longer in flight (which timed out) are dropped.
+ *
+ * Parameters:
+ *      state            I/P    Pgm1Client::State*    the state of the client
+ *      message          I/P    const char*           the received message
+ *      messageLength    I/P    size_t                the number of bytes in message
+ *******************************************************************************************************************************/
+static void handle_library_message(Pgm1Client::State* state, const char* message, size_t messageLength)
+{
+    std::lock_guard<std::mutex> guard(state->pendingLock);
+    MessageHeader header;
+    size_t offset = 0;
+    while (read_frame(message, messageLength, offset, &header))
+    {
+        const char* payload = message + offset + sizeof(header);
+        size_t payloadLength = header.payloadLength;
+        offset += sizeof(header) + header.payloadLength;
+        std::map<uint32_t, LibraryRequest>::iterator request = state->pending.find(header.requestID);
+        if (request == state->pending.end())
+        {
+            continue; // NOTE: the late reply to a request which timed out
+        }
+        if (header.sequence != request->second.sequence ||
+            !expand_reply(header, &payload, &payloadLength, &state->expandBuffer[0], state->expandBuffer.size()))
+        {
+            complete_library_request(request, false, MESSAGE_CORRUPT_REPLY, state);
+            continue;
+        }
+        std::string& result = request->second.reply.result;
+        result.append(payload, payloadLength);
+        ++request->second.sequence;
+        if ((header.flags & FRAME_MORE) != 0)
+        {
+            continue;
+        }
+        if (header.opcode == OPCODE_GET_UNAME_FIELDS)
+        {
+            // NOTE: the entries of a binary reply span the chunks, so it is only rendered once the last one has arrived
+            size_t textLength;
+            if (!render_uname(result.data(), result.size(), &state->textBuffer[0], state->textBuffer.size(), &textLength))
+            {
+                complete_library_request(request, false, MESSAGE_CORRUPT_REPLY, state);
+                continue;
+            }
+            result.assign(&state->textBuffer[0], textLength);
+        }
+        complete_library_request(request, true, NULL, state);
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool receive_library_replies(Pgm1Client::State* state)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to receive what the server has sent to a client, waiting up to LIBRARY_POLL_INTERVAL
+ *      milliseconds for it, and to hand every whole message to handle_library_message(). A message from the reply queue
+ *      is whole, while the gateway sends a stream of length-prefixed messages (see GATEWAY_LENGTH_SIZE), of which the
+ *      last one received may still be partial, so it is kept until the rest of it arrives.
+ *
+ * Parameters:
+ *      state                      I/P    Pgm1Client::State*    the state of the client
+ *      receive_library_replies    O/P    bool                  true while connected, false once the connection is lost
+ *******************************************************************************************************************************/
+static bool receive_library_replies(Pgm1Client::State* state)
+{
+    if (state->descriptor == -1)
+    {
+        const timespec deadline = realtime_after(LIBRARY_POLL_INTERVAL);
+        const ssize_t messageLength = mq_timedreceive(state->replyQueue, &state->input[0], state->input.size(), NULL,
+                                                      &deadline);
+        if (messageLength == -1)
+        {
+            return errno == ETIMEDOUT || errno == EINTR;
+        }
+        handle_library_message(state, &state->input[0], messageLength);
+        return true;
+    }
+
+    pollfd descriptor = { state->descriptor, POLLIN, 0 };
+    const int readyCount = poll(&descriptor, 1, LIBRARY_POLL_INTERVAL);
+    if (readyCount <= 0)
+    {
+        return readyCount == 0 || errno == EINTR;
+    }
+    const ssize_t received = recv(state->descriptor, &state->input[state->inputLength],
+                                  state->input.size() - state->inputLength, 0);
+    if (received <= 0)
+    {
+        return received == -1 && errno == EINTR; // NOTE: the server has gone (or ended the session)
+    }
+    state->inputLength += received;
+
+    size_t offset = 0;
+    while (state->inputLength - offset >= GATEWAY_LENGTH_SIZE)
+    {
+        uint32_t messageLength;
+        memcpy(&messageLength, &state->input[offset], GATEWAY_LENGTH_SIZE);
+        if (messageLength > state->input.size() - GATEWAY_LENGTH_SIZE)
+        {
+            return false; // NOTE: a malformed stream, nothing after it can be trusted
+        }
+        if (state->inputLength - offset - GATEWAY_LENGTH_SIZE < messageLength)
+        {
+            break;
+        }
+        handle_library_message(state, &state->input[offset + GATEWAY_LENGTH_SIZE], messageLength);
+        offset += GATEWAY_LENGTH_SIZE + messageLength;
+    }
+    memmove(&state->input[0], &state->input[offset], state->inputLength - offset);
+    state->inputLength -= offset;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void* run_library_receiver(void* argument)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Receiver thread of a client, started by connect(). Receives the replies of the server and resolves the
+ *      future of every request once its reply is complete, and fails the requests which have expired, until the client
+ *      closes or the connection is lost. Every request still in flight then fails as MESSAGE_NO_CONNECTION.
+ *
+ * Parameters:
+ *      argument                I/P    void*    the Pgm1Client::State of the client
+ *      run_library_receiver    O/P    void*    NULL
+ *******************************************************************************************************************************/
+static void* run_library_receiver(void* argument)
+{
+    Pgm1Client::State* state = static_cast<Pgm1Client::State*>(argument);
+    while (state->connected.load(std::memory_order_acquire))
+    {
+        if (!receive_library_replies(state))
+        {
+            state->connected.store(false, std::memory_order_release);
+            break;
+        }
+        expire_library_requests(state);
+    }
+    fail_library_requests(state, MESSAGE_NO_CONNECTION);
+    return NULL;
+}
+
+/********************************************************************************************************************************
+ * static bool send_library_message(Pgm1Client::State* state, char* message, size_t messageLength, unsigned int priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to send a message of framed commands through the connection of a client: to the command
+ *      queue with the given priority (waiting up to the timeout of the client while it is full), or to the gateway behind
+ *      its length. Must be called with the sendLock held.
+ *
+ * Parameters:
+ *      state                   I/P    Pgm1Client::State*    the state of the client
+ *      message                 I/P    char*                 the message, preceded by GATEWAY_LENGTH_SIZE bytes of room for
+ *                                                           its length
+ *      messageLength           I/P    size_t                the number of bytes in message (without the length)
+ *      priority                I/P    unsigned int          the message priority (see COMMAND_NAMES)
+ *      send_library_message    O/P    bool                  true on success, false if the message could not be sent
+ *******************************************************************************************************************************/
+static bool send_library_message(Pgm1Client::State* state, char* message, size_t messageLength, unsigned int priority)
+{
+    if (state->descriptor == -1)
+    {
+        int result;
+        do
+        {
+            const timespec deadline = realtime_after((state->config.timeout != 0) ? state->config.timeout :
+                                                     LIBRARY_POLL_INTERVAL);
+            result = mq_timedsend(state->commandQueue, message, messageLength, priority, &deadline);
+        } while (result == -1 && (errno == EINTR || (errno == ETIMEDOUT && state->config.timeout == 0)));
+        return result == 0;
+    }
+
+    const uint32_t length = messageLength;
+    memcpy(message - GATEWAY_LENGTH_SIZE, &length, GATEWAY_LENGTH_SIZE);
+    size_t sent = 0;
+    while (sent < GATEWAY_LENGTH_SIZE + messageLength)
+    {
+        const ssize_t sentLength = send(state->descriptor, message - GATEWAY_LENGTH_SIZE + sent,
+                                        GATEWAY_LENGTH_SIZE + messageLength - sent, MSG_NOSIGNAL);
+        if (sentLength == -1 && errno != EINTR)
+        {
+            return false;
+        }
+        sent += (sentLength > 0) ? sentLength : 0;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * Pgm1Client::Pgm1Client(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Creates a client which is not connected (see connect()).
+ *******************************************************************************************************************************/
+Pgm1Client::Pgm1Client()
+    : state(new State())
+{
+    state->descriptor = -1;
+    state->commandQueue = -1;
+    state->replyQueue = -1;
+    state->replyQueueName[0] = '\0';
+    state->clientID = 0;
+    state->instance = -1;
+    state->messageSize = 0;
+    state->inputLength = 0;
+    state->nextRequestID = 0;
+    state->windowSize = 0;
+    state->receiving = false;
+    state->connected.store(false);
+}
+
+/********************************************************************************************************************************
+ * Pgm1Client::~Pgm1Client(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Closes the client (see close()), failing every request still in flight.
+ *******************************************************************************************************************************/
+Pgm1Client::~Pgm1Client()
+{
+    close();
+    delete state;
+}
+
+/********************************************************************************************************************************
+ * bool Pgm1Client::connect(const Pgm1ClientConfig& config)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Name the private reply queue after the instance of the client too, so a process can
+ *                              connect any number of clients through the command queue.
+ * 10/14/2026   Kerby Kaska     Reject a priority above QUEUE_PRIORITY_LIMIT, like the client does.
+ *
+ * Description: Connects the client to a server, and starts its receiver thread (see run_library_receiver()). Through the
+ *      command queue of the standalone server, the message size of the server is adopted, and a private reply queue
+ *      named after the process ID and the instance of the client (see claim_library_instance()) is created with its
+ *      depth, like pgm1 --client does (see open_reply_queue()). Through
+ *      a gateway, the connection is opened like the fan-out client does (see open_endpoint()). A client which is
+ *      connected is closed first. On error, the reason is kept for error() and false is returned.
+ *
+ * Parameters:
+ *      config     I/P    const Pgm1ClientConfig&    the configuration of the client
+ *      connect    O/P    bool                       true on success, false on error
+ *******************************************************************************************************************************/
+bool Pgm1Client::connect(const Pgm1ClientConfig& config)
+{
+    close();
+    pthread_once(&libraryOnce, build_compression_dictionary);
+    state->config = config;
+    state->error.clear();
+    state->inputLength = 0;
+
+    if (config.priority > QUEUE_PRIORITY_LIMIT)
+    {
+        state->error = "The priority must be between 0 and " + std::to_string(QUEUE_PRIORITY_LIMIT) + " (see " + 
+                       ENV_PRIORITY + ").";
+        return false;
+    }
+    if (config.endpoint != NULL)
+    {
+        if (config.messageSize < QUEUE_MIN_MESSAGE_SIZE || config.messageSize > QUEUE_MAX_MESSAGE_SIZE)
+        {
+            state->error = "The message size must be between " + std::to_string(QUEUE_MIN_MESSAGE_SIZE) + " and " +
+                           std::to_string(QUEUE_MAX_MESSAGE_SIZE) + " bytes.";
+            return false;
+        }
+        state->descriptor = open_endpoint(config.endpoint, false);
+        if (state->descriptor == -1)
+        {
+            state->error = std::string("Could not connect to ") + config.endpoint + ".";
+            return false;
+        }
+        state->messageSize = config.messageSize;
+        state->windowSize = QUEUE_MAX_MESSAGES; // NOTE: the depth of the server is not known through a gateway
+    }
+    else
+    {
+        state->instance = claim_library_instance();
+        if (state->instance == -1)
+        {
+            state->error = "Already " + std::to_string(LIBRARY_MAX_INSTANCES) + 
+                           " clients of this process are connected through the command queue.";
+            return false;
+        }
+        state->commandQueue = mq_open(COMMAND_QUEUE_NAME, O_WRONLY);
+        mq_attr serverAttributes;
+        if (state->commandQueue == -1 || mq_getattr(state->commandQueue, &serverAttributes) == -1)
+        {
+            state->error = (errno == ENOENT) ? MESSAGE_NO_SERVER : library_error("commandQueue::mq_open()");
+            close();
+            return false;
+        }
+        state->messageSize = serverAttributes.mq_msgsize;
+        state->windowSize = serverAttributes.mq_maxmsg;
+
+        // create the private reply queue (replacing one left behind by a crashed process with the same process ID)
+        state->clientID = static_cast<int32_t>(static_cast<uint32_t>(getpid()) | 
+                                               (static_cast<uint32_t>(state->instance) << LIBRARY_INSTANCE_SHIFT));
+        mq_attr queueAttributes;
+        memset(&queueAttributes, 0, sizeof(queueAttributes));
+        queueAttributes.mq_maxmsg = serverAttributes.mq_maxmsg;
+        queueAttributes.mq_msgsize = serverAttributes.mq_msgsize;
+        state->replyQueue = open_reply_queue(state->clientID, &queueAttributes, state->replyQueueName);
+        if (state->replyQueue == -1)
+        {
+            state->error = library_error("responseQueue::mq_open()");
+            state->replyQueueName[0] = '\0';
+            close();
+            return false;
+        }
+    }
+
+    const size_t bufferSize = (state->descriptor != -1) ? GATEWAY_LENGTH_SIZE + QUEUE_MAX_MESSAGE_SIZE : state->messageSize;
+    state->input.assign(bufferSize, 0);
+    state->expandBuffer.assign(QUEUE_MAX_MESSAGE_SIZE, 0);
+    state->textBuffer.assign(UNAME_TEXT_SIZE, 0);
+    state->connected.store(true, std::memory_order_release);
+    const int error = pthread_create(&state->receiver, NULL, run_library_receiver, state);
+    if (error != 0)
+    {
+        state->error = std::string("pthread_create(): ") + strerror(error);
+        state->connected.store(false);
+        close();
+        return false;
+    }
+    state->receiving = true;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * void Pgm1Client::close(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Disconnects the client from the server: stops the receiver thread, fails every request still in flight
+ *      as MESSAGE_NO_CONNECTION, and closes the connection (unlinking the private reply queue, and releasing the instance
+ *      named by it). Does nothing if the client is not connected.
+ *******************************************************************************************************************************/
+void Pgm1Client::close()
+{
+    std::lock_guard<std::mutex> guard(state->sendLock); // NOTE: no request is framed while the connection goes away
+    state->connected.store(false, std::memory_order_release);
+    if (state->descriptor != -1)
+    {
+        shutdown(state->descriptor, SHUT_RDWR); // NOTE: wakes the receiver thread right away
+    }
+    if (state->receiving)
+    {
+        pthread_join(state->receiver, NULL);
+        state->receiving = false;
+    }
+    fail_library_requests(state, MESSAGE_NO_CONNECTION);
+
+    if (state->descriptor != -1)
+    {
+        ::close(state->descriptor);
+        state->descriptor = -1;
+    }
+    if (state->replyQueue != -1)
+    {
+        mq_close(state->replyQueue);
+        state->replyQueue = -1;
+    }
+    if (state->replyQueueName[0] != '\0')
+    {
+        mq_unlink(state->replyQueueName);
+        state->replyQueueName[0] = '\0';
+    }
+    if (state->commandQueue != -1)
+    {
+        mq_close(state->commandQueue);
+        state->commandQueue = -1;
+    }
+    if (state->instance != -1)
+    {
+        release_library_instance(state->instance); // NOTE: the reply queue named after it is unlinked by now
+        state->instance = -1;
+    }
+    state->clientID = 0;
+    state->messageSize = 0;
+}
+
+/********************************************************************************************************************************
+ * std::vector<std::future<Pgm1Reply> > Pgm1Client::submit_batch(const std::vector<std::string>& commands)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Frame with frame_request(), flagged as the client is configured.
+ * 10/14/2026   Kerby Kaska     Look the commands up with find_command(), like pgm1 does.
+ * 10/14/2026   Kerby Kaska     Send above the configured priority instead of QUEUE_MESSAGE_PRIORITY.
+ *
+ * Description: Sends several commands to the server, and returns the future of the reply of each one, in the order of the
+ *      commands. The commands are framed back to back into as few messages as possible, like --batch does, and every
+ *      message is sent with the highest priority of its commands, its priority class above the configured priority (see
+ *      COMMAND_NAMES, the commands of plugins are sent as text, with the priority of PRIORITY_BULK). A command too large for a message on its own is
+ *      truncated to fit. At most windowSize requests are kept in flight, so a large batch returns once all but the last
+ *      windowSize of its commands have been answered. Should the client not be connected, or a message not be sent, the futures of the commands
+ *      concerned fail as MESSAGE_NO_CONNECTION (a message which could not be sent closes the connection).
+ *
+ * Parameters:
+ *      commands        I/P    const std::vector<std::string>&        the commands to send
+ *      submit_batch    O/P    std::vector<std::future<Pgm1Reply> >   the future of the reply of every command
+ *******************************************************************************************************************************/
+std::vector<std::future<Pgm1Reply> > Pgm1Client::submit_batch(const std::vector<std::string>& commands)
+{
+    std::vector<std::future<Pgm1Reply> > futures;
+    std::lock_guard<std::mutex> guard(state->sendLock);
+    const bool connected = state->connected.load(std::memory_order_acquire);
+    const size_t messageSize = state->messageSize;
+    const uint16_t flags = state->config.compress ? FRAME_ACCEPTS_COMPRESSED : 0;
+    std::vector<char> buffer(GATEWAY_LENGTH_SIZE + messageSize);
+    char* message = &buffer[GATEWAY_LENGTH_SIZE];
+    size_t messageLength = 0;
+    unsigned int priority = 0;
+    bool sent = true;
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        // wait for room in the window, sending what is framed so far so the requests in flight can be answered
+        if (connected)
+        {
+            std::unique_lock<std::mutex> pendingGuard(state->pendingLock);
+            if (state->pending.size() >= state->windowSize && messageLength > 0)
+            {
+                pendingGuard.unlock();
+                sent = send_library_message(state, message, messageLength, priority) && sent;
+                messageLength = 0;
+                priority = 0;
+                pendingGuard.lock();
+            }
+            while (sent && state->pending.size() >= state->windowSize &&
+                   state->connected.load(std::memory_order_acquire))
+            {
+                state->pendingDone.wait_for(pendingGuard, std::chrono::milliseconds(LIBRARY_POLL_INTERVAL));
+            }
+        }
+
+        // register the request before anything is sent, so its reply always finds it
+        const uint32_t requestID = state->nextRequestID++;
+        uint32_t expiry = 0;
+        if (state->config.timeout != 0)
+        {
+            expiry = monotonic_milliseconds() + state->config.timeout;
+            expiry = (expiry == 0) ? 1 : expiry;
+        }
+        {
+            std::lock_guard<std::mutex> pendingGuard(state->pendingLock);
+            LibraryRequest& request = state->pending[requestID];
+            request.reply.ok = false;
+            request.reply.requestID = requestID;
+            request.reply.opcode = OPCODE_TEXT;
+            request.sequence = 0;
+            request.expiry = expiry;
+            futures.push_back(request.promise.get_future());
+            if (!connected)
+            {
+                complete_library_request(state->pending.find(requestID), false, MESSAGE_NO_CONNECTION, state);
+                continue;
+            }
+        }
+
+        // frame the command behind the others, sending the message first if the command no longer fits in it
+        const uint32_t deadline = (state->descriptor == -1) ? expiry : 0; // NOTE: a gateway host has another clock
+        const uint16_t commandOpcode = find_command(commands[i].data(), commands[i].size());
+        uint16_t opcode = OPCODE_TEXT;
+        size_t frameLength = frame_request(commands[i].data(), commands[i].size(), commandOpcode, requestID, 
+            state->clientID, deadline, flags, message + messageLength, messageSize - messageLength, messageLength == 0,
+            &opcode);
+        if (frameLength == 0 && messageLength > 0)
+        {
+            sent = send_library_message(state, message, messageLength, priority) && sent;
+            messageLength = 0;
+            priority = 0;
+            frameLength = frame_request(commands[i].data(), commands[i].size(), commandOpcode, requestID, 
+                state->clientID, deadline, flags, message, messageSize, true, &opcode);
+        }
+        std::lock_guard<std::mutex> pendingGuard(state->pendingLock);
+        std::map<uint32_t, LibraryRequest>::iterator request = state->pending.find(requestID);
+        if (frameLength == 0)
+        {
+            if (request != state->pending.end())
+            {
+                complete_library_request(request, false, MESSAGE_UNFRAMED, state);
+            }
+            continue;
+        }
+
+        messageLength += frameLength;
+        priority = std::max(priority, state->config.priority + COMMAND_NAMES[opcode].priority);
+        if (request != state->pending.end())
+        {
+            request->second.reply.opcode = opcode;
+        }
+    }
+    if (messageLength > 0)
+    {
+        sent = send_library_message(state, message, messageLength, priority) && sent;
+    }
+    if (!sent || !state->connected.load(std::memory_order_acquire))
+    {
+        // NOTE: the connection is lost, so the receiver thread stops on its own and nothing in flight will be answered
+        state->connected.store(false, std::memory_order_release);
+        fail_library_requests(state, MESSAGE_NO_CONNECTION);
+    }
+    return futures;
+}
+
+/********************************************************************************************************************************
+ * std::vector<Pgm1Reply> Pgm1Client::call_batch(const std::vector<std::string>& commands)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Sends several commands to the server like submit_batch(), and waits for the reply of every one of them.
+ *
+ * Parameters:
+ *      commands      I/P    const std::vector<std::string>&    the commands to send
+ *      call_batch    O/P    std::vector<Pgm1Reply>             the reply of every command, in the order of the commands
+ *******************************************************************************************************************************/
+std::vector<Pgm1Reply> Pgm1Client::call_batch(const std::vector<std::string>& commands)
+{
+    std::vector<std::future<Pgm1Reply> > futures = submit_batch(commands);
+    std::vector<Pgm1Reply> replies;
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        replies.push_back(futures[i].get());
+    }
+    return replies;
+}
+
+/********************************************************************************************************************************
+ * std::future<Pgm1Reply> Pgm1Client::submit(const std::string& command)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Sends a command to the server in a message of its own, and returns the future of its reply right away.
+ *
+ * Parameters:
+ *      command    I/P    const std::string&        the command to send
+ *      submit     O/P    std::future<Pgm1Reply>    the future of the reply of the command
+ *******************************************************************************************************************************/
+std::future<Pgm1Reply> Pgm1Client::submit(const std::string& command)
+{
+    std::vector<std::future<Pgm1Reply> > futures = submit_batch(std::vector<std::string>(1, command));
+    return std::move(futures[0]);
+}
+
+/********************************************************************************************************************************
+ * Pgm1Reply Pgm1Client::call(const std::string& command)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Sends a command to the server, and waits for its reply (or its failure, see Pgm1Reply).
+ *
+ * Parameters:
+ *      command    I/P    const std::string&    the command to send
+ *      call       O/P    Pgm1Reply             the reply of the command
+ *******************************************************************************************************************************/
+Pgm1Reply Pgm1Client::call(const std::string& command)
+{
+    return submit(command).get();
+}
+
+/********************************************************************************************************************************
+ * const std::string& Pgm1Client::error(void) const
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: The reason the last connect() failed (empty once it succeeded).
+ *
+ * Parameters:
+ *      error    O/P    const std::string&    the reason the last connect() failed
+ *******************************************************************************************************************************/
+const std::string& Pgm1Client::error() const
+{
+    return state->error;
+}
@@ -8,111 +8,1212 @@
 * 1/23/2022    Kerby Kaska     Created close_queues() utility function to clean up queue resources and avoid code redundancy
 * 2/01/2022    Kerby Kaska     Added waitpid() to end of server loop to avoid child zombie process 
 * 2/05/2022    Kerby Kaska     Added kill_process() to kill opposing client/server process on error to avoid zombies
+* 10/14/2026   Kerby Kaska     Messages are now sent with only their used bytes and are no longer NUL-terminated
+* 10/14/2026   Kerby Kaska     Added the framed MessageHeader with a request ID, and the pipelined client mode (--pipeline)
+* 10/14/2026   Kerby Kaska     Added the supervised server worker pool (--workers) sharing the commandQueue
+* 10/14/2026   Kerby Kaska     Added the standalone server (--server) and client (--client) modes with per-client reply queues
+* 10/14/2026   Kerby Kaska     Replaced the strcmp() chain with the opcode-indexed COMMAND_TABLE and a compile-time perfect hash
+* 10/14/2026   Kerby Kaska     Cache the system information responses. Added the "refresh" command and SIGHUP to invalidate them
+* 10/14/2026   Kerby Kaska     Added the payload length to the MessageHeader, and batched command/reply messages (--batch)
+* 10/14/2026   Kerby Kaska     Added the Transport interface, and the shared memory ring transport (--transport shm)
+* 10/14/2026   Kerby Kaska     The queue depth, message size, and priority are configured at startup (arguments or environment)
+* 10/14/2026   Kerby Kaska     Added the benchmark mode (--bench) with a text, CSV, or JSON report
+* 10/14/2026   Kerby Kaska     The server workers run an epoll reactor, holding replies for full reply queues in per-client outboxes
+* 10/14/2026   Kerby Kaska     Commands are sent with the message priority of their priority class, and replies with that of their request
+* 10/14/2026   Kerby Kaska     Added the lock-free per-worker serverStats, the "stats" command, and the periodic statistics dump (--stats-file)
+* 10/14/2026   Kerby Kaska     Added the non-interactive client for piped input, which reads with read() and writes with writev()
+* 10/14/2026   Kerby Kaska     The system Unix name is sent as binary fields (rendered by the client), optionally only the fields named
+* 10/14/2026   Kerby Kaska     Added command plugins (--plugin, see plugin.h), registered in the dispatch table and the perfect hash at startup
+* 10/14/2026   Kerby Kaska     Blocking commands run on a per-worker AsyncExecutor, which hands their replies back to the reactor
+* 10/14/2026   Kerby Kaska     Added the persistent command queue (--persistent), and standalone clients reattach to a restarted server
+* 10/14/2026   Kerby Kaska     The server stops gracefully through signalfd, draining the queued commands and held replies first
+* 10/14/2026   Kerby Kaska     Requests carry a deadline (--deadline), every queue operation is timed, and the server sheds load (--shed-at)
+* 10/14/2026   Kerby Kaska     The client and server workers can be pinned to CPUs (--affinity), placed on the same core or NUMA node with auto
+* 10/14/2026   Kerby Kaska     Large replies are compressed against a static dictionary for clients which flag it (--compress)
+* 10/14/2026   Kerby Kaska     Results too large for a message are streamed in numbered chunks, which the clients print as they arrive
+* 10/14/2026   Kerby Kaska     The server buffers come from preallocated, cache-line-aligned arenas and pools, sized from the queue depth
+* 10/14/2026   Kerby Kaska     Memoize the responses of idempotent commands by opcode and arguments, in a sharded LRU cache
+* 10/14/2026   Kerby Kaska     Added the gateway of the standalone server (--listen) on a Unix or TCP socket, and the fan-out client (--hosts)
+* 10/14/2026   Kerby Kaska     Sampled requests carry per-stage timestamps, which the client dumps as a Chrome trace (--trace)
+* 10/14/2026   Kerby Kaska     The client records its commands to a log (--record), which the replay client replays as load (--replay)
+* 10/14/2026   Kerby Kaska     Added the Makefile (release, LTO, and PGO builds), and the entry point can be renamed with PGM1_MAIN
+* 10/14/2026   Kerby Kaska     Moved the protocol to protocol.cpp and the transports to transport.cpp, shared with libpgm1 and the benchmarks
+* 10/14/2026   Kerby Kaska     Moved the command handlers, COMMAND_TABLE, the plugins, and the caches to dispatch.cpp, shared the same way
+* 10/14/2026   Kerby Kaska     Moved parse_count() to protocol.cpp, so libpgm1 parses PGM1_PRIORITY like the client
 *
 * Procedures:
 * main                 - client/server program using message queues to prompt user for commands, receive their results, and print them to the console
 *
-* close_queues         - convenience method to close both message queue descriptors to avoid code redundancy
+* run_standalone_server - publishes the command queue and runs the server pool until it is signalled to stop
+*
+* run_standalone_client - attaches to a running standalone server and sends it commands through a private reply queue
+*
+* run_fanout_client    - sends every command to several gateways (ARG_HOSTS) at once, and prints the reply of each host
+*
+* receive_fanout_reply - receives from the connection of a fan-out host, and collects the reply to the current command
+*
+* receive_reply        - utility method to wait for a reply, reattaching a standalone client to the server once it takes too long
+*
+* reattach_server      - reopens the command queue of a restarted standalone server, with an exponential backoff while there is none
+*
+* run_supervisor       - forks the server worker pool and supervises it and the client, reaping every process on exit
+*
+* run_server           - server worker which sets up its buffers and runs its event loop (the reactor on the message queue transport)
+*
+* run_reactor          - server worker epoll event loop which drains the command queues and flushes the outboxes of full reply queues
+*
+* start_executor, stop_executor, close_executor, run_executor_thread
+*                      - AsyncExecutor, the threads of a server worker running its blocking commands off the reactor
+*
+* submit_job, complete_jobs
+*                      - queue a blocking command on the AsyncExecutor, and send the replies of its completed jobs
+*
+* serve_message        - executes every framed command of a received message and sends back their (batched) results
+*
+* drain_command_queue  - serves the messages waiting on a readable command queue without blocking
+*
+* accept_connections, read_connection, serve_connection, handle_connection_event
+*                      - accept the gateway connections, and serve the length-prefixed messages they send
+*
+* run_client           - interactive client event loop which sends one command at a time and prints its result
+*
+* run_pipelined_client - pipelined client event loop which keeps up to the queue depth of commands outstanding at once
+*
+* run_bench_client     - benchmark client which measures the throughput and round trip latency of every command
+*
+* run_bench_round      - benchmarks the round trip of a single command with a window of outstanding requests
+*
+* run_replay_client    - replays a recorded command log from several generator processes, and reports it like the benchmark
+*
+* run_replay_generator - generator process replaying its share of the recorded commands at the recorded pace (or faster)
+*
+* map_record_file, next_record_entry
+*                      - map a recorded command log (ARG_REPLAY) into memory, and step through its commands
+*
+* open_record_file, record_command, flush_record_file, close_record_file
+*                      - log the commands read by the client, and when they were read, to ARG_RECORD
+*
+* create_reply_queue   - utility method to create the private reply queue of a standalone client (or replay generator)
+*
+* print_server_stats   - utility method to request the statistics report of the server pool and print it to the console
+*
+* print_bench_report   - prints the benchmark results as a table, CSV, or JSON
+*
+* run_client_loop      - runs the client event loop selected by the program options (the non-interactive client for piped input)
+*
+* read_line            - utility method to read a line of input in place from the chunks buffered by an InputReader
+*
+* write_output, flush_output, write_vectors
+*                      - utility methods to gather replies in the buffer of an OutputWriter and writev() them out in large chunks
+*
+* command_priority     - utility method to look up the message priority of a command from its priority class in COMMAND_TABLE
+*
+* parse_arguments      - parses the command line arguments into the program options
+*
+* parse_option         - utility method to parse a bounded count option, printing an error message if it is invalid
+*
+* check_queue_limits   - checks the queue configuration against the message queue limits of the system
+*
+* parse_cpu_list       - utility method to parse a list of CPUs such as "0,2-3" (ARG_AFFINITY, and the lists of sysfs)
+*
+* plan_placement, read_cpu_list, add_placement_cpu
+*                      - plan the CPUs of ARG_AFFINITY, finding the CPUs next to the current one in the topology for AFFINITY_AUTO
+*
+* place_process        - utility method to pin the calling process to its CPU of the placement
+*
+* set_bench_placement  - pins (or unpins) the benchmark client and the server pool between two passes of the benchmark
+*
+* read_system_limit    - utility method to read a message queue limit of the system from /proc/sys/fs/mqueue
+*
+* open_stats           - maps the serverStats of the server pool into shared memory before the workers are forked
+*
+* write_stats_file     - dumps the statistics report to ARG_STATS_FILE, replacing the previous report atomically
 *
 * kill_process         - utility method to send a SIGKILL to the provided process ID and wait for it to exit
 *
-* signal_handler       - signal handler for SIGINT, SIGKILL, SIGSTOP, and SIGTERM to ensure proper cleanup of resources used
+* kill_pool            - utility method to send a SIGKILL to every process of the server pool and wait for them all to exit
+*
+* request_deadline     - utility method to set the deadline of a request from ARG_DEADLINE
+*
+* percentile           - utility method to look up a percentile of sorted latencies
+*
+* record_trace         - utility method to strip the TraceStamps off a traced reply frame into the traceRing of the client
+*
+* write_trace_file, append_trace_event
+*                      - dump the traceRing to ARG_TRACE in the Chrome trace event format (which Perfetto opens too)
+*
+* get_reply_entry      - utility method to look up (or open and cache) the private reply queue of a standalone client
+*
+* release_reply_queue  - utility method to close and forget the cached private reply queue of a standalone client
+*
+* map_arena, unmap_arena
+*                      - utility methods to preallocate the page-aligned memory every buffer of a server worker is carved from
+*
+* open_pool, close_pool, acquire_buffer, release_buffer
+*                      - utility methods of a BufferPool, a fixed set of cache-line-aligned buffers handed out and back
+*
+* push_slot, pop_slot  - utility methods of a SlotQueue, the fixed FIFO of job slots of the AsyncExecutor
+*
+* close_reply_entry    - utility method to close a cached reply queue, dropping any replies still in its outbox
+*
+* clear_outbox         - utility method to drop every reply held in the outbox of a cached reply queue
+*
+* hold_reply, flush_reply_entry
+*                      - utility methods to hold replies for a full reply queue in its outbox, and send them once it has room
+*
+* receive_now          - utility method to receive a message from a queue without blocking
+*
+* frame_command        - utility method to frame a line of user input as a command message (see frame_request)
+*
+* send_command         - utility method to send a (batched) command message to the server on the commandQueue
+*
+* send_reply           - utility method to send a (batched) reply message on the reply queue of the client that sent it
+*
+* sample_queue_depth   - utility method to sample the number of messages waiting on the command channel
+*
+* compress_reply       - utility method to compress the result of a reply frame in place, for a client which accepts it
+*
+* stream_reply         - sends a result too large for a message to the client in chunks of a message each
+*
+* command_queue_depth  - utility method to read the number of messages waiting on the command channel
+*
+* signal_handler       - async-signal-safe handler for SIGINT and SIGTERM in the client processes to ensure proper cleanup of resources used
+*
+* hangup_handler       - signal handler for SIGHUP which invalidates the responseCache of a server worker
+*
+* affinity_handler     - signal handler which pins (or unpins) a server worker for the benchmark (see set_bench_placement)
+*
+* stop_signals         - utility method to fill a signal set with the signals which stop the server gracefully (SIGINT and SIGTERM)
+*
+* has_held_replies     - utility method to check whether a server worker holds any reply in the outbox of a client
+*
+* find_connection, connection_client_id
+*                      - utility methods to map the client ID of a gateway request to its connection, and back
+*
+* update_connection_events, flush_connection, close_connection, end_connection_session
+*                      - utility methods to watch, flush, and close a gateway connection
+*
+* send_gateway_reply   - utility method to send a (batched) reply to a gateway connection, behind the output it has pending
+*
+* has_gateway_output, close_gateway
+*                      - utility methods to check whether any gateway connection has output pending, and to close them all
 ****************************************************************************************************************************************************/
 
 #include <iostream>
 #include <mqueue.h>
 #include <unistd.h>
 #include <errno.h>
-#include <sys/utsname.h>
 #include <signal.h>
 #include <cstring>
+#include <cstdlib>
 #include <sys/wait.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <time.h>
+#include <atomic>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <mutex>
+#include <condition_variable>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/signalfd.h>
+#include <sys/prctl.h>
+#include <poll.h>
+#include <sched.h>
+#include <cstddef>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include "protocol.h"
+#include "transport.h"
+#include "dispatch.h"
 
 /********************************************************************************************************************************
- * Queue Descriptors:
- * commandQueue         mqd_t                message queue descriptor used to identify the server input message queue
- * responseQueue        mqd_t                message queue descriptor used to identify the server output message queue
+ * Queue Constants:
+ * REPLY_QUEUE_CACHE_SIZE   const unsigned int    number of standalone client reply queues each server worker keeps open
+ * REPLY_OUTBOX_LIMIT       const unsigned int    number of replies held for a standalone client whose reply queue is full
+ * REPLY_POOL_DEPTHS        const unsigned int    number of full queues of replies the held reply buffers of each server
+ *                                                worker are preallocated for (see ReplyQueueCache)
+ * REACTOR_MAX_EVENTS       const int             number of epoll events the reactor handles per epoll_wait()
+ * REACTOR_DRAIN_LIMIT      const unsigned int    number of messages the reactor serves from a command queue before moving on
+ * REACTOR_REPLY_TAG        const uint32_t        epoll event data bit marking reply queue events (the rest is the cache entry)
+ * REACTOR_EXECUTOR_TAG     const uint32_t        epoll event data marking the completions of the AsyncExecutor
+ * REACTOR_SIGNAL_TAG       const uint32_t        epoll event data marking the signalfd of the stop signals (see stop_signals())
+ * REACTOR_GATEWAY_TAG      const uint32_t        epoll event data marking the listening socket of the gateway (ARG_LISTEN)
+ * REACTOR_CONNECTION_TAG   const uint32_t        epoll event data bit marking gateway connection events (the rest is the slot)
+ * EXECUTOR_THREADS         const unsigned int    number of threads each server worker runs blocking commands on
+ * EXECUTOR_QUEUE_LIMIT     const unsigned int    number of blocking commands a server worker has queued or running at once
+ * QUEUE_DEPTH_LIMIT        const unsigned int    largest queue depth accepted at startup (the hard limit of Linux)
+ * MSG_MAX_PATH             const char*           file holding the largest queue depth the system allows
+ * MSGSIZE_MAX_PATH         const char*           file holding the largest message size the system allows
  *******************************************************************************************************************************/
-static mqd_t commandQueue;
-static mqd_t responseQueue;
+static const unsigned int REPLY_QUEUE_CACHE_SIZE = 16;
+static const unsigned int REPLY_OUTBOX_LIMIT    = 64;
+static const unsigned int REPLY_POOL_DEPTHS     = 4;
+static const int REACTOR_MAX_EVENTS             = 32;
+static const unsigned int REACTOR_DRAIN_LIMIT   = 64;
+static const uint32_t REACTOR_REPLY_TAG         = 0x80000000u;
+static const uint32_t REACTOR_EXECUTOR_TAG      = 0x40000000u;
+static const uint32_t REACTOR_SIGNAL_TAG        = 0x20000000u;
+static const uint32_t REACTOR_GATEWAY_TAG       = 0x10000000u;
+static const uint32_t REACTOR_CONNECTION_TAG    = 0x08000000u;
+static const unsigned int EXECUTOR_THREADS      = 2;
+static const unsigned int EXECUTOR_QUEUE_LIMIT  = 64;
+static const unsigned int QUEUE_DEPTH_LIMIT     = 65536;
+static const char* MSG_MAX_PATH                 = "/proc/sys/fs/mqueue/msg_max";
+static const char* MSGSIZE_MAX_PATH             = "/proc/sys/fs/mqueue/msgsize_max";
 
 /********************************************************************************************************************************
- * Queue Constants:
- * COMMAND_QUEUE_NAME       const char*           name of the message queue handled by commandQueue
- * RESPONSE_QUEUE_NAME      const char*           name of the message queue handled by responseQueue
- * QUEUE_MAX_MESSAGES       const unsigned int    maximum number of messages in the queue before blocking new messages
- * QUEUE_MESSAGE_SIZE       const unsigned int    number of bytes indicating the size of an individual queue message
- * QUEUE_PERMISSIONS        const int             octal Unix read/write/execute file permissions granted to the queue on creation
- * QUEUE_MESSAGE_PRIORITY   const int             message priority of all messages sent through the message queue
- *******************************************************************************************************************************/
-static const char* COMMAND_QUEUE_NAME           = "/pgm1_mq_command";
-static const char* RESPONSE_QUEUE_NAME          = "/pgm1_mq_response";
-static const unsigned int QUEUE_MAX_MESSAGES    = 10;
-static const unsigned int QUEUE_MESSAGE_SIZE    = 1024;
-static const int QUEUE_PERMISSIONS              = 0777; // read/write/execute for everyone
-static const int QUEUE_MESSAGE_PRIORITY         = 15;
-
-/********************************************************************************************************************************
- * Command Constants:
- * CMD_GET_DOMAIN_NAME      const char*           command string to be entered by the user for getting the system domain name
- * CMD_GET_HOST_NAME        const char*           command string to be entered by the user for getting the system host name
- * CMD_GET_UNAME            const char*           command string to be entered by the user for getting the system Unix name
- * CMD_GET_HELP             const char*           command string to be entered by the user for getting a useful help message
- * CMD_EXIT                 const char*           command string to be entered by the user for exiting the program
- *******************************************************************************************************************************/
-static const char* CMD_GET_DOMAIN_NAME  = "getdomainname";
-static const char* CMD_GET_HOST_NAME    = "gethostname";
-static const char* CMD_GET_UNAME        = "uname";
-static const char* CMD_GET_HELP         = "help";
-static const char* CMD_EXIT             = "exit";
+ * Statistics Constants:
+ * STATS_DEPTH_INTERVAL     const uint64_t        1 in this many messages samples the depth of the command queue (a power of two)
+ * STATS_DUMP_INTERVAL      const unsigned int    default number of seconds between two dumps of ARG_STATS_FILE
+ * MAX_STATS_INTERVAL       const unsigned int    largest number of seconds accepted for ARG_STATS_INTERVAL
+ * STATS_REPORT_SIZE        const unsigned int    number of bytes reserved for the statistics report written to ARG_STATS_FILE
+ * STATS_FILE_SUFFIX        const char*           suffix of the file the report is written to before it replaces ARG_STATS_FILE
+ *******************************************************************************************************************************/
+static const uint64_t STATS_DEPTH_INTERVAL          = 1024;
+static const unsigned int STATS_DUMP_INTERVAL       = 10;
+static const unsigned int MAX_STATS_INTERVAL        = 86400;
+static const unsigned int STATS_REPORT_SIZE         = 4096;
+static const char* STATS_FILE_SUFFIX                = ".tmp";
+static_assert((STATS_DEPTH_INTERVAL & (STATS_DEPTH_INTERVAL - 1)) == 0, "STATS_DEPTH_INTERVAL must be a power of two");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the shared statistics need lock-free (address-free) atomics");
 
 /********************************************************************************************************************************
  * Message Constants:
  * MESSAGE_PROMPT           const char*           console message printed to the user when prompted to enter a command
- * MESSAGE_HELP             const char*           message returned to the user as a result of the CMD_GET_HELP command
- * MESSAGE_EXIT             const char*           message returned to the user as a result of the CMD_EXIT command
- * MESSAGE_BAD_COMMAND      const char*           message format used to format the message returned for an unknown command
- * MESSAGE_UNAME            const char*           message format used to format the message returned for CMD_GET_UNAME
+ * MESSAGE_USAGE            const char*           console message printed to the user when an unknown argument is provided
+ * MESSAGE_RECONNECTING     const char*           console message printed when a standalone client lost its server
+ * MESSAGE_RECONNECTED      const char*           console message printed when a standalone client attached to a restarted server
+ * MESSAGE_RESUMING         const char*           console message printed when a standalone server finds messages left queued
+ * MESSAGE_STOPPING         const char*           console message printed when a standalone server is signalled to stop
  *******************************************************************************************************************************/
 static const char* MESSAGE_PROMPT       = "Enter a command: ";
-static const char* MESSAGE_HELP         = "Available Commands:\n"
-                                          " > getdomainname - get the system domain name and print it to the console\n"
-                                          " > gethostname - get the system host name and print it to the console\n"
-                                          " > uname - get the system Unix name and print it to the console\n"
-                                          " > help - gets this help message and prints it to the console\n"
-                                          " > exit - exit the application";
-static const char* MESSAGE_EXIT         = "Goodbye!";
-static const char* MESSAGE_BAD_COMMAND  = "Unknown command: \"%s\"";
-static const char* MESSAGE_UNAME        = " System: %s\n"
-                                          "   Node: %s\n"
-                                          "Release: %s\n"
-                                          "Version: %s\n"
-                                          "Machine: %s\n"
-                                          " Domain: %s";
+static const char* MESSAGE_USAGE        = "Usage: pgm1 [--server | --client] [--pipeline | --batch] [--workers count] [--transport name]\n"
+                                          "            [--depth count] [--message-size bytes] [--priority number]\n"
+                                          "            [--bench count [--concurrency count] [--payload bytes] [--format name]]\n"
+                                          "            [--stats-file path [--stats-interval seconds]] [--plugin path]... [--persistent]\n"
+                                          "            [--deadline milliseconds] [--shed-at count] [--affinity cpus|auto] [--compress]\n"
+                                          "            [--listen endpoint] [--hosts endpoint,...] [--trace path [--trace-rate count]]\n"
+                                          "            [--record path | --replay path [--speed factor|max] [--generators count]]\n"
+                                          " --server - run only the server, which serves any number of --client processes until stopped\n"
+                                          " --client - run only the client, which sends its commands to a running --server process\n"
+                                          " --pipeline - keep several commands in flight at once (for scripted input piped into stdin)\n"
+                                          " --batch - like --pipeline, and pack the commands already read from stdin into one message\n"
+                                          " --workers count - number of server worker processes receiving commands (default 1)\n"
+                                          " --transport mqueue|shm - exchange messages through message queues (default) or shared memory\n"
+                                          " --depth count - number of messages each queue holds (default 10, or $PGM1_QUEUE_DEPTH)\n"
+                                          " --message-size bytes - size of the largest message (default 1024, or $PGM1_MESSAGE_SIZE)\n"
+                                          " --priority number - priority of bulk messages, others are sent above it (default 15, or $PGM1_PRIORITY)\n"
+                                          " --bench count - benchmark every command with count requests instead of reading commands\n"
+                                          " --concurrency count - number of benchmark requests in flight at once (default 1)\n"
+                                          " --payload bytes - size of the benchmarked text command (default 16)\n"
+                                          " --format text|csv|json - format of the benchmark report (default text)\n"
+                                          " --stats-file path - dump the server statistics (see the stats command) to path periodically\n"
+                                          " --stats-interval seconds - number of seconds between two dumps of --stats-file (default 10)\n"
+                                          " --plugin path - load the commands of a plugin shared object (see plugin.h), may be repeated\n"
+                                          " --persistent - keep the --server command queue (and the commands left on it) across restarts\n"
+                                          " --deadline milliseconds - give up on (and have the server drop) requests not answered in time\n"
+                                          " --shed-at count - answer \"busy\" while count messages are waiting on the command queue\n"
+                                          " --affinity cpus|auto - pin the client and workers to a list of CPUs (0,2-3), or to the current core/NUMA node\n"
+                                          " --compress - have the server compress the large replies to this client, so more of them fit in a message\n"
+                                          " --listen unix:path|tcp:[host:]port - have the --server also serve the clients connecting to the socket\n"
+                                          " --hosts endpoint,... - send every command to each --listen endpoint at once, and print every reply\n"
+                                          " --trace path - time the stages of sampled requests, and dump them to path as a Chrome (Perfetto) trace\n"
+                                          " --trace-rate count - trace 1 in count requests (default 64)\n"
+                                          " --record path - log the commands of the client, and when each one was read, to path\n"
+                                          " --replay path - replay the commands logged by --record as load, and report them like --bench\n"
+                                          " --speed factor|max - replay factor times as fast as recorded (default 1), or as fast as possible\n"
+                                          " --generators count - number of processes replaying the commands between them (default 1)";
+static const char* MESSAGE_RECONNECTING = "Lost the server, waiting for it to restart...";
+static const char* MESSAGE_RECONNECTED  = "Reconnected to the restarted server, resending the outstanding commands.";
+static const char* MESSAGE_RESUMING     = "Resuming %ld message(s) left on the command queue.";
+static const char* MESSAGE_STOPPING     = "Stopping, the commands already queued are served first (signal again to stop now).";
 
 /********************************************************************************************************************************
- * static int close_queues(void)
- * Author: Kerby Kaska
- * Date: 1/23/2022
- * Modification History:
- * 1/23/2022    Kerby Kaska     Created.
+ * Argument Constants:
+ * ARG_SERVER               const char*           command line argument which runs only the standalone server
+ * ARG_CLIENT               const char*           command line argument which runs only the standalone client
+ * ARG_PIPELINED            const char*           command line argument which runs the client in pipelined mode
+ * ARG_BATCHED              const char*           command line argument which runs the client in batched (pipelined) mode
+ * ARG_WORKERS              const char*           command line argument followed by the number of server worker processes
+ * ARG_TRANSPORT            const char*           command line argument followed by the name of the transport (see TRANSPORTS)
+ * ARG_QUEUE_DEPTH          const char*           command line argument followed by the queue depth (QueueConfig::maxMessages)
+ * ARG_MESSAGE_SIZE         const char*           command line argument followed by the message size (QueueConfig::messageSize)
+ * ARG_PRIORITY             const char*           command line argument followed by the message priority
+ * ENV_QUEUE_DEPTH          const char*           environment variable providing the default for ARG_QUEUE_DEPTH
+ * ENV_MESSAGE_SIZE         const char*           environment variable providing the default for ARG_MESSAGE_SIZE
+ * ARG_BENCH                const char*           command line argument followed by the number of requests to benchmark
+ * ARG_CONCURRENCY          const char*           command line argument followed by the number of outstanding bench requests
+ * ARG_PAYLOAD              const char*           command line argument followed by the bench text command payload size
+ * ARG_FORMAT               const char*           command line argument followed by the bench report format (text, csv, json)
+ * ARG_STATS_FILE           const char*           command line argument followed by the file the server statistics are dumped to
+ * ARG_STATS_INTERVAL       const char*           command line argument followed by the number of seconds between two dumps
+ * ARG_PLUGIN               const char*           command line argument followed by the path of a plugin to load (repeatable)
+ * ARG_PERSISTENT           const char*           command line argument which keeps the standalone server's command queue on exit
+ * ARG_DEADLINE             const char*           command line argument followed by the milliseconds the client gives a request
+ * ARG_SHED_AT              const char*           command line argument followed by the command queue depth to shed requests at
+ * ARG_AFFINITY             const char*           command line argument followed by the CPUs to pin the processes to (or auto)
+ * ARG_COMPRESS             const char*           command line argument which has the server compress the replies to the client
+ * ARG_LISTEN               const char*           command line argument followed by the endpoint the standalone server's gateway
+ *                                                listens on (unix:path or tcp:[host:]port)
+ * ARG_HOSTS                const char*           command line argument followed by the comma-separated endpoints the fan-out
+ *                                                client sends every command to
+ * ARG_TRACE                const char*           command line argument followed by the file the client dumps its traces to
+ * ARG_TRACE_RATE           const char*           command line argument followed by the number of requests per traced request
+ * ARG_RECORD               const char*           command line argument followed by the file the client logs its commands to
+ * ARG_REPLAY               const char*           command line argument followed by the recorded command log to replay
+ * ARG_SPEED                const char*           command line argument followed by the pace of the replay (a factor, or max)
+ * ARG_GENERATORS           const char*           command line argument followed by the number of replay generator processes
+ * MAX_DEADLINE             const unsigned int    largest number of milliseconds accepted for ARG_DEADLINE
+ * MAX_WORKERS              const unsigned int    largest number of server worker processes accepted for ARG_WORKERS
+ *******************************************************************************************************************************/
+static const char* ARG_SERVER           = "--server";
+static const char* ARG_CLIENT           = "--client";
+static const char* ARG_PIPELINED        = "--pipeline";
+static const char* ARG_BATCHED          = "--batch";
+static const char* ARG_WORKERS          = "--workers";
+static const char* ARG_TRANSPORT        = "--transport";
+static const char* ARG_QUEUE_DEPTH      = "--depth";
+static const char* ARG_MESSAGE_SIZE     = "--message-size";
+static const char* ARG_PRIORITY         = "--priority";
+static const char* ENV_QUEUE_DEPTH      = "PGM1_QUEUE_DEPTH";
+static const char* ENV_MESSAGE_SIZE     = "PGM1_MESSAGE_SIZE";
+static const char* ARG_BENCH            = "--bench";
+static const char* ARG_CONCURRENCY      = "--concurrency";
+static const char* ARG_PAYLOAD          = "--payload";
+static const char* ARG_FORMAT           = "--format";
+static const char* ARG_STATS_FILE       = "--stats-file";
+static const char* ARG_STATS_INTERVAL   = "--stats-interval";
+static const char* ARG_PLUGIN           = "--plugin";
+static const char* ARG_PERSISTENT       = "--persistent";
+static const char* ARG_DEADLINE         = "--deadline";
+static const char* ARG_SHED_AT          = "--shed-at";
+static const char* ARG_AFFINITY         = "--affinity";
+static const char* ARG_COMPRESS         = "--compress";
+static const char* ARG_LISTEN           = "--listen";
+static const char* ARG_HOSTS            = "--hosts";
+static const char* ARG_TRACE            = "--trace";
+static const char* ARG_TRACE_RATE       = "--trace-rate";
+static const char* ARG_RECORD           = "--record";
+static const char* ARG_REPLAY           = "--replay";
+static const char* ARG_SPEED            = "--speed";
+static const char* ARG_GENERATORS       = "--generators";
+static const unsigned int MAX_DEADLINE  = 3600000;
+static const unsigned int MAX_WORKERS   = 64;
+
+/********************************************************************************************************************************
+ * Benchmark Constants:
+ * BENCH_COMMANDS           const char*[]         commands benchmarked by ARG_BENCH (followed by the text command payload)
+ * BENCH_COMMAND_COUNT      const unsigned int    number of commands in BENCH_COMMANDS
+ * BENCH_TEXT_NAME          const char*           name the text command payload is reported as
+ * BENCH_PAYLOAD_FILL       const char            byte the text command payload is filled with
+ * BENCH_MIXED_PREFIX       const char*           prefix of the command names reported by the mixed round
+ * BENCH_FORMAT_NAMES       const char*[]         names of the report formats accepted by ARG_FORMAT, by BenchFormat
+ * MAX_BENCH_REQUESTS       const unsigned int    largest number of requests accepted for ARG_BENCH
+ *******************************************************************************************************************************/
+static const char* const BENCH_COMMANDS[]       = { CMD_GET_DOMAIN_NAME, CMD_GET_HOST_NAME, CMD_GET_UNAME, "uname machine", 
+                                                    CMD_GET_HELP };
+static const unsigned int BENCH_COMMAND_COUNT   = sizeof(BENCH_COMMANDS) / sizeof(BENCH_COMMANDS[0]);
+static const char* BENCH_TEXT_NAME              = "text";
+static const char BENCH_PAYLOAD_FILL            = 'x';
+static const char* BENCH_MIXED_PREFIX           = "mixed:";
+static const char* BENCH_FORMAT_NAMES[]         = { "text", "csv", "json" };
+static const unsigned int MAX_BENCH_REQUESTS    = 100000000;
+
+/********************************************************************************************************************************
+ * Stream Constants:
+ * STREAM_INPUT_SIZE        const size_t          bytes of stdin read at once by the non-interactive client (see InputReader)
+ * STREAM_OUTPUT_SIZE       const size_t          bytes of replies buffered before the non-interactive client writes them out
+ * STREAM_RESULT_SIZE       const size_t          largest result of a command (when larger than a message), streamed to the client
+ *                                                in chunks of a message each (see stream_reply())
+ *******************************************************************************************************************************/
+static const size_t STREAM_INPUT_SIZE   = 64 * 1024;
+static const size_t STREAM_OUTPUT_SIZE  = 64 * 1024;
+static const size_t STREAM_RESULT_SIZE  = 64 * 1024;
+
+/********************************************************************************************************************************
+ * Reconnect Constants:
+ * RECONNECT_REPLY_TIMEOUT  const unsigned int    milliseconds a standalone client waits for a reply before checking on the server
+ * RECONNECT_BACKOFF        const unsigned int    milliseconds a standalone client first waits for a lost server to reappear
+ * RECONNECT_BACKOFF_LIMIT  const unsigned int    largest number of milliseconds between two checks (both waits double each time)
+ * RECONNECT_ATTEMPTS       const unsigned int    number of times a standalone client checks for a lost server before giving up
+ *******************************************************************************************************************************/
+static const unsigned int RECONNECT_REPLY_TIMEOUT   = 1000;
+static const unsigned int RECONNECT_BACKOFF         = 50;
+static const unsigned int RECONNECT_BACKOFF_LIMIT   = 4000;
+static const unsigned int RECONNECT_ATTEMPTS        = 12;
+
+/********************************************************************************************************************************
+ * Gateway Constants:
+ * GATEWAY_CONNECTIONS      const unsigned int    number of gateway connections each server worker serves at once
+ * GATEWAY_GENERATIONS      const uint32_t        number of generations the client ID of a connection slot counts through (see
+ *                                                connection_client_id())
+ * MAX_FANOUT_HOSTS         const unsigned int    largest number of endpoints accepted for ARG_HOSTS
+ * FANOUT_REPLY_TIMEOUT     const unsigned int    milliseconds the fan-out client waits for the replies of every host, unless
+ *                                                ARG_DEADLINE gives the requests a deadline of their own
+ *******************************************************************************************************************************/
+static const unsigned int GATEWAY_CONNECTIONS       = 16;
+static const uint32_t GATEWAY_GENERATIONS           = 1u << 20;
+static const unsigned int MAX_FANOUT_HOSTS          = 32;
+static const unsigned int FANOUT_REPLY_TIMEOUT      = 5000;
+
+/********************************************************************************************************************************
+ * Shutdown Constants:
+ * SHUTDOWN_DEADLINE        const unsigned int    seconds the server pool has to drain once it is signalled to stop, before it is
+ *                                                killed
+ *******************************************************************************************************************************/
+static const unsigned int SHUTDOWN_DEADLINE         = 5;
+
+/********************************************************************************************************************************
+ * Deadline Constants:
+ * REPLY_SEND_TIMEOUT       const int             milliseconds a server worker waits for room on the response channel of the 
+ *                                                forked client before it drops the reply
+ *******************************************************************************************************************************/
+static const int REPLY_SEND_TIMEOUT                 = 1000;
+
+/********************************************************************************************************************************
+ * Affinity Constants:
+ * AFFINITY_AUTO            const char*           value of ARG_AFFINITY which places the processes next to the current CPU
+ * AFFINITY_PIN_SIGNAL      const int             signal which pins a server worker to its CPU (and acknowledges the benchmark
+ *                                                client once the whole pool is pinned)
+ * AFFINITY_UNPIN_SIGNAL    const int             signal which unpins a server worker, back to the CPUs it was started with
+ * AFFINITY_ACK_TIMEOUT     const int             milliseconds the benchmark client waits for the pool to be (un)pinned
+ * CPU_SIBLINGS_FORMAT      const char*           format of the sysfs file listing the hardware threads of the core of a CPU
+ * NUMA_NODES_PATH          const char*           sysfs file listing the online NUMA nodes
+ * NUMA_NODE_CPUS_FORMAT    const char*           format of the sysfs file listing the CPUs of a NUMA node
+ * CPU_LIST_SIZE            const size_t          size of the buffer a sysfs list of CPUs is read into
+ * BENCH_PLACEMENT_NAMES    const char*[]         placements the benchmark reports its results with (by pass, see
+ *                                                run_bench_client())
+ *******************************************************************************************************************************/
+static const char* AFFINITY_AUTO                    = "auto";
+static const int AFFINITY_PIN_SIGNAL                = SIGUSR1;
+static const int AFFINITY_UNPIN_SIGNAL              = SIGUSR2;
+static const int AFFINITY_ACK_TIMEOUT               = 1000;
+static const char* CPU_SIBLINGS_FORMAT              = "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list";
+static const char* NUMA_NODES_PATH                  = "/sys/devices/system/node/online";
+static const char* NUMA_NODE_CPUS_FORMAT            = "/sys/devices/system/node/node%d/cpulist";
+static const size_t CPU_LIST_SIZE                   = 4096;
+static const char* BENCH_PLACEMENT_NAMES[]          = { "none", "unpinned", "pinned" };
+
+/********************************************************************************************************************************
+ * Trace Constants:
+ * TRACE_SAMPLE_INTERVAL    const unsigned int    default number of requests per traced request (ARG_TRACE_RATE)
+ * MAX_TRACE_INTERVAL       const unsigned int    largest number of requests per traced request accepted for ARG_TRACE_RATE
+ * TRACE_RING_SIZE          const unsigned int    number of completed traces the traceRing keeps (the oldest are overwritten)
+ * TRACE_STAGE_NAMES        const char*[]         names of the stages between two consecutive TraceStamps, in order
+ * TRACE_EVENT_SIZE         const size_t          size of the buffer each event of the trace file is formatted into
+ * TRACE_CATEGORY           const char*           category of every event of the trace file
+ *******************************************************************************************************************************/
+static const unsigned int TRACE_SAMPLE_INTERVAL     = 64;
+static const unsigned int MAX_TRACE_INTERVAL        = 1000000;
+static const unsigned int TRACE_RING_SIZE           = 4096;
+static const char* TRACE_STAGE_NAMES[]              = { "command queue", "dispatch", "handler", "reply queue" };
+static const size_t TRACE_EVENT_SIZE                = 256;
+static const char* TRACE_CATEGORY                   = "pgm1";
+
+/********************************************************************************************************************************
+ * Record Constants:
+ * RECORD_MAGIC             const char*           first RECORD_MAGIC_SIZE bytes of every recorded command log (ARG_RECORD)
+ * RECORD_MAGIC_SIZE        const size_t          number of bytes of RECORD_MAGIC in the file
+ * RECORD_BUFFER_SIZE       const size_t          size of the buffer the recorded commands are gathered in before writing them
+ * REPLAY_SPEED_MAX         const char*           value of ARG_SPEED which replays the commands as fast as possible
+ * MAX_REPLAY_SPEED         const unsigned int    largest factor accepted for ARG_SPEED
+ * MAX_GENERATORS           const unsigned int    largest number of replay generator processes accepted for ARG_GENERATORS
+ *******************************************************************************************************************************/
+static const char* RECORD_MAGIC                     = "pgm1rec1";
+static const size_t RECORD_MAGIC_SIZE               = 8;
+static const size_t RECORD_BUFFER_SIZE              = 128 * 1024;
+static const char* REPLAY_SPEED_MAX                 = "max";
+static const unsigned int MAX_REPLAY_SPEED          = 1000;
+static const unsigned int MAX_GENERATORS            = 32;
+
+/********************************************************************************************************************************
+ * Process State:
+ * poolProcessIDs       pid_t[]              process IDs of the server workers forked by this (supervisor) process
+ * poolSize             unsigned int         number of process IDs in poolProcessIDs
+ *
+ * NOTE: these are global so that signal_handler() can clean them up
+ *******************************************************************************************************************************/
+static pid_t poolProcessIDs[MAX_WORKERS];
+static unsigned int poolSize = 0;
+
+/********************************************************************************************************************************
+ * Reconnect State:
+ * clientReconnects     bool                 true in a standalone client, which reattaches to a restarted server
+ * replyTimeout         unsigned int         milliseconds the client waits for its next reply (see RECONNECT_REPLY_TIMEOUT)
+ *******************************************************************************************************************************/
+static bool clientReconnects = false;
+static unsigned int replyTimeout = RECONNECT_REPLY_TIMEOUT;
+
+/********************************************************************************************************************************
+ * Shutdown State:
+ * keepQueuedCommands   bool                 true if the commands left queued are kept for the next server (ARG_PERSISTENT),
+ *                                           instead of being drained when the server is signalled to stop
+ *******************************************************************************************************************************/
+static bool keepQueuedCommands = false;
+
+/********************************************************************************************************************************
+ * Deadline State:
+ * requestTimeout       unsigned int         milliseconds the client gives every request before it times out (ARG_DEADLINE),
+ *                                           or 0 to wait for as long as it takes
+ * shedThreshold        unsigned int         number of messages waiting on the command queue at which the server sheds the
+ *                                           requests which are not PRIORITY_CONTROL (ARG_SHED_AT), or 0 to never shed
+ *******************************************************************************************************************************/
+static unsigned int requestTimeout = 0;
+static unsigned int shedThreshold = 0;
+
+/********************************************************************************************************************************
+ * Affinity State:
+ * placementCpus        int[]                CPUs of the placement (ARG_AFFINITY), in order: the forked client is pinned to
+ *                                           the first one, and the server workers to the ones after it, wrapping around
+ * placementCount       unsigned int         number of CPUs in placementCpus, or 0 to leave every process unpinned
+ * unpinnedCpus         cpu_set_t            CPUs the program was started with (the affinity mask of an unpinned process)
+ * pinnedCpus           cpu_set_t            CPU of this process in the placement, once place_process() has pinned it
  *
- * Description: Utility method to close queue descriptors to avoid code redundancy.
- *     Attempts to close the message queue descriptors held by commandQueue and responseQueue. On error, an error message 
- *     is printed to the console and EXIT_FAILURE is returned. On success, EXIT_SUCCESS is returned.
+ * NOTE: these are global so that affinity_handler() can switch between them
+ *******************************************************************************************************************************/
+static int placementCpus[CPU_SETSIZE];
+static unsigned int placementCount = 0;
+static cpu_set_t unpinnedCpus;
+static cpu_set_t pinnedCpus;
+
+/********************************************************************************************************************************
+ * Compression State:
+ * compressReplies      bool                 true if the client flags its requests FRAME_ACCEPTS_COMPRESSED (ARG_COMPRESS)
+ *******************************************************************************************************************************/
+static bool compressReplies = false;
+
+/********************************************************************************************************************************
+ * Gateway State:
+ * gatewayDescriptor    int                  listening socket of the standalone server's gateway (ARG_LISTEN), inherited by
+ *                                           every server worker, or -1 if none
+ * gatewaySocketPath    char[]               path of the Unix domain socket the gateway listens on, unlinked when the standalone
+ *                                           server exits, or empty for none
+ *******************************************************************************************************************************/
+static int gatewayDescriptor = -1;
+static char gatewaySocketPath[sizeof(sockaddr_un::sun_path)] = "";
+
+/********************************************************************************************************************************
+ * Record State:
+ * recordDescriptor     int                  file the client logs its commands to (ARG_RECORD), or -1 if it does not record
+ * recordBuffer         char[]               the recorded commands not written to the file yet
+ * recordLength         size_t               number of bytes in recordBuffer
+ * recordTime           uint64_t             CLOCK_MONOTONIC time in nanoseconds the delay of the next command counts from
+ *******************************************************************************************************************************/
+static int recordDescriptor = -1;
+static char recordBuffer[RECORD_BUFFER_SIZE];
+static size_t recordLength = 0;
+static uint64_t recordTime = 0;
+
+/********************************************************************************************************************************
+ * struct TraceRecord
+ * Description: Completed trace of a request, as kept in the traceRing of the client.
  *
- * Parameters:
- *     close_queues    O/P    int    EXIT_FAILURE on error, EXIT_SUCCESS on success
+ * Members:
+ * requestID                uint32_t              ID of the traced request
+ * opcode                   uint16_t              opcode the reply was echoed with
+ * stamps                   TraceStamps           timestamps of every stage of the request
  *******************************************************************************************************************************/
-static int close_queues()
+struct TraceRecord
 {
-    if (mq_close(commandQueue) == -1 || mq_close(responseQueue) == -1) 
-    {
-        perror("close_queues::mq_close()");
-        return EXIT_FAILURE;
-    }
-    return EXIT_SUCCESS;
-}
+    uint32_t requestID;
+    uint16_t opcode;
+    TraceStamps stamps;
+};
+
+/********************************************************************************************************************************
+ * Trace State:
+ * traceInterval        unsigned int              number of requests per traced request (ARG_TRACE_RATE), or 0 if the client
+ *                                                does not trace (ARG_TRACE)
+ * traceRing            TraceRecord[]             the last TRACE_RING_SIZE completed traces of the client
+ * traceHead            std::atomic<uint64_t>     number of traces ever recorded, the next one goes to traceRing[traceHead %
+ *                                                TRACE_RING_SIZE]
+ *
+ * NOTE: the ring has a single writer (the client loop) and never blocks it, a record is published by the release store of
+ *       traceHead past it, and a reader acquiring traceHead only reads the TRACE_RING_SIZE records behind it
+ *******************************************************************************************************************************/
+static unsigned int traceInterval = 0;
+static TraceRecord traceRing[TRACE_RING_SIZE];
+static std::atomic<uint64_t> traceHead(0);
+
+/********************************************************************************************************************************
+ * struct BufferPool
+ * Description: Fixed set of equally sized buffers, carved out of a single arena preallocated when the pool is opened (see
+ *     map_arena()). Every buffer starts on a cache line and is rounded up to whole cache lines, so two buffers never share
+ *     a line, whichever threads write them. A buffer is owned by whoever acquired it until it is released, and neither
+ *     acquiring nor releasing one ever allocates (freeBuffers is reserved for every buffer up front).
+ *
+ * Members:
+ * arena                    char*                 the memory every buffer is carved from, or NULL if the pool is not open
+ * arenaSize                size_t                number of bytes in arena
+ * bufferSize               size_t                number of bytes of each buffer (rounded up to CACHE_LINE_SIZE)
+ * freeBuffers              std::vector<char*>    the buffers which are not owned by anyone
+ *******************************************************************************************************************************/
+struct BufferPool
+{
+    char* arena;
+    size_t arenaSize;
+    size_t bufferSize;
+    std::vector<char*> freeBuffers;
+};
+
+/********************************************************************************************************************************
+ * struct HeldReply
+ * Description: Reply held in the outbox of a standalone client until its reply queue has room.
+ *
+ * Members:
+ * message                  char*                 the framed reply message, in a buffer of the replyPool held until it is sent
+ * messageLength            size_t                number of bytes in message
+ * priority                 unsigned int          the message priority to send the reply with (that of its request)
+ *******************************************************************************************************************************/
+struct HeldReply
+{
+    char* message;
+    size_t messageLength;
+    unsigned int priority;
+};
+
+/********************************************************************************************************************************
+ * struct Outbox
+ * Description: Replies waiting for room in the reply queue of a standalone client, in order, in a fixed ring of
+ *     REPLY_OUTBOX_LIMIT replies (so holding a reply never allocates).
+ *
+ * Members:
+ * replies                  HeldReply[]           the ring of held replies
+ * first                    unsigned int          index of the oldest held reply in replies
+ * count                    unsigned int          number of held replies
+ *******************************************************************************************************************************/
+struct Outbox
+{
+    HeldReply replies[REPLY_OUTBOX_LIMIT];
+    unsigned int first;
+    unsigned int count;
+};
+
+/********************************************************************************************************************************
+ * struct ReplyQueueCache
+ * Description: Private reply queues of standalone clients that a server worker has open, so the queue is only opened 
+ *     by name on the first reply to each client. Entries are evicted round-robin once the cache is full. Replies to a 
+ *     client whose reply queue is full are held in the outbox of its entry, and sent once the reactor reports the
+ *     queue writable again, so a slow client never stalls the replies to any other client.
+ *
+ * Members:
+ * clientIDs                int32_t[]             client ID of each cached reply queue, or 0 for an empty entry
+ * queues                   mqd_t[]               message queue descriptor of each cached reply queue
+ * outboxes                 Outbox[]              replies waiting for room in each cached reply queue (in order)
+ * replyPool                BufferPool            the buffers of the held replies of every outbox, REPLY_POOL_DEPTHS queue
+ *                                                depths of them (standalone server only)
+ * releasing                bool[]                true if the entry is released as soon as its outbox has been sent
+ * nextEviction             unsigned int          index of the entry to evict next when the cache is full
+ * epollDescriptor          int                   epoll instance of the reactor watching the outboxes, or -1 if none
+ *******************************************************************************************************************************/
+struct ReplyQueueCache
+{
+    int32_t clientIDs[REPLY_QUEUE_CACHE_SIZE];
+    mqd_t queues[REPLY_QUEUE_CACHE_SIZE];
+    Outbox outboxes[REPLY_QUEUE_CACHE_SIZE];
+    BufferPool replyPool;
+    bool releasing[REPLY_QUEUE_CACHE_SIZE];
+    unsigned int nextEviction;
+    int epollDescriptor;
+};
+
+/********************************************************************************************************************************
+ * struct GatewayConnection
+ * Description: Connection of a client to the gateway of a standalone server (ARG_LISTEN). Every message on the connection,
+ *     either way, is prefixed with its length (GATEWAY_LENGTH_SIZE bytes, in host byte order like the MessageHeader), and
+ *     is a (batched) command or reply message as it would be sent on the message queues. Both buffers are a single
+ *     buffer of the connection pool of the Gateway, owned by the connection while it is open.
+ *
+ * Members:
+ * descriptor               int                   the connected socket (non-blocking), or -1 for a free slot
+ * generation               uint32_t              number of times the slot was closed (modulo GATEWAY_GENERATIONS), so the
+ *                                                replies to a closed connection never reach the next one (see
+ *                                                connection_client_id())
+ * events                   uint32_t              the epoll events the connection is watched for
+ * closing                  bool                  true once the client is done (end of input, or the end of its session), so
+ *                                                the connection closes as soon as its pending output is sent
+ * input                    char*                 the bytes received and not served yet (at most one whole message)
+ * inputLength              size_t                number of bytes in input
+ * output                   char*                 the length-prefixed replies waiting to be sent
+ * outputStart              size_t                offset in output of the first byte not sent yet
+ * outputLength             size_t                number of bytes in output not sent yet
+ *******************************************************************************************************************************/
+struct GatewayConnection
+{
+    int descriptor;
+    uint32_t generation;
+    uint32_t events;
+    bool closing;
+    char* input;
+    size_t inputLength;
+    char* output;
+    size_t outputStart;
+    size_t outputLength;
+};
+
+/********************************************************************************************************************************
+ * struct Gateway
+ * Description: Connections a server worker accepted from the listening gatewayDescriptor, served by its reactor next to 
+ *     the command queue. The workers of the pool share the listening socket (watched with EPOLLEXCLUSIVE), and each
+ *     connection belongs to the worker which accepted it. The buffers of every connection are preallocated in a pool.
+ *
+ * Members:
+ * connections              GatewayConnection[]   the connection slots
+ * buffers                  BufferPool            the input and output buffers of the connections, one buffer each (NULL
+ *                                                arena if the worker has no gateway)
+ * inputSize                size_t                number of bytes of the input of a connection (a length and a message)
+ * outputSize               size_t                number of bytes of the output of a connection (a queue depth of replies,
+ *                                                and a streamed result)
+ * epollDescriptor          int                   epoll instance of the reactor watching the connections, or -1 if none
+ *******************************************************************************************************************************/
+struct Gateway
+{
+    GatewayConnection connections[GATEWAY_CONNECTIONS];
+    BufferPool buffers;
+    size_t inputSize;
+    size_t outputSize;
+    int epollDescriptor;
+};
+
+/********************************************************************************************************************************
+ * struct StatsConfig
+ * Description: Statistics dump configuration of this process, set once at startup from ARG_STATS_FILE and 
+ *     ARG_STATS_INTERVAL.
+ *
+ * Members:
+ * dumpPath                 const char*           file the supervisor dumps the statistics report to, or NULL for none
+ * dumpInterval             unsigned int          number of seconds between two dumps
+ *******************************************************************************************************************************/
+struct StatsConfig
+{
+    const char* dumpPath;
+    unsigned int dumpInterval;
+};
+
+/********************************************************************************************************************************
+ * Statistics:
+ * statsConfig          StatsConfig          statistics dump configuration of this process (see StatsConfig)
+ *
+ * NOTE: the serverStats of the pool (and the workerStats of this worker) are dispatch state, see dispatch.h
+ *******************************************************************************************************************************/
+static StatsConfig statsConfig = { NULL, STATS_DUMP_INTERVAL };
+
+/********************************************************************************************************************************
+ * struct AsyncJob
+ * Description: Blocking command queued on (or completed by) the AsyncExecutor of a server worker. Every job is aligned to
+ *     a cache line of its own, so the executor threads running two jobs never write to the same line.
+ *
+ * Members:
+ * header                   MessageHeader         header of the request, echoed back in front of the result (its payloadLength
+ *                                                is the length of the arguments until the job completes, then of the result)
+ * opcode                   uint16_t              opcode of the command (resolved, if the request named it as text)
+ * priority                 unsigned int          message priority the request was received with, and is replied with
+ * handlerNanoseconds       uint64_t              time the handler took to run
+ * trace                    TraceStamps           timestamps of a traced request (FRAME_TRACED), stamped around its handler
+ * argumentsLength          size_t                number of bytes of the arguments in buffer (kept to memoize the response)
+ * buffer                   char*                 the framed reply (header and result) followed by the arguments of the request,
+ *                                                a buffer of the jobBuffers owned by the job slot
+ *******************************************************************************************************************************/
+struct alignas(CACHE_LINE_SIZE) AsyncJob
+{
+    MessageHeader header;
+    uint16_t opcode;
+    unsigned int priority;
+    uint64_t handlerNanoseconds;
+    TraceStamps trace;
+    size_t argumentsLength;
+    char* buffer;
+};
+
+/********************************************************************************************************************************
+ * struct SlotQueue
+ * Description: Fixed FIFO of AsyncExecutor job slots (see push_slot() and pop_slot()). There are never more than
+ *     EXECUTOR_QUEUE_LIMIT jobs, so it can never overflow, and unlike a std::deque it never allocates.
+ *
+ * Members:
+ * slots                    unsigned int[]        the ring of queued job slots
+ * first                    unsigned int          index of the oldest queued slot in slots
+ * count                    unsigned int          number of queued slots
+ *******************************************************************************************************************************/
+struct SlotQueue
+{
+    unsigned int slots[EXECUTOR_QUEUE_LIMIT];
+    unsigned int first;
+    unsigned int count;
+};
+
+/********************************************************************************************************************************
+ * struct AsyncExecutor
+ * Description: Bounded executor of the blocking commands of a server worker. A fixed set of EXECUTOR_THREADS threads runs 
+ *     the handlers of the queued jobs, while the server loop keeps serving other commands. Completed jobs are handed back
+ *     to the server loop through an eventfd watched by its reactor, and the server loop sends their replies, so only the
+ *     server loop ever touches the reply queues and the workerStats. The EXECUTOR_QUEUE_LIMIT jobs and their buffers are
+ *     allocated once, when the executor starts, and the buffer of a job is handed from the server loop (the arguments) to
+ *     a thread (the reply) and back (to send it) along with its slot.
+ *
+ * Members:
+ * lock                     std::mutex            guards every member below except threads, jobs, and eventDescriptor
+ * jobReady                 std::condition_variable signalled when a job is queued, or when the executor is stopping
+ * threads                  std::vector<pthread_t> the threads running the handlers
+ * jobs                     AsyncJob*             every job slot, in an arena of their own (see map_arena())
+ * jobBuffers               BufferPool            the buffers of the job slots, each one reply and the arguments of a request
+ * replySize                size_t                number of bytes of the reply in each job buffer (the message size)
+ * freeJobs                 std::vector<unsigned int> the slots of jobs which are not in use
+ * pendingJobs              SlotQueue             the slots of jobs waiting for a thread, in the order they were queued
+ * completedJobs            SlotQueue             the slots of jobs waiting for the server loop to send their reply
+ * stopping                 bool                  true once the threads should exit (after the pending jobs)
+ * eventDescriptor          int                   eventfd written by a thread whenever it completes a job
+ *******************************************************************************************************************************/
+struct AsyncExecutor
+{
+    std::mutex lock;
+    std::condition_variable jobReady;
+    std::vector<pthread_t> threads;
+    AsyncJob* jobs;
+    BufferPool jobBuffers;
+    size_t replySize;
+    std::vector<unsigned int> freeJobs;
+    SlotQueue pendingJobs;
+    SlotQueue completedJobs;
+    bool stopping;
+    int eventDescriptor;
+};
+
+/********************************************************************************************************************************
+ * struct ServerWorker
+ * Description: State of a server worker, shared by its event loop and the methods serving each message.
+ *
+ * Members:
+ * standalone               bool                  true if this worker belongs to a standalone server (which has no forked client)
+ * running                  bool                  false once the worker should exit (CMD_EXIT from the forked client)
+ * draining                 bool                  true once the worker was signalled to stop (see stop_signals()), and serves 
+ *                                                what is left before exiting
+ * shedding                 bool                  true while at least shedThreshold messages are waiting on the command queue,
+ *                                                so the message being served only gets MESSAGE_SHED replies (see serve_message())
+ * messageSize              size_t                number of bytes of each message (the message size configured at startup)
+ * resultSize               size_t                number of bytes of the largest result of a command (STREAM_RESULT_SIZE, or
+ *                                                what fits in a message if that is more)
+ * arena                    char*                 storage of inputBuffer, outputBuffer, resultBuffer, compressionBuffer, and
+ *                                                chunkBuffer, each starting on a cache line (see map_arena())
+ * arenaSize                size_t                number of bytes in arena
+ * inputBuffer              char*                 input buffer - framed commands from the client
+ * outputBuffer             char*                 output buffer - framed command responses for the client (with room for a
+ *                                                result of resultSize bytes behind the first header)
+ * resultBuffer             char*                 result buffer - result of a batched command that may not fit in outputBuffer
+ * compressionBuffer        char*                 compression buffer - a result being compressed (see compress_payload())
+ * chunkBuffer              char*                 chunk buffer - the framed chunk of a streamed result (see stream_reply())
+ * replyQueues              ReplyQueueCache       private reply queues of standalone clients
+ * gateway                  Gateway               connections of the gateway clients (standalone server with ARG_LISTEN)
+ * executor                 AsyncExecutor*        executor of the blocking commands (NULL to run them on the server loop)
+ *******************************************************************************************************************************/
+struct ServerWorker
+{
+    bool standalone;
+    bool running;
+    bool draining;
+    bool shedding;
+    size_t messageSize;
+    size_t resultSize;
+    char* arena;
+    size_t arenaSize;
+    char* inputBuffer;
+    char* outputBuffer;
+    char* resultBuffer;
+    char* compressionBuffer;
+    char* chunkBuffer;
+    ReplyQueueCache replyQueues;
+    Gateway gateway;
+    AsyncExecutor* executor;
+};
+
+/********************************************************************************************************************************
+ * struct PendingRequest
+ * Description: Slot in the pipelined client window for a request that has been sent but not yet printed.
+ *
+ * Members:
+ * complete                 bool                  true once the reply to the request has been received (its last chunk, if it
+ *                                                is streamed)
+ * response                 std::string           the reply to the request (without its MessageHeader), or the chunks of it
+ *                                                received but not printed yet
+ * sequence                 uint16_t              the sequence number of the next chunk of the reply (see stream_reply())
+ * request                  std::string           the framed request, kept to resend it after a reconnect (standalone client only)
+ * priority                 unsigned int          the message priority of the request
+ * deadline                 uint32_t              the deadline of the request (see MessageHeader), or 0 for none
+ *******************************************************************************************************************************/
+struct PendingRequest
+{
+    bool complete;
+    std::string response;
+    uint16_t sequence;
+    std::string request;
+    unsigned int priority;
+    uint32_t deadline;
+};
+
+/********************************************************************************************************************************
+ * struct InputReader
+ * Description: Buffered reader of the commands of the non-interactive client. Input is read() in chunks of 
+ *      STREAM_INPUT_SIZE, and every command is handed out as a pointer into the chunk, without copying it into a string.
+ *
+ * Members:
+ * descriptor               int                   the file descriptor the commands are read from (STDIN_FILENO)
+ * buffer                   std::vector<char>     the chunk of input read so far
+ * start                    size_t                offset in buffer of the first byte not handed out yet
+ * end                      size_t                offset in buffer after the last byte read
+ * ended                    bool                  true once the input has ended (or failed)
+ *******************************************************************************************************************************/
+struct InputReader
+{
+    int descriptor;
+    std::vector<char> buffer;
+    size_t start;
+    size_t end;
+    bool ended;
+};
+
+/********************************************************************************************************************************
+ * struct OutputWriter
+ * Description: Buffered writer of the replies of the non-interactive client. Replies are gathered into buffer, and only 
+ *      written out once it is full (or before the client blocks on its input), with writev() rather than a flush per line.
+ *
+ * Members:
+ * descriptor               int                   the file descriptor the replies are written to (STDOUT_FILENO)
+ * buffer                   std::vector<char>     the replies gathered so far, each followed by a newline
+ * length                   size_t                number of bytes used in buffer
+ *******************************************************************************************************************************/
+struct OutputWriter
+{
+    int descriptor;
+    std::vector<char> buffer;
+    size_t length;
+};
+
+/********************************************************************************************************************************
+ * struct FanoutHost
+ * Description: Gateway of a host the fan-out client (ARG_HOSTS) sends every command to, over a connection opened once and
+ *      reused by every command.
+ *
+ * Members:
+ * endpoint                 std::string           the endpoint of the host, as given to ARG_HOSTS
+ * descriptor               int                   the connected socket, or -1 once the host is not connected
+ * input                    std::vector<char>     the bytes received and not handled yet (at most one length-prefixed message)
+ * inputLength              size_t                number of bytes in input
+ * result                   std::string           the reply of the host to the current command so far (rendered once whole)
+ * sequence                 uint16_t              the sequence number of the next chunk of the reply (see stream_reply())
+ * answered                 bool                  true once the whole reply to the current command has arrived
+ *******************************************************************************************************************************/
+struct FanoutHost
+{
+    std::string endpoint;
+    int descriptor;
+    std::vector<char> input;
+    size_t inputLength;
+    std::string result;
+    uint16_t sequence;
+    bool answered;
+};
+
+/********************************************************************************************************************************
+ * enum BenchFormat
+ * Description: Output format of the benchmark report (ARG_FORMAT).
+ *
+ * Values:
+ * BENCH_FORMAT_TEXT        aligned table for the console (default)
+ * BENCH_FORMAT_CSV         comma separated values, with a header row and the configuration repeated on every row
+ * BENCH_FORMAT_JSON        a single JSON object with the configuration and an array of results
+ * BENCH_FORMAT_COUNT       number of formats
+ *******************************************************************************************************************************/
+enum BenchFormat
+{
+    BENCH_FORMAT_TEXT = 0,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON,
+    BENCH_FORMAT_COUNT
+};
+
+/********************************************************************************************************************************
+ * struct BenchOptions
+ * Description: Benchmark options parsed from the command line arguments by parse_arguments().
+ *
+ * Members:
+ * requestCount             unsigned int          number of requests sent for each benchmarked command (ARG_BENCH)
+ * concurrency              unsigned int          number of requests kept outstanding at once (ARG_CONCURRENCY)
+ * payloadSize              unsigned int          number of bytes of the text command payload (ARG_PAYLOAD)
+ * format                   BenchFormat           output format of the report (ARG_FORMAT)
+ *******************************************************************************************************************************/
+struct BenchOptions
+{
+    unsigned int requestCount;
+    unsigned int concurrency;
+    unsigned int payloadSize;
+    BenchFormat format;
+};
+
+/********************************************************************************************************************************
+ * struct BenchSlot
+ * Description: Slot in the benchmark window for a request that has been sent but not yet answered.
+ *
+ * Members:
+ * outstanding              bool                  true while the request is waiting for its reply
+ * command                  unsigned int          index of the command of the request in the commands of the round
+ * sendTime                 uint64_t              CLOCK_MONOTONIC time the request was framed, in nanoseconds
+ *******************************************************************************************************************************/
+struct BenchSlot
+{
+    bool outstanding;
+    unsigned int command;
+    uint64_t sendTime;
+};
+
+/********************************************************************************************************************************
+ * struct BenchResult
+ * Description: Result of benchmarking a single command (on its own, or as part of the mixed round).
+ *
+ * Members:
+ * command                  std::string           name of the benchmarked command (BENCH_TEXT_NAME for the text payload,
+ *                                                prefixed by BENCH_MIXED_PREFIX in the mixed round)
+ * priority                 PriorityClass         priority class the command was sent with
+ * requestCount             unsigned int          number of requests which completed
+ * seconds                  double                wall clock time from the first request to the last reply of the round
+ * latencies                std::vector<uint64_t> round trip latency of every request in nanoseconds, sorted
+ * placement                const char*           placement of the processes during the round (see BENCH_PLACEMENT_NAMES)
+ *******************************************************************************************************************************/
+struct BenchResult
+{
+    std::string command;
+    PriorityClass priority;
+    unsigned int requestCount;
+    double seconds;
+    std::vector<uint64_t> latencies;
+    const char* placement;
+};
+
+/********************************************************************************************************************************
+ * struct RecordEntry
+ * Description: Entry of a recorded command log (ARG_RECORD), which follows RECORD_MAGIC with one entry for each command read
+ *     by the client, in order. Every entry is followed by the command itself (not NUL-terminated, without its newline).
+ *
+ * Members:
+ * delay                    uint32_t              microseconds between reading the previous command (or starting to record)
+ *                                                and reading this one (a longer delay is cut short to UINT32_MAX)
+ * commandLength            uint32_t              number of bytes of the command following the entry
+ *******************************************************************************************************************************/
+struct RecordEntry
+{
+    uint32_t delay;
+    uint32_t commandLength;
+};
+
+/********************************************************************************************************************************
+ * struct ReplayCursor
+ * Description: Position of a replay in the mapped recorded command log (see next_record_entry()).
+ *
+ * Members:
+ * file                     const char*           the mapped recorded command log
+ * fileSize                 size_t                number of bytes in file
+ * offset                   size_t                offset of the next RecordEntry in file
+ * entry                    unsigned int          index of the next RecordEntry in file (counting from 0)
+ * time                     uint64_t              nanoseconds from the start of the recording to the last command stepped to
+ *******************************************************************************************************************************/
+struct ReplayCursor
+{
+    const char* file;
+    size_t fileSize;
+    size_t offset;
+    unsigned int entry;
+    uint64_t time;
+};
+
+/********************************************************************************************************************************
+ * struct ReplaySample
+ * Description: Measured round trip of a replayed command, one for each command of the recorded command log, written by the
+ *     generator replaying it into memory shared with the replay client (every generator writes only its own commands).
+ *
+ * Members:
+ * latency                  uint64_t              nanoseconds from framing the command to receiving its reply
+ * opcode                   uint16_t              opcode the command was framed as
+ * answered                 bool                  true once the reply has been received (false for a command not replayed)
+ *******************************************************************************************************************************/
+struct ReplaySample
+{
+    uint64_t latency;
+    uint16_t opcode;
+    bool answered;
+};
+
+/********************************************************************************************************************************
+ * struct ProgramOptions
+ * Description: Program options parsed from the command line arguments by parse_arguments().
+ *
+ * Members:
+ * server                   bool                  true to run only the standalone server (ARG_SERVER)
+ * client                   bool                  true to run only the standalone client (ARG_CLIENT)
+ * pipelined                bool                  true to run the client in pipelined mode (ARG_PIPELINED or ARG_BATCHED)
+ * batched                  bool                  true to batch several commands into each message (ARG_BATCHED)
+ * workerCount              unsigned int          number of worker processes in the server pool (ARG_WORKERS)
+ * transport                const Transport*      transport between the forked client and server pool (ARG_TRANSPORT)
+ * queue                    QueueConfig           queue configuration (ARG_QUEUE_DEPTH, ARG_MESSAGE_SIZE, and ARG_PRIORITY)
+ * benchmark                bool                  true to run the benchmark client instead of reading commands (ARG_BENCH)
+ * bench                    BenchOptions          benchmark options (ARG_BENCH, ARG_CONCURRENCY, ARG_PAYLOAD, and ARG_FORMAT)
+ * stats                    StatsConfig           statistics dump configuration (ARG_STATS_FILE and ARG_STATS_INTERVAL)
+ * plugins                  const char*[]         paths of the plugins to load (ARG_PLUGIN)
+ * pluginCount              unsigned int          number of paths in plugins
+ * persistent               bool                  true to keep the standalone server's command queue on exit (ARG_PERSISTENT)
+ * requestTimeout           unsigned int          milliseconds the client gives every request (ARG_DEADLINE), or 0 for no limit
+ * shedThreshold            unsigned int          command queue depth the server sheds requests at (ARG_SHED_AT), or 0 for never
+ * affinity                 const char*           CPUs to pin the processes to (ARG_AFFINITY), AFFINITY_AUTO, or NULL for none
+ * compress                 bool                  true to have the server compress the replies to the client (ARG_COMPRESS)
+ * listen                   const char*           endpoint the standalone server's gateway listens on (ARG_LISTEN), or NULL
+ * hosts                    const char*           endpoints the fan-out client sends every command to (ARG_HOSTS), or NULL
+ * tracePath                const char*           file the client dumps its traces to (ARG_TRACE), or NULL
+ * traceInterval            unsigned int          number of requests per traced request (ARG_TRACE_RATE), or 0 if not given
+ * recordPath               const char*           file the client logs its commands to (ARG_RECORD), or NULL
+ * replayPath               const char*           recorded command log to replay instead of reading commands (ARG_REPLAY), or NULL
+ * replaySpeed              unsigned int          factor the replay is sped up by (ARG_SPEED), or 0 for as fast as possible
+ * generatorCount           unsigned int          number of replay generator processes (ARG_GENERATORS)
+ *******************************************************************************************************************************/
+struct ProgramOptions
+{
+    bool server;
+    bool client;
+    bool pipelined;
+    bool batched;
+    unsigned int workerCount;
+    const Transport* transport;
+    QueueConfig queue;
+    bool benchmark;
+    BenchOptions bench;
+    StatsConfig stats;
+    const char* plugins[MAX_PLUGINS];
+    unsigned int pluginCount;
+    bool persistent;
+    unsigned int requestTimeout;
+    unsigned int shedThreshold;
+    const char* affinity;
+    bool compress;
+    const char* listen;
+    const char* hosts;
+    const char* tracePath;
+    unsigned int traceInterval;
+    const char* recordPath;
+    const char* replayPath;
+    unsigned int replaySpeed;
+    unsigned int generatorCount;
+};
 
 /********************************************************************************************************************************
  * static void kill_process(pid_t)
@@ -132,33 +1233,5964 @@ static void kill_process(pid_t processID)
     // send the kill signal
     if (kill(processID, SIGKILL) == -1)
     {
-        perror("kill_process::kill()");
+        perror("kill_process::kill()");
+    }
+    // wait for the process to exit to avoid a zombie
+    if (waitpid(processID, NULL, 0) == -1)
+    {
+        std::cerr << "kill_process::waitpid() - unable to wait for process (" << processID << ") to exit.\n";
+    }
+}
+
+/********************************************************************************************************************************
+ * static void kill_pool(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to send a SIGKILL to every process of the server pool (poolProcessIDs) and wait for them all 
+ *      to exit. Every process is signalled before any of them is waited on, so the pool is torn down in parallel.
+ *******************************************************************************************************************************/
+static void kill_pool()
+{
+    // send the kill signal to every process first
+    for (unsigned int i = 0; i < poolSize; ++i)
+    {
+        if (kill(poolProcessIDs[i], SIGKILL) == -1 && errno != ESRCH) // ESRCH - the worker has exited already
+        {
+            perror("kill_pool::kill()");
+        }
+    }
+    // wait for every process to exit to avoid zombies
+    for (unsigned int i = 0; i < poolSize; ++i)
+    {
+        if (waitpid(poolProcessIDs[i], NULL, 0) == -1 && errno != ECHILD) // ECHILD - the worker was reaped already
+        {
+            std::cerr << "kill_pool::waitpid() - unable to wait for process (" << poolProcessIDs[i] << ") to exit.\n";
+        }
+    }
+    poolSize = 0;
+}
+
+/********************************************************************************************************************************
+ * static uint32_t request_deadline(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to find the deadline of a request framed now, requestTimeout milliseconds from now. A 
+ *      deadline which wraps around to 0 is moved to 1, since 0 stands for no deadline.
+ *
+ * Parameters:
+ *      request_deadline    O/P    uint32_t    the deadline of the request (see MessageHeader), or 0 if requestTimeout is 0
+ *******************************************************************************************************************************/
+static uint32_t request_deadline()
+{
+    if (requestTimeout == 0)
+    {
+        return 0;
+    }
+    const uint32_t deadline = monotonic_milliseconds() + requestTimeout;
+    return (deadline == 0) ? 1 : deadline;
+}
+
+/********************************************************************************************************************************
+ * static void signal_handler(int signalNum)
+ * Author: Kerby Kaska
+ * Date: 1/20/2022
+ * Modification History:
+ * 1/20/2022    Kerby Kaska     Created.
+ * 1/23/2022    Kerby Kaska     Refactored to call close_queues() instead to clean up resources.
+ * 10/14/2026   Kerby Kaska     Kill and reap the server pool first, so no worker is left blocked on the command queue.
+ * 10/14/2026   Kerby Kaska     Only make async-signal-safe calls. The server processes take their signals from a signalfd.
+ *
+ * Description: Signal handler for SIGINT and SIGTERM in the client processes (and the shared memory server workers) to 
+ *     ensure proper cleanup of resources used. The queue published by this process (if any) is unlinked, and the process
+ *     is terminated EXIT_SUCCESS with _exit(), which closes its descriptors and unmaps its memory. No message is printed
+ *     and exit() is not called, since neither is safe in a signal handler. The supervisor and the message queue server 
+ *     workers block these signals and read them from a signalfd in their event loops instead (see run_supervisor() and 
+ *     run_reactor()), so they can stop gracefully.
+ *
+ * Parameters:
+ *     signalNum    I/P    int    (unused) indicator of the system signal which triggered the handler
+ *******************************************************************************************************************************/
+static void signal_handler(int signalNum)
+{
+    if (ownedQueueName[0] != '\0')
+    {
+        mq_unlink(ownedQueueName); // NOTE: a plain system call on Linux
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+/********************************************************************************************************************************
+ * static void hangup_handler(int signalNum)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Signal handler for SIGHUP, the cheap way to tell the server that the system information has changed.
+ *     In a server worker, the responseCache and memoCache are flagged stale so they are invalidated before their next
+ *     use. The supervisor reads SIGHUP from its signalfd instead, and forwards it to every worker of the pool. Only
+ *     async-signal-safe calls are made.
+ *
+ * Parameters:
+ *     signalNum    I/P    int    (unused) indicator of the system signal which triggered the handler
+ *******************************************************************************************************************************/
+static void hangup_handler(int signalNum)
+{
+    responseCacheStale = 1;
+    memoCacheStale = 1;
+}
+
+/********************************************************************************************************************************
+ * static void affinity_handler(int signalNum)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Signal handler for AFFINITY_PIN_SIGNAL and AFFINITY_UNPIN_SIGNAL in a pinned server worker, which the
+ *     supervisor forwards from the benchmark client (see set_bench_placement()). The worker is pinned back to its CPU of
+ *     the placement (pinnedCpus), or unpinned to every CPU the program was started with (unpinnedCpus). Only the thread
+ *     of the reactor is moved, the threads of the AsyncExecutor block every signal and keep the CPU they started on.
+ *     sched_setaffinity() is a plain system call, so it is safe in a signal handler.
+ *
+ * Parameters:
+ *     signalNum    I/P    int    indicator of the system signal which triggered the handler
+ *******************************************************************************************************************************/
+static void affinity_handler(int signalNum)
+{
+    sched_setaffinity(0, sizeof(cpu_set_t), (signalNum == AFFINITY_PIN_SIGNAL) ? &pinnedCpus : &unpinnedCpus);
+}
+
+/********************************************************************************************************************************
+ * static void stop_signals(sigset_t* signals)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to fill a signal set with the signals which stop the server gracefully, SIGINT (CTRL+C) and
+ *     SIGTERM. (SIGKILL and SIGSTOP can be neither caught nor blocked.)
+ *
+ * Parameters:
+ *     signals    O/P    sigset_t*    the signal set to fill
+ *******************************************************************************************************************************/
+static void stop_signals(sigset_t* signals)
+{
+    sigemptyset(signals);
+    sigaddset(signals, SIGINT);
+    sigaddset(signals, SIGTERM);
+}
+
+/********************************************************************************************************************************
+ * static void record_trace(const MessageHeader& header, const char* payload, size_t* payloadLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method for the clients to strip the TraceStamps off the end of the (expanded) payload of a 
+ *      FRAME_TRACED reply frame, stamp the time the reply was received, and record the completed trace in the traceRing,
+ *      overwriting the oldest trace once it is full. Any other frame is left as it is.
+ *
+ * Parameters:
+ *      header           I/P    const MessageHeader&    the header of the reply frame
+ *      payload          I/P    const char*             the payload of the frame (expanded, see expand_reply())
+ *      payloadLength    I/O    size_t*                 the number of bytes in payload, then without the TraceStamps
+ *******************************************************************************************************************************/
+static void record_trace(const MessageHeader& header, const char* payload, size_t* payloadLength)
+{
+    if ((header.flags & FRAME_TRACED) == 0 || *payloadLength < sizeof(TraceStamps))
+    {
+        return;
+    }
+    *payloadLength -= sizeof(TraceStamps);
+    const uint64_t head = traceHead.load(std::memory_order_relaxed); // NOTE: the client loop is the only writer
+    TraceRecord& record = traceRing[head % TRACE_RING_SIZE];
+    record.requestID = header.requestID;
+    record.opcode = header.opcode;
+    memcpy(&record.stamps, payload + *payloadLength, sizeof(record.stamps));
+    record.stamps.replyDequeue = monotonic_nanoseconds();
+    traceHead.store(head + 1, std::memory_order_release);
+}
+
+/********************************************************************************************************************************
+ * static bool open_record_file(const char* path)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Starts logging the commands of the client to a recorded command log (ARG_RECORD), replacing the file if it
+ *      exists. The RECORD_MAGIC is gathered in the recordBuffer, and the delay of the first command counts from now. On
+ *      error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      path                I/P    const char*    the file to log the commands to
+ *      open_record_file    O/P    bool           true on success, false on error
+ *******************************************************************************************************************************/
+static bool open_record_file(const char* path)
+{
+    recordDescriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (recordDescriptor == -1)
+    {
+        perror("client::open()");
+        return false;
+    }
+    memcpy(recordBuffer, RECORD_MAGIC, RECORD_MAGIC_SIZE);
+    recordLength = RECORD_MAGIC_SIZE;
+    recordTime = monotonic_nanoseconds();
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void flush_record_file(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to write the commands gathered in the recordBuffer to the recorded command log. On error, an
+ *      error message is printed to the console, and the client stops recording (the log holds the commands written so 
+ *      far), since the commands are of more use to the user than their log.
+ *******************************************************************************************************************************/
+static void flush_record_file()
+{
+    size_t written = 0;
+    while (recordDescriptor != -1 && written < recordLength)
+    {
+        const ssize_t writeLength = write(recordDescriptor, recordBuffer + written, recordLength - written);
+        if (writeLength == -1 && errno != EINTR)
+        {
+            perror("client::write()");
+            close(recordDescriptor);
+            recordDescriptor = -1;
+        }
+        written += (writeLength > 0) ? writeLength : 0;
+    }
+    recordLength = 0;
+}
+
+/********************************************************************************************************************************
+ * static void record_command(const char* command, size_t commandLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to log a command read by the client to the recorded command log (if it records), with the
+ *      delay since the previous command. The commands are gathered in the recordBuffer and written out once it is full
+ *      (see flush_record_file()), so recording costs the client no system call for most commands. A command longer than
+ *      the largest message is cut short, since no more of it could be sent anyway.
+ *
+ * Parameters:
+ *      command          I/P    const char*    the command read by the client (not NUL-terminated)
+ *      commandLength    I/P    size_t         the number of bytes in command
+ *******************************************************************************************************************************/
+static void record_command(const char* command, size_t commandLength)
+{
+    if (recordDescriptor == -1)
+    {
+        return;
+    }
+    RecordEntry entry;
+    const uint64_t delay = (monotonic_nanoseconds() - recordTime) / 1000;
+    entry.delay = (delay < UINT32_MAX) ? delay : UINT32_MAX;
+    entry.commandLength = (commandLength < QUEUE_MAX_MESSAGE_SIZE) ? commandLength : QUEUE_MAX_MESSAGE_SIZE;
+    recordTime += entry.delay * 1000ULL; // NOTE: the delays add up to the recorded times, without a rounding drift
+    if (recordLength + sizeof(entry) + entry.commandLength > RECORD_BUFFER_SIZE)
+    {
+        flush_record_file();
+    }
+    memcpy(recordBuffer + recordLength, &entry, sizeof(entry));
+    memcpy(recordBuffer + recordLength + sizeof(entry), command, entry.commandLength);
+    recordLength += sizeof(entry) + entry.commandLength;
+}
+
+/********************************************************************************************************************************
+ * static void close_record_file(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Stops logging the commands of the client, writing out the rest of the recordBuffer first (if it records).
+ *******************************************************************************************************************************/
+static void close_record_file()
+{
+    flush_record_file();
+    if (recordDescriptor != -1)
+    {
+        close(recordDescriptor);
+        recordDescriptor = -1;
+    }
+}
+
+
+/********************************************************************************************************************************
+ * static char* map_arena(size_t size)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to preallocate an arena of private, page-aligned memory for the buffers of a server worker.
+ *      The pages are populated right away (MAP_POPULATE), so serving a message never takes a page fault on a buffer, and
+ *      the arena is not shared with any other process, so the buffers of two workers can never share a cache line. On
+ *      error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      size         I/P    size_t    the number of bytes of the arena
+ *      map_arena    O/P    char*     the arena, or NULL on error
+ *******************************************************************************************************************************/
+static char* map_arena(size_t size)
+{
+    void* arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (arena == MAP_FAILED)
+    {
+        perror("server::mmap()");
+        return NULL;
+    }
+    return static_cast<char*>(arena);
+}
+
+/********************************************************************************************************************************
+ * static void unmap_arena(void* arena, size_t size)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to release an arena preallocated by map_arena(), if any.
+ *
+ * Parameters:
+ *      arena    I/P    void*     the arena, or NULL for none
+ *      size     I/P    size_t    the number of bytes of the arena
+ *******************************************************************************************************************************/
+static void unmap_arena(void* arena, size_t size)
+{
+    if (arena != NULL)
+    {
+        munmap(arena, size);
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool open_pool(BufferPool* pool, size_t bufferCount, size_t bufferSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Preallocates the arena of a BufferPool, and carves it into bufferCount free buffers of at least bufferSize
+ *      bytes each, starting on a cache line each. On error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      pool           O/P    BufferPool*    the pool to open
+ *      bufferCount    I/P    size_t         the number of buffers of the pool
+ *      bufferSize     I/P    size_t         the number of bytes of each buffer
+ *      open_pool      O/P    bool           true on success, false on error
+ *******************************************************************************************************************************/
+static bool open_pool(BufferPool* pool, size_t bufferCount, size_t bufferSize)
+{
+    pool->bufferSize = align_to_cache_line(bufferSize);
+    pool->arenaSize = bufferCount * pool->bufferSize;
+    pool->arena = map_arena(pool->arenaSize);
+    if (pool->arena == NULL)
+    {
+        return false;
+    }
+    pool->freeBuffers.reserve(bufferCount);
+    for (size_t i = bufferCount; i > 0; --i)
+    {
+        pool->freeBuffers.push_back(pool->arena + (i - 1) * pool->bufferSize); // NOTE: handed out from the front first
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void close_pool(BufferPool* pool)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Releases the arena of a BufferPool (if it is open). None of its buffers may be used afterwards.
+ *
+ * Parameters:
+ *      pool    I/P    BufferPool*    the pool to close
+ *******************************************************************************************************************************/
+static void close_pool(BufferPool* pool)
+{
+    unmap_arena(pool->arena, pool->arenaSize);
+    pool->arena = NULL;
+    pool->freeBuffers.clear();
+}
+
+/********************************************************************************************************************************
+ * static inline char* acquire_buffer(BufferPool* pool)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to take ownership of a free buffer of a BufferPool, the one released last (whose cache lines
+ *      are the most likely to still be warm).
+ *
+ * Parameters:
+ *      pool              I/P    BufferPool*    the pool to acquire the buffer from
+ *      acquire_buffer    O/P    char*          the buffer (of pool->bufferSize bytes), or NULL if every buffer is in use
+ *******************************************************************************************************************************/
+static inline char* acquire_buffer(BufferPool* pool)
+{
+    if (pool->freeBuffers.empty())
+    {
+        return NULL;
+    }
+    char* buffer = pool->freeBuffers.back();
+    pool->freeBuffers.pop_back();
+    return buffer;
+}
+
+/********************************************************************************************************************************
+ * static inline void release_buffer(BufferPool* pool, char* buffer)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to hand a buffer acquired from a BufferPool back to it.
+ *
+ * Parameters:
+ *      pool      I/P    BufferPool*    the pool the buffer was acquired from
+ *      buffer    I/P    char*          the buffer, which its owner no longer uses
+ *******************************************************************************************************************************/
+static inline void release_buffer(BufferPool* pool, char* buffer)
+{
+    pool->freeBuffers.push_back(buffer); // NOTE: never allocates, there is room for every buffer of the pool
+}
+
+/********************************************************************************************************************************
+ * static inline void push_slot(SlotQueue* queue, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to queue a job slot at the back of a SlotQueue.
+ *
+ * Parameters:
+ *      queue    I/P    SlotQueue*      the queue of job slots
+ *      slot     I/P    unsigned int    the job slot to queue
+ *******************************************************************************************************************************/
+static inline void push_slot(SlotQueue* queue, unsigned int slot)
+{
+    queue->slots[(queue->first + queue->count) % EXECUTOR_QUEUE_LIMIT] = slot;
+    ++queue->count;
+}
+
+/********************************************************************************************************************************
+ * static inline unsigned int pop_slot(SlotQueue* queue)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to take the oldest job slot off the front of a SlotQueue, which must not be empty.
+ *
+ * Parameters:
+ *      queue       I/P    SlotQueue*      the queue of job slots
+ *      pop_slot    O/P    unsigned int    the oldest queued job slot
+ *******************************************************************************************************************************/
+static inline unsigned int pop_slot(SlotQueue* queue)
+{
+    const unsigned int slot = queue->slots[queue->first];
+    queue->first = (queue->first + 1) % EXECUTOR_QUEUE_LIMIT;
+    --queue->count;
+    return slot;
+}
+
+/********************************************************************************************************************************
+ * static void clear_outbox(ReplyQueueCache* cache, unsigned int entry)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to drop every reply held in the outbox of a cache entry, handing their buffers back to the
+ *      replyPool.
+ *
+ * Parameters:
+ *      cache    I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      entry    I/P    unsigned int        the cache entry whose outbox to empty
+ *******************************************************************************************************************************/
+static void clear_outbox(ReplyQueueCache* cache, unsigned int entry)
+{
+    Outbox& outbox = cache->outboxes[entry];
+    for (unsigned int i = 0; i < outbox.count; ++i)
+    {
+        release_buffer(&cache->replyPool, outbox.replies[(outbox.first + i) % REPLY_OUTBOX_LIMIT].message);
+    }
+    outbox.first = 0;
+    outbox.count = 0;
+}
+
+/********************************************************************************************************************************
+ * static void close_reply_entry(ReplyQueueCache* cache, unsigned int entry)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to close the reply queue of a cache entry and empty the entry. Any replies still in its
+ *      outbox are dropped, and the reply queue is removed from the reactor.
+ *
+ * Parameters:
+ *      cache    I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      entry    I/P    unsigned int        the cache entry to close
+ *******************************************************************************************************************************/
+static void close_reply_entry(ReplyQueueCache* cache, unsigned int entry)
+{
+    if (cache->outboxes[entry].count != 0)
+    {
+        std::cerr << "server::close_reply_entry() - dropped " << cache->outboxes[entry].count << " replies to client "
+                  << cache->clientIDs[entry] << ".\n";
+        stats_add(&workerStats->repliesDropped, cache->outboxes[entry].count);
+        clear_outbox(cache, entry);
+        epoll_ctl(cache->epollDescriptor, EPOLL_CTL_DEL, cache->queues[entry], NULL);
+    }
+    mq_close(cache->queues[entry]);
+    cache->clientIDs[entry] = 0;
+    cache->releasing[entry] = false;
+}
+
+/********************************************************************************************************************************
+ * static int get_reply_entry(ReplyQueueCache* cache, int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Renamed from get_reply_queue(). Returns the cache entry, which holds the outbox of the client.
+ *
+ * Description: Utility method to look up the private reply queue of a standalone client in the cache, opening it by name
+ *      (see REPLY_QUEUE_NAME_FORMAT) on a miss. The queue is opened non-blocking, so a client that stops reading its
+ *      replies can never stall a server worker. If the cache is full, the next entry in round-robin order is evicted 
+ *      (dropping any replies still in its outbox).
+ *
+ * Parameters:
+ *      cache              I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      clientID           I/P    int32_t             the client ID from the MessageHeader of the request
+ *      get_reply_entry    O/P    int                 the cache entry of the client, or -1 on error (errno is set)
+ *******************************************************************************************************************************/
+static int get_reply_entry(ReplyQueueCache* cache, int32_t clientID)
+{
+    int freeEntry = -1;
+    for (unsigned int i = 0; i < REPLY_QUEUE_CACHE_SIZE; ++i)
+    {
+        if (cache->clientIDs[i] == clientID)
+        {
+            return i;
+        }
+        if (cache->clientIDs[i] == 0 && freeEntry == -1)
+        {
+            freeEntry = i;
+        }
+    }
+
+    char queueName[REPLY_QUEUE_NAME_SIZE];
+    snprintf(queueName, sizeof(queueName), REPLY_QUEUE_NAME_FORMAT, clientID);
+    const mqd_t queue = mq_open(queueName, O_WRONLY | O_NONBLOCK);
+    if (queue == -1)
+    {
+        return -1;
+    }
+
+    // evict the next entry in round-robin order if the cache is full
+    if (freeEntry == -1)
+    {
+        freeEntry = cache->nextEviction;
+        cache->nextEviction = (cache->nextEviction + 1) % REPLY_QUEUE_CACHE_SIZE;
+        close_reply_entry(cache, freeEntry);
+    }
+    cache->clientIDs[freeEntry] = clientID;
+    cache->queues[freeEntry] = queue;
+    return freeEntry;
+}
+
+/********************************************************************************************************************************
+ * static void release_reply_queue(ReplyQueueCache* cache, int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Wait for the outbox of the client to be sent first.
+ *
+ * Description: Utility method to close and forget the cached reply queue of a standalone client once its session has 
+ *      ended (CMD_EXIT), so that a later client reusing the same process ID gets its own queue opened by name. Should
+ *      replies to the client still be waiting in its outbox, the entry is released once they have been sent.
+ *
+ * Parameters:
+ *      cache       I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      clientID    I/P    int32_t             the client ID of the client whose session has ended
+ *******************************************************************************************************************************/
+static void release_reply_queue(ReplyQueueCache* cache, int32_t clientID)
+{
+    for (unsigned int i = 0; i < REPLY_QUEUE_CACHE_SIZE; ++i)
+    {
+        if (cache->clientIDs[i] == clientID)
+        {
+            if (cache->outboxes[i].count == 0)
+            {
+                close_reply_entry(cache, i);
+            }
+            else
+            {
+                cache->releasing[i] = true; // NOTE: released by flush_reply_entry()
+            }
+        }
+    }
+}
+
+/********************************************************************************************************************************
+ * static void hold_reply(ReplyQueueCache* cache, unsigned int entry, const char* message, size_t messageLength, 
+ *                        unsigned int priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hold the priority of the reply along with it.
+ * 10/14/2026   Kerby Kaska     Hold the reply in a buffer of the replyPool.
+ *
+ * Description: Utility method to hold a reply in the outbox of a cache entry until its reply queue has room. The reply
+ *      queue is watched by the reactor (EPOLLOUT) while its outbox is not empty. At most REPLY_OUTBOX_LIMIT replies are
+ *      held for each client, any more are dropped (the client has stopped reading its replies). The reply is copied into
+ *      a buffer of the replyPool, which the outbox owns until the reply is sent, and should every buffer of the pool be
+ *      in use, the reply is dropped too (the clients together are more than REPLY_POOL_DEPTHS queues behind).
+ *
+ * Parameters:
+ *      cache            I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      entry            I/P    unsigned int        the cache entry of the client
+ *      message          I/P    const char*         the framed reply message
+ *      messageLength    I/P    size_t              the number of bytes in message
+ *      priority         I/P    unsigned int        the message priority to send the reply with
+ *******************************************************************************************************************************/
+static void hold_reply(ReplyQueueCache* cache, unsigned int entry, const char* message, size_t messageLength, 
+                       unsigned int priority)
+{
+    Outbox& outbox = cache->outboxes[entry];
+    char* buffer = (outbox.count < REPLY_OUTBOX_LIMIT) ? acquire_buffer(&cache->replyPool) : NULL;
+    if (buffer == NULL)
+    {
+        std::cerr << "server::hold_reply() - dropped a reply to client " << cache->clientIDs[entry] << ".\n";
+        stats_add(&workerStats->repliesDropped, 1);
+        return;
+    }
+    if (outbox.count == 0)
+    {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLOUT;
+        event.data.u32 = REACTOR_REPLY_TAG | entry;
+        if (epoll_ctl(cache->epollDescriptor, EPOLL_CTL_ADD, cache->queues[entry], &event) == -1)
+        {
+            perror("server::epoll_ctl()");
+            release_buffer(&cache->replyPool, buffer);
+            return;
+        }
+    }
+    memcpy(buffer, message, messageLength);
+    HeldReply& reply = outbox.replies[(outbox.first + outbox.count) % REPLY_OUTBOX_LIMIT];
+    reply.message = buffer;
+    reply.messageLength = messageLength;
+    reply.priority = priority;
+    ++outbox.count;
+}
+
+/********************************************************************************************************************************
+ * static void flush_reply_entry(ReplyQueueCache* cache, unsigned int entry)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to send as many replies from the outbox of a cache entry as its reply queue has room for,
+ *      once the reactor reports it writable. Once the outbox is empty, the reply queue is no longer watched (and the
+ *      entry is released, if the session of the client has ended in the meantime).
+ *
+ * Parameters:
+ *      cache    I/P    ReplyQueueCache*    the reply queues already opened by this worker
+ *      entry    I/P    unsigned int        the cache entry of the client
+ *******************************************************************************************************************************/
+static void flush_reply_entry(ReplyQueueCache* cache, unsigned int entry)
+{
+    Outbox& outbox = cache->outboxes[entry];
+    while (outbox.count != 0)
+    {
+        const HeldReply& reply = outbox.replies[outbox.first];
+        if (mq_send(cache->queues[entry], reply.message, reply.messageLength, reply.priority) == -1)
+        {
+            if (errno == EAGAIN)
+            {
+                stats_add(&workerStats->queueFull, 1);
+                return; // still full, wait for the next EPOLLOUT
+            }
+            perror("server::mq_send()"); // the client has exited, drop the rest of its replies
+            stats_add(&workerStats->repliesDropped, outbox.count);
+            clear_outbox(cache, entry);
+            break;
+        }
+        stats_add(&workerStats->messagesOut, 1);
+        stats_add(&workerStats->bytesOut, reply.messageLength);
+        release_buffer(&cache->replyPool, reply.message);
+        outbox.first = (outbox.first + 1) % REPLY_OUTBOX_LIMIT;
+        --outbox.count;
+    }
+    epoll_ctl(cache->epollDescriptor, EPOLL_CTL_DEL, cache->queues[entry], NULL);
+    if (cache->releasing[entry])
+    {
+        close_reply_entry(cache, entry);
+    }
+}
+
+/********************************************************************************************************************************
+ * static int32_t connection_client_id(const Gateway* gateway, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to find the client ID the requests of a gateway connection are served under. The ID is
+ *      negative, so it never names the private reply queue of a standalone client (a process ID) or the forked client (0),
+ *      and it counts the generation of the slot as well, so a late reply (from the AsyncExecutor) to a connection which
+ *      has closed since is dropped rather than sent to the next connection of the slot.
+ *
+ * Parameters:
+ *      gateway                 I/P    const Gateway*    the gateway of the server worker
+ *      slot                    I/P    unsigned int      the slot of the connection
+ *      connection_client_id    O/P    int32_t           the client ID of the connection
+ *******************************************************************************************************************************/
+static int32_t connection_client_id(const Gateway* gateway, unsigned int slot)
+{
+    return -static_cast<int32_t>(1 + slot + GATEWAY_CONNECTIONS * gateway->connections[slot].generation);
+}
+
+/********************************************************************************************************************************
+ * static int find_connection(const Gateway* gateway, int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to look up the gateway connection a (negative) client ID was handed out to by
+ *      connection_client_id().
+ *
+ * Parameters:
+ *      gateway            I/P    const Gateway*    the gateway of the server worker
+ *      clientID           I/P    int32_t           the client ID from the MessageHeader of the request
+ *      find_connection    O/P    int               the slot of the connection, or -1 if it has closed since
+ *******************************************************************************************************************************/
+static int find_connection(const Gateway* gateway, int32_t clientID)
+{
+    const uint32_t number = static_cast<uint32_t>(-(clientID + 1));
+    const unsigned int slot = number % GATEWAY_CONNECTIONS;
+    const GatewayConnection& connection = gateway->connections[slot];
+    if (gateway->buffers.arena == NULL || connection.descriptor == -1 || 
+        connection.generation != number / GATEWAY_CONNECTIONS)
+    {
+        return -1;
+    }
+    return static_cast<int>(slot);
+}
+
+/********************************************************************************************************************************
+ * static void update_connection_events(Gateway* gateway, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to watch a gateway connection for the events it is waiting on: EPOLLIN while the client may
+ *      send more, and EPOLLOUT while output is pending. A connection whose output is over half full is no longer read,
+ *      so a client which sends commands faster than it reads the replies is held back by TCP flow control instead of
+ *      having its replies dropped. The events are only changed (with epoll_ctl()) when they differ.
+ *
+ * Parameters:
+ *      gateway    I/P    Gateway*        the gateway of the server worker
+ *      slot       I/P    unsigned int    the slot of the connection
+ *******************************************************************************************************************************/
+static void update_connection_events(Gateway* gateway, unsigned int slot)
+{
+    GatewayConnection* connection = &gateway->connections[slot];
+    uint32_t events = 0;
+    if (!connection->closing && connection->outputLength <= gateway->outputSize / 2)
+    {
+        events |= EPOLLIN;
+    }
+    if (connection->outputLength > 0)
+    {
+        events |= EPOLLOUT;
+    }
+    if (events == connection->events)
+    {
+        return;
+    }
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.u32 = REACTOR_CONNECTION_TAG | slot;
+    if (epoll_ctl(gateway->epollDescriptor, EPOLL_CTL_MOD, connection->descriptor, &event) == -1)
+    {
+        perror("server::epoll_ctl()");
+        return;
+    }
+    connection->events = events;
+}
+
+/********************************************************************************************************************************
+ * static void close_connection(Gateway* gateway, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to close a gateway connection, dropping its pending input and output, and to free its slot
+ *      (and its buffer) for the next connection. The generation of the slot moves on, so the client ID of the connection
+ *      is never handed out again while replies to it may still be on their way.
+ *
+ * Parameters:
+ *      gateway    I/P    Gateway*        the gateway of the server worker
+ *      slot       I/P    unsigned int    the slot of the connection
+ *******************************************************************************************************************************/
+static void close_connection(Gateway* gateway, unsigned int slot)
+{
+    GatewayConnection* connection = &gateway->connections[slot];
+    if (gateway->epollDescriptor != -1)
+    {
+        epoll_ctl(gateway->epollDescriptor, EPOLL_CTL_DEL, connection->descriptor, NULL);
+    }
+    close(connection->descriptor);
+    release_buffer(&gateway->buffers, connection->input);
+    connection->descriptor = -1;
+    connection->generation = (connection->generation + 1) % GATEWAY_GENERATIONS;
+    connection->events = 0;
+    connection->closing = false;
+    connection->input = NULL;
+    connection->inputLength = 0;
+    connection->output = NULL;
+    connection->outputStart = 0;
+    connection->outputLength = 0;
+}
+
+/********************************************************************************************************************************
+ * static void flush_connection(Gateway* gateway, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to send as much of the pending output of a gateway connection as the socket has room for,
+ *      without blocking. The rest is sent once the reactor reports the socket writable again. A closing connection is 
+ *      closed as soon as its output has been sent, and a connection whose client has gone is closed right away.
+ *
+ * Parameters:
+ *      gateway    I/P    Gateway*        the gateway of the server worker
+ *      slot       I/P    unsigned int    the slot of the connection
+ *******************************************************************************************************************************/
+static void flush_connection(Gateway* gateway, unsigned int slot)
+{
+    GatewayConnection* connection = &gateway->connections[slot];
+    while (connection->outputLength > 0)
+    {
+        const ssize_t sent = send(connection->descriptor, connection->output + connection->outputStart, 
+                                  connection->outputLength, MSG_NOSIGNAL);
+        if (sent == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break; // the client is behind, send the rest on the next EPOLLOUT
+            }
+            perror("server::send()"); // the client has gone, drop the rest of its replies
+            close_connection(gateway, slot);
+            return;
+        }
+        connection->outputStart += sent;
+        connection->outputLength -= sent;
+    }
+    if (connection->outputLength == 0)
+    {
+        connection->outputStart = 0;
+        if (connection->closing)
+        {
+            close_connection(gateway, slot);
+            return;
+        }
+    }
+    update_connection_events(gateway, slot);
+}
+
+/********************************************************************************************************************************
+ * static void send_gateway_reply(Gateway* gateway, int32_t clientID, const char* message, size_t messageLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to send a (batched) reply message to the gateway connection named by its client ID. The
+ *      reply is prefixed with its length and appended to the pending output of the connection, which is then flushed, so
+ *      replies are always sent in order. Should the connection have closed since, or its output have no room left (a
+ *      client which stopped reading), the reply is dropped.
+ *
+ * Parameters:
+ *      gateway          I/P    Gateway*       the gateway of the server worker
+ *      clientID         I/P    int32_t        the client ID of the connection (see connection_client_id())
+ *      message          I/P    const char*    the framed reply message
+ *      messageLength    I/P    size_t         the number of bytes in message
+ *******************************************************************************************************************************/
+static void send_gateway_reply(Gateway* gateway, int32_t clientID, const char* message, size_t messageLength)
+{
+    const int slot = find_connection(gateway, clientID);
+    if (slot == -1)
+    {
+        std::cerr << "server::send_gateway_reply() - dropped a reply to a closed connection.\n";
+        stats_add(&workerStats->repliesDropped, 1);
+        return;
+    }
+    GatewayConnection* connection = &gateway->connections[slot];
+    if (connection->outputStart + connection->outputLength + GATEWAY_LENGTH_SIZE + messageLength > gateway->outputSize)
+    {
+        memmove(connection->output, connection->output + connection->outputStart, connection->outputLength);
+        connection->outputStart = 0;
+    }
+    if (connection->outputLength + GATEWAY_LENGTH_SIZE + messageLength > gateway->outputSize)
+    {
+        std::cerr << "server::send_gateway_reply() - dropped a reply to a connection which is not reading.\n";
+        stats_add(&workerStats->queueFull, 1);
+        stats_add(&workerStats->repliesDropped, 1);
+        return;
+    }
+    const uint32_t length = static_cast<uint32_t>(messageLength);
+    char* end = connection->output + connection->outputStart + connection->outputLength;
+    memcpy(end, &length, GATEWAY_LENGTH_SIZE);
+    memcpy(end + GATEWAY_LENGTH_SIZE, message, messageLength);
+    connection->outputLength += GATEWAY_LENGTH_SIZE + messageLength;
+    stats_add(&workerStats->messagesOut, 1);
+    stats_add(&workerStats->bytesOut, messageLength);
+    flush_connection(gateway, slot);
+}
+
+/********************************************************************************************************************************
+ * static void end_connection_session(Gateway* gateway, int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to end the session of a gateway client (CMD_EXIT). Its connection is closed once the replies
+ *      still pending on it have been sent.
+ *
+ * Parameters:
+ *      gateway     I/P    Gateway*    the gateway of the server worker
+ *      clientID    I/P    int32_t     the client ID of the connection (see connection_client_id())
+ *******************************************************************************************************************************/
+static void end_connection_session(Gateway* gateway, int32_t clientID)
+{
+    const int slot = find_connection(gateway, clientID);
+    if (slot == -1)
+    {
+        return;
+    }
+    gateway->connections[slot].closing = true;
+    if (gateway->connections[slot].outputLength == 0)
+    {
+        close_connection(gateway, slot);
+    }
+    else
+    {
+        update_connection_events(gateway, slot);
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool has_gateway_output(const Gateway* gateway)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether any gateway connection of a server worker has output pending.
+ *
+ * Parameters:
+ *      gateway               I/P    const Gateway*    the gateway of the server worker
+ *      has_gateway_output    O/P    bool              true if any connection has output pending
+ *******************************************************************************************************************************/
+static bool has_gateway_output(const Gateway* gateway)
+{
+    for (unsigned int slot = 0; slot < GATEWAY_CONNECTIONS; ++slot)
+    {
+        if (gateway->connections[slot].descriptor != -1 && gateway->connections[slot].outputLength != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/********************************************************************************************************************************
+ * static void close_gateway(Gateway* gateway)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to close every gateway connection of a server worker, once its reactor stops.
+ *
+ * Parameters:
+ *      gateway    I/P    Gateway*    the gateway of the server worker
+ *******************************************************************************************************************************/
+static void close_gateway(Gateway* gateway)
+{
+    for (unsigned int slot = 0; slot < GATEWAY_CONNECTIONS; ++slot)
+    {
+        if (gateway->connections[slot].descriptor != -1)
+        {
+            close_connection(gateway, slot);
+        }
+    }
+}
+
+/********************************************************************************************************************************
+ * static unsigned int command_priority(uint16_t opcode)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to look up the message priority a command is sent with, which is the configured message
+ *      priority raised by the priority class of the command in COMMAND_TABLE.
+ *
+ * Parameters:
+ *      opcode              I/P    uint16_t        the opcode the command was framed as
+ *      command_priority    O/P    unsigned int    the message priority to send the command with
+ *******************************************************************************************************************************/
+static unsigned int command_priority(uint16_t opcode)
+{
+    return queueConfig.messagePriority + command_entry(opcode).priority;
+}
+
+/********************************************************************************************************************************
+ * static bool send_reply(ServerWorker* worker, int32_t clientID, unsigned int priority, const char* message, 
+ *                        size_t messageLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of run_server().
+ * 10/14/2026   Kerby Kaska     Replies to the forked client go through the selected transport.
+ * 10/14/2026   Kerby Kaska     Replies to a standalone client whose reply queue is full are held in its outbox.
+ * 10/14/2026   Kerby Kaska     Replies are sent with the priority of their request.
+ * 10/14/2026   Kerby Kaska     Replies to the forked client wait for room for at most REPLY_SEND_TIMEOUT milliseconds.
+ * 10/14/2026   Kerby Kaska     Replies to a gateway client go on its connection (see send_gateway_reply()).
+ *
+ * Description: Sends a (batched) reply message to the client it belongs to. Replies to the forked client go on the 
+ *      CHANNEL_RESPONSE of the selected transport, and an error sending them is fatal. Should the forked client not make 
+ *      room for a reply within REPLY_SEND_TIMEOUT milliseconds (it gave up on the request, or stopped reading), the reply 
+ *      is dropped instead, so a stuck client never freezes the worker. Replies to a standalone client go 
+ *      on its private reply queue, and errors sending them (the client has exited) only drop the reply, so one client 
+ *      can never stop the server for every other client. Should the reply queue be full (EAGAIN), the reply is held in 
+ *      the outbox of the client and sent by the reactor once there is room (see hold_reply()). Replies are never sent
+ *      ahead of the outbox, so every client still receives its replies in order. Replies to a gateway client (a negative
+ *      client ID) go on its connection the same way, behind the output still pending on it.
+ *
+ * Parameters:
+ *      worker           I/P    ServerWorker*    the server worker sending the reply
+ *      clientID         I/P    int32_t          the client ID from the MessageHeader of the request
+ *      priority         I/P    unsigned int     the message priority of the request, which the reply is sent with
+ *      message          I/P    const char*      the framed reply message
+ *      messageLength    I/P    size_t           the number of bytes in message
+ *      send_reply       O/P    bool             false if the server worker must stop, true otherwise
+ *******************************************************************************************************************************/
+static bool send_reply(ServerWorker* worker, int32_t clientID, unsigned int priority, const char* message, 
+                       size_t messageLength)
+{
+    // shared response channel (forked client)
+    if (clientID == 0)
+    {
+        if (worker->standalone) // there is no shared response channel to reply on
+        {
+            std::cerr << "server::send_reply() - dropped a reply without a client ID.\n";
+            return true;
+        }
+
+        // send the response back to the child (only the used bytes of the output buffer)
+        if (transport->send(CHANNEL_RESPONSE, message, messageLength, priority, REPLY_SEND_TIMEOUT) == -1) 
+        {
+            if (errno == ETIMEDOUT)
+            {
+                std::cerr << "server::send_reply() - dropped a reply the client did not make room for in time.\n";
+                stats_add(&workerStats->repliesDropped, 1);
+                return true;
+            }
+            perror("server::send()");
+            return false;
+        }
+        stats_add(&workerStats->messagesOut, 1);
+        stats_add(&workerStats->bytesOut, messageLength);
+        return true;
+    }
+
+    // gateway connection (ARG_LISTEN)
+    if (clientID < 0)
+    {
+        send_gateway_reply(&worker->gateway, clientID, message, messageLength);
+        return true;
+    }
+
+    // private reply queue (standalone client)
+    ReplyQueueCache* cache = &worker->replyQueues;
+    const int entry = get_reply_entry(cache, clientID);
+    if (entry == -1)
+    {
+        perror("server::get_reply_entry()"); // the client has exited already
+        stats_add(&workerStats->repliesDropped, 1);
+    }
+    else if (cache->outboxes[entry].count != 0)
+    {
+        hold_reply(cache, entry, message, messageLength, priority); // queue behind the replies already waiting
+    }
+    else if (mq_send(cache->queues[entry], message, messageLength, priority) == -1)
+    {
+        if (errno == EAGAIN)
+        {
+            stats_add(&workerStats->queueFull, 1);
+        }
+        if (errno == EAGAIN && cache->epollDescriptor != -1)
+        {
+            hold_reply(cache, entry, message, messageLength, priority); // the client is behind, send it once there is room
+        }
+        else
+        {
+            perror("server::mq_send()"); // the client has exited (or there is no reactor to wait on), drop the reply
+            stats_add(&workerStats->repliesDropped, 1);
+        }
+    }
+    else
+    {
+        stats_add(&workerStats->messagesOut, 1);
+        stats_add(&workerStats->bytesOut, messageLength);
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void stop_executor(AsyncExecutor* executor)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Stops the threads of an AsyncExecutor once every pending job has run, and waits for them to exit. The 
+ *      completed jobs are left for complete_jobs(), and the eventDescriptor is closed by it once none are left.
+ *
+ * Parameters:
+ *      executor    I/P    AsyncExecutor*    the executor to stop
+ *******************************************************************************************************************************/
+static void stop_executor(AsyncExecutor* executor)
+{
+    {
+        std::lock_guard<std::mutex> guard(executor->lock);
+        executor->stopping = true;
+    }
+    executor->jobReady.notify_all();
+    for (size_t i = 0; i < executor->threads.size(); ++i)
+    {
+        pthread_join(executor->threads[i], NULL);
+    }
+    executor->threads.clear();
+}
+
+/********************************************************************************************************************************
+ * static void close_executor(AsyncExecutor* executor)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Releases what start_executor() allocated for an AsyncExecutor whose threads have stopped (or never started):
+ *      its eventDescriptor, its job slots, and their buffers.
+ *
+ * Parameters:
+ *      executor    I/P    AsyncExecutor*    the executor to close
+ *******************************************************************************************************************************/
+static void close_executor(AsyncExecutor* executor)
+{
+    if (executor->eventDescriptor != -1)
+    {
+        close(executor->eventDescriptor);
+        executor->eventDescriptor = -1;
+    }
+    unmap_arena(executor->jobs, EXECUTOR_QUEUE_LIMIT * sizeof(AsyncJob));
+    executor->jobs = NULL;
+    close_pool(&executor->jobBuffers);
+}
+
+/********************************************************************************************************************************
+ * static void* run_executor_thread(void* argument)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Stamp the handler times of a traced job.
+ *
+ * Description: Thread of the AsyncExecutor. Runs the handler of each pending job, oldest first, into the buffer of the job,
+ *      and hands it back to the server loop through the completedJobs and the eventDescriptor. Exits once the executor is 
+ *      stopping and no job is pending.
+ *
+ * Parameters:
+ *      argument               I/P    void*    the AsyncExecutor
+ *      run_executor_thread    O/P    void*    always NULL
+ *******************************************************************************************************************************/
+static void* run_executor_thread(void* argument)
+{
+    AsyncExecutor* executor = static_cast<AsyncExecutor*>(argument);
+    const size_t replySize = executor->replySize;
+    std::unique_lock<std::mutex> guard(executor->lock);
+    while (true)
+    {
+        while (executor->pendingJobs.count == 0 && !executor->stopping)
+        {
+            executor->jobReady.wait(guard);
+        }
+        if (executor->pendingJobs.count == 0)
+        {
+            return NULL; // stopping, and every job has run
+        }
+        const unsigned int slot = pop_slot(&executor->pendingJobs);
+        guard.unlock();
+
+        // run the handler without the lock, the job (and its buffer) belongs to this thread until it is completed
+        AsyncJob& job = executor->jobs[slot];
+        char* result = job.buffer + sizeof(MessageHeader);
+        bool running = true; // NOTE: blocking commands cannot stop the server loop
+        const uint64_t startTime = monotonic_nanoseconds();
+        job.header.payloadLength = command_entry(job.opcode).handler(job.buffer + replySize, job.header.payloadLength,
+            result, replySize - sizeof(MessageHeader), &running);
+        job.handlerNanoseconds = monotonic_nanoseconds() - startTime;
+        if ((job.header.flags & FRAME_TRACED) != 0)
+        {
+            job.trace.handlerStart = startTime;
+            job.trace.handlerEnd = startTime + job.handlerNanoseconds;
+        }
+        memcpy(job.buffer, &job.header, sizeof(job.header));
+
+        guard.lock();
+        push_slot(&executor->completedJobs, slot);
+        const uint64_t increment = 1;
+        if (write(executor->eventDescriptor, &increment, sizeof(increment)) == -1 && errno != EAGAIN)
+        {
+            perror("executor::write()");
+        }
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool start_executor(AsyncExecutor* executor, size_t messageSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     The job slots and their buffers are preallocated in arenas, a cache line apart.
+ *
+ * Description: Allocates the job slots of an AsyncExecutor and their buffers (see BufferPool), creates its
+ *      eventDescriptor, and starts its threads. Every signal is blocked in the threads, so the signal handlers keep running
+ *      on the server loop. On error, an error message is printed to the console, and the threads started so far are
+ *      stopped again (the caller closes the executor, see close_executor()).
+ *
+ * Parameters:
+ *      executor          I/P    AsyncExecutor*    the executor to start
+ *      messageSize       I/P    size_t            the message size configured at startup (the size of each reply)
+ *      start_executor    O/P    bool              true on success, false on error
+ *******************************************************************************************************************************/
+static bool start_executor(AsyncExecutor* executor, size_t messageSize)
+{
+    executor->stopping = false;
+    executor->eventDescriptor = -1;
+    executor->pendingJobs.first = executor->pendingJobs.count = 0;
+    executor->completedJobs.first = executor->completedJobs.count = 0;
+    executor->replySize = messageSize;
+    executor->jobBuffers.arena = NULL;
+    executor->jobs = reinterpret_cast<AsyncJob*>(map_arena(EXECUTOR_QUEUE_LIMIT * sizeof(AsyncJob)));
+    if (executor->jobs == NULL || !open_pool(&executor->jobBuffers, EXECUTOR_QUEUE_LIMIT, 2 * messageSize))
+    {
+        return false;
+    }
+    executor->freeJobs.reserve(EXECUTOR_QUEUE_LIMIT);
+    for (unsigned int slot = 0; slot < EXECUTOR_QUEUE_LIMIT; ++slot)
+    {
+        executor->jobs[slot].buffer = acquire_buffer(&executor->jobBuffers); // NOTE: the reply, then the arguments
+        executor->freeJobs.push_back(slot);
+    }
+    executor->eventDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (executor->eventDescriptor == -1)
+    {
+        perror("executor::eventfd()");
+        return false;
+    }
+
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    int error = 0;
+    for (unsigned int i = 0; i < EXECUTOR_THREADS && error == 0; ++i)
+    {
+        pthread_t thread;
+        error = pthread_create(&thread, NULL, run_executor_thread, executor);
+        if (error == 0)
+        {
+            executor->threads.push_back(thread);
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    if (error != 0)
+    {
+        std::cerr << "executor::pthread_create() - " << strerror(error) << "\n";
+        stop_executor(executor);
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool submit_job(AsyncExecutor* executor, const MessageHeader& header, uint16_t opcode, const char* arguments,
+ *                        size_t argumentsLength, unsigned int priority, const TraceStamps& trace)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Keep the TraceStamps of a traced request.
+ *
+ * Description: Queues a blocking command on the AsyncExecutor, copying its header and arguments into a free job slot. 
+ *      Should all EXECUTOR_QUEUE_LIMIT slots be in use, nothing is queued, and the caller runs the command itself.
+ *
+ * Parameters:
+ *      executor           I/P    AsyncExecutor*          the executor to queue the command on
+ *      header             I/P    const MessageHeader&    the header of the request
+ *      opcode             I/P    uint16_t                the opcode of the command (resolved, if the request named it as text)
+ *      arguments          I/P    const char*             the arguments of the command (not NUL-terminated)
+ *      argumentsLength    I/P    size_t                  the number of bytes in arguments
+ *      priority           I/P    unsigned int            the message priority of the request
+ *      trace              I/P    const TraceStamps&      the timestamps of the request so far (if it is FRAME_TRACED)
+ *      submit_job         O/P    bool                    true if the command was queued, false if the executor is full
+ *******************************************************************************************************************************/
+static bool submit_job(AsyncExecutor* executor, const MessageHeader& header, uint16_t opcode, const char* arguments, 
+                       size_t argumentsLength, unsigned int priority, const TraceStamps& trace)
+{
+    {
+        std::lock_guard<std::mutex> guard(executor->lock);
+        if (executor->freeJobs.empty())
+        {
+            return false;
+        }
+        const unsigned int slot = executor->freeJobs.back();
+        executor->freeJobs.pop_back();
+
+        // NOTE: the slot is not visible to the threads until it is pending, so it can be filled in under the lock cheaply
+        AsyncJob& job = executor->jobs[slot];
+        job.header = header;
+        job.header.payloadLength = argumentsLength;
+        job.argumentsLength = argumentsLength;
+        job.opcode = opcode;
+        job.priority = priority;
+        job.trace = trace;
+        memcpy(job.buffer + executor->replySize, arguments, argumentsLength);
+        push_slot(&executor->pendingJobs, slot);
+    }
+    executor->jobReady.notify_one();
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool complete_jobs(ServerWorker* worker)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Append the TraceStamps of a traced job to its reply.
+ *
+ * Description: Sends the reply of every job the AsyncExecutor of the worker has completed (on the server loop, once its 
+ *      eventDescriptor is readable), and frees their slots. The handler time of every blocking command is counted in the
+ *      workerStats (there are few enough of them to time them all), and the response of an idempotent one is memoized.
+ *      The TraceStamps of a traced job are appended to its reply (once its response is memoized without them), unless
+ *      the reply would no longer fit in a message, in which case it is sent untraced.
+ *
+ * Parameters:
+ *      worker           I/P    ServerWorker*    the server worker owning the executor
+ *      complete_jobs    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool complete_jobs(ServerWorker* worker)
+{
+    AsyncExecutor* executor = worker->executor;
+    uint64_t completions;
+    if (read(executor->eventDescriptor, &completions, sizeof(completions)) == -1 && errno != EAGAIN)
+    {
+        perror("server::read()");
+        return false;
+    }
+
+    std::unique_lock<std::mutex> guard(executor->lock);
+    while (executor->completedJobs.count != 0)
+    {
+        const unsigned int slot = pop_slot(&executor->completedJobs);
+        guard.unlock();
+
+        const AsyncJob& job = executor->jobs[slot];
+        stats_add(&workerStats->handlerSamples[job.opcode], 1);
+        stats_add(&workerStats->handlerNanoseconds[job.opcode], job.handlerNanoseconds);
+        if (command_entry(job.opcode).memoizeSeconds != 0)
+        {
+            memoize_response(job.opcode, job.buffer + executor->replySize, job.argumentsLength,
+                             job.buffer + sizeof(job.header), job.header.payloadLength);
+        }
+        size_t replyLength = sizeof(job.header) + job.header.payloadLength;
+        if ((job.header.flags & FRAME_TRACED) != 0)
+        {
+            MessageHeader header = job.header;
+            if (replyLength + sizeof(job.trace) <= executor->replySize)
+            {
+                memcpy(job.buffer + replyLength, &job.trace, sizeof(job.trace));
+                header.payloadLength += sizeof(job.trace);
+                replyLength += sizeof(job.trace);
+            }
+            else
+            {
+                header.flags &= ~FRAME_TRACED;
+            }
+            memcpy(job.buffer, &header, sizeof(header));
+        }
+        if (!send_reply(worker, job.header.clientID, job.priority, job.buffer, replyLength))
+        {
+            return false;
+        }
+
+        guard.lock();
+        executor->freeJobs.push_back(slot);
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static long command_queue_depth(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of sample_queue_depth().
+ *
+ * Description: Utility method to read the number of messages waiting on the command channel. The message queue transport
+ *      asks mq_getattr(), and the shared memory transport reads the positions of its ring.
+ *
+ * Parameters:
+ *      command_queue_depth    O/P    long    the number of messages waiting on the command channel, or -1 on error
+ *******************************************************************************************************************************/
+static long command_queue_depth()
+{
+    if (transport == &MQUEUE_TRANSPORT)
+    {
+        mq_attr queueAttributes;
+        if (mq_getattr(commandQueue, &queueAttributes) == -1)
+        {
+            return -1;
+        }
+        return queueAttributes.mq_curmsgs;
+    }
+    SharedRing* ring = sharedRings[CHANNEL_COMMAND];
+    return static_cast<uint32_t>(ring->enqueuePosition.load(std::memory_order_relaxed) - 
+                                 ring->dequeuePosition.load(std::memory_order_relaxed));
+}
+
+/********************************************************************************************************************************
+ * static void sample_queue_depth(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to sample the number of messages waiting on the command channel into the workerStats
+ *      (see command_queue_depth()).
+ *******************************************************************************************************************************/
+static void sample_queue_depth()
+{
+    const long depth = command_queue_depth();
+    if (depth == -1)
+    {
+        return;
+    }
+    stats_add(&workerStats->depthSamples, 1);
+    stats_add(&workerStats->depthTotal, depth);
+    stats_max(&workerStats->depthMax, depth);
+}
+
+/********************************************************************************************************************************
+ * static void compress_reply(ServerWorker* worker, MessageHeader* header, char* result)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of serve_message().
+ *
+ * Description: Utility method to compress the result of a reply frame in place (see compress_payload()), if its client
+ *      accepts compressed replies and the result is at least COMPRESSION_MIN_LENGTH bytes, flagging the header
+ *      FRAME_COMPRESSED. A result which does not get smaller is left as it is.
+ *
+ * Parameters:
+ *      worker    I/P    ServerWorker*     the server worker sending the reply
+ *      header    I/O    MessageHeader*    the header of the reply frame, echoed from its request
+ *      result    I/O    char*             the result of the frame (header->payloadLength bytes, at most a message)
+ *******************************************************************************************************************************/
+static void compress_reply(ServerWorker* worker, MessageHeader* header, char* result)
+{
+    if ((header->flags & FRAME_ACCEPTS_COMPRESSED) == 0 || header->payloadLength < COMPRESSION_MIN_LENGTH)
+    {
+        return;
+    }
+    const size_t compressedLength = compress_payload(result, header->payloadLength, worker->compressionBuffer);
+    if (compressedLength > 0)
+    {
+        stats_add(&workerStats->repliesCompressed, 1);
+        stats_add(&workerStats->compressionSaved, header->payloadLength - compressedLength);
+        memcpy(result, worker->compressionBuffer, compressedLength);
+        header->payloadLength = compressedLength;
+        header->flags |= FRAME_COMPRESSED;
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool stream_reply(ServerWorker* worker, int32_t clientID, unsigned int priority, const MessageHeader& header,
+ *                          const char* result, size_t resultLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Sends a result too large for a message back to the client in chunks of a message each. Every chunk is a
+ *      reply frame of its own, with the header of the request echoed in front of it, numbered by its sequence (from 0),
+ *      and flagged FRAME_MORE but for the last one. Each chunk is compressed on its own (see compress_reply()), and sent as
+ *      soon as it is framed, so the client prints the first chunk while the rest are still on their way. The chunks of a
+ *      reply are sent in order on the same queue, so they arrive in order.
+ *
+ *      Should a chunk be dropped (the client did not make room for it, or has exited), the rest of the reply is of no use
+ *      to the client, so it is not sent either.
+ *
+ * Parameters:
+ *      worker           I/P    ServerWorker*           the server worker sending the reply
+ *      clientID         I/P    int32_t                 the client ID from the MessageHeader of the request
+ *      priority         I/P    unsigned int            the message priority of the request, which the reply is sent with
+ *      header           I/P    const MessageHeader&    the header of the request, echoed in front of every chunk
+ *      result           I/P    const char*             the result of the request
+ *      resultLength     I/P    size_t                  the number of bytes in result
+ *      stream_reply     O/P    bool                    false if the server worker must stop, true otherwise
+ *******************************************************************************************************************************/
+static bool stream_reply(ServerWorker* worker, int32_t clientID, unsigned int priority, const MessageHeader& header,
+                         const char* result, size_t resultLength)
+{
+    WorkerStats* stats = workerStats;
+    const size_t chunkSize = worker->messageSize - sizeof(header);
+    const uint64_t repliesDropped = stats->repliesDropped.load(std::memory_order_relaxed);
+    stats_add(&stats->repliesStreamed, 1);
+    MessageHeader chunk = header;
+    chunk.sequence = 0;
+    for (size_t offset = 0; offset < resultLength; offset += chunkSize)
+    {
+        chunk.flags = header.flags;
+        chunk.payloadLength = std::min(chunkSize, resultLength - offset);
+        if (offset + chunkSize < resultLength)
+        {
+            chunk.flags |= FRAME_MORE;
+        }
+        memcpy(worker->chunkBuffer + sizeof(chunk), result + offset, chunk.payloadLength);
+        compress_reply(worker, &chunk, worker->chunkBuffer + sizeof(chunk));
+        memcpy(worker->chunkBuffer, &chunk, sizeof(chunk));
+        if (!send_reply(worker, clientID, priority, worker->chunkBuffer, sizeof(chunk) + chunk.payloadLength))
+        {
+            return false;
+        }
+        stats_add(&stats->chunksStreamed, 1);
+        if (stats->repliesDropped.load(std::memory_order_relaxed) != repliesDropped)
+        {
+            break; // NOTE: the client cannot reassemble the reply without the chunk it missed
+        }
+        ++chunk.sequence;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool serve_message(ServerWorker* worker, ssize_t inputLength, unsigned int priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of run_server().
+ * 10/14/2026   Kerby Kaska     Reply with the priority of the message, and count it in the priorityCounters.
+ * 10/14/2026   Kerby Kaska     Count the message in the workerStats instead, and only time 1 in STATS_SAMPLE_INTERVAL.
+ * 10/14/2026   Kerby Kaska     Queue blocking commands on the AsyncExecutor of the worker.
+ * 10/14/2026   Kerby Kaska     Drop the requests whose deadline has passed, and shed the rest while the worker is shedding.
+ * 10/14/2026   Kerby Kaska     Stream the results too large for a message in chunks.
+ * 10/14/2026   Kerby Kaska     Answer memoized blocking commands on the server loop instead of queueing them.
+ * 10/14/2026   Kerby Kaska     CMD_EXIT from a gateway client closes its connection.
+ * 10/14/2026   Kerby Kaska     Stamp the TraceStamps of traced requests, and append them to their replies.
+ * 10/14/2026   Kerby Kaska     Class and shed a text command as the command it names (see find_command()).
+ *
+ * Description: Executes every framed command of a (batched) message received into the inputBuffer of the worker, and
+ *      sends their framed results back to the client with the MessageHeader of each command echoed back in front of it,
+ *      so the client can match the reply to its request. The results are packed into a single batched reply. Should the
+ *      results not fit in one message, the reply is sent as soon as it is full and the rest of the results continue in
+ *      the next one. A single result too large for a message (up to resultSize bytes) is streamed in chunks of a message
+ *      each instead (see stream_reply()), right after the replies batched ahead of it.
+ *
+ *      Requests from standalone clients carry a client ID which names their private reply queue (every frame of a batch 
+ *      comes from the same client). CMD_EXIT from the forked client stops the worker, while CMD_EXIT from a standalone 
+ *      client only ends the session of that client (and closes the connection of a gateway client, see serve_connection()).
+ *
+ *      Blocking commands are queued on the AsyncExecutor of the worker (if any) instead, which replies to each of them on 
+ *      its own once its handler has run, so the rest of the batch (and the next messages) never wait on them. A blocking
+ *      command whose response is still memoized is answered right away instead, like any other (see execute_command()).
+ *
+ *      A request whose deadline has passed is dropped unanswered, since its client has already given up on it. While the
+ *      worker is shedding (see drain_command_queue()), every request but CMD_EXIT and the PRIORITY_CONTROL commands is 
+ *      answered with MESSAGE_SHED (as text) instead of being executed, so the queue drains as fast as possible and the 
+ *      clients learn about the overload right away rather than once their deadline passes. A text command (OPCODE_TEXT)
+ *      is looked up first, so it is classed and shed as the command it names.
+ *
+ *      The replies are sent with the priority the message was received with. The message is counted in the workerStats
+ *      under the highest priority class of its commands, along with the time from receiving it to sending its last reply
+ *      (for 1 in STATS_SAMPLE_INTERVAL messages). 1 in STATS_DEPTH_INTERVAL messages samples the command queue depth.
+ *
+ *      The TraceStamps of a traced request (FRAME_TRACED) are stripped off the end of its payload before it is served,
+ *      stamped with the time the message started being served and around the handler, and appended to the end of its
+ *      result. A result which would no longer fit in a message with them (or is streamed) is sent untraced instead.
+ *
+ * Parameters:
+ *      worker           I/P    ServerWorker*    the server worker which received the message
+ *      inputLength      I/P    ssize_t          the number of bytes received into the inputBuffer
+ *      priority         I/P    unsigned int     the message priority the message was received with
+ *      serve_message    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool serve_message(ServerWorker* worker, ssize_t inputLength, unsigned int priority)
+{
+    // count the message, and time it (or sample the queue depth) once every so many messages
+    WorkerStats* stats = workerStats;
+    const uint64_t messageCount = stats->messagesIn.load(std::memory_order_relaxed);
+    stats->messagesIn.store(messageCount + 1, std::memory_order_relaxed);
+    stats_add(&stats->bytesIn, inputLength);
+    const bool timed = (messageCount & (STATS_SAMPLE_INTERVAL - 1)) == 0;
+    const uint64_t receiveTime = timed ? monotonic_nanoseconds() : 0;
+    if ((messageCount & (STATS_DEPTH_INTERVAL - 1)) == 0)
+    {
+        sample_queue_depth();
+    }
+
+    const size_t messageSize = worker->messageSize;
+    const char* inputBuffer = worker->inputBuffer;
+    char* outputBuffer = worker->outputBuffer;
+
+    // the first frame names the client that every reply of the batch goes back to
+    MessageHeader header;
+    if (!read_frame(inputBuffer, inputLength, 0, &header))
+    {
+        // there is no request ID to reply to, so the message can only be dropped
+        std::cerr << "server::read_frame() - dropped malformed message (" << inputLength << " bytes).\n";
+        return true;
+    }
+    const int32_t clientID = header.clientID;
+
+    bool sessionRunning = true;
+    uint64_t dequeueTime = receiveTime; // time the message started being served, once a traced request needs it
+    PriorityClass priorityClass = PRIORITY_BULK; // highest priority class of the commands in the message
+    size_t outputLength = 0; // number of bytes of the batched reply in outputBuffer
+    size_t inputOffset = 0; // offset of the next frame in inputBuffer
+    while (read_frame(inputBuffer, inputLength, inputOffset, &header))
+    {
+        const char* payload = inputBuffer + inputOffset + sizeof(header);
+        inputOffset += sizeof(header) + header.payloadLength;
+
+        // strip the timestamps off a traced request, they go back to the client at the end of its reply
+        TraceStamps trace;
+        if ((header.flags & FRAME_TRACED) != 0)
+        {
+            if (header.payloadLength < sizeof(trace))
+            {
+                header.flags &= ~FRAME_TRACED;
+            }
+            else
+            {
+                header.payloadLength -= sizeof(trace);
+                memcpy(&trace, payload + header.payloadLength, sizeof(trace));
+                if (dequeueTime == 0)
+                {
+                    dequeueTime = monotonic_nanoseconds();
+                }
+                trace.dequeue = dequeueTime;
+            }
+        }
+
+        // a text command is classed (and shed) as the command it names, not as OPCODE_TEXT
+        const bool named = header.opcode == OPCODE_TEXT;
+        const uint16_t opcode = named ? find_command(payload, header.payloadLength) : header.opcode;
+        const PriorityClass commandPriority = (opcode < commandCount) ? command_entry(opcode).priority : PRIORITY_BULK;
+        if (commandPriority > priorityClass)
+        {
+            priorityClass = commandPriority;
+        }
+
+        // the client has given up on a request past its deadline, so it is not worth an answer
+        if (deadline_passed(header.deadline))
+        {
+            stats_add(&stats->requestsExpired, 1);
+            continue;
+        }
+        const bool shed = worker->shedding && opcode != OPCODE_EXIT && commandPriority != PRIORITY_CONTROL;
+
+        // a blocking command is replied to by the executor once its handler has run (a text command has no arguments),
+        // unless its response is memoized
+        if (worker->executor != NULL && !shed)
+        {
+            const size_t argumentsLength = named ? 0 : header.payloadLength;
+            if (opcode != OPCODE_TEXT && opcode < commandCount && command_entry(opcode).blocking && 
+                (command_entry(opcode).memoizeSeconds == 0 || find_memoized(opcode, payload, argumentsLength) == NULL) &&
+                submit_job(worker->executor, header, opcode, payload, argumentsLength, priority, trace))
+            {
+                stats_add(&stats->requests[opcode], 1);
+                if (command_entry(opcode).memoizeSeconds != 0)
+                {
+                    stats_add(&stats->memoMisses, 1);
+                }
+                continue;
+            }
+        }
+
+        // the first result is executed straight into outputBuffer, later ones into resultBuffer in case they do not fit
+        char* result = (outputLength == 0) ? outputBuffer + sizeof(header) : worker->resultBuffer;
+        size_t resultLength;
+        const bool traced = (header.flags & FRAME_TRACED) != 0;
+        if (traced)
+        {
+            trace.handlerStart = monotonic_nanoseconds();
+        }
+        if (shed)
+        {
+            header.opcode = OPCODE_TEXT; // NOTE: tells the client the reply is text, whatever the request was
+            resultLength = copy_message(result, worker->resultSize, MESSAGE_SHED);
+            stats_add(&stats->requestsShed, 1);
+        }
+        else
+        {
+            resultLength = execute_command(header.opcode, payload, header.payloadLength, result, worker->resultSize,
+                &sessionRunning);
+        }
+
+        // hand the timestamps back at the end of the result, unless it no longer fits in a message with them
+        if (traced)
+        {
+            trace.handlerEnd = monotonic_nanoseconds();
+            if (sizeof(header) + resultLength + sizeof(trace) <= messageSize)
+            {
+                memcpy(result + resultLength, &trace, sizeof(trace));
+                resultLength += sizeof(trace);
+            }
+            else
+            {
+                header.flags &= ~FRAME_TRACED; // NOTE: a streamed result is never traced
+            }
+        }
+
+        // stream a result too large for a message in chunks, after the replies batched ahead of it
+        if (sizeof(header) + resultLength > messageSize)
+        {
+            if (outputLength > 0 && !send_reply(worker, clientID, priority, outputBuffer, outputLength))
+            {
+                return false;
+            }
+            outputLength = 0;
+            if (!stream_reply(worker, clientID, priority, header, result, resultLength))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // compress a large result for a client which can expand it, so more results fit in the batched reply
+        header.payloadLength = resultLength;
+        compress_reply(worker, &header, result);
+
+        // send the batched reply first if the result does not fit in it
+        if (outputLength + sizeof(header) + header.payloadLength > messageSize)
+        {
+            if (!send_reply(worker, clientID, priority, outputBuffer, outputLength))
+            {
+                return false;
+            }
+            outputLength = 0;
+        }
+
+        // echo the header back in front of the result, so the client can match the reply to its request
+        memcpy(outputBuffer + outputLength, &header, sizeof(header));
+        if (result != outputBuffer + outputLength + sizeof(header))
+        {
+            memcpy(outputBuffer + outputLength + sizeof(header), result, header.payloadLength);
+        }
+        outputLength += sizeof(header) + header.payloadLength;
+    }
+    if (inputOffset != static_cast<size_t>(inputLength))
+    {
+        std::cerr << "server::read_frame() - dropped a malformed frame at offset " << inputOffset << ".\n";
+    }
+
+    if (outputLength > 0 && !send_reply(worker, clientID, priority, outputBuffer, outputLength))
+    {
+        return false; // NOTE: nothing is left to send if every command of the message went to the executor
+    }
+
+    stats_add(&stats->priorityMessages[priorityClass], 1);
+    if (timed)
+    {
+        const uint64_t serviceNanoseconds = monotonic_nanoseconds() - receiveTime;
+        stats_add(&stats->prioritySamples[priorityClass], 1);
+        stats_add(&stats->priorityNanoseconds[priorityClass], serviceNanoseconds);
+        stats_max(&stats->priorityMaxNanoseconds[priorityClass], serviceNanoseconds);
+    }
+
+    if (!sessionRunning)
+    {
+        if (clientID == 0)
+        {
+            worker->running = false; // the forked client exits after CMD_EXIT, so the server does too
+        }
+        else if (clientID < 0)
+        {
+            end_connection_session(&worker->gateway, clientID);
+        }
+        else
+        {
+            release_reply_queue(&worker->replyQueues, clientID);
+        }
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void accept_connections(ServerWorker* worker)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Accepts every connection waiting on the listening gatewayDescriptor, once the reactor reports it readable,
+ *      into a free connection slot of the worker. Other workers of the pool accept from the same socket, so it may well 
+ *      be empty already. A connection is refused (closed right away) while every slot of the worker is in use. TCP 
+ *      connections are set TCP_NODELAY, since every reply is flushed as soon as it is sent.
+ *
+ * Parameters:
+ *      worker    I/P    ServerWorker*    the server worker accepting the connections
+ *******************************************************************************************************************************/
+static void accept_connections(ServerWorker* worker)
+{
+    Gateway* gateway = &worker->gateway;
+    while (true)
+    {
+        const int descriptor = accept4(gatewayDescriptor, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                perror("server::accept4()");
+            }
+            return;
+        }
+
+        unsigned int slot = 0;
+        while (slot < GATEWAY_CONNECTIONS && gateway->connections[slot].descriptor != -1)
+        {
+            ++slot;
+        }
+        if (slot == GATEWAY_CONNECTIONS)
+        {
+            std::cerr << "server::accept_connections() - refused a connection, all " << GATEWAY_CONNECTIONS 
+                      << " connections of the worker are in use.\n";
+            close(descriptor);
+            continue;
+        }
+        const int enabled = 1;
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled)); // NOTE: fails on a Unix socket
+
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = REACTOR_CONNECTION_TAG | slot;
+        if (epoll_ctl(gateway->epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) == -1)
+        {
+            perror("server::epoll_ctl()");
+            close(descriptor);
+            continue;
+        }
+        GatewayConnection* connection = &gateway->connections[slot];
+        connection->descriptor = descriptor;
+        connection->events = EPOLLIN;
+        connection->closing = false;
+        connection->input = acquire_buffer(&gateway->buffers); // NOTE: the pool holds a buffer for every slot
+        connection->inputLength = 0;
+        connection->output = connection->input + align_to_cache_line(gateway->inputSize);
+        connection->outputStart = 0;
+        connection->outputLength = 0;
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool serve_connection(ServerWorker* worker, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Serves every whole message received on a gateway connection, in order, like a message received from the
+ *      command queue (see serve_message()). Each message is copied into the inputBuffer of the worker, with the client 
+ *      ID of every frame replaced by that of the connection (see connection_client_id()), so the replies go back on it 
+ *      whatever the client put there. The message is served with the message priority of its highest priority command.
+ *      A partial message is kept until the rest of it arrives, and a message which could never fit in the message size
+ *      of the server closes the connection.
+ *
+ * Parameters:
+ *      worker              I/P    ServerWorker*    the server worker which received the messages
+ *      slot                I/P    unsigned int     the slot of the connection
+ *      serve_connection    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool serve_connection(ServerWorker* worker, unsigned int slot)
+{
+    Gateway* gateway = &worker->gateway;
+    GatewayConnection* connection = &gateway->connections[slot];
+    size_t offset = 0; // offset in the input of the next message
+    while (connection->descriptor != -1 && connection->inputLength - offset >= GATEWAY_LENGTH_SIZE)
+    {
+        uint32_t messageLength;
+        memcpy(&messageLength, connection->input + offset, GATEWAY_LENGTH_SIZE);
+        if (messageLength < sizeof(MessageHeader) || messageLength > worker->messageSize)
+        {
+            std::cerr << "server::serve_connection() - closed a connection which sent a malformed message (" 
+                      << messageLength << " bytes).\n";
+            close_connection(gateway, slot);
+            return true;
+        }
+        if (connection->inputLength - offset - GATEWAY_LENGTH_SIZE < messageLength)
+        {
+            break; // wait for the rest of the message
+        }
+        memcpy(worker->inputBuffer, connection->input + offset + GATEWAY_LENGTH_SIZE, messageLength);
+        offset += GATEWAY_LENGTH_SIZE + messageLength;
+
+        // every reply goes back on this connection, and is sent with the priority of the highest command
+        const int32_t clientID = connection_client_id(gateway, slot);
+        unsigned int priority = queueConfig.messagePriority;
+        MessageHeader header;
+        size_t frameOffset = 0;
+        while (read_frame(worker->inputBuffer, messageLength, frameOffset, &header))
+        {
+            memcpy(worker->inputBuffer + frameOffset + offsetof(MessageHeader, clientID), &clientID, sizeof(clientID));
+            if (header.opcode < commandCount)
+            {
+                priority = std::max(priority, command_priority(header.opcode));
+            }
+            frameOffset += sizeof(header) + header.payloadLength;
+        }
+        if (!serve_message(worker, messageLength, priority))
+        {
+            return false;
+        }
+    }
+    if (connection->descriptor != -1 && offset > 0)
+    {
+        memmove(connection->input, connection->input + offset, connection->inputLength - offset);
+        connection->inputLength -= offset;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool read_connection(ServerWorker* worker, unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Receives what a readable gateway connection has sent (a single recv(), so the other connections and the
+ *      command queue get their turn), and serves every whole message of it. Once the client has shut the connection 
+ *      down, it is closed as soon as the replies pending on it have been sent, and on error it is closed right away.
+ *
+ * Parameters:
+ *      worker             I/P    ServerWorker*    the server worker serving the connection
+ *      slot               I/P    unsigned int     the slot of the connection
+ *      read_connection    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool read_connection(ServerWorker* worker, unsigned int slot)
+{
+    Gateway* gateway = &worker->gateway;
+    GatewayConnection* connection = &gateway->connections[slot];
+    const ssize_t received = recv(connection->descriptor, connection->input + connection->inputLength, 
+                                  gateway->inputSize - connection->inputLength, 0);
+    if (received == -1)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            perror("server::recv()"); // the client has gone
+            close_connection(gateway, slot);
+        }
+        return true;
+    }
+    if (received == 0)
+    {
+        connection->closing = true; // NOTE: the client sends nothing more, but may still read its replies
+    }
+    connection->inputLength += received;
+    if (!serve_connection(worker, slot))
+    {
+        return false;
+    }
+    if (connection->descriptor != -1 && connection->closing && connection->outputLength == 0)
+    {
+        close_connection(gateway, slot);
+    }
+    else if (connection->descriptor != -1)
+    {
+        update_connection_events(gateway, slot);
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool handle_connection_event(ServerWorker* worker, unsigned int slot, uint32_t events)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Handles the epoll events the reactor reported for a gateway connection: pending output is flushed once
+ *      the connection is writable, and input is served once it is readable. A connection which reports an error or a
+ *      hang up without anything left to read is closed.
+ *
+ * Parameters:
+ *      worker                     I/P    ServerWorker*    the server worker serving the connection
+ *      slot                       I/P    unsigned int     the slot of the connection
+ *      events                     I/P    uint32_t         the epoll events reported for the connection
+ *      handle_connection_event    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool handle_connection_event(ServerWorker* worker, unsigned int slot, uint32_t events)
+{
+    Gateway* gateway = &worker->gateway;
+    if (slot >= GATEWAY_CONNECTIONS || gateway->connections[slot].descriptor == -1)
+    {
+        return true; // NOTE: closed by an earlier event of the same epoll_wait()
+    }
+    if (events & EPOLLOUT)
+    {
+        flush_connection(gateway, slot);
+    }
+    if (gateway->connections[slot].descriptor != -1 && (events & EPOLLIN))
+    {
+        return read_connection(worker, slot);
+    }
+    if (gateway->connections[slot].descriptor != -1 && (events & (EPOLLERR | EPOLLHUP)))
+    {
+        close_connection(gateway, slot);
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static ssize_t receive_now(mqd_t queue, char* buffer, size_t bufferSize, unsigned int* priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hand back the priority of the message.
+ *
+ * Description: Utility method to receive a message from a queue without ever blocking. An mq_timedreceive() with a 
+ *      timeout in the past never waits, whether or not the queue was opened O_NONBLOCK, so the flags of a queue shared
+ *      with the forked client never have to change. Like mq_receive(), the oldest message of the highest priority is 
+ *      received first.
+ *
+ * Parameters:
+ *      queue          I/P    mqd_t      the message queue to receive from
+ *      buffer         O/P    char*      the buffer to receive the message into
+ *      bufferSize     I/P    size_t           the size of buffer in bytes (at least the message size of the queue)
+ *      priority       O/P    unsigned int*    the priority the message was sent with
+ *      receive_now    O/P    ssize_t          the number of bytes received, or -1 on error (EAGAIN if the queue is empty)
+ *******************************************************************************************************************************/
+static ssize_t receive_now(mqd_t queue, char* buffer, size_t bufferSize, unsigned int* priority)
+{
+    static const timespec expired = { 0, 0 };
+    const ssize_t length = mq_timedreceive(queue, buffer, bufferSize, priority, &expired);
+    if (length == -1 && errno == ETIMEDOUT)
+    {
+        errno = EAGAIN;
+    }
+    return length;
+}
+
+/********************************************************************************************************************************
+ * static bool has_held_replies(const ReplyQueueCache* cache)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether a server worker holds any reply in the outbox of a client, waiting for 
+ *      room in its reply queue.
+ *
+ * Parameters:
+ *      cache               I/P    const ReplyQueueCache*    the reply queues opened by this worker
+ *      has_held_replies    O/P    bool                      true if any outbox holds a reply
+ *******************************************************************************************************************************/
+static bool has_held_replies(const ReplyQueueCache* cache)
+{
+    for (unsigned int entry = 0; entry < REPLY_QUEUE_CACHE_SIZE; ++entry)
+    {
+        if (cache->outboxes[entry].count != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/********************************************************************************************************************************
+ * static bool drain_command_queue(ServerWorker* worker, mqd_t queue)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Drain to the end once the worker stops, since CMD_EXIT overtakes earlier commands.
+ * 10/14/2026   Kerby Kaska     Drain to the end once the worker is draining as well.
+ * 10/14/2026   Kerby Kaska     Shed load while the queue is deeper than the shedThreshold.
+ *
+ * Description: Serves the messages waiting on a command queue the reactor reported readable, until the queue is empty
+ *      or REACTOR_DRAIN_LIMIT messages have been served (so the outboxes and other command queues get their turn). Other
+ *      workers of the pool drain the same queue, so it may well be empty already.
+ *
+ *      With a shedThreshold, the depth of the queue is read once (with mq_getattr()) before draining it, and every 
+ *      message is served with the worker shedding while the messages left of that backlog are still at or above the
+ *      shedThreshold. Messages arriving meanwhile are only counted by the next drain, so the backlog is an estimate 
+ *      which is cheap to keep, and a burst is shed at most REACTOR_DRAIN_LIMIT messages late.
+ *
+ *      Once CMD_EXIT from the forked client stops the worker, the queue is drained to the end regardless. CMD_EXIT is a
+ *      PRIORITY_CONTROL command, so it overtakes the commands the client sent before it, which must still be served.
+ *      The same goes for a worker which is draining before it stops (see run_reactor()).
+ *
+ * Parameters:
+ *      worker                 I/P    ServerWorker*    the server worker draining the queue
+ *      queue                  I/P    mqd_t            the command queue to drain
+ *      drain_command_queue    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool drain_command_queue(ServerWorker* worker, mqd_t queue)
+{
+    long backlog = 0; // number of messages waiting on the queue before it is drained
+    if (shedThreshold != 0)
+    {
+        mq_attr queueAttributes;
+        backlog = (mq_getattr(queue, &queueAttributes) == 0) ? queueAttributes.mq_curmsgs : 0;
+    }
+    for (unsigned int i = 0; i < REACTOR_DRAIN_LIMIT || !worker->running || worker->draining; ++i)
+    {
+        worker->shedding = shedThreshold != 0 && backlog - static_cast<long>(i) >= static_cast<long>(shedThreshold);
+        unsigned int priority;
+        const ssize_t inputLength = receive_now(queue, worker->inputBuffer, worker->messageSize, &priority);
+        if (inputLength == -1)
+        {
+            if (errno == EAGAIN || errno == EINTR) // drained (or interrupted by a SIGHUP, the reactor comes back)
+            {
+                return true;
+            }
+            perror("server::mq_timedreceive()");
+            return false;
+        }
+        if (!serve_message(worker, inputLength, priority))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool run_reactor(ServerWorker* worker, const mqd_t* queues, unsigned int queueCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Stop gracefully on SIGINT and SIGTERM, read from a signalfd.
+ * 10/14/2026   Kerby Kaska     Serve the gateway connections (ARG_LISTEN) next to the command queues.
+ *
+ * Description: Event loop of a server worker on the message queue transport. A single epoll instance watches every 
+ *      command queue for incoming messages (EPOLLIN), and the reply queue of every standalone client with replies held
+ *      in its outbox for room (EPOLLOUT). Readable command queues are drained without blocking, and writable reply 
+ *      queues are flushed, so a client which is slow to read its replies never stalls the replies to any other client.
+ *      The command queues are watched with EPOLLEXCLUSIVE, so a message wakes up one worker of the pool rather than all
+ *      of them. Loops until the worker stops (CMD_EXIT from the forked client).
+ *
+ *      With a gateway (ARG_LISTEN), the same epoll instance watches the listening socket shared by the pool (with 
+ *      EPOLLEXCLUSIVE as well), and every connection the worker accepted from it, whose messages go through the very same
+ *      serve_message() as those of the command queues (see serve_connection()).
+ *
+ *      The stop signals (see stop_signals()) are blocked by the supervisor before the worker is forked, and read from a 
+ *      signalfd watched by the same epoll instance, so a signal never interrupts a command. Once signalled, the worker 
+ *      of a standalone server drains: it serves every command left on the command queues (unless keepQueuedCommands), 
+ *      and keeps flushing the outboxes (and the gateway connections, accepting no new ones) until every held reply is
+ *      sent, and then exits. The supervisor kills it should that take longer than SHUTDOWN_DEADLINE seconds. The worker
+ *      of a forked client, whose client is stopped with it, exits right away.
+ *
+ * Parameters:
+ *      worker         I/P    ServerWorker*    the server worker running the reactor
+ *      queues         I/P    const mqd_t*     the command queues to serve
+ *      queueCount     I/P    unsigned int     the number of command queues in queues
+ *      run_reactor    O/P    bool             false if the server worker must stop on error, true otherwise
+ *******************************************************************************************************************************/
+static bool run_reactor(ServerWorker* worker, const mqd_t* queues, unsigned int queueCount)
+{
+    const int epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if (epollDescriptor == -1)
+    {
+        perror("server::epoll_create1()");
+        return false;
+    }
+    worker->replyQueues.epollDescriptor = epollDescriptor;
+    worker->gateway.epollDescriptor = epollDescriptor;
+
+    sigset_t stopSignals;
+    stop_signals(&stopSignals);
+    const int signalDescriptor = signalfd(-1, &stopSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalDescriptor == -1)
+    {
+        perror("server::signalfd()");
+        close(epollDescriptor);
+        return false;
+    }
+
+    for (unsigned int i = 0; i <= queueCount + 1; ++i)
+    {
+        // the command queues, followed by the stop signals, and the completions of the executor (if any)
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = (i < queueCount) ? EPOLLIN | EPOLLEXCLUSIVE : EPOLLIN;
+        event.data.u32 = (i < queueCount) ? i : (i == queueCount) ? REACTOR_SIGNAL_TAG : REACTOR_EXECUTOR_TAG;
+        const int descriptor = (i < queueCount) ? queues[i] : (i == queueCount) ? signalDescriptor : 
+            (worker->executor != NULL) ? worker->executor->eventDescriptor : -1;
+        if (descriptor != -1 && epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) == -1)
+        {
+            perror("server::epoll_ctl()");
+            close(signalDescriptor);
+            close(epollDescriptor);
+            return false;
+        }
+    }
+
+    // the listening socket of the gateway (if any), whose connections every worker of the pool takes turns accepting
+    bool listening = worker->gateway.buffers.arena != NULL;
+    if (listening)
+    {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.u32 = REACTOR_GATEWAY_TAG;
+        if (epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, gatewayDescriptor, &event) == -1)
+        {
+            perror("server::epoll_ctl()");
+            close(signalDescriptor);
+            close(epollDescriptor);
+            return false;
+        }
+    }
+
+    bool succeeded = true;
+    bool drained = false;
+    epoll_event events[REACTOR_MAX_EVENTS];
+    while (worker->running && succeeded && !drained)
+    {
+        const int eventCount = epoll_wait(epollDescriptor, events, REACTOR_MAX_EVENTS, -1);
+        if (eventCount == -1)
+        {
+            if (errno == EINTR) // interrupted by a SIGHUP (or an affinity signal)
+            {
+                continue;
+            }
+            perror("server::epoll_wait()");
+            succeeded = false;
+            break;
+        }
+
+        for (int i = 0; i < eventCount && worker->running && succeeded; ++i)
+        {
+            const uint32_t tag = events[i].data.u32;
+            if (tag & REACTOR_REPLY_TAG)
+            {
+                flush_reply_entry(&worker->replyQueues, tag & ~REACTOR_REPLY_TAG);
+            }
+            else if (tag & REACTOR_CONNECTION_TAG)
+            {
+                succeeded = handle_connection_event(worker, tag & ~REACTOR_CONNECTION_TAG, events[i].events);
+            }
+            else if (tag == REACTOR_GATEWAY_TAG)
+            {
+                accept_connections(worker);
+            }
+            else if (tag == REACTOR_EXECUTOR_TAG)
+            {
+                succeeded = complete_jobs(worker);
+            }
+            else if (tag == REACTOR_SIGNAL_TAG)
+            {
+                signalfd_siginfo signal;
+                while (read(signalDescriptor, &signal, sizeof(signal)) == sizeof(signal))
+                {
+                    worker->draining = true; // NOTE: a second signal changes nothing, the supervisor enforces the deadline
+                }
+            }
+            else
+            {
+                succeeded = drain_command_queue(worker, queues[tag]);
+            }
+        }
+
+        // once signalled, serve what is left (only a standalone server has clients left to serve), and then stop
+        if (worker->draining && succeeded)
+        {
+            const bool drainQueues = worker->standalone && !keepQueuedCommands;
+            for (unsigned int i = 0; i < queueCount && drainQueues && succeeded; ++i)
+            {
+                succeeded = drain_command_queue(worker, queues[i]);
+            }
+            if (listening)
+            {
+                epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, gatewayDescriptor, NULL); // NOTE: accept no new connections
+                listening = false;
+            }
+            drained = !worker->standalone || 
+                (!has_held_replies(&worker->replyQueues) && !has_gateway_output(&worker->gateway));
+        }
+    }
+
+    // the blocking commands still queued or running are replied to before the worker exits
+    if (worker->executor != NULL)
+    {
+        stop_executor(worker->executor);
+        succeeded = complete_jobs(worker) && succeeded;
+    }
+
+    close_gateway(&worker->gateway);
+    worker->gateway.epollDescriptor = -1;
+    worker->replyQueues.epollDescriptor = -1;
+    close(signalDescriptor);
+    close(epollDescriptor);
+    return succeeded;
+}
+
+/********************************************************************************************************************************
+ * static int run_server(bool standalone)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved the server loop out of main() and added the framed MessageHeader.
+ * 10/14/2026   Kerby Kaska     Now runs as one worker of the server pool. The supervisor waits on the client instead.
+ * 10/14/2026   Kerby Kaska     Reply on the private reply queue of standalone clients named by the MessageHeader.
+ * 10/14/2026   Kerby Kaska     Execute every frame of a batched message, and pack their results into batched replies.
+ * 10/14/2026   Kerby Kaska     Receive commands through the selected transport.
+ * 10/14/2026   Kerby Kaska     The buffers are sized from the queueConfig set at startup.
+ * 10/14/2026   Kerby Kaska     Moved the message handling to serve_message(). The message queue transport runs the reactor.
+ * 10/14/2026   Kerby Kaska     Start the AsyncExecutor for the reactor, if any command is blocking.
+ * 10/14/2026   Kerby Kaska     The reactor stops gracefully on the stop signals, the shared memory loop exits right away.
+ * 10/14/2026   Kerby Kaska     The shared memory loop sheds load by the depth of the ring, read for every message.
+ * 10/14/2026   Kerby Kaska     Carve the buffers out of a preallocated arena, and pool the held replies by the queue depth.
+ * 10/14/2026   Kerby Kaska     Pool the buffers of the gateway connections (ARG_LISTEN).
+ *
+ * Description: Server worker. Sets up the buffers of the worker, and runs its event loop until the CMD_EXIT command is 
+ *      received from the forked client. Every worker of the pool receives from the same commandQueue, so each command is 
+ *      handled by exactly one worker (see serve_message()). On the message queue transport, the worker runs the epoll 
+ *      reactor (see run_reactor()), with an AsyncExecutor for the blocking commands (if any). The shared memory rings have 
+ *      no descriptor to wait on, so on that transport the worker blocks on CHANNEL_COMMAND instead, runs the blocking 
+ *      commands itself, and is stopped right away by the stop signals (see signal_handler(), it only serves the forked 
+ *      client, which stops with it).
+ *
+ *      Every buffer is preallocated before the first message is received, so serving a message never allocates: the
+ *      working buffers are carved out of one arena, each starting on a cache line, and a standalone server pools the
+ *      buffers of the replies held for slow clients (REPLY_POOL_DEPTHS times the queue depth of them, see hold_reply()),
+ *      and with a gateway, the buffers of its GATEWAY_CONNECTIONS connections.
+ *
+ * Parameters:
+ *      standalone         I/P    bool     true if this worker belongs to a standalone server (which has no forked client)
+ *      run_server         O/P    int      EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_server(bool standalone)
+{
+    ServerWorker worker = ServerWorker();
+    worker.standalone = standalone;
+    worker.running = true;
+    worker.messageSize = queueConfig.messageSize;
+    worker.resultSize = std::max(STREAM_RESULT_SIZE, worker.messageSize - sizeof(MessageHeader));
+    // NOTE: allocated to match the message size configured at startup, every buffer on a cache line of its own
+    const size_t messageBytes = align_to_cache_line(worker.messageSize);
+    const size_t outputBytes = align_to_cache_line(sizeof(MessageHeader) + worker.resultSize);
+    worker.arenaSize = 3 * messageBytes + outputBytes + align_to_cache_line(worker.resultSize);
+    worker.arena = map_arena(worker.arenaSize);
+    if (worker.arena == NULL)
+    {
+        close_queues(); // NOTE: the supervisor reaps the rest of the pool and the client once a worker fails
+        return EXIT_FAILURE;
+    }
+    worker.inputBuffer = worker.arena;
+    worker.outputBuffer = worker.inputBuffer + messageBytes;
+    worker.resultBuffer = worker.outputBuffer + outputBytes;
+    worker.compressionBuffer = worker.resultBuffer + align_to_cache_line(worker.resultSize);
+    worker.chunkBuffer = worker.compressionBuffer + messageBytes;
+    worker.replyQueues.epollDescriptor = -1;
+    worker.executor = NULL;
+
+    // a standalone server holds the replies to its slow clients in a pool sized from the queue depth
+    const size_t heldReplies = std::min(std::max(REPLY_POOL_DEPTHS * queueConfig.maxMessages, REPLY_OUTBOX_LIMIT),
+                                        REPLY_QUEUE_CACHE_SIZE * REPLY_OUTBOX_LIMIT);
+    if (standalone && !open_pool(&worker.replyQueues.replyPool, heldReplies, worker.messageSize))
+    {
+        unmap_arena(worker.arena, worker.arenaSize);
+        close_queues(); // NOTE: the supervisor reaps the rest of the pool and the client once a worker fails
+        return EXIT_FAILURE;
+    }
+
+    // the gateway connections each hold a whole message of input, and a queue depth of replies and a streamed result
+    Gateway* gateway = &worker.gateway;
+    for (unsigned int slot = 0; slot < GATEWAY_CONNECTIONS; ++slot)
+    {
+        gateway->connections[slot].descriptor = -1;
+    }
+    gateway->epollDescriptor = -1;
+    const size_t framedMessage = GATEWAY_LENGTH_SIZE + worker.messageSize;
+    gateway->inputSize = framedMessage;
+    gateway->outputSize = (queueConfig.maxMessages + STREAM_RESULT_SIZE / (worker.messageSize - sizeof(MessageHeader)) + 
+                           1) * framedMessage;
+    if (standalone && gatewayDescriptor != -1 && 
+        !open_pool(&gateway->buffers, GATEWAY_CONNECTIONS, align_to_cache_line(gateway->inputSize) + gateway->outputSize))
+    {
+        close_pool(&worker.replyQueues.replyPool);
+        unmap_arena(worker.arena, worker.arenaSize);
+        close_queues(); // NOTE: the supervisor reaps the rest of the pool and the client once a worker fails
+        return EXIT_FAILURE;
+    }
+
+    bool succeeded = true;
+    if (transport == &MQUEUE_TRANSPORT)
+    {
+        // blocking commands run on an executor, whose completions the reactor waits on next to the command queue
+        AsyncExecutor executor;
+        if (has_blocking_command())
+        {
+            if (!start_executor(&executor, worker.messageSize))
+            {
+                close_executor(&executor);
+                close_queues(); // NOTE: the supervisor reaps the rest of the pool and the client once a worker fails
+                return EXIT_FAILURE;
+            }
+            worker.executor = &executor;
+        }
+        succeeded = run_reactor(&worker, &commandQueue, 1);
+        if (worker.executor != NULL)
+        {
+            close_executor(&executor);
+            worker.executor = NULL;
+        }
+    }
+    else
+    {
+        // NOTE: the rings have no descriptor to wait on, so the stop signals are taken by signal_handler() (forked only)
+        sigset_t stopSignals;
+        stop_signals(&stopSignals);
+        sigprocmask(SIG_UNBLOCK, &stopSignals, NULL);
+        while (worker.running && succeeded)
+        {
+            // wait for a command from the client (blocking) and then process it
+            unsigned int priority;
+            const ssize_t inputLength = transport->receive(CHANNEL_COMMAND, worker.inputBuffer, worker.messageSize, 
+                &priority, -1);
+            if (inputLength == -1 && errno == EINTR) // interrupted by a SIGHUP (or an affinity signal)
+            {
+                continue;
+            }
+            if (inputLength == -1) 
+            {
+                perror("server::receive()");
+                succeeded = false;
+                break;
+            }
+            worker.shedding = shedThreshold != 0 && command_queue_depth() + 1 >= static_cast<long>(shedThreshold);
+            succeeded = serve_message(&worker, inputLength, priority);
+        }
+    }
+
+    close_pool(&gateway->buffers);
+    close_pool(&worker.replyQueues.replyPool);
+    unmap_arena(worker.arena, worker.arenaSize);
+    if (!succeeded)
+    {
+        close_queues(); // NOTE: the supervisor reaps the rest of the pool and the client once a worker fails
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * static bool open_stats(unsigned int workerCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Maps the serverStats of the server pool into anonymous shared memory, so they are inherited by every
+ *      worker forked afterwards, with one zeroed WorkerStats for each worker. On error, an error message is printed to 
+ *      the console.
+ *
+ * Parameters:
+ *      workerCount    I/P    unsigned int    the number of worker processes in the server pool
+ *      open_stats     O/P    bool            true on success, false on error
+ *******************************************************************************************************************************/
+static bool open_stats(unsigned int workerCount)
+{
+    void* region = mmap(NULL, workerCount * sizeof(WorkerStats), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, 
+                        -1, 0);
+    if (region == MAP_FAILED)
+    {
+        perror("supervisor::mmap()");
+        return false;
+    }
+    serverStats = static_cast<WorkerStats*>(region);
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        new (&serverStats[i]) WorkerStats(); // NOTE: the mapping is zero-filled, this only starts the lifetime of the atomics
+    }
+    serverStatsCount = workerCount;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void write_stats_file(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Dumps the statistics report of the server pool (see format_stats()) to the ARG_STATS_FILE. The report is
+ *      written to a temporary file next to it first (STATS_FILE_SUFFIX), which then replaces the file in one rename(), so
+ *      a reader never sees a partial report. Errors are printed to the console, but never stop the server.
+ *******************************************************************************************************************************/
+static void write_stats_file()
+{
+    std::vector<char> report(STATS_REPORT_SIZE);
+    size_t reportLength = format_stats(&report[0], report.size());
+    report[reportLength++] = '\n';
+
+    const std::string temporaryPath = std::string(statsConfig.dumpPath) + STATS_FILE_SUFFIX;
+    const int file = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file == -1)
+    {
+        perror("supervisor::open()");
+        return;
+    }
+    const bool written = write(file, &report[0], reportLength) == static_cast<ssize_t>(reportLength);
+    if (!written)
+    {
+        perror("supervisor::write()");
+    }
+    close(file);
+    if (written && rename(temporaryPath.c_str(), statsConfig.dumpPath) == -1)
+    {
+        perror("supervisor::rename()");
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool parse_cpu_list(const char* text, int* cpus, unsigned int* cpuCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to parse a list of CPUs, made up of CPU numbers and inclusive ranges separated by commas
+ *      (such as "0,2-3"), the format of ARG_AFFINITY and of the CPU lists of sysfs. The CPUs are kept in the order they
+ *      are listed. A trailing newline (as read from sysfs) is accepted.
+ *
+ * Parameters:
+ *      text              I/P    const char*      the list of CPUs to parse
+ *      cpus              O/P    int*             the parsed CPUs (room for CPU_SETSIZE of them)
+ *      cpuCount          O/P    unsigned int*    the number of CPUs in cpus
+ *      parse_cpu_list    O/P    bool             true if text is a valid list of at most CPU_SETSIZE CPUs, false otherwise
+ *******************************************************************************************************************************/
+static bool parse_cpu_list(const char* text, int* cpus, unsigned int* cpuCount)
+{
+    *cpuCount = 0;
+    const char* position = text;
+    while (true)
+    {
+        char* end;
+        errno = 0;
+        const long first = strtol(position, &end, 10);
+        long last = first;
+        if (end == position || errno != 0 || *position == '-' || *position == '+')
+        {
+            return false;
+        }
+        if (*end == '-')
+        {
+            position = end + 1;
+            last = strtol(position, &end, 10);
+            if (end == position || errno != 0 || *position == '-' || *position == '+')
+            {
+                return false;
+            }
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE || *cpuCount + (last - first) >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+            cpus[(*cpuCount)++] = static_cast<int>(cpu);
+        }
+        if (*end == ',')
+        {
+            position = end + 1;
+            continue;
+        }
+        return *end == '\0' || (*end == '\n' && end[1] == '\0');
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool read_cpu_list(const char* path, int* cpus, unsigned int* cpuCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to read a list of CPUs (or of NUMA nodes, in the same format) from a sysfs file. No error
+ *      message is printed, since the topology is missing from sysfs on some systems (and in some containers).
+ *
+ * Parameters:
+ *      path             I/P    const char*      the path of the sysfs file
+ *      cpus             O/P    int*             the CPUs listed by the file (room for CPU_SETSIZE of them)
+ *      cpuCount         O/P    unsigned int*    the number of CPUs in cpus
+ *      read_cpu_list    O/P    bool             true if the file was read and parsed, false otherwise
+ *******************************************************************************************************************************/
+static bool read_cpu_list(const char* path, int* cpus, unsigned int* cpuCount)
+{
+    const int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor == -1)
+    {
+        return false;
+    }
+    char text[CPU_LIST_SIZE];
+    const ssize_t textLength = read(descriptor, text, sizeof(text) - 1);
+    close(descriptor);
+    if (textLength <= 0)
+    {
+        return false;
+    }
+    text[textLength] = '\0';
+    return parse_cpu_list(text, cpus, cpuCount);
+}
+
+/********************************************************************************************************************************
+ * static void add_placement_cpu(int cpu, cpu_set_t* placed)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to append a CPU to the placementCpus of AFFINITY_AUTO, unless it is already placed, or is
+ *      not one of the unpinnedCpus the program may run on.
+ *
+ * Parameters:
+ *      cpu       I/P    int           the CPU to append
+ *      placed    I/O    cpu_set_t*    the CPUs already in placementCpus
+ *******************************************************************************************************************************/
+static void add_placement_cpu(int cpu, cpu_set_t* placed)
+{
+    if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &unpinnedCpus) && !CPU_ISSET(cpu, placed))
+    {
+        CPU_SET(cpu, placed);
+        placementCpus[placementCount++] = cpu;
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool plan_placement(const char* affinity)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Plans the placementCpus of ARG_AFFINITY, before anything is forked. The unpinnedCpus are read first, so
+ *      every CPU of the placement can be checked against them (and so the benchmark can unpin the processes again).
+ *
+ *      An explicit list of CPUs is used as given. With AFFINITY_AUTO, the placement starts on the CPU this process runs
+ *      on, followed by the other hardware threads of the same core, and then by the other CPUs of the same NUMA node, as
+ *      listed by sysfs. Since the forked client is pinned to the first CPU, and the first server worker to the second,
+ *      each request and its reply stay on the same core, or at least on the same node (and its memory), instead of
+ *      crossing the interconnect. A node with a single CPU keeps every process on it. Should sysfs not describe the
+ *      topology, every CPU the program may run on is used, starting with the current one.
+ *
+ * Parameters:
+ *      affinity          I/P    const char*    the value of ARG_AFFINITY (a list of CPUs, or AFFINITY_AUTO)
+ *      plan_placement    O/P    bool           true if the placement was planned, false on error
+ *******************************************************************************************************************************/
+static bool plan_placement(const char* affinity)
+{
+    if (sched_getaffinity(0, sizeof(unpinnedCpus), &unpinnedCpus) == -1)
+    {
+        perror("affinity::sched_getaffinity()");
+        return false;
+    }
+    if (strcmp(affinity, AFFINITY_AUTO) != 0)
+    {
+        parse_cpu_list(affinity, placementCpus, &placementCount); // NOTE: already checked by parse_arguments()
+        for (unsigned int i = 0; i < placementCount; ++i)
+        {
+            if (!CPU_ISSET(placementCpus[i], &unpinnedCpus))
+            {
+                std::cerr << "affinity::sched_getaffinity() - CPU " << placementCpus[i]
+                          << " is not available to this process.\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the current CPU, then the other hardware threads of its core, then the rest of its NUMA node
+    cpu_set_t placed;
+    CPU_ZERO(&placed);
+    const int currentCpu = sched_getcpu();
+    add_placement_cpu(currentCpu, &placed);
+    char path[128];
+    int cpus[CPU_SETSIZE];
+    unsigned int cpuCount;
+    snprintf(path, sizeof(path), CPU_SIBLINGS_FORMAT, currentCpu);
+    if (read_cpu_list(path, cpus, &cpuCount))
+    {
+        for (unsigned int i = 0; i < cpuCount; ++i)
+        {
+            add_placement_cpu(cpus[i], &placed);
+        }
+    }
+    bool foundNode = false;
+    int nodes[CPU_SETSIZE];
+    unsigned int nodeCount;
+    if (read_cpu_list(NUMA_NODES_PATH, nodes, &nodeCount))
+    {
+        for (unsigned int node = 0; node < nodeCount && !foundNode; ++node)
+        {
+            snprintf(path, sizeof(path), NUMA_NODE_CPUS_FORMAT, nodes[node]);
+            if (!read_cpu_list(path, cpus, &cpuCount) || std::find(cpus, cpus + cpuCount, currentCpu) == cpus + cpuCount)
+            {
+                continue;
+            }
+            foundNode = true;
+            for (unsigned int i = 0; i < cpuCount; ++i)
+            {
+                add_placement_cpu(cpus[i], &placed);
+            }
+        }
+    }
+    if (!foundNode)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            add_placement_cpu(cpu, &placed);
+        }
+    }
+    return placementCount > 0;
+}
+
+/********************************************************************************************************************************
+ * static bool place_process(unsigned int slot)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to pin the calling process to its CPU of the placement (see plan_placement()): the CPU at
+ *      the given slot of placementCpus, wrapping around once every CPU has a process. The forked client takes slot 0,
+ *      and the server workers the slots after it. The CPU is kept in pinnedCpus, so affinity_handler() can pin the
+ *      process back to it. Without a placement, nothing is done.
+ *
+ * Parameters:
+ *      slot             I/P    unsigned int    the slot of the process in the placement
+ *      place_process    O/P    bool            true if the process was pinned (or there is no placement), false on error
+ *******************************************************************************************************************************/
+static bool place_process(unsigned int slot)
+{
+    if (placementCount == 0)
+    {
+        return true;
+    }
+    CPU_ZERO(&pinnedCpus);
+    CPU_SET(placementCpus[slot % placementCount], &pinnedCpus);
+    if (sched_setaffinity(0, sizeof(pinnedCpus), &pinnedCpus) == -1)
+    {
+        perror("affinity::sched_setaffinity()");
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static int run_supervisor(pid_t clientProcessID, unsigned int workerCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Keep track of the pool in poolProcessIDs for signal_handler(). Added the client-less mode.
+ * 10/14/2026   Kerby Kaska     Map the serverStats of the pool, and dump them to the ARG_STATS_FILE periodically.
+ * 10/14/2026   Kerby Kaska     Wait on a signalfd instead of waitpid(), and stop the pool gracefully on the stop signals.
+ * 10/14/2026   Kerby Kaska     Pin every worker to its CPU of the placement, and forward the affinity signals to the pool.
+ * 10/14/2026   Kerby Kaska     Every worker dies with the supervisor (PR_SET_PDEATHSIG), even when it is killed outright.
+ *
+ * Description: Forks the server pool of workerCount worker processes, which all receive from the same commandQueue, and
+ *      supervises the pool and the client process until the client exits. Once the client exits (normally after the
+ *      CMD_EXIT command, or when its input ends), the remaining workers are still blocked waiting on the commandQueue, so
+ *      they are killed and reaped with kill_pool(). Should any worker fail, the client and the rest of the pool are killed
+ *      and reaped as well, so no zombies are left behind.
+ *
+ *      Without a client process (the standalone server), the pool is supervised until a worker fails, or until it is
+ *      signalled to stop.
+ *
+ *      Every signal of the supervisor is blocked and read from a signalfd (SIGCHLD, SIGHUP, SIGALRM, and the stop 
+ *      signals), so it is handled in this loop rather than in a signal handler, and can never be lost between two checks.
+ *      Every worker asks for a SIGTERM once the supervisor dies, so it drains and exits (see run_reactor()) instead of
+ *      serving an orphaned queue, should the supervisor be killed outright (SIGKILL) before it could stop the pool. The
+ *      worker then unpublishes the queue the supervisor published (the supervisor can no longer do it).
+ *      Once signalled to stop, the supervisor stops accepting input: the command queue is unpublished (unless it is 
+ *      persistent), so no new client can attach (a restarted server can publish a new one right away), and the forked 
+ *      client is stopped. Every worker is then signalled to drain (see run_reactor()), and is given SHUTDOWN_DEADLINE 
+ *      seconds to serve the commands left queued and to flush its held replies, before the rest of the pool is killed 
+ *      and reaped with kill_pool(). A second stop signal kills the pool right away.
+ *
+ *      With ARG_STATS_FILE, a SIGALRM timer wakes up the supervisor every ARG_STATS_INTERVAL seconds to dump the
+ *      serverStats, and once more when the pool has exited.
+ *
+ *      With ARG_AFFINITY, every worker pins itself to its CPU of the placement (the slots after the one of the forked
+ *      client, see place_process()) before it sets up its buffers, so they are allocated on its NUMA node. The affinity
+ *      signals of the benchmark client are forwarded to every worker, and acknowledged to the client once they are sent
+ *      (a worker handles a pending signal before it serves anything else).
+ *
+ * Parameters:
+ *      clientProcessID    I/P    pid_t           the process ID of the client process, or 0 for the standalone server
+ *      workerCount        I/P    unsigned int    the number of worker processes in the server pool
+ *      run_supervisor     O/P    int             EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_supervisor(pid_t clientProcessID, unsigned int workerCount)
+{
+    // SIGHUP invalidates the cached responses of every worker (only the server processes handle it, not the client)
+    signal(SIGHUP, hangup_handler);
+
+    // every signal of the supervisor is read from a signalfd, blocked before any worker is forked
+    sigset_t supervisedSignals;
+    sigset_t previousSignals;
+    stop_signals(&supervisedSignals);
+    sigaddset(&supervisedSignals, SIGCHLD);
+    sigaddset(&supervisedSignals, SIGHUP);
+    sigaddset(&supervisedSignals, SIGALRM);
+    sigaddset(&supervisedSignals, AFFINITY_PIN_SIGNAL);
+    sigaddset(&supervisedSignals, AFFINITY_UNPIN_SIGNAL);
+    sigprocmask(SIG_BLOCK, &supervisedSignals, &previousSignals);
+    const int signalDescriptor = signalfd(-1, &supervisedSignals, SFD_CLOEXEC);
+
+    const bool hasClient = clientProcessID > 0;
+    if (signalDescriptor == -1 || !open_stats(workerCount))
+    {
+        if (signalDescriptor == -1)
+        {
+            perror("supervisor::signalfd()");
+        }
+        if (hasClient)
+        {
+            kill_process(clientProcessID);
+        }
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    supervisorProcessID = getpid(); // NOTE: the same process which forked the client, if any
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        const pid_t workerID = fork();
+        if (workerID == 0) // server worker process
+        {
+            // NOTE: the supervisor may have died before the death signal was requested, so its pid is checked after it
+            if (prctl(PR_SET_PDEATHSIG, SIGTERM) == -1 || getppid() != supervisorProcessID)
+            {
+                _exit(EXIT_FAILURE);
+            }
+
+            // the worker handles SIGHUP itself, and reads the stop signals in its own loop (see run_reactor())
+            sigset_t workerSignals = previousSignals;
+            sigaddset(&workerSignals, SIGINT);
+            sigaddset(&workerSignals, SIGTERM);
+            sigprocmask(SIG_SETMASK, &workerSignals, NULL);
+            close(signalDescriptor);
+
+            // the pool and the published queue belong to the supervisor, so this worker must never clean them up
+            char publishedQueueName[sizeof(ownedQueueName)];
+            snprintf(publishedQueueName, sizeof(publishedQueueName), "%s", ownedQueueName);
+            poolSize = 0;
+            ownedQueueName[0] = '\0';
+            workerStats = &serverStats[i];
+            if (!place_process(hasClient ? i + 1 : i))
+            {
+                exit(EXIT_FAILURE);
+            }
+            if (placementCount > 0)
+            {
+                sigset_t affinitySignals;
+                sigemptyset(&affinitySignals);
+                sigaddset(&affinitySignals, AFFINITY_PIN_SIGNAL);
+                sigaddset(&affinitySignals, AFFINITY_UNPIN_SIGNAL);
+                signal(AFFINITY_PIN_SIGNAL, affinity_handler);
+                signal(AFFINITY_UNPIN_SIGNAL, affinity_handler);
+                sigprocmask(SIG_UNBLOCK, &affinitySignals, NULL);
+            }
+            const int workerStatus = (run_server(clientProcessID == 0) == EXIT_SUCCESS) ? close_queues() : EXIT_FAILURE;
+
+            // NOTE: an orphaned worker unpublishes the queue of its dead supervisor (the first one to get there does)
+            if (getppid() != supervisorProcessID && publishedQueueName[0] != '\0' && 
+                mq_unlink(publishedQueueName) == -1 && errno != ENOENT)
+            {
+                perror("worker::mq_unlink()");
+            }
+            exit(workerStatus);
+        }
+        if (workerID == -1)
+        {
+            perror("supervisor::fork()");
+            kill_pool();
+            if (hasClient)
+            {
+                kill_process(clientProcessID);
+            }
+            close(signalDescriptor);
+            close_queues();
+            return EXIT_FAILURE;
+        }
+        poolProcessIDs[poolSize++] = workerID;
+    }
+
+    // dump the statistics periodically, the SIGALRM is read from the signalfd (the workers do not inherit the timer)
+    if (statsConfig.dumpPath != NULL)
+    {
+        itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        timer.it_interval.tv_sec = statsConfig.dumpInterval;
+        timer.it_value.tv_sec = statsConfig.dumpInterval;
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+
+    // wait for the client to exit, or for a worker to fail (or, without a client, for the whole pool to exit), and once 
+    // the pool is draining, for every process to exit
+    bool clientRunning = hasClient;
+    bool failed = false;
+    bool draining = false;
+    bool reapDue = true; // NOTE: a process may have exited before SIGCHLD was blocked
+    uint64_t drainDeadline = 0;
+    while ((clientRunning || (poolSize > 0 && (draining || !hasClient))) && !failed)
+    {
+        // reap every process which has exited
+        int status;
+        pid_t processID;
+        while (reapDue && !failed && (processID = waitpid(-1, &status, WNOHANG)) > 0)
+        {
+            const bool succeeded = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+            if (processID == clientProcessID)
+            {
+                clientRunning = false;
+                failed = !succeeded;
+                continue;
+            }
+
+            // forget about the reaped worker, so kill_pool() does not try to kill it again
+            for (unsigned int i = 0; i < poolSize; ++i)
+            {
+                if (poolProcessIDs[i] == processID)
+                {
+                    poolProcessIDs[i] = poolProcessIDs[--poolSize];
+                    break;
+                }
+            }
+            if (!succeeded)
+            {
+                std::cerr << "supervisor::waitpid() - server worker (" << processID << ") failed.\n";
+                failed = true;
+            }
+        }
+        if (reapDue)
+        {
+            reapDue = false;
+            continue; // check the loop condition again
+        }
+
+        // wait for the next signal (no longer than the deadline, once the pool is draining)
+        int timeout = -1;
+        if (draining)
+        {
+            const uint64_t now = monotonic_nanoseconds();
+            if (now >= drainDeadline)
+            {
+                std::cerr << "supervisor::poll() - the server pool did not drain within " << SHUTDOWN_DEADLINE 
+                          << " seconds.\n";
+                break;
+            }
+            timeout = static_cast<int>((drainDeadline - now + 999999) / 1000000);
+        }
+        pollfd signalEvent = { signalDescriptor, POLLIN, 0 };
+        const int ready = poll(&signalEvent, 1, timeout);
+        if (ready == -1 && errno != EINTR)
+        {
+            perror("supervisor::poll()");
+            failed = true;
+            break;
+        }
+        signalfd_siginfo signal;
+        if (ready <= 0 || read(signalDescriptor, &signal, sizeof(signal)) != sizeof(signal))
+        {
+            continue; // the deadline is checked above
+        }
+
+        if (signal.ssi_signo == SIGCHLD)
+        {
+            reapDue = true;
+        }
+        else if (signal.ssi_signo == SIGALRM)
+        {
+            write_stats_file();
+        }
+        else if (signal.ssi_signo == SIGHUP)
+        {
+            for (unsigned int i = 0; i < poolSize; ++i)
+            {
+                kill(poolProcessIDs[i], SIGHUP);
+            }
+        }
+        else if (signal.ssi_signo == static_cast<uint32_t>(AFFINITY_PIN_SIGNAL) ||
+                 signal.ssi_signo == static_cast<uint32_t>(AFFINITY_UNPIN_SIGNAL))
+        {
+            // (un)pin the pool along with the benchmark client, and let it know once every worker has been signalled
+            for (unsigned int i = 0; placementCount > 0 && i < poolSize; ++i)
+            {
+                kill(poolProcessIDs[i], signal.ssi_signo);
+            }
+            if (clientRunning && static_cast<pid_t>(signal.ssi_pid) == clientProcessID)
+            {
+                kill(clientProcessID, AFFINITY_PIN_SIGNAL);
+            }
+        }
+        else if (draining) // a second stop signal, stop right away
+        {
+            break;
+        }
+        else
+        {
+            // stop accepting input, and let the pool drain what is left
+            draining = true;
+            drainDeadline = monotonic_nanoseconds() + SHUTDOWN_DEADLINE * 1000000000ull;
+            if (!hasClient)
+            {
+                std::cout << MESSAGE_STOPPING << std::endl;
+            }
+            if (ownedQueueName[0] != '\0')
+            {
+                if (mq_unlink(ownedQueueName) == -1)
+                {
+                    perror("supervisor::mq_unlink()");
+                }
+                ownedQueueName[0] = '\0';
+            }
+            if (clientRunning)
+            {
+                kill(clientProcessID, SIGTERM);
+            }
+            for (unsigned int i = 0; i < poolSize; ++i)
+            {
+                kill(poolProcessIDs[i], SIGTERM);
+            }
+        }
+    }
+    close(signalDescriptor);
+
+    // stop everything that is still running (workers never exit on their own after a client has finished)
+    if (clientRunning)
+    {
+        kill_process(clientProcessID);
+    }
+    kill_pool();
+    if (statsConfig.dumpPath != NULL)
+    {
+        write_stats_file(); // the final statistics of the pool
+    }
+
+    if (failed)
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    return close_queues();
+}
+
+/********************************************************************************************************************************
+ * static size_t frame_command(const char* input, size_t inputLength, uint32_t requestID, int32_t clientID, 
+ *                             uint32_t deadline, char* buffer, size_t bufferSize, bool truncate, uint16_t* opcode)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Known commands are framed as their opcode, so the server never has to look them up by name.
+ * 10/14/2026   Kerby Kaska     Added the payload length to the frame, and the option to refuse frames that do not fit.
+ * 10/14/2026   Kerby Kaska     Take the command as a pointer and length, so it can be framed straight out of an InputReader.
+ * 10/14/2026   Kerby Kaska     Request the system Unix name in binary, with the fields named after it (if any).
+ * 10/14/2026   Kerby Kaska     Added the deadline of the request.
+ * 10/14/2026   Kerby Kaska     Trace 1 in traceInterval requests.
+ * 10/14/2026   Kerby Kaska     Moved the framing to frame_request(), shared with libpgm1.
+ *
+ * Description: Utility method to frame a line of user input as a command (see frame_request()), looked up through the
+ *      commandIndex, so the commands of plugins are framed as their opcode as well. Replies are flagged 
+ *      FRAME_ACCEPTS_COMPRESSED while the client accepts them compressed (ARG_COMPRESS), and while the client traces
+ *      (ARG_TRACE), 1 in traceInterval requests (by request ID) is flagged FRAME_TRACED.
+ *
+ * Parameters:
+ *      input            I/P    const char*           the command entered by the user (not NUL-terminated)
+ *      inputLength      I/P    size_t                the number of bytes in input
+ *      requestID        I/P    uint32_t              the request ID the server will echo back in its reply
+ *      clientID         I/P    int32_t               the client ID naming the reply queue (0 for the shared responseQueue)
+ *      deadline         I/P    uint32_t              the deadline of the request (see request_deadline()), or 0 for none
+ *      buffer           O/P    char*                 the buffer to frame the command into
+ *      bufferSize       I/P    size_t                the size of buffer in bytes
+ *      truncate         I/P    bool                  true to truncate a command that does not fit, false to refuse it
+ *      opcode           O/P    uint16_t*             the opcode the command was framed as
+ *      frame_command    O/P    size_t                the total number of bytes of the frame, or 0 if it did not fit
+ *******************************************************************************************************************************/
+static size_t frame_command(const char* input, size_t inputLength, uint32_t requestID, int32_t clientID, 
+                            uint32_t deadline, char* buffer, size_t bufferSize, bool truncate, uint16_t* opcode)
+{
+    uint16_t flags = compressReplies ? FRAME_ACCEPTS_COMPRESSED : 0;
+    if (traceInterval != 0 && requestID % traceInterval == 0)
+    {
+        flags |= FRAME_TRACED;
+    }
+    return frame_request(input, inputLength, find_command(input, inputLength), requestID, clientID, deadline, flags, 
+                         buffer, bufferSize, truncate, opcode);
+}
+
+/********************************************************************************************************************************
+ * static bool send_command(const char* message, size_t messageLength, unsigned int priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Send with the priority of the message (see command_priority()).
+ * 10/14/2026   Kerby Kaska     Wait for room for at most requestTimeout milliseconds (if set).
+ *
+ * Description: Utility method to send a (batched) command message to the server on the CHANNEL_COMMAND of the selected 
+ *      transport. A batched message is sent with the highest priority of its commands. With a requestTimeout, a full
+ *      command queue is waited on for at most that long, and should the server not make room in time, the message is
+ *      not sent at all (its requests then time out waiting for their replies, since their deadline has passed by then).
+ *      On error, an error message is printed to the console and the queues are closed.
+ *
+ * Parameters:
+ *      message          I/P    const char*     the framed command message
+ *      messageLength    I/P    size_t          the number of bytes in message
+ *      priority         I/P    unsigned int    the message priority to send the message with
+ *      send_command     O/P    bool            true on success, false on error
+ *******************************************************************************************************************************/
+static bool send_command(const char* message, size_t messageLength, unsigned int priority)
+{
+    // send the command to the parent/server on the command channel (only the used bytes of the message)
+    const int timeout = (requestTimeout != 0) ? static_cast<int>(requestTimeout) : -1;
+    if (transport->send(CHANNEL_COMMAND, message, messageLength, priority, timeout) == -1 && errno != ETIMEDOUT)
+    {
+        perror("client::send()");
+        close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool reattach_server(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Reattaches a standalone client to the server after a reply took too long. The queue published under
+ *      COMMAND_QUEUE_NAME is opened again, waiting for it with an exponential backoff while no server is running, and
+ *      replaces the commandQueue if it is not the same queue (a restarted server which is not ARG_PERSISTENT creates a 
+ *      new one). On error, or once RECONNECT_ATTEMPTS checks found no server, an error message is printed to the console.
+ *
+ * Parameters:
+ *      reattach_server    O/P    bool    true once the commandQueue is the published command queue, false on error
+ *******************************************************************************************************************************/
+static bool reattach_server()
+{
+    struct stat attached;
+    if (fstat(commandQueue, &attached) == -1) // NOTE: a message queue descriptor is a file descriptor on Linux
+    {
+        perror("commandQueue::fstat()");
+        return false;
+    }
+
+    unsigned int backoff = RECONNECT_BACKOFF;
+    for (unsigned int attempt = 0; attempt < RECONNECT_ATTEMPTS; ++attempt)
+    {
+        const mqd_t queue = mq_open(COMMAND_QUEUE_NAME, O_WRONLY);
+        if (queue == -1 && errno != ENOENT)
+        {
+            perror("commandQueue::mq_open()");
+            return false;
+        }
+        if (queue != -1)
+        {
+            struct stat published;
+            mq_attr attributes;
+            if (fstat(queue, &published) == -1 || mq_getattr(queue, &attributes) == -1)
+            {
+                perror("commandQueue::fstat()");
+                mq_close(queue);
+                return false;
+            }
+            if (published.st_ino == attached.st_ino)
+            {
+                mq_close(queue); // still the same queue, the server (or its restart) is just slow to reply
+                return true;
+            }
+            if (static_cast<size_t>(attributes.mq_msgsize) < queueConfig.messageSize)
+            {
+                std::cerr << "client::reattach_server() - the restarted server has a smaller message size ("
+                          << attributes.mq_msgsize << ").\n";
+                mq_close(queue);
+                return false;
+            }
+            mq_close(commandQueue);
+            commandQueue = queue;
+            std::cerr << MESSAGE_RECONNECTED << std::endl;
+            return true;
+        }
+
+        // no server is running, wait for the next one to start
+        if (attempt == 0)
+        {
+            std::cerr << MESSAGE_RECONNECTING << std::endl;
+        }
+        const timespec delay = { static_cast<time_t>(backoff / 1000), static_cast<long>(backoff % 1000) * 1000000L };
+        nanosleep(&delay, NULL);
+        backoff = std::min(2 * backoff, RECONNECT_BACKOFF_LIMIT);
+    }
+    std::cerr << MESSAGE_NO_SERVER << std::endl;
+    return false;
+}
+
+/********************************************************************************************************************************
+ * static ssize_t receive_reply(char* buffer, size_t bufferSize, int timeout)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Wait for at most the timeout of the caller (the deadline of its oldest request).
+ *
+ * Description: Utility method to wait for the next reply message on the CHANNEL_RESPONSE of the selected transport, for
+ *      at most timeout milliseconds. A standalone client waits no longer than replyTimeout milliseconds either, and then 
+ *      reattaches to the server (see reattach_server()), returning 0 so the caller resends every command that has not 
+ *      been answered yet. The replyTimeout doubles each time it expires (up to RECONNECT_BACKOFF_LIMIT), so a slow server
+ *      is not flooded with resent commands, and is reset by the next reply. Resent commands may be answered twice, the 
+ *      client drops the replies it already has. Should the timeout of the caller expire first, -1 is returned with errno
+ *      set to ETIMEDOUT, without checking on the server.
+ *
+ * Parameters:
+ *      buffer           O/P    char*      the buffer to receive the reply message into
+ *      bufferSize       I/P    size_t     the size of buffer in bytes (at least the message size)
+ *      timeout          I/P    int        the milliseconds to wait at most, or -1 to wait for as long as it takes
+ *      receive_reply    O/P    ssize_t    the number of bytes received, 0 to resend the outstanding commands, -1 on error
+ *                                         (ETIMEDOUT once the timeout has expired)
+ *******************************************************************************************************************************/
+static ssize_t receive_reply(char* buffer, size_t bufferSize, int timeout)
+{
+    const bool checksServer = clientReconnects && (timeout < 0 || replyTimeout < static_cast<unsigned int>(timeout));
+    const ssize_t length = transport->receive(CHANNEL_RESPONSE, buffer, bufferSize, NULL, 
+        checksServer ? static_cast<int>(replyTimeout) : timeout);
+    if (length != -1 || errno != ETIMEDOUT || !checksServer)
+    {
+        if (length != -1)
+        {
+            replyTimeout = RECONNECT_REPLY_TIMEOUT;
+        }
+        return length;
+    }
+    replyTimeout = std::min(2 * replyTimeout, RECONNECT_BACKOFF_LIMIT);
+    if (!reattach_server())
+    {
+        errno = EHOSTDOWN;
+        return -1;
+    }
+    return 0;
+}
+
+/********************************************************************************************************************************
+ * static bool write_vectors(int descriptor, iovec* vectors, int vectorCount)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to writev() every byte of the vectors to a file descriptor, continuing after a signal or a
+ *      partial write (which a pipe returns once it is full). The vectors are consumed in the process. On error, an error 
+ *      message is printed to the console.
+ *
+ * Parameters:
+ *      descriptor       I/P    int        the file descriptor to write to
+ *      vectors          I/P    iovec*     the buffers to write, in order
+ *      vectorCount      I/P    int        the number of buffers in vectors
+ *      write_vectors    O/P    bool       true on success, false on error
+ *******************************************************************************************************************************/
+static bool write_vectors(int descriptor, iovec* vectors, int vectorCount)
+{
+    while (vectorCount > 0)
+    {
+        ssize_t written = writev(descriptor, vectors, vectorCount);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("client::writev()");
+            return false;
+        }
+
+        // skip the buffers that were written completely, and the written part of the first one that was not
+        while (vectorCount > 0 && static_cast<size_t>(written) >= vectors->iov_len)
+        {
+            written -= vectors->iov_len;
+            ++vectors;
+            --vectorCount;
+        }
+        if (vectorCount > 0)
+        {
+            vectors->iov_base = static_cast<char*>(vectors->iov_base) + written;
+            vectors->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool flush_output(OutputWriter* writer)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to write out the replies gathered by an OutputWriter (if any). On error, an error message is
+ *      printed to the console.
+ *
+ * Parameters:
+ *      writer          I/P    OutputWriter*   the writer to flush
+ *      flush_output    O/P    bool            true on success, false on error
+ *******************************************************************************************************************************/
+static bool flush_output(OutputWriter* writer)
+{
+    iovec vector = { &writer->buffer[0], writer->length };
+    writer->length = 0;
+    return write_vectors(writer->descriptor, &vector, 1);
+}
+
+/********************************************************************************************************************************
+ * static bool write_output(OutputWriter* writer, const char* reply, size_t replyLength, bool complete)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Write the chunks of a streamed reply without the newline.
+ *
+ * Description: Utility method to write a reply followed by a newline through an OutputWriter. The reply is copied into
+ *      its buffer while it fits. Otherwise the buffer, the reply, and the newline are written out together in a single
+ *      writev(), so a large reply is never copied. A chunk of a streamed reply which more chunks follow is written
+ *      without the newline. On error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      writer          I/P    OutputWriter*   the writer to write the reply through
+ *      reply           I/P    const char*     the reply (without its MessageHeader)
+ *      replyLength     I/P    size_t          the number of bytes in reply
+ *      complete        I/P    bool            true to end the reply with a newline, false for a chunk more chunks follow
+ *      write_output    O/P    bool            true on success, false on error
+ *******************************************************************************************************************************/
+static bool write_output(OutputWriter* writer, const char* reply, size_t replyLength, bool complete)
+{
+    if (writer->length + replyLength + 1 <= writer->buffer.size())
+    {
+        memcpy(&writer->buffer[writer->length], reply, replyLength);
+        writer->length += replyLength;
+        if (complete)
+        {
+            writer->buffer[writer->length++] = '\n';
+        }
+        return true;
+    }
+    char newline = '\n';
+    iovec vectors[3] = { { &writer->buffer[0], writer->length }, { const_cast<char*>(reply), replyLength },
+                         { &newline, complete ? 1u : 0u } };
+    writer->length = 0;
+    return write_vectors(writer->descriptor, vectors, 3);
+}
+
+/********************************************************************************************************************************
+ * static bool read_line(InputReader* reader, OutputWriter* writer, const char** line, size_t* lineLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to hand out the next line of input of an InputReader, like getline() but in place: line 
+ *      points into the buffer of the reader, and stays valid until the next call. Once no whole line is buffered, the rest 
+ *      is moved to the front of the buffer and the next chunk is read(). The replies of the writer are flushed first, 
+ *      since read() may block until whoever is feeding the input has seen them. A line longer than the whole buffer is 
+ *      handed out in pieces (it is truncated to the message size anyway), and the last line does not need a newline. A 
+ *      read error is printed to the console, and ends the input.
+ *
+ * Parameters:
+ *      reader        I/P    InputReader*    the reader to read the line from
+ *      writer        I/P    OutputWriter*   the writer to flush before blocking on the input
+ *      line          O/P    const char**    the line (not NUL-terminated, without its newline)
+ *      lineLength    O/P    size_t*         the number of bytes in line
+ *      read_line     O/P    bool            true if a line was read, false once the input has ended
+ *******************************************************************************************************************************/
+static bool read_line(InputReader* reader, OutputWriter* writer, const char** line, size_t* lineLength)
+{
+    while (true)
+    {
+        char* begin = &reader->buffer[reader->start];
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', reader->end - reader->start));
+        if (newline != NULL || (reader->end > reader->start && (reader->ended || reader->end - reader->start == 
+            reader->buffer.size())))
+        {
+            *line = begin;
+            *lineLength = (newline != NULL) ? static_cast<size_t>(newline - begin) : reader->end - reader->start;
+            reader->start += *lineLength + ((newline != NULL) ? 1 : 0);
+            return true;
+        }
+        if (reader->ended)
+        {
+            return false;
+        }
+
+        // move the partial line to the front, and read the next chunk after it
+        memmove(&reader->buffer[0], begin, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+        if (writer->length > 0 && !flush_output(writer))
+        {
+            reader->ended = true;
+            continue;
+        }
+        const ssize_t readLength = read(reader->descriptor, &reader->buffer[reader->end], 
+                                        reader->buffer.size() - reader->end);
+        if (readLength == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (readLength == -1)
+        {
+            perror("client::read()");
+        }
+        if (readLength <= 0)
+        {
+            reader->ended = true;
+            continue;
+        }
+        reader->end += readLength;
+    }
+}
+
+/********************************************************************************************************************************
+ * static int run_client(int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved the client loop out of main() and added the framed MessageHeader.
+ * 10/14/2026   Kerby Kaska     Added the client ID naming the private reply queue of a standalone client.
+ * 10/14/2026   Kerby Kaska     The buffers are sized from the queueConfig set at startup.
+ * 10/14/2026   Kerby Kaska     No longer flush every result, the console is flushed before reading the next command.
+ * 10/14/2026   Kerby Kaska     Render the binary CMD_GET_UNAME_FIELDS results as text.
+ * 10/14/2026   Kerby Kaska     Resend the command after a reconnect (see receive_reply()).
+ * 10/14/2026   Kerby Kaska     Give up on the command once its deadline passes (ARG_DEADLINE).
+ * 10/14/2026   Kerby Kaska     Print every chunk of a streamed reply as it arrives.
+ * 10/14/2026   Kerby Kaska     Record every command read (ARG_RECORD).
+ * 10/14/2026   Kerby Kaska     Render a streamed binary reply once its last chunk has arrived.
+ *
+ * Description: Interactive client event loop. Prompts the user for a command, sends it to the server on the commandQueue,
+ *      waits for the matching response on the responseQueue, and prints it to the console. Loops until the user enters
+ *      the CMD_EXIT command or the input ends. Should the client reattach to a restarted server, the command is sent 
+ *      again, and replies to earlier commands (answered twice) are dropped. With a requestTimeout, MESSAGE_TIMED_OUT is
+ *      printed instead once the deadline of the command passes, and its reply is dropped should it still arrive.
+ *
+ * Parameters:
+ *      clientID      I/P    int32_t    the client ID naming the private reply queue (0 for the shared responseQueue)
+ *      run_client    O/P    int        EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_client(int32_t clientID)
+{
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(3 * messageSize + UNAME_TEXT_SIZE); // NOTE: allocated to match the message size configured at startup
+    char* inputBuffer = &buffers[0]; // input buffer - framed command responses from the server
+    char* outputBuffer = inputBuffer + messageSize; // output buffer - framed commands for the server
+    char* textBuffer = outputBuffer + messageSize; // text buffer - binary responses rendered as text
+    char* expandBuffer = textBuffer + UNAME_TEXT_SIZE; // expand buffer - compressed responses expanded
+
+    // print help message and prompt on client start
+    std::cout << MESSAGE_HELP << std::endl;
+    std::cout << MESSAGE_PROMPT;
+
+    bool running = true;
+    uint32_t requestID = 0;
+    std::string input;
+    while (running && getline(std::cin, input)) // get console input from user
+    {
+        record_command(input.data(), input.size());
+        uint16_t opcode;
+        const uint32_t deadline = request_deadline();
+        const size_t commandLength = frame_command(input.data(), input.size(), ++requestID, clientID, deadline, 
+            outputBuffer, messageSize, true, &opcode);
+        if (!send_command(outputBuffer, commandLength, command_priority(opcode)))
+        {
+            return EXIT_FAILURE;
+        }
+
+        // print every chunk of the response as it arrives (a response which is not streamed is a single chunk)
+        uint16_t sequence = 0; // sequence number of the next chunk of the response
+        bool streaming = true; // false once the last chunk of the response has been printed
+        std::string binaryResult; // chunks of a binary response, which is only rendered once it is whole
+        while (streaming)
+        {
+            // wait for the response to the command on the response channel (until its deadline), resending it after a
+            // reconnect, and skipping the late replies to earlier commands (and the chunks which were printed already)
+            ssize_t responseLength;
+            MessageHeader header;
+            do
+            {
+                responseLength = receive_reply(inputBuffer, messageSize, remaining_timeout(deadline));
+                if (responseLength == 0 && !send_command(outputBuffer, commandLength, command_priority(opcode)))
+                {
+                    return EXIT_FAILURE;
+                }
+            }
+            while (responseLength == 0 || (responseLength > 0 && (clientReconnects || requestTimeout != 0) &&
+                                           read_frame(inputBuffer, responseLength, 0, &header) &&
+                                           (header.requestID != requestID || header.sequence != sequence)));
+
+            // print the result to the console (rendering a binary result as text first)
+            // NOTE: no flush, std::cin is tied to std::cout, so the result is flushed before the next command is read
+            const char* result = MESSAGE_TIMED_OUT;
+            size_t resultLength = strlen(MESSAGE_TIMED_OUT);
+            if (responseLength != -1 || errno != ETIMEDOUT)
+            {
+                if (responseLength == -1)
+                {
+                    perror("client::receive()");
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                if (!read_frame(inputBuffer, responseLength, 0, &header) || header.requestID != requestID ||
+                    header.sequence != sequence)
+                {
+                    std::cerr << "client::read_frame() - received a reply that does not match request (" << requestID << ").\n";
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                result = inputBuffer + sizeof(header);
+                resultLength = header.payloadLength;
+                if (!expand_reply(header, &result, &resultLength, expandBuffer, messageSize))
+                {
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                record_trace(header, result, &resultLength);
+                if (header.opcode == OPCODE_GET_UNAME_FIELDS)
+                {
+                    // NOTE: the entries of a binary response span the chunks, so nothing is printed until the last one
+                    binaryResult.append(result, resultLength);
+                    resultLength = 0;
+                    if ((header.flags & FRAME_MORE) == 0 &&
+                        !render_uname(binaryResult.data(), binaryResult.size(), textBuffer, UNAME_TEXT_SIZE, &resultLength))
+                    {
+                        close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                        return EXIT_FAILURE;
+                    }
+                    result = textBuffer;
+                }
+            }
+            std::cout.write(result, resultLength);
+            streaming = responseLength > 0 && (header.flags & FRAME_MORE) != 0;
+            if (streaming)
+            {
+                std::cout.flush(); // NOTE: shows the chunk while the rest of the response is still on its way
+                ++sequence;
+            }
+        }
+        std::cout << '\n';
+
+        // stop looping if user input "exit" command
+        // NOTE: at this point, we sent the "exit" command to the server, which will cause the server loop to exit as well
+        if (opcode == OPCODE_EXIT) 
+        {
+            running = false;
+        }
+        else
+        {
+            std::cout << MESSAGE_PROMPT; // print the prompt again (only if we aren't exiting)
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * static int run_pipelined_client(int32_t clientID, bool batched, uint32_t windowSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added the client ID naming the private reply queue of a standalone client.
+ * 10/14/2026   Kerby Kaska     Added the batched mode, and the matching of every frame of a batched reply.
+ * 10/14/2026   Kerby Kaska     The window and buffers are sized from the queueConfig set at startup.
+ * 10/14/2026   Kerby Kaska     Read stdin through an InputReader and write stdout through an OutputWriter. The window size
+ *                              is a parameter, so the non-interactive client can run it with a window of one.
+ * 10/14/2026   Kerby Kaska     Render the binary CMD_GET_UNAME_FIELDS results as text.
+ * 10/14/2026   Kerby Kaska     Resend the outstanding commands after a reconnect (see receive_reply()).
+ * 10/14/2026   Kerby Kaska     Give up on the oldest command once its deadline passes (ARG_DEADLINE).
+ * 10/14/2026   Kerby Kaska     Reassemble the streamed replies, writing out the chunks of the oldest one as they arrive.
+ * 10/14/2026   Kerby Kaska     Record every command read (ARG_RECORD).
+ * 10/14/2026   Kerby Kaska     Render a streamed binary reply once its last chunk has arrived.
+ *
+ * Description: Pipelined client event loop, intended for scripted input piped into stdin. Instead of waiting for each
+ *      response before reading the next command, up to windowSize requests are kept outstanding at once. Each
+ *      request is tagged with an increasing request ID, which the server echoes back, and stored in a window of pending
+ *      slots (indexed by request ID modulo the queue depth). Replies are matched to their slot by request ID, and
+ *      printed to the console in the order the commands were given. Once the CMD_EXIT command has been sent (or the input
+ *      ends) no further commands are read, and the loop exits after every outstanding reply has been printed.
+ *
+ *      In batched mode, every command which is already buffered from stdin is packed into the same message (as long as
+ *      it fits in the message size and there are free slots), so a whole batch of commands costs a single mq_send, and
+ *      the server answers it with a single batched reply. A command is sent on its own as soon as no more input is 
+ *      buffered, so batching never delays a command waiting for input that has not arrived yet.
+ *
+ *      A streamed reply (see stream_reply()) arrives in chunks, numbered by their sequence. The chunks of the oldest
+ *      request are written out (and flushed) as soon as they arrive, while the chunks of a later one are reassembled in its
+ *      slot until its turn. The chunks of a binary reply are always reassembled, and the reply rendered once whole. A chunk
+ *      out of sequence (the duplicate of a resent command) is dropped.
+ *
+ *      The response queue can never overflow, since the server only replies to requests that are outstanding, every reply
+ *      message holds at least one reply, and no more than the queue depth of requests are ever outstanding (the chunks of
+ *      a streamed reply are the exception, the server waits for the client to make room for them). With a
+ *      requestTimeout, the wait for replies never lasts past the deadline of the oldest outstanding request (deadlines
+ *      increase with the request ID), which is then printed as MESSAGE_TIMED_OUT in its place. Its late reply is dropped,
+ *      and since it no longer counts as outstanding, it may find the response queue full, in which case the server drops
+ *      it after REPLY_SEND_TIMEOUT milliseconds (or holds it in the outbox of a standalone client).
+ *
+ *      Commands are framed straight out of the chunks read() from stdin, and a reply which arrives in order is written 
+ *      straight out of the received message (only replies that arrive early are kept in their slot), so no command or 
+ *      reply is copied into a string. Replies are written out in large writev() calls, not flushed line by line.
+ *
+ *      A standalone client also keeps a copy of every outstanding command, and should it reattach to a restarted server,
+ *      resends each command that has not been answered yet on its own, in order. Replies which arrive twice are dropped.
+ *
+ * Parameters:
+ *      clientID                I/P    int32_t    the client ID naming the private reply queue (0 for the shared responseQueue)
+ *      batched                 I/P    bool       true to pack several commands into each message
+ *      windowSize              I/P    uint32_t   the number of requests kept outstanding at once (at most the queue depth)
+ *      run_pipelined_client    O/P    int        EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_pipelined_client(int32_t clientID, bool batched, uint32_t windowSize)
+{
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(3 * messageSize + UNAME_TEXT_SIZE); // NOTE: allocated to match the message size configured at startup
+    char* inputBuffer = &buffers[0]; // input buffer - framed command responses from the server
+    char* outputBuffer = inputBuffer + messageSize; // output buffer - framed commands for the server
+    char* textBuffer = outputBuffer + messageSize; // text buffer - binary responses rendered as text
+    char* expandBuffer = textBuffer + UNAME_TEXT_SIZE; // expand buffer - compressed responses expanded
+    std::vector<PendingRequest> pending(windowSize); // window of outstanding requests, indexed by request ID
+    InputReader reader = { STDIN_FILENO, std::vector<char>(STREAM_INPUT_SIZE), 0, 0, false };
+    OutputWriter writer = { STDOUT_FILENO, std::vector<char>(STREAM_OUTPUT_SIZE), 0 };
+
+    uint32_t nextRequestID = 0; // request ID of the next command to send
+    uint32_t oldestRequestID = 0; // request ID of the oldest command that has not been printed yet
+    bool reading = true; // false once the input has ended or the CMD_EXIT command has been sent
+    const char* input;
+    size_t inputLength;
+    while (true)
+    {
+        // fill the window with as many commands as there are free slots
+        size_t commandLength = 0; // number of bytes of the (batched) command message in outputBuffer
+        unsigned int commandPriority = 0; // highest priority of the commands in outputBuffer
+        while (reading && nextRequestID - oldestRequestID < windowSize)
+        {
+            if (!read_line(&reader, &writer, &input, &inputLength))
+            {
+                reading = false;
+                break;
+            }
+            record_command(input, inputLength);
+
+            // append the command to the batch, or send the batch first if the command does not fit in it
+            uint16_t opcode;
+            const uint32_t deadline = request_deadline();
+            size_t frameLength = frame_command(input, inputLength, nextRequestID, clientID, deadline, 
+                outputBuffer + commandLength, messageSize - commandLength, commandLength == 0, &opcode);
+            if (frameLength == 0)
+            {
+                if (!send_command(outputBuffer, commandLength, commandPriority))
+                {
+                    return EXIT_FAILURE;
+                }
+                commandLength = 0;
+                commandPriority = 0;
+                frameLength = frame_command(input, inputLength, nextRequestID, clientID, deadline, outputBuffer, 
+                    messageSize, true, &opcode);
+            }
+            PendingRequest& request = pending[nextRequestID % windowSize];
+            request.complete = false;
+            request.response.clear();
+            request.sequence = 0;
+            request.deadline = deadline;
+            if (clientReconnects)
+            {
+                request.request.assign(outputBuffer + commandLength, frameLength);
+                request.priority = command_priority(opcode);
+            }
+            commandLength += frameLength;
+            commandPriority = std::max(commandPriority, command_priority(opcode));
+            ++nextRequestID;
+
+            // the server stops after CMD_EXIT, so there is no point in sending anything after it
+            if (opcode == OPCODE_EXIT)
+            {
+                reading = false;
+            }
+
+            // send right away, unless batching and more input is already buffered
+            if (!batched || reader.start == reader.end)
+            {
+                if (!send_command(outputBuffer, commandLength, commandPriority))
+                {
+                    return EXIT_FAILURE;
+                }
+                commandLength = 0;
+                commandPriority = 0;
+            }
+        }
+        if (commandLength > 0 && !send_command(outputBuffer, commandLength, commandPriority))
+        {
+            return EXIT_FAILURE;
+        }
+
+        // stop once every outstanding reply has been printed
+        if (oldestRequestID == nextRequestID)
+        {
+            break;
+        }
+
+        // wait for any outstanding reply on the response channel (until the deadline of the oldest request)
+        const ssize_t responseLength = receive_reply(inputBuffer, messageSize, 
+            remaining_timeout(pending[oldestRequestID % windowSize].deadline));
+        if (responseLength == -1 && errno == ETIMEDOUT)
+        {
+            // print the oldest request as timed out, followed by every completed reply after it
+            do
+            {
+                const PendingRequest& oldest = pending[oldestRequestID % windowSize];
+                const bool written = oldest.complete ? 
+                    write_output(&writer, oldest.response.data(), oldest.response.size(), true) :
+                    write_output(&writer, MESSAGE_TIMED_OUT, strlen(MESSAGE_TIMED_OUT), true);
+                if (!written)
+                {
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                ++oldestRequestID;
+            }
+            while (oldestRequestID != nextRequestID && pending[oldestRequestID % windowSize].complete);
+            continue;
+        }
+        if (responseLength == -1)
+        {
+            perror("client::receive()");
+            close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+            return EXIT_FAILURE;
+        }
+        for (uint32_t requestID = oldestRequestID; responseLength == 0 && requestID != nextRequestID; ++requestID)
+        {
+            // reattached to the server, resend every command which has not been answered
+            const PendingRequest& request = pending[requestID % windowSize];
+            if (!request.complete && !send_command(request.request.data(), request.request.size(), request.priority))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+
+        // match every reply of the (batched) message to its outstanding request by request ID
+        MessageHeader header;
+        size_t responseOffset = 0;
+        while (read_frame(inputBuffer, responseLength, responseOffset, &header))
+        {
+            const char* payload = inputBuffer + responseOffset + sizeof(header);
+            size_t payloadLength = header.payloadLength;
+            responseOffset += sizeof(header) + header.payloadLength;
+            if (header.requestID - oldestRequestID >= nextRequestID - oldestRequestID ||
+                pending[header.requestID % windowSize].complete ||
+                header.sequence != pending[header.requestID % windowSize].sequence)
+            {
+                // NOTE: a command resent after a reconnect may well be answered twice, and one which timed out late
+                if (!clientReconnects && requestTimeout == 0)
+                {
+                    std::cerr << "client::read_frame() - dropped a reply that does not match an outstanding request.\n";
+                }
+                continue;
+            }
+            if (!expand_reply(header, &payload, &payloadLength, expandBuffer, messageSize))
+            {
+                close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                return EXIT_FAILURE;
+            }
+            record_trace(header, payload, &payloadLength);
+            PendingRequest& request = pending[header.requestID % windowSize];
+            const bool complete = (header.flags & FRAME_MORE) == 0;
+            ++request.sequence;
+            if (header.opcode == OPCODE_GET_UNAME_FIELDS)
+            {
+                // the entries of a binary reply span the chunks, so it is reassembled in its slot and rendered once whole
+                request.response.append(payload, payloadLength);
+                if (!complete)
+                {
+                    continue;
+                }
+                if (!render_uname(request.response.data(), request.response.size(), textBuffer, UNAME_TEXT_SIZE,
+                                  &payloadLength))
+                {
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                payload = textBuffer;
+                request.response.clear();
+            }
+            if (header.requestID != oldestRequestID)
+            {
+                request.response.append(payload, payloadLength); // arrived early, keep it until its turn
+                request.complete = complete;
+                continue;
+            }
+
+            // write out the chunks which arrived before the reply reached the front of the window, then the reply (or
+            // stream its chunk right away)
+            if (!request.response.empty() && !write_output(&writer, request.response.data(), request.response.size(),
+                                                           false))
+            {
+                close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                return EXIT_FAILURE;
+            }
+            request.response.clear();
+            if (!write_output(&writer, payload, payloadLength, complete) || (!complete && !flush_output(&writer)))
+            {
+                close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                return EXIT_FAILURE;
+            }
+            if (!complete)
+            {
+                continue;
+            }
+
+            // print every completed reply after the one at the front of the window, in the order the commands were given
+            ++oldestRequestID;
+            while (oldestRequestID != nextRequestID && pending[oldestRequestID % windowSize].complete)
+            {
+                const PendingRequest& oldest = pending[oldestRequestID % windowSize];
+                if (!write_output(&writer, oldest.response.data(), oldest.response.size(), true))
+                {
+                    close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                    return EXIT_FAILURE;
+                }
+                ++oldestRequestID;
+            }
+        }
+        if (responseOffset != static_cast<size_t>(responseLength))
+        {
+            std::cerr << "client::read_frame() - dropped a malformed reply at offset " << responseOffset << ".\n";
+        }
+    }
+    if (!flush_output(&writer))
+    {
+        close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * static double percentile(const std::vector<uint64_t>& sorted, double fraction)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to look up a percentile of sorted latencies (nearest rank), converted to microseconds.
+ *
+ * Parameters:
+ *      sorted        I/P    const std::vector<uint64_t>&    the latencies in nanoseconds, sorted in ascending order
+ *      fraction      I/P    double                          the percentile as a fraction (0.99 for p99)
+ *      percentile    O/P    double                          the latency at the percentile in microseconds (0 if empty)
+ *******************************************************************************************************************************/
+static double percentile(const std::vector<uint64_t>& sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(ceil(fraction * sorted.size()));
+    rank = (rank < 1) ? 1 : (rank > sorted.size()) ? sorted.size() : rank;
+    return sorted[rank - 1] / 1000.0;
+}
+
+/********************************************************************************************************************************
+ * static bool run_bench_round(int32_t clientID, const std::vector<std::string>& commands, const BenchOptions* bench, 
+ *                             bool batched, uint32_t* nextRequestID, BenchResult* results)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Benchmark a mix of commands in one round. Send every command with its priority.
+ *
+ * Description: Benchmarks the round trip of one command, or of a mix of commands sent in turn. Every command is sent 
+ *      requestCount times, with up to concurrency requests outstanding at once (each one tagged with its request ID, like
+ *      the pipelined client), and the latency of every request is measured from the time it is framed to the time its 
+ *      reply is received. In batched mode, the requests which can be sent at once are packed into as few messages as 
+ *      possible. Every message is sent with the priority of its commands, so in a mixed round the latencies of each 
+ *      command show how far its priority class overtakes the others. On error, an error message is printed to the 
+ *      console and the queues are closed.
+ *
+ * Parameters:
+ *      clientID           I/P    int32_t                           the client ID naming the private reply queue (0 for
+ *                                                                  the shared responseQueue)
+ *      commands           I/P    const std::vector<std::string>&   the commands to benchmark, sent in turn
+ *      bench              I/P    const BenchOptions*               the benchmark options
+ *      batched            I/P    bool                              true to pack several requests into each message
+ *      nextRequestID      I/O    uint32_t*                         the request ID of the next request to send
+ *      results            O/P    BenchResult*                      the measured round trip latencies and duration of
+ *                                                                  each command (one result for each of commands)
+ *      run_bench_round    O/P    bool                              true on success, false on error
+ *******************************************************************************************************************************/
+static bool run_bench_round(int32_t clientID, const std::vector<std::string>& commands, const BenchOptions* bench, 
+                            bool batched, uint32_t* nextRequestID, BenchResult* results)
+{
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(3 * messageSize); // NOTE: allocated to match the message size configured at startup
+    char* inputBuffer = &buffers[0]; // input buffer - framed command responses from the server
+    char* outputBuffer = inputBuffer + messageSize; // output buffer - framed commands for the server
+    char* expandBuffer = outputBuffer + messageSize; // expand buffer - compressed responses expanded
+    std::vector<BenchSlot> window(bench->concurrency); // outstanding requests, indexed by request ID
+    const unsigned int commandCount = commands.size();
+    const unsigned int requestCount = bench->requestCount * commandCount;
+    for (unsigned int i = 0; i < commandCount; ++i)
+    {
+        results[i].requestCount = 0;
+        results[i].latencies.clear();
+        results[i].latencies.reserve(bench->requestCount);
+    }
+
+    const uint32_t firstRequestID = *nextRequestID;
+    unsigned int sent = 0; // number of requests sent so far
+    unsigned int received = 0; // number of replies received so far
+    const uint64_t startTime = monotonic_nanoseconds();
+    while (received < requestCount)
+    {
+        // send requests until the window is full (the slot of the next request ID is still outstanding)
+        size_t commandLength = 0; // number of bytes of the (batched) command message in outputBuffer
+        unsigned int commandPriority = 0; // highest priority of the commands in outputBuffer
+        while (sent < requestCount && !window[(firstRequestID + sent) % bench->concurrency].outstanding)
+        {
+            uint16_t opcode;
+            const uint32_t requestID = firstRequestID + sent;
+            const unsigned int command = sent % commandCount;
+            const size_t frameLength = frame_command(commands[command].data(), commands[command].size(), requestID, 
+                clientID, 0, outputBuffer + commandLength, messageSize - commandLength, commandLength == 0, &opcode);
+            if (frameLength == 0) // the batch is full, send it and start the next one
+            {
+                if (!send_command(outputBuffer, commandLength, commandPriority))
+                {
+                    return false;
+                }
+                commandLength = 0;
+                commandPriority = 0;
+                continue;
+            }
+            BenchSlot& slot = window[requestID % bench->concurrency];
+            slot.outstanding = true;
+            slot.command = command;
+            slot.sendTime = monotonic_nanoseconds();
+            results[command].priority = command_entry(opcode).priority;
+            commandLength += frameLength;
+            commandPriority = std::max(commandPriority, command_priority(opcode));
+            ++sent;
+            if (!batched)
+            {
+                if (!send_command(outputBuffer, commandLength, commandPriority))
+                {
+                    return false;
+                }
+                commandLength = 0;
+                commandPriority = 0;
+            }
+        }
+        if (commandLength > 0 && !send_command(outputBuffer, commandLength, commandPriority))
+        {
+            return false;
+        }
+
+        // wait for any outstanding reply on the response channel (blocking)
+        const ssize_t responseLength = transport->receive(CHANNEL_RESPONSE, inputBuffer, messageSize, NULL, -1);
+        const uint64_t receiveTime = monotonic_nanoseconds();
+        if (responseLength == -1)
+        {
+            perror("bench::receive()");
+            close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+            return false;
+        }
+
+        // match every reply of the (batched) message to its outstanding request by request ID
+        MessageHeader header;
+        size_t responseOffset = 0;
+        while (read_frame(inputBuffer, responseLength, responseOffset, &header))
+        {
+            // NOTE: a compressed reply is expanded like the other clients do, so the benchmark pays for it too
+            const char* payload = inputBuffer + responseOffset + sizeof(header);
+            size_t payloadLength = header.payloadLength;
+            responseOffset += sizeof(header) + header.payloadLength;
+            if (!expand_reply(header, &payload, &payloadLength, expandBuffer, messageSize))
+            {
+                close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                return false;
+            }
+            record_trace(header, payload, &payloadLength);
+            BenchSlot& slot = window[header.requestID % bench->concurrency];
+            if (header.requestID - firstRequestID >= sent || !slot.outstanding)
+            {
+                std::cerr << "bench::read_frame() - dropped a reply that does not match an outstanding request.\n";
+                continue;
+            }
+            if ((header.flags & FRAME_MORE) != 0)
+            {
+                continue; // NOTE: a streamed reply is only complete once its last chunk arrives
+            }
+            slot.outstanding = false;
+            results[slot.command].latencies.push_back(receiveTime - slot.sendTime);
+            ++results[slot.command].requestCount;
+            ++received;
+        }
+    }
+    const double seconds = (monotonic_nanoseconds() - startTime) / 1e9;
+    for (unsigned int i = 0; i < commandCount; ++i)
+    {
+        results[i].seconds = seconds;
+        std::sort(results[i].latencies.begin(), results[i].latencies.end());
+    }
+    *nextRequestID = firstRequestID + sent;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static void print_bench_report(const std::vector<BenchResult>& results, const BenchOptions* bench, 
+ *                                const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Report the placement of every result, and compare the pinned and unpinned latencies.
+ *
+ * Description: Prints the benchmark report to the console in the selected format. Every format carries the transport and
+ *      queue configuration the results were measured with, so reports from different runs can be compared.
+ *
+ *      With ARG_AFFINITY, the first half of the results was measured unpinned and the second half pinned (see
+ *      run_bench_client()). The text and JSON reports then compare the median and p99 latencies of both passes, command
+ *      by command (the CSV report lists both passes, with the placement of each row).
+ *
+ * Parameters:
+ *      results    I/P    const std::vector<BenchResult>&    the result of every benchmarked command
+ *      bench      I/P    const BenchOptions*                the benchmark options the benchmark ran with
+ *      options    I/P    const ProgramOptions*              the program options the benchmark ran with
+ *******************************************************************************************************************************/
+static void print_bench_report(const std::vector<BenchResult>& results, const BenchOptions* bench, 
+                               const ProgramOptions* options)
+{
+    // NOTE: the number of workers of a standalone server is unknown to its clients, it is reported as 0
+    const unsigned int workerCount = options->client ? 0 : options->workerCount;
+    char line[256];
+    const char* affinity = (options->affinity != NULL) ? options->affinity : BENCH_PLACEMENT_NAMES[0];
+    if (bench->format == BENCH_FORMAT_CSV)
+    {
+        std::cout << "command,priority,transport,workers,depth,message_size,concurrency,payload,batched,placement,requests,"
+                     "seconds,ops_per_sec,p50_us,p99_us,p999_us\n";
+    }
+    else if (bench->format == BENCH_FORMAT_JSON)
+    {
+        snprintf(line, sizeof(line), "{\"transport\":\"%s\",\"workers\":%u,\"depth\":%u,\"message_size\":%u,"
+            "\"concurrency\":%u,\"payload\":%u,\"batched\":%s,\"affinity\":\"%s\",\"results\":[", transport->name,
+            workerCount, queueConfig.maxMessages, queueConfig.messageSize, bench->concurrency, bench->payloadSize,
+            options->batched ? "true" : "false", affinity);
+        std::cout << line;
+    }
+    else
+    {
+        std::cout << "Benchmark: transport " << transport->name << ", " << workerCount << " worker(s), depth "
+                  << queueConfig.maxMessages << ", message size " << queueConfig.messageSize << ", concurrency "
+                  << bench->concurrency << ", payload " << bench->payloadSize << (options->batched ? ", batched" : "")
+                  << ", affinity " << affinity << "\n";
+        snprintf(line, sizeof(line), "%-20s %-8s %-9s %10s %10s %12s %10s %10s %10s\n", "command", "priority",
+            "placement", "requests", "seconds", "ops/s", "p50 (us)", "p99 (us)", "p999 (us)");
+        std::cout << line;
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& result = results[i];
+        const double opsPerSecond = (result.seconds > 0) ? result.requestCount / result.seconds : 0.0;
+        const double p50 = percentile(result.latencies, 0.50);
+        const double p99 = percentile(result.latencies, 0.99);
+        const double p999 = percentile(result.latencies, 0.999);
+        const char* priority = PRIORITY_CLASS_NAMES[result.priority];
+        if (bench->format == BENCH_FORMAT_CSV)
+        {
+            snprintf(line, sizeof(line), "%s,%s,%s,%u,%u,%u,%u,%u,%d,%s,%u,%.6f,%.1f,%.3f,%.3f,%.3f\n",
+                result.command.c_str(), priority, transport->name, workerCount, queueConfig.maxMessages,
+                queueConfig.messageSize, bench->concurrency, bench->payloadSize, options->batched ? 1 : 0,
+                result.placement, result.requestCount, result.seconds, opsPerSecond, p50, p99, p999);
+        }
+        else if (bench->format == BENCH_FORMAT_JSON)
+        {
+            snprintf(line, sizeof(line), "%s{\"command\":\"%s\",\"priority\":\"%s\",\"placement\":\"%s\","
+                "\"requests\":%u,\"seconds\":%.6f,\"ops_per_sec\":%.1f,\"p50_us\":%.3f,\"p99_us\":%.3f,"
+                "\"p999_us\":%.3f}", (i == 0) ? "" : ",", result.command.c_str(), priority, result.placement,
+                result.requestCount, result.seconds, opsPerSecond, p50, p99, p999);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%-20s %-8s %-9s %10u %10.3f %12.1f %10.1f %10.1f %10.1f\n",
+                result.command.c_str(), priority, result.placement, result.requestCount, result.seconds, opsPerSecond,
+                p50, p99, p999);
+        }
+        std::cout << line;
+    }
+    if (bench->format == BENCH_FORMAT_JSON)
+    {
+        std::cout << "]";
+    }
+
+    // the latency difference of every command between the pinned pass and the unpinned pass (negative if pinning helps)
+    const size_t passSize = results.size() / 2;
+    if (options->affinity != NULL && bench->format != BENCH_FORMAT_CSV)
+    {
+        if (bench->format == BENCH_FORMAT_JSON)
+        {
+            std::cout << ",\"pinned_delta\":[";
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "Pinned latency difference to unpinned:\n%-20s %12s %12s\n", "command",
+                "p50 (us)", "p99 (us)");
+            std::cout << line;
+        }
+        for (size_t i = 0; i < passSize; ++i)
+        {
+            const BenchResult& unpinned = results[i];
+            const BenchResult& pinned = results[passSize + i];
+            const double p50 = percentile(pinned.latencies, 0.50) - percentile(unpinned.latencies, 0.50);
+            const double p99 = percentile(pinned.latencies, 0.99) - percentile(unpinned.latencies, 0.99);
+            if (bench->format == BENCH_FORMAT_JSON)
+            {
+                snprintf(line, sizeof(line), "%s{\"command\":\"%s\",\"p50_us\":%.3f,\"p99_us\":%.3f}",
+                    (i == 0) ? "" : ",", pinned.command.c_str(), p50, p99);
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "%-20s %+12.1f %+12.1f\n", pinned.command.c_str(), p50, p99);
+            }
+            std::cout << line;
+        }
+        if (bench->format == BENCH_FORMAT_JSON)
+        {
+            std::cout << "]";
+        }
+    }
+    if (bench->format == BENCH_FORMAT_JSON)
+    {
+        std::cout << "}\n";
+    }
+    std::cout.flush();
+}
+
+/********************************************************************************************************************************
+ * static bool set_bench_placement(int32_t clientID, bool pinned)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Signal the supervisor with signal_supervisor(), never whichever process adopted the client.
+ *
+ * Description: Pins the benchmark client to its CPU of the placement (or unpins it to every CPU the program was started
+ *      with) before a pass of the benchmark. A forked client then signals its supervisor (AFFINITY_PIN_SIGNAL or
+ *      AFFINITY_UNPIN_SIGNAL), which forwards the signal to every server worker, and waits up to AFFINITY_ACK_TIMEOUT
+ *      milliseconds for the AFFINITY_PIN_SIGNAL acknowledging it. Both signals are blocked since before the fork (see
+ *      main()), so the acknowledgement is never lost. The pool of a standalone server belongs to another process, so a
+ *      standalone client only (un)pins itself.
+ *
+ * Parameters:
+ *      clientID               I/P    int32_t    the client ID of the benchmark client (0 for the forked client)
+ *      pinned                 I/P    bool       true to pin the processes to their CPUs, false to unpin them
+ *      set_bench_placement    O/P    bool       true if the processes were (un)pinned, false on error
+ *******************************************************************************************************************************/
+static bool set_bench_placement(int32_t clientID, bool pinned)
+{
+    if (sched_setaffinity(0, sizeof(cpu_set_t), pinned ? &pinnedCpus : &unpinnedCpus) == -1)
+    {
+        perror("bench::sched_setaffinity()");
+        return false;
+    }
+    if (clientID != 0)
+    {
+        return true;
+    }
+    if (!signal_supervisor(pinned ? AFFINITY_PIN_SIGNAL : AFFINITY_UNPIN_SIGNAL))
+    {
+        perror("bench::kill()");
+        return false;
+    }
+    sigset_t acknowledgement;
+    sigemptyset(&acknowledgement);
+    sigaddset(&acknowledgement, AFFINITY_PIN_SIGNAL);
+    const timespec timeout = { AFFINITY_ACK_TIMEOUT / 1000, (AFFINITY_ACK_TIMEOUT % 1000) * 1000000L };
+    while (sigtimedwait(&acknowledgement, NULL, &timeout) == -1)
+    {
+        if (errno != EINTR)
+        {
+            perror("bench::sigtimedwait()");
+            return false;
+        }
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static int run_bench_client(int32_t clientID, const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added the mixed round.
+ * 10/14/2026   Kerby Kaska     Run every round unpinned and then pinned with ARG_AFFINITY.
+ *
+ * Description: Benchmark client (ARG_BENCH), which replaces the interactive loop. Every command of BENCH_COMMANDS is
+ *      benchmarked in turn with run_bench_round(), followed by a text command with a payload of payloadSize bytes (which
+ *      the server answers with MESSAGE_BAD_COMMAND). Then all of them are benchmarked again mixed together in a single 
+ *      round, where the commands of each priority class compete for the same queue, and the report is printed once every
+ *      round is done. The CMD_EXIT command is sent last, so the server pool of a forked client exits as well.
+ *
+ *      With ARG_AFFINITY, all of the rounds run twice: a first pass with every process unpinned, and a second pass with
+ *      them pinned to their CPUs of the placement (see set_bench_placement()), so the report can compare both.
+ *
+ * Parameters:
+ *      clientID            I/P    int32_t                 the client ID naming the private reply queue (0 for the shared
+ *                                                         responseQueue)
+ *      options             I/P    const ProgramOptions*   the program options, including the benchmark options
+ *      run_bench_client    O/P    int                     EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_bench_client(int32_t clientID, const ProgramOptions* options)
+{
+    // the replies to a standalone client are dropped once its reply queue is full, so never have more outstanding
+    BenchOptions bench = options->bench;
+    if (bench.concurrency > queueConfig.maxMessages)
+    {
+        std::cerr << "Concurrency " << bench.concurrency << " exceeds the queue depth of " << queueConfig.maxMessages 
+                  << ", using " << queueConfig.maxMessages << " instead.\n";
+        bench.concurrency = queueConfig.maxMessages;
+    }
+
+    // every command of BENCH_COMMANDS, followed by a text command which is never a known command
+    std::vector<std::string> commands(BENCH_COMMANDS, BENCH_COMMANDS + BENCH_COMMAND_COUNT);
+    commands.push_back(std::string(bench.payloadSize, BENCH_PAYLOAD_FILL));
+
+    // benchmark each command on its own, and then all of them mixed together in a single round (in every pass)
+    const unsigned int passCount = (placementCount > 0) ? 2 : 1;
+    const size_t passSize = 2 * commands.size();
+    std::vector<BenchResult> results(passCount * passSize);
+    uint32_t nextRequestID = 0;
+    for (unsigned int pass = 0; pass < passCount; ++pass)
+    {
+        BenchResult* passResults = &results[pass * passSize];
+        const char* placement = BENCH_PLACEMENT_NAMES[(placementCount > 0) ? pass + 1 : 0];
+        if (placementCount > 0 && !set_bench_placement(clientID, pass == 1))
+        {
+            close_queues();
+            return EXIT_FAILURE;
+        }
+        for (unsigned int i = 0; i < commands.size(); ++i)
+        {
+            passResults[i].command = (i < BENCH_COMMAND_COUNT) ? commands[i] : BENCH_TEXT_NAME;
+            passResults[i].placement = placement;
+            passResults[commands.size() + i].command = BENCH_MIXED_PREFIX + passResults[i].command;
+            passResults[commands.size() + i].placement = placement;
+            if (!run_bench_round(clientID, std::vector<std::string>(1, commands[i]), &bench, options->batched,
+                                 &nextRequestID, &passResults[i]))
+            {
+                return EXIT_FAILURE; // NOTE: the queues have already been cleaned up
+            }
+        }
+        if (!run_bench_round(clientID, commands, &bench, options->batched, &nextRequestID,
+                             &passResults[commands.size()]))
+        {
+            return EXIT_FAILURE; // NOTE: the queues have already been cleaned up
+        }
+    }
+
+    print_bench_report(results, &bench, options);
+
+    // send CMD_EXIT last and wait for its reply, so the server (or session) ends like it does for the other clients
+    BenchOptions exitBench = bench;
+    exitBench.requestCount = 1;
+    exitBench.concurrency = 1;
+    BenchResult exitResult;
+    if (!run_bench_round(clientID, std::vector<std::string>(1, CMD_EXIT), &exitBench, false, &nextRequestID, 
+                         &exitResult))
+    {
+        return EXIT_FAILURE; // NOTE: the queues have already been cleaned up
+    }
+    return EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * static bool create_reply_queue(int32_t clientID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of run_standalone_client().
+ * 10/14/2026   Kerby Kaska     Open the queue with open_reply_queue(), shared with libpgm1.
+ *
+ * Description: Utility method to create the private reply queue of a client (see REPLY_QUEUE_NAME_FORMAT) as the 
+ *      responseQueue, replacing one left behind by a crashed client with the same process ID. The queue is named in
+ *      ownedQueueName, so close_queues() unlinks it on exit. On error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      clientID              I/P    int32_t    the client ID naming the queue (the process ID of the client)
+ *      create_reply_queue    O/P    bool       true on success, false on error
+ *******************************************************************************************************************************/
+static bool create_reply_queue(int32_t clientID)
+{
+    char queueName[REPLY_QUEUE_NAME_SIZE];
+    mq_attr queueAttributes = queue_attributes();
+    responseQueue = open_reply_queue(clientID, &queueAttributes, queueName);
+    if (responseQueue == -1)
+    {
+        perror("responseQueue::mq_open()");
+        return false;
+    }
+    snprintf(ownedQueueName, sizeof(ownedQueueName), "%s", queueName); // unlinked by close_queues() on exit
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool print_server_stats(int32_t clientID, uint32_t requestID)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to request the statistics report of the server pool (CMD_STATS) and print it to the 
+ *      console, every chunk of it (see stream_reply()), so a report of the client can be read next to the counters of the
+ *      server. Replies to other requests are dropped. On error, an error message is printed to the console and the queues
+ *      are closed.
+ *
+ * Parameters:
+ *      clientID              I/P    int32_t     the client ID naming the reply queue (0 for the shared responseQueue)
+ *      requestID             I/P    uint32_t    the request ID to send the command with
+ *      print_server_stats    O/P    bool        true on success, false on error
+ *******************************************************************************************************************************/
+static bool print_server_stats(int32_t clientID, uint32_t requestID)
+{
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(3 * messageSize); // NOTE: allocated to match the message size configured at startup
+    char* inputBuffer = &buffers[0]; // input buffer - framed command responses from the server
+    char* outputBuffer = inputBuffer + messageSize; // output buffer - framed commands for the server
+    char* expandBuffer = outputBuffer + messageSize; // expand buffer - compressed responses expanded
+    uint16_t opcode;
+    const size_t commandLength = frame_command(CMD_STATS, strlen(CMD_STATS), requestID, clientID, 0, outputBuffer, 
+        messageSize, true, &opcode);
+    if (!send_command(outputBuffer, commandLength, command_priority(opcode)))
+    {
+        return false;
+    }
+
+    bool streaming = true; // false once the last chunk of the report has been printed
+    while (streaming)
+    {
+        const ssize_t responseLength = transport->receive(CHANNEL_RESPONSE, inputBuffer, messageSize, NULL, -1);
+        if (responseLength == -1)
+        {
+            perror("client::receive()");
+            close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+            return false;
+        }
+        MessageHeader header;
+        size_t responseOffset = 0;
+        while (read_frame(inputBuffer, responseLength, responseOffset, &header))
+        {
+            const char* payload = inputBuffer + responseOffset + sizeof(header);
+            size_t payloadLength = header.payloadLength;
+            responseOffset += sizeof(header) + header.payloadLength;
+            if (header.requestID != requestID)
+            {
+                continue;
+            }
+            if (!expand_reply(header, &payload, &payloadLength, expandBuffer, messageSize))
+            {
+                close_queues(); // NOTE: the supervisor reaps the server pool once the client exits
+                return false;
+            }
+            std::cout.write(payload, payloadLength);
+            streaming = (header.flags & FRAME_MORE) != 0;
+        }
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static const char* map_record_file(const char* path, size_t* fileSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Maps a recorded command log (ARG_REPLAY) into memory read-only, and checks that it starts with the
+ *      RECORD_MAGIC. The commands are replayed straight out of the mapping, which the generator processes share with the 
+ *      replay client, so the log is never copied. On error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      path               I/P    const char*    the recorded command log to map
+ *      fileSize           O/P    size_t*        the number of bytes of the log
+ *      map_record_file    O/P    const char*    the mapped log (see munmap()), or NULL on error
+ *******************************************************************************************************************************/
+static const char* map_record_file(const char* path, size_t* fileSize)
+{
+    const int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file == -1)
+    {
+        perror("replay::open()");
+        return NULL;
+    }
+    struct stat attributes;
+    if (fstat(file, &attributes) == -1)
+    {
+        perror("replay::fstat()");
+        close(file);
+        return NULL;
+    }
+    if (static_cast<size_t>(attributes.st_size) < RECORD_MAGIC_SIZE)
+    {
+        std::cerr << "replay::map_record_file() - " << path << " is not a recorded command log.\n";
+        close(file);
+        return NULL;
+    }
+    void* mapping = mmap(NULL, attributes.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // NOTE: the mapping holds on to the file
+    if (mapping == MAP_FAILED)
+    {
+        perror("replay::mmap()");
+        return NULL;
+    }
+    if (memcmp(mapping, RECORD_MAGIC, RECORD_MAGIC_SIZE) != 0)
+    {
+        std::cerr << "replay::map_record_file() - " << path << " is not a recorded command log.\n";
+        munmap(mapping, attributes.st_size);
+        return NULL;
+    }
+    *fileSize = attributes.st_size;
+    return static_cast<const char*>(mapping);
+}
+
+/********************************************************************************************************************************
+ * static bool next_record_entry(ReplayCursor* cursor, const char** command, size_t* commandLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to step a replay to the next command of the mapped recorded command log, adding its delay to
+ *      the time of the replay. Once the log ends (or an entry runs past its end), false is returned and the cursor stays 
+ *      where it is, so a cursor which stopped short of the end of the file marks a malformed log.
+ *
+ * Parameters:
+ *      cursor               I/O    ReplayCursor*    the position of the replay in the log
+ *      command              O/P    const char**     the command (not NUL-terminated, pointing into the mapped log)
+ *      commandLength        O/P    size_t*          the number of bytes in command
+ *      next_record_entry    O/P    bool             true if the cursor stepped to a command, false at the end of the log
+ *******************************************************************************************************************************/
+static bool next_record_entry(ReplayCursor* cursor, const char** command, size_t* commandLength)
+{
+    RecordEntry entry;
+    if (cursor->fileSize - cursor->offset < sizeof(entry))
+    {
+        return false;
+    }
+    memcpy(&entry, cursor->file + cursor->offset, sizeof(entry));
+    if (entry.commandLength > cursor->fileSize - cursor->offset - sizeof(entry))
+    {
+        return false;
+    }
+    *command = cursor->file + cursor->offset + sizeof(entry);
+    *commandLength = entry.commandLength;
+    cursor->offset += sizeof(entry) + entry.commandLength;
+    cursor->time += entry.delay * 1000ULL;
+    ++cursor->entry;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static int run_replay_generator(unsigned int generator, const ProgramOptions* options, const char* file, size_t fileSize,
+ *                                 ReplaySample* samples)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Generator process of the replay client (ARG_REPLAY), forked once for each of ARG_GENERATORS. Replays every
+ *      generatorCount-th command of the recorded command log (starting from the generator-th), so the generators share the
+ *      load between them while the commands keep the pace they were recorded at. Every command is sent in a message of its
+ *      own, with its priority, as soon as it is due: its recorded time (from the start of the recording) divided by the 
+ *      replaySpeed, from the start of the replay, or right away at ARG_SPEED REPLAY_SPEED_MAX. Up to concurrency requests
+ *      are outstanding at once (like the benchmark), and a command due while the window is full waits for a reply first.
+ *      The replies are awaited until the next command is due, and the round trip of every command is measured like the
+ *      benchmark measures it, into its sample.
+ *
+ *      Each generator creates its own private reply queue (see create_reply_queue()), the client ID of its requests, so 
+ *      the generators never receive each other's replies. CMD_EXIT is never replayed, it would end the session of the
+ *      generator (or stop the server pool of the forked client), the replay client sends it once every generator is done.
+ *      On error, an error message is printed to the console and the queues are closed.
+ *
+ * Parameters:
+ *      generator               I/P    unsigned int              the index of the generator (below generatorCount)
+ *      options                 I/P    const ProgramOptions*     the program options, including the replay options
+ *      file                    I/P    const char*               the mapped recorded command log (see map_record_file())
+ *      fileSize                I/P    size_t                    the number of bytes in file
+ *      samples                 O/P    ReplaySample*             the samples of every command of the log (shared memory),
+ *                                                               of which the generator writes those it replays
+ *      run_replay_generator    O/P    int                       EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_replay_generator(unsigned int generator, const ProgramOptions* options, const char* file, size_t fileSize,
+                                ReplaySample* samples)
+{
+    // the replies to the generator go to a reply queue of its own (the queue of the replay client is not this one's)
+    if (responseQueue != -1)
+    {
+        mq_close(responseQueue);
+    }
+    ownedQueueName[0] = '\0';
+    const int32_t clientID = getpid();
+    if (!create_reply_queue(clientID))
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(3 * messageSize); // NOTE: allocated to match the message size configured at startup
+    char* inputBuffer = &buffers[0]; // input buffer - framed command responses from the server
+    char* outputBuffer = inputBuffer + messageSize; // output buffer - framed commands for the server
+    char* expandBuffer = outputBuffer + messageSize; // expand buffer - compressed responses expanded
+    const unsigned int concurrency = options->bench.concurrency;
+    std::vector<BenchSlot> window(concurrency); // outstanding requests, indexed by request ID (slot.command is the entry)
+
+    ReplayCursor cursor = { file, fileSize, RECORD_MAGIC_SIZE, 0, 0 };
+    const char* command = NULL; // the next command of this generator, once loaded
+    size_t commandLength = 0;
+    unsigned int entry = 0; // index of the command in the log
+    bool loaded = false; // true while the next command of this generator waits to be sent
+    bool more = true; // false once the log has no more commands for this generator
+    uint32_t nextRequestID = 0;
+    unsigned int outstanding = 0;
+    const uint64_t startTime = monotonic_nanoseconds();
+    while (more || loaded || outstanding > 0)
+    {
+        // load the next command of this generator, stepping over those of the other generators (and CMD_EXIT)
+        while (more && !loaded)
+        {
+            entry = cursor.entry;
+            more = next_record_entry(&cursor, &command, &commandLength);
+            loaded = more && entry % options->generatorCount == generator && 
+                find_command(command, commandLength) != OPCODE_EXIT;
+        }
+
+        // send the command once it is due and the window has room for it, or wait for the replies until it is due
+        int timeout = -1;
+        if (loaded)
+        {
+            const uint64_t now = monotonic_nanoseconds();
+            const uint64_t dueTime = (options->replaySpeed == 0) ? now : startTime + cursor.time / options->replaySpeed;
+            BenchSlot& slot = window[nextRequestID % concurrency];
+            if (dueTime <= now && !slot.outstanding)
+            {
+                uint16_t opcode;
+                const size_t frameLength = frame_command(command, commandLength, nextRequestID, clientID, 0, outputBuffer,
+                    messageSize, true, &opcode);
+                slot.outstanding = true;
+                slot.command = entry;
+                slot.sendTime = monotonic_nanoseconds();
+                samples[entry].opcode = opcode;
+                if (!send_command(outputBuffer, frameLength, command_priority(opcode)))
+                {
+                    return EXIT_FAILURE;
+                }
+                ++nextRequestID;
+                ++outstanding;
+                loaded = false;
+                continue;
+            }
+            if (dueTime > now)
+            {
+                timeout = static_cast<int>((dueTime - now + 999999) / 1000000);
+            }
+        }
+
+        // NOTE: a timed receive on an empty queue is how an idle generator sleeps until its next command is due
+        const ssize_t responseLength = transport->receive(CHANNEL_RESPONSE, inputBuffer, messageSize, NULL, timeout);
+        const uint64_t receiveTime = monotonic_nanoseconds();
+        if (responseLength == -1)
+        {
+            if (errno == ETIMEDOUT || errno == EINTR)
+            {
+                continue;
+            }
+            perror("replay::receive()");
+            close_queues();
+            return EXIT_FAILURE;
+        }
+
+        // match every reply of the (batched) message to its outstanding request by request ID
+        MessageHeader header;
+        size_t responseOffset = 0;
+        while (read_frame(inputBuffer, responseLength, responseOffset, &header))
+        {
+            const char* payload = inputBuffer + responseOffset + sizeof(header);
+            size_t payloadLength = header.payloadLength;
+            responseOffset += sizeof(header) + header.payloadLength;
+            if (!expand_reply(header, &payload, &payloadLength, expandBuffer, messageSize))
+            {
+                close_queues();
+                return EXIT_FAILURE;
+            }
+            BenchSlot& slot = window[header.requestID % concurrency];
+            if (header.requestID >= nextRequestID || !slot.outstanding)
+            {
+                std::cerr << "replay::read_frame() - dropped a reply that does not match an outstanding request.\n";
+                continue;
+            }
+            if ((header.flags & FRAME_MORE) != 0)
+            {
+                continue; // NOTE: a streamed reply is only complete once its last chunk arrives
+            }
+            slot.outstanding = false;
+            samples[slot.command].latency = receiveTime - slot.sendTime;
+            samples[slot.command].answered = true;
+            --outstanding;
+        }
+    }
+    return close_queues();
+}
+
+/********************************************************************************************************************************
+ * static int run_replay_client(int32_t clientID, const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Replay client (ARG_REPLAY), which replaces the interactive loop. Maps the recorded command log, and forks
+ *      ARG_GENERATORS generator processes which replay its commands between them (see run_replay_generator()), measuring
+ *      the round trip of every command into memory shared with this process. Once every generator has exited, the 
+ *      latencies are summed up by command (by opcode, every unknown command as one text command) and reported like the 
+ *      benchmark (see print_bench_report()), the throughput over the whole replay. The text report is followed by the 
+ *      statistics report of the server pool (see print_server_stats()), and CMD_EXIT is sent last, so the server pool of
+ *      a forked client exits as well.
+ *
+ * Parameters:
+ *      clientID             I/P    int32_t                 the client ID naming the private reply queue (0 for the shared
+ *                                                          responseQueue)
+ *      options              I/P    const ProgramOptions*   the program options, including the replay options
+ *      run_replay_client    O/P    int                     EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_replay_client(int32_t clientID, const ProgramOptions* options)
+{
+    // the replies to a generator are dropped once its reply queue is full, so never have more outstanding
+    ProgramOptions replay = *options;
+    if (replay.bench.concurrency > queueConfig.maxMessages)
+    {
+        std::cerr << "Concurrency " << replay.bench.concurrency << " exceeds the queue depth of " 
+                  << queueConfig.maxMessages << ", using " << queueConfig.maxMessages << " instead.\n";
+        replay.bench.concurrency = queueConfig.maxMessages;
+    }
+    replay.bench.payloadSize = 0; // NOTE: the commands are those recorded, there is no payload to report
+
+    // map the log, and count its commands (one sample each)
+    size_t fileSize;
+    const char* file = map_record_file(options->replayPath, &fileSize);
+    if (file == NULL)
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    ReplayCursor cursor = { file, fileSize, RECORD_MAGIC_SIZE, 0, 0 };
+    const char* command;
+    size_t commandLength;
+    while (next_record_entry(&cursor, &command, &commandLength))
+    {
+    }
+    const size_t samplesSize = std::max<size_t>(cursor.entry, 1) * sizeof(ReplaySample);
+    void* samplesRegion = (cursor.offset != fileSize) ? MAP_FAILED : 
+        mmap(NULL, samplesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (samplesRegion == MAP_FAILED)
+    {
+        if (cursor.offset != fileSize)
+        {
+            std::cerr << "replay::next_record_entry() - " << options->replayPath << " is malformed at offset " 
+                      << cursor.offset << ".\n";
+        }
+        else
+        {
+            perror("replay::mmap()");
+        }
+        munmap(const_cast<char*>(file), fileSize);
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    ReplaySample* samples = static_cast<ReplaySample*>(samplesRegion); // NOTE: zero-filled, nothing is answered yet
+    const unsigned int entryCount = cursor.entry;
+
+    // fork the generators, and wait for every one of them to finish its share of the log
+    std::cout.flush(); // NOTE: nothing buffered may be written twice by the generators
+    const uint64_t startTime = monotonic_nanoseconds();
+    std::vector<pid_t> generators;
+    bool failed = false;
+    for (unsigned int i = 0; i < replay.generatorCount && !failed; ++i)
+    {
+        const pid_t processID = fork();
+        if (processID == 0) // generator process
+        {
+            exit(run_replay_generator(i, &replay, file, fileSize, samples));
+        }
+        if (processID == -1)
+        {
+            perror("replay::fork()");
+            failed = true;
+            break;
+        }
+        generators.push_back(processID);
+    }
+    for (size_t i = 0; i < generators.size(); ++i)
+    {
+        if (failed)
+        {
+            kill_process(generators[i]);
+            continue;
+        }
+        int status;
+        while (waitpid(generators[i], &status, 0) == -1 && errno == EINTR)
+        {
+        }
+        failed = !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS;
+    }
+    const double seconds = (monotonic_nanoseconds() - startTime) / 1e9;
+    munmap(const_cast<char*>(file), fileSize);
+    if (failed)
+    {
+        munmap(samplesRegion, samplesSize);
+        close_queues();
+        return EXIT_FAILURE;
+    }
+
+    // sum the samples up by command, in opcode order (CMD_EXIT and the commands of a failed generator are unanswered)
+    std::vector<std::vector<uint64_t> > latencies(MAX_OPCODES);
+    for (unsigned int i = 0; i < entryCount; ++i)
+    {
+        if (samples[i].answered && samples[i].opcode < MAX_OPCODES)
+        {
+            latencies[samples[i].opcode].push_back(samples[i].latency);
+        }
+    }
+    munmap(samplesRegion, samplesSize);
+    std::vector<BenchResult> results;
+    for (unsigned int opcode = 0; opcode < MAX_OPCODES; ++opcode)
+    {
+        if (latencies[opcode].empty())
+        {
+            continue;
+        }
+        const bool known = opcode != OPCODE_TEXT && opcode < commandCount;
+        results.push_back(BenchResult());
+        BenchResult& result = results.back();
+        result.command = known ? command_entry(opcode).name : BENCH_TEXT_NAME;
+        result.priority = known ? command_entry(opcode).priority : PRIORITY_BULK;
+        result.requestCount = latencies[opcode].size();
+        result.seconds = seconds;
+        result.latencies.swap(latencies[opcode]);
+        std::sort(result.latencies.begin(), result.latencies.end());
+        result.placement = BENCH_PLACEMENT_NAMES[0];
+    }
+
+    print_bench_report(results, &replay.bench, &replay);
+    uint32_t nextRequestID = 0;
+    if (replay.bench.format == BENCH_FORMAT_TEXT && !print_server_stats(clientID, nextRequestID++))
+    {
+        return EXIT_FAILURE; // NOTE: the queues have already been cleaned up
+    }
+
+    // send CMD_EXIT last and wait for its reply, so the server (or session) ends like it does for the other clients
+    BenchOptions exitBench = replay.bench;
+    exitBench.requestCount = 1;
+    exitBench.concurrency = 1;
+    BenchResult exitResult;
+    if (!run_bench_round(clientID, std::vector<std::string>(1, CMD_EXIT), &exitBench, false, &nextRequestID, 
+                         &exitResult))
+    {
+        return EXIT_FAILURE; // NOTE: the queues have already been cleaned up
+    }
+    return EXIT_SUCCESS;
+}
+
+/********************************************************************************************************************************
+ * static void append_trace_event(std::string* trace, const char* name, char phase, uint32_t requestID, uint64_t time)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to append an async event of a traced request to the traceEvents of a Chrome trace, with
+ *      the comma separating it from the previous event (if any). The events of a request share its request ID, so the
+ *      slices of a request nest between its begin and end events, whichever requests overlap it.
+ *
+ * Parameters:
+ *      trace        I/O    std::string*    the trace being formatted, up to the events so far
+ *      name         I/P    const char*     the name of the slice
+ *      phase        I/P    char            'b' for the event beginning the slice, 'e' for the one ending it
+ *      requestID    I/P    uint32_t        the request ID of the traced request
+ *      time         I/P    uint64_t        the CLOCK_MONOTONIC time of the event in nanoseconds
+ *******************************************************************************************************************************/
+static void append_trace_event(std::string* trace, const char* name, char phase, uint32_t requestID, uint64_t time)
+{
+    char event[TRACE_EVENT_SIZE];
+    const int processID = getpid();
+    const size_t eventLength = format_length(snprintf(event, sizeof(event), 
+        "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"id\":%u,\"pid\":%d,\"tid\":%d,\"ts\":%llu.%03u}", 
+        (trace->back() == '[') ? "" : ",", name, TRACE_CATEGORY, phase, requestID, processID, processID, 
+        static_cast<unsigned long long>(time / 1000), static_cast<unsigned int>(time % 1000)), sizeof(event));
+    trace->append(event, eventLength);
+}
+
+/********************************************************************************************************************************
+ * static bool write_trace_file(const char* path)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Dumps the completed traces of the traceRing (the last TRACE_RING_SIZE of them) to a file in the Chrome
+ *      trace event format, which chrome://tracing and Perfetto both open. Every request is a slice named after its 
+ *      command, from the time it was framed to the time its reply was received, nesting one slice for each of the
+ *      TRACE_STAGE_NAMES (see append_trace_event()). Timestamps are CLOCK_MONOTONIC microseconds. On error, an error 
+ *      message is printed to the console.
+ *
+ * Parameters:
+ *      path                I/P    const char*    the file to write the traces to (ARG_TRACE)
+ *      write_trace_file    O/P    bool           true on success, false on error
+ *******************************************************************************************************************************/
+static bool write_trace_file(const char* path)
+{
+    const uint64_t head = traceHead.load(std::memory_order_acquire);
+    const unsigned int stageCount = sizeof(TRACE_STAGE_NAMES) / sizeof(TRACE_STAGE_NAMES[0]);
+    std::string trace = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (uint64_t i = (head > TRACE_RING_SIZE) ? head - TRACE_RING_SIZE : 0; i < head; ++i)
+    {
+        const TraceRecord& record = traceRing[i % TRACE_RING_SIZE];
+        const uint64_t times[stageCount + 1] = { record.stamps.enqueue, record.stamps.dequeue, record.stamps.handlerStart,
+                                                 record.stamps.handlerEnd, record.stamps.replyDequeue };
+        char command[TRACE_EVENT_SIZE];
+        if (record.opcode != OPCODE_TEXT && record.opcode < commandCount)
+        {
+            snprintf(command, sizeof(command), "%s", command_entry(record.opcode).name);
+        }
+        else
+        {
+            snprintf(command, sizeof(command), (record.opcode == OPCODE_TEXT) ? "text" : "opcode %u", record.opcode);
+        }
+
+        append_trace_event(&trace, command, 'b', record.requestID, times[0]);
+        for (unsigned int stage = 0; stage < stageCount; ++stage)
+        {
+            append_trace_event(&trace, TRACE_STAGE_NAMES[stage], 'b', record.requestID, times[stage]);
+            append_trace_event(&trace, TRACE_STAGE_NAMES[stage], 'e', record.requestID, times[stage + 1]);
+        }
+        append_trace_event(&trace, command, 'e', record.requestID, times[stageCount]);
+    }
+    trace += "]}\n";
+
+    const int file = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file == -1)
+    {
+        perror("client::open()");
+        return false;
+    }
+    const bool written = write(file, trace.data(), trace.size()) == static_cast<ssize_t>(trace.size());
+    if (!written)
+    {
+        perror("client::write()");
+    }
+    close(file);
+    return written;
+}
+
+/********************************************************************************************************************************
+ * static int run_client_loop(int32_t clientID, const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Run the non-interactive client when stdin is not a terminal.
+ * 10/14/2026   Kerby Kaska     Dump the traces of the client to ARG_TRACE once it is done.
+ * 10/14/2026   Kerby Kaska     Added the replay client, and record the commands of the client to ARG_RECORD.
+ *
+ * Description: Runs the client event loop selected by the program options: the replay client (ARG_REPLAY), the 
+ *      benchmark client (ARG_BENCH), the pipelined client (ARG_PIPELINED or ARG_BATCHED), or the interactive client. Should stdin not be a terminal, there
+ *      is no user to prompt, so instead of the interactive client, the non-interactive client runs: the pipelined client 
+ *      with a window of one request, which still sends one command at a time, but reads and writes in large chunks 
+ *      without printing the help message or the prompts. Once the client loop is done, its traces are dumped to
+ *      ARG_TRACE (if set, see write_trace_file()), even if it failed, since the traces leading up to it are of interest.
+ *      With ARG_RECORD, every command the client reads is logged to the file until the client loop is done (see 
+ *      record_command()).
+ *
+ * Parameters:
+ *      clientID           I/P    int32_t                 the client ID naming the private reply queue (0 for the shared
+ *                                                        responseQueue)
+ *      options            I/P    const ProgramOptions*   the program options selecting the client loop
+ *      run_client_loop    O/P    int                     EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_client_loop(int32_t clientID, const ProgramOptions* options)
+{
+    if (options->recordPath != NULL && !open_record_file(options->recordPath))
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    int result;
+    if (options->replayPath != NULL)
+    {
+        result = run_replay_client(clientID, options);
+    }
+    else if (options->benchmark)
+    {
+        result = run_bench_client(clientID, options);
+    }
+    else if (options->pipelined)
+    {
+        result = run_pipelined_client(clientID, options->batched, queueConfig.maxMessages);
+    }
+    else
+    {
+        result = isatty(STDIN_FILENO) ? run_client(clientID) : run_pipelined_client(clientID, false, 1);
+    }
+    close_record_file();
+    if (options->tracePath != NULL && !write_trace_file(options->tracePath))
+    {
+        return EXIT_FAILURE; // NOTE: the queues have been cleaned up (or still are by the caller) either way
+    }
+    return result;
+}
+
+/********************************************************************************************************************************
+ * static int run_standalone_server(unsigned int workerCount, bool persistent, const char* endpoint)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Adopt the attributes of a command queue which already exists.
+ * 10/14/2026   Kerby Kaska     Open the command queue non-blocking for the reactor of the server workers.
+ * 10/14/2026   Kerby Kaska     Added the persistent command queue (ARG_PERSISTENT), and resume the messages left on it.
+ * 10/14/2026   Kerby Kaska     Added the gateway (ARG_LISTEN).
+ * 10/14/2026   Kerby Kaska     Keep the path of the Unix domain socket of the gateway, which open_endpoint() no longer does.
+ *
+ * Description: Standalone server (ARG_SERVER). Creates the command queue and keeps it published under COMMAND_QUEUE_NAME,
+ *      so that any number of standalone client processes (ARG_CLIENT) can attach to it, and then runs the server pool
+ *      until it is signalled to stop. Every client names its own private reply queue in the header of its requests, so
+ *      there is no shared response queue. The command queue is unlinked again when the server exits. Should the command
+ *      queue already exist (left behind by a crashed server), its depth and message size are adopted by the server.
+ *
+ *      A persistent command queue is not unlinked on exit, so the next server starts on the same queue, and the commands
+ *      clients sent while no server was running are kept on it. The messages left on the queue are served first, like any
+ *      other (replies to clients which have exited since are dropped). Clients keep the same queue open across restarts.
+ *
+ *      With an endpoint (ARG_LISTEN), the server also listens on a Unix domain or TCP socket (see open_endpoint()), which 
+ *      every worker inherits, so clients on other hosts (or without access to the message queues) send their commands 
+ *      through it, into the same serve_message() as the command queue (see serve_connection()). The socket is closed (and
+ *      the path of a Unix domain socket unlinked) when the server exits.
+ *
+ * Parameters:
+ *      workerCount              I/P    unsigned int    the number of worker processes in the server pool
+ *      persistent               I/P    bool            true to keep the command queue on exit (ARG_PERSISTENT)
+ *      endpoint                 I/P    const char*     the endpoint the gateway listens on (ARG_LISTEN), or NULL for none
+ *      run_standalone_server    O/P    int             EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_standalone_server(unsigned int workerCount, bool persistent, const char* endpoint)
+{
+    mq_attr queueAttributes = queue_attributes();
+    commandQueue = mq_open(COMMAND_QUEUE_NAME, O_RDONLY | O_CREAT | O_NONBLOCK, QUEUE_PERMISSIONS, &queueAttributes);
+    if (commandQueue == -1)
+    {
+        perror("commandQueue::mq_open()");
+        return EXIT_FAILURE;
+    }
+    if (!persistent)
+    {
+        snprintf(ownedQueueName, sizeof(ownedQueueName), "%s", COMMAND_QUEUE_NAME); // unlinked by close_queues() on exit
+    }
+    keepQueuedCommands = persistent; // NOTE: the commands left queued are kept for the next server, not drained on exit
+
+    // mq_open() ignores the attributes of a queue which already exists, so use whatever it was created with
+    if (mq_getattr(commandQueue, &queueAttributes) == -1)
+    {
+        perror("commandQueue::mq_getattr()");
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    queueConfig.maxMessages = queueAttributes.mq_maxmsg;
+    queueConfig.messageSize = queueAttributes.mq_msgsize;
+
+    // the listening socket of the gateway is inherited by every worker forked by the supervisor
+    if (endpoint != NULL && (gatewayDescriptor = open_endpoint(endpoint, true)) == -1)
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    if (endpoint != NULL && strncmp(endpoint, GATEWAY_UNIX_PREFIX, strlen(GATEWAY_UNIX_PREFIX)) == 0)
+    {
+        snprintf(gatewaySocketPath, sizeof(gatewaySocketPath), "%s", endpoint + strlen(GATEWAY_UNIX_PREFIX)); // unlinked on exit
+    }
+
+    std::cout << "Serving commands on " << COMMAND_QUEUE_NAME << ((endpoint != NULL) ? " and " : "") 
+              << ((endpoint != NULL) ? endpoint : "") << " with " << workerCount << " worker(s) (depth " 
+              << queueConfig.maxMessages << ", message size " << queueConfig.messageSize << ")." << std::endl;
+    if (queueAttributes.mq_curmsgs > 0)
+    {
+        char text[96]; // NOTE: room for MESSAGE_RESUMING with any long, so an optimized build never warns of truncation
+        snprintf(text, sizeof(text), MESSAGE_RESUMING, queueAttributes.mq_curmsgs);
+        std::cout << text << std::endl; // NOTE: the workers drain them first, as soon as their reactors start
+    }
+    const int result = run_supervisor(0, workerCount); // NOTE: only the supervisor returns, the workers exit in it
+
+    if (gatewayDescriptor != -1)
+    {
+        close(gatewayDescriptor);
+        gatewayDescriptor = -1;
+    }
+    if (gatewaySocketPath[0] != '\0' && unlink(gatewaySocketPath) == -1)
+    {
+        perror("endpoint::unlink()");
+    }
+    return result;
+}
+
+/********************************************************************************************************************************
+ * static int run_standalone_client(const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added the batched client mode.
+ * 10/14/2026   Kerby Kaska     Adopt the message size of the server.
+ * 10/14/2026   Kerby Kaska     Run the client loop selected by the program options (see run_client_loop()).
+ * 10/14/2026   Kerby Kaska     Reattach to a restarted server.
+ * 10/14/2026   Kerby Kaska     Pin the client to its CPU of the placement.
+ * 10/14/2026   Kerby Kaska     Moved the creation of the private reply queue to create_reply_queue().
+ *
+ * Description: Standalone client (ARG_CLIENT). Attaches to the command queue published by a running standalone server,
+ *      and creates a private reply queue named after its process ID (REPLY_QUEUE_NAME_FORMAT). The process ID is sent
+ *      as the client ID in the header of every request, so the server replies on the private queue, and replies to other 
+ *      clients can never block this one. The private reply queue is unlinked again when the client exits. The message 
+ *      size of the command queue is adopted by the client, so its requests always fit in the command queue, and the 
+ *      replies of the server always fit in the private reply queue.
+ *
+ *      The interactive and pipelined clients survive a restart of the server (see receive_reply()): should a reply take
+ *      too long, the client reattaches to the (restarted) server, and resends every command that has not been answered.
+ *
+ *      With ARG_AFFINITY, the client is pinned to the first CPU of its placement. The placement of the server pool is
+ *      that of the server process, so for AFFINITY_AUTO both should be started on the same NUMA node (with taskset).
+ *
+ * Parameters:
+ *      options                  I/P    const ProgramOptions*    the program options selecting the client loop
+ *      run_standalone_client    O/P    int                      EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_standalone_client(const ProgramOptions* options)
+{
+    commandQueue = mq_open(COMMAND_QUEUE_NAME, O_WRONLY);
+    if (commandQueue == -1)
+    {
+        const int error = errno; // NOTE: perror() may change errno
+        perror("commandQueue::mq_open()");
+        if (error == ENOENT)
+        {
+            std::cerr << MESSAGE_NO_SERVER << std::endl;
+        }
+        return EXIT_FAILURE;
+    }
+    mq_attr serverAttributes;
+    if (mq_getattr(commandQueue, &serverAttributes) == -1)
+    {
+        perror("commandQueue::mq_getattr()");
+        close_queues();
+        return EXIT_FAILURE;
+    }
+    queueConfig.messageSize = serverAttributes.mq_msgsize;
+
+    // create the private reply queue (replacing one left behind by a crashed client with the same process ID)
+    const int32_t clientID = getpid();
+    if (!create_reply_queue(clientID) || !place_process(0))
+    {
+        close_queues();
+        return EXIT_FAILURE;
+    }
+
+    clientReconnects = true; // NOTE: the private reply queue outlives the server, so only the command queue is reattached
+    const int result = run_client_loop(clientID, options);
+    if (result == EXIT_FAILURE)
+    {
+        return EXIT_FAILURE; // NOTE: the client has already cleaned up the queues
+    }
+    return close_queues();
+}
+
+/********************************************************************************************************************************
+ * static void receive_fanout_reply(FanoutHost* host, uint32_t requestID, char* textBuffer, char* expandBuffer)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Render a streamed binary reply once its last chunk has arrived.
+ *
+ * Description: Receives what the connection of a fan-out host has sent (a single recv()), and collects every frame of the
+ *      reply to the current command into the result of the host, expanded, and rendered once whole, like the other clients
+ *      do. The host has answered once the last chunk of the reply (see stream_reply()) has arrived. Late replies to earlier
+ *      commands (which timed out) are dropped. Should the connection be lost, or the host send something malformed, the
+ *      connection is closed.
+ *
+ * Parameters:
+ *      host             I/P    FanoutHost*    the host to receive from
+ *      requestID        I/P    uint32_t       the request ID of the current command
+ *      textBuffer       I/P    char*          buffer of UNAME_TEXT_SIZE bytes the binary responses are rendered into
+ *      expandBuffer     I/P    char*          buffer of QUEUE_MAX_MESSAGE_SIZE bytes the compressed responses are expanded into
+ *******************************************************************************************************************************/
+static void receive_fanout_reply(FanoutHost* host, uint32_t requestID, char* textBuffer, char* expandBuffer)
+{
+    const ssize_t received = recv(host->descriptor, &host->input[host->inputLength], 
+                                  host->input.size() - host->inputLength, 0);
+    if (received == -1 && errno == EINTR)
+    {
+        return;
+    }
+    if (received <= 0)
+    {
+        if (received == -1)
+        {
+            perror("client::recv()");
+        }
+        close(host->descriptor); // NOTE: the host has gone (or ended the session)
+        host->descriptor = -1;
+        return;
+    }
+    host->inputLength += received;
+
+    // collect every whole message received, and keep a partial one until the rest of it arrives
+    size_t offset = 0;
+    while (host->inputLength - offset >= GATEWAY_LENGTH_SIZE)
+    {
+        uint32_t messageLength;
+        memcpy(&messageLength, &host->input[offset], GATEWAY_LENGTH_SIZE);
+        if (messageLength > host->input.size() - GATEWAY_LENGTH_SIZE)
+        {
+            std::cerr << "client::receive_fanout_reply() - " << host->endpoint << " sent a malformed message (" 
+                      << messageLength << " bytes).\n";
+            close(host->descriptor);
+            host->descriptor = -1;
+            return;
+        }
+        if (host->inputLength - offset - GATEWAY_LENGTH_SIZE < messageLength)
+        {
+            break;
+        }
+        const char* message = &host->input[offset + GATEWAY_LENGTH_SIZE];
+        offset += GATEWAY_LENGTH_SIZE + messageLength;
+
+        MessageHeader header;
+        size_t frameOffset = 0;
+        while (read_frame(message, messageLength, frameOffset, &header))
+        {
+            const char* payload = message + frameOffset + sizeof(header);
+            size_t payloadLength = header.payloadLength;
+            frameOffset += sizeof(header) + header.payloadLength;
+            if (header.requestID != requestID || host->answered || header.sequence != host->sequence)
+            {
+                continue; // NOTE: the late reply to a command which timed out
+            }
+            if (!expand_reply(header, &payload, &payloadLength, expandBuffer, QUEUE_MAX_MESSAGE_SIZE))
+            {
+                close(host->descriptor);
+                host->descriptor = -1;
+                return;
+            }
+            host->result.append(payload, payloadLength);
+            ++host->sequence;
+            host->answered = (header.flags & FRAME_MORE) == 0;
+            if (host->answered && header.opcode == OPCODE_GET_UNAME_FIELDS)
+            {
+                // NOTE: the entries of a binary reply span the chunks, so it is rendered once the last one has arrived
+                size_t textLength;
+                if (!render_uname(host->result.data(), host->result.size(), textBuffer, UNAME_TEXT_SIZE, &textLength))
+                {
+                    close(host->descriptor);
+                    host->descriptor = -1;
+                    return;
+                }
+                host->result.assign(textBuffer, textLength);
+            }
+        }
+    }
+    memmove(&host->input[0], &host->input[offset], host->inputLength - offset);
+    host->inputLength -= offset;
+}
+
+/********************************************************************************************************************************
+ * static int run_fanout_client(const ProgramOptions* options)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Fan-out client (ARG_HOSTS). Connects once to the gateway (ARG_LISTEN) of every host, and reuses the 
+ *      connections for every command read from stdin: each command is framed once, sent to every host at once, and the
+ *      replies of all of them are awaited in parallel with poll(), so a command costs the round trip of the slowest host
+ *      rather than the sum of them. The replies are then printed in the order the hosts were given, each one prefixed by 
+ *      the endpoint of its host. A host which has not answered within FANOUT_REPLY_TIMEOUT milliseconds (or the
+ *      requestTimeout) is printed as MESSAGE_TIMED_OUT, and one which is not connected as MESSAGE_NO_CONNECTION. Loops
+ *      until the CMD_EXIT command (which ends the session on every host) or the end of the input.
+ *
+ *      The requests carry no deadline, since the CLOCK_MONOTONIC of the client means nothing to another host (see 
+ *      MessageHeader), so the timeout is kept by the client alone. The commands are framed with the message size of the
+ *      client, which must not exceed that of the servers (a server closes the connection of a larger message).
+ *
+ * Parameters:
+ *      options              I/P    const ProgramOptions*    the program options naming the hosts (ARG_HOSTS)
+ *      run_fanout_client    O/P    int                      EXIT_SUCCESS on success, EXIT_FAILURE on error
+ *******************************************************************************************************************************/
+static int run_fanout_client(const ProgramOptions* options)
+{
+    // connect to every host once, the connections are reused by every command
+    std::vector<FanoutHost> hosts;
+    for (const char* endpoint = options->hosts; *endpoint != '\0'; )
+    {
+        const char* end = strchr(endpoint, ',');
+        const size_t endpointLength = (end != NULL) ? static_cast<size_t>(end - endpoint) : strlen(endpoint);
+        FanoutHost host;
+        host.endpoint.assign(endpoint, endpointLength);
+        host.descriptor = open_endpoint(host.endpoint.c_str(), false);
+        host.input.resize(GATEWAY_LENGTH_SIZE + QUEUE_MAX_MESSAGE_SIZE);
+        host.inputLength = 0;
+        host.sequence = 0;
+        host.answered = false;
+        hosts.push_back(host);
+        endpoint += endpointLength + ((end != NULL) ? 1 : 0);
+    }
+
+    const size_t messageSize = queueConfig.messageSize;
+    std::vector<char> buffers(GATEWAY_LENGTH_SIZE + messageSize + UNAME_TEXT_SIZE + QUEUE_MAX_MESSAGE_SIZE);
+    char* outputBuffer = &buffers[0]; // output buffer - the length-prefixed framed command for every host
+    char* textBuffer = outputBuffer + GATEWAY_LENGTH_SIZE + messageSize; // text buffer - binary responses rendered as text
+    char* expandBuffer = textBuffer + UNAME_TEXT_SIZE; // expand buffer - compressed responses expanded
+    std::vector<pollfd> descriptors(hosts.size());
+    std::vector<size_t> polledHosts(hosts.size()); // index in hosts of each of the descriptors
+    InputReader reader = { STDIN_FILENO, std::vector<char>(STREAM_INPUT_SIZE), 0, 0, false };
+    OutputWriter writer = { STDOUT_FILENO, std::vector<char>(STREAM_OUTPUT_SIZE), 0 };
+
+    bool succeeded = true;
+    bool running = true;
+    uint32_t requestID = 0;
+    const char* input;
+    size_t inputLength;
+    while (running && succeeded && read_line(&reader, &writer, &input, &inputLength))
+    {
+        // send the command to every host which is connected
+        uint16_t opcode;
+        const uint32_t messageLength = frame_command(input, inputLength, requestID, 0, 0, 
+            outputBuffer + GATEWAY_LENGTH_SIZE, messageSize, true, &opcode);
+        memcpy(outputBuffer, &messageLength, GATEWAY_LENGTH_SIZE);
+        running = opcode != OPCODE_EXIT; // NOTE: every host ends the session, and closes the connection after it
+        for (size_t i = 0; i < hosts.size(); ++i)
+        {
+            FanoutHost& host = hosts[i];
+            host.result.clear();
+            host.sequence = 0;
+            host.answered = false;
+            size_t sent = 0;
+            while (host.descriptor != -1 && sent < GATEWAY_LENGTH_SIZE + messageLength)
+            {
+                const ssize_t length = send(host.descriptor, outputBuffer + sent, 
+                                            GATEWAY_LENGTH_SIZE + messageLength - sent, MSG_NOSIGNAL);
+                if (length == -1 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (length == -1)
+                {
+                    perror("client::send()"); // NOTE: the host has gone
+                    close(host.descriptor);
+                    host.descriptor = -1;
+                    break;
+                }
+                sent += length;
+            }
+        }
+
+        // wait for the replies of every host in parallel, until the timeout
+        uint32_t deadline = monotonic_milliseconds() + ((requestTimeout != 0) ? requestTimeout : FANOUT_REPLY_TIMEOUT);
+        deadline = (deadline == 0) ? 1 : deadline; // NOTE: 0 stands for no deadline
+        while (true)
+        {
+            nfds_t descriptorCount = 0;
+            for (size_t i = 0; i < hosts.size(); ++i)
+            {
+                if (hosts[i].descriptor != -1 && !hosts[i].answered)
+                {
+                    descriptors[descriptorCount].fd = hosts[i].descriptor;
+                    descriptors[descriptorCount].events = POLLIN;
+                    descriptors[descriptorCount].revents = 0;
+                    polledHosts[descriptorCount++] = i;
+                }
+            }
+            const int timeout = remaining_timeout(deadline);
+            if (descriptorCount == 0 || timeout == 0)
+            {
+                break;
+            }
+            const int readyCount = poll(&descriptors[0], descriptorCount, timeout);
+            if (readyCount == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (readyCount == -1)
+            {
+                perror("client::poll()");
+                succeeded = false;
+                break;
+            }
+            for (nfds_t i = 0; i < descriptorCount; ++i)
+            {
+                if (descriptors[i].revents != 0)
+                {
+                    receive_fanout_reply(&hosts[polledHosts[i]], requestID, textBuffer, expandBuffer);
+                }
+            }
+        }
+        ++requestID;
+
+        // print the reply of every host, in the order the hosts were given
+        for (size_t i = 0; i < hosts.size() && succeeded; ++i)
+        {
+            const FanoutHost& host = hosts[i];
+            const char* result = host.answered ? host.result.data() : 
+                (host.descriptor == -1) ? MESSAGE_NO_CONNECTION : MESSAGE_TIMED_OUT;
+            const size_t resultLength = host.answered ? host.result.size() : strlen(result);
+            succeeded = write_output(&writer, host.endpoint.data(), host.endpoint.size(), false) && 
+                        write_output(&writer, ": ", 2, false) && write_output(&writer, result, resultLength, true);
+        }
+    }
+    succeeded = flush_output(&writer) && succeeded;
+
+    for (size_t i = 0; i < hosts.size(); ++i)
+    {
+        if (hosts[i].descriptor != -1)
+        {
+            close(hosts[i].descriptor);
+        }
+    }
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/********************************************************************************************************************************
+ * static bool parse_option(const char* name, const char* text, unsigned int minimum, unsigned int maximum, 
+ *                          unsigned int* value)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of parse_arguments().
+ *
+ * Description: Utility method to parse the value of a command line argument (or environment variable) as a count between
+ *      minimum and maximum (inclusive). On error, an error message and the usage message are printed to the console.
+ *
+ * Parameters:
+ *      name            I/P    const char*      the name of the argument (or environment variable), for the error message
+ *      text            I/P    const char*      the value to parse, or NULL if the argument is missing its value
+ *      minimum         I/P    unsigned int     the smallest accepted value
+ *      maximum         I/P    unsigned int     the largest accepted value
+ *      value           O/P    unsigned int*    the parsed value (unchanged on error)
+ *      parse_option    O/P    bool             true if text is a valid value, false otherwise
+ *******************************************************************************************************************************/
+static bool parse_option(const char* name, const char* text, unsigned int minimum, unsigned int maximum, 
+                         unsigned int* value)
+{
+    if (text == NULL || !parse_count(text, minimum, maximum, value))
+    {
+        std::cerr << "Invalid value for " << name << " (expected " << minimum << " to " << maximum << ")\n" 
+                  << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static bool read_system_limit(const char* path, long* limit)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to read a message queue limit of the system, such as MSG_MAX_PATH or MSGSIZE_MAX_PATH.
+ *
+ * Parameters:
+ *      path                 I/P    const char*    the file holding the limit
+ *      limit                O/P    long*          the limit (unchanged on error)
+ *      read_system_limit    O/P    bool           true if the limit was read, false if the file is missing or unreadable
+ *******************************************************************************************************************************/
+static bool read_system_limit(const char* path, long* limit)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+    const bool result = (fscanf(file, "%ld", limit) == 1);
+    fclose(file);
+    return result;
+}
+
+/********************************************************************************************************************************
+ * static bool check_queue_limits(const QueueConfig* config)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Checks a queue configuration against the message queue limits of the system (MSG_MAX_PATH and 
+ *      MSGSIZE_MAX_PATH, and MQ_PRIO_MAX), so a mismatch is reported clearly up front instead of as an EINVAL from 
+ *      mq_open() or mq_send(). A limit the system does not publish is not checked. On a mismatch, an error message is
+ *      printed to the console, naming the limit and how to raise it.
+ *
+ * Parameters:
+ *      config                I/P    const QueueConfig*    the queue configuration to check
+ *      check_queue_limits    O/P    bool                  true if the configuration is within the limits, false otherwise
+ *******************************************************************************************************************************/
+static bool check_queue_limits(const QueueConfig* config)
+{
+    bool result = true;
+    long limit;
+    if (read_system_limit(MSG_MAX_PATH, &limit) && config->maxMessages > limit)
+    {
+        std::cerr << "Queue depth " << config->maxMessages << " exceeds the system limit of " << limit << " (raise it in " 
+                  << MSG_MAX_PATH << ")" << std::endl;
+        result = false;
     }
-    // wait for the process to exit to avoid a zombie
-    if (waitpid(processID, NULL, 0) == -1)
+    if (read_system_limit(MSGSIZE_MAX_PATH, &limit) && config->messageSize > limit)
     {
-        std::cerr << "kill_process::waitpid() - unable to wait for process (" << processID << ") to exit.\n";
+        std::cerr << "Message size " << config->messageSize << " exceeds the system limit of " << limit << " (raise it in " 
+                  << MSGSIZE_MAX_PATH << ")" << std::endl;
+        result = false;
+    }
+    limit = sysconf(_SC_MQ_PRIO_MAX);
+    if (limit > 0 && config->messagePriority + PRIORITY_CONTROL >= limit)
+    {
+        std::cerr << "Message priority " << config->messagePriority << " exceeds the system limit of " 
+                  << (limit - 1 - PRIORITY_CONTROL) << " (" << PRIORITY_CONTROL << " below MQ_PRIO_MAX - 1)" << std::endl;
+        result = false;
     }
+    return result;
 }
 
 /********************************************************************************************************************************
- * static void signal_handler(int signalNum)
+ * static bool parse_arguments(int argc, char* argv[], ProgramOptions* options)
  * Author: Kerby Kaska
- * Date: 1/20/2022
+ * Date: 10/14/2026
  * Modification History:
- * 1/20/2022    Kerby Kaska     Created.
- * 1/23/2022    Kerby Kaska     Refactored to call close_queues() instead to clean up resources.
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added ARG_BATCHED.
+ * 10/14/2026   Kerby Kaska     Added ARG_TRANSPORT.
+ * 10/14/2026   Kerby Kaska     Added ARG_QUEUE_DEPTH, ARG_MESSAGE_SIZE, and ARG_PRIORITY, with defaults from the environment.
+ * 10/14/2026   Kerby Kaska     Added ARG_BENCH, ARG_CONCURRENCY, ARG_PAYLOAD, and ARG_FORMAT.
+ * 10/14/2026   Kerby Kaska     Added ARG_DEADLINE and ARG_SHED_AT.
+ * 10/14/2026   Kerby Kaska     Added ARG_AFFINITY.
+ * 10/14/2026   Kerby Kaska     Added ARG_COMPRESS.
+ * 10/14/2026   Kerby Kaska     Added ARG_LISTEN and ARG_HOSTS.
+ * 10/14/2026   Kerby Kaska     Added ARG_TRACE and ARG_TRACE_RATE.
+ * 10/14/2026   Kerby Kaska     Added ARG_RECORD, ARG_REPLAY, ARG_SPEED, and ARG_GENERATORS.
  *
- * Description: Signal handler for SIGINT, SIGKILL, SIGSTOP, and SIGTERM to ensure proper cleanup of resources used.
- *     On error, an error message is printed to the console and the program is terminated EXIT_FAILURE.
- *     On success, the program is terminated EXIT_SUCCESS.
+ * Description: Parses the provided command line arguments into the program options. On an unrecognized argument (or an
+ *      invalid combination of arguments), an error message and the usage message are printed to the console and false 
+ *      is returned.
  *
  * Parameters:
- *     signalNum    I/P    int    (unused) indicator of the system signal which triggered the handler
+ *      argc               I/P    int                number of provided command line arguments
+ *      argv               I/P    char**             provided command line arguments
+ *      options            O/P    ProgramOptions*    the parsed program options
+ *      parse_arguments    O/P    bool               true if every argument was recognized, false otherwise
  *******************************************************************************************************************************/
-static void signal_handler(int signalNum)
+static bool parse_arguments(int argc, char* argv[], ProgramOptions* options)
 {
-    exit(close_queues());
+    options->server = false;
+    options->client = false;
+    options->pipelined = false;
+    options->batched = false;
+    options->workerCount = 1;
+    options->transport = &MQUEUE_TRANSPORT;
+    options->queue = queueConfig;
+    options->benchmark = false;
+    options->bench.requestCount = 0;
+    options->bench.concurrency = 1;
+    options->bench.payloadSize = 16;
+    options->bench.format = BENCH_FORMAT_TEXT;
+    options->stats = statsConfig;
+    options->pluginCount = 0;
+    options->persistent = false;
+    options->requestTimeout = 0;
+    options->shedThreshold = 0;
+    options->affinity = NULL;
+    options->compress = false;
+    options->listen = NULL;
+    options->hosts = NULL;
+    options->tracePath = NULL;
+    options->traceInterval = 0;
+    options->recordPath = NULL;
+    options->replayPath = NULL;
+    options->replaySpeed = 1;
+    options->generatorCount = 1;
+    bool replayOptions = false; // true once ARG_SPEED or ARG_GENERATORS is given
+
+    // the environment provides the defaults of the queue configuration, which the command line arguments override
+    QueueConfig* queue = &options->queue;
+    if ((getenv(ENV_QUEUE_DEPTH) != NULL && 
+         !parse_option(ENV_QUEUE_DEPTH, getenv(ENV_QUEUE_DEPTH), 1, QUEUE_DEPTH_LIMIT, &queue->maxMessages)) ||
+        (getenv(ENV_MESSAGE_SIZE) != NULL &&
+         !parse_option(ENV_MESSAGE_SIZE, getenv(ENV_MESSAGE_SIZE), QUEUE_MIN_MESSAGE_SIZE, QUEUE_MAX_MESSAGE_SIZE, 
+                       &queue->messageSize)) ||
+        (getenv(ENV_PRIORITY) != NULL && 
+         !parse_option(ENV_PRIORITY, getenv(ENV_PRIORITY), 0, QUEUE_PRIORITY_LIMIT, &queue->messagePriority)))
+    {
+        return false;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], ARG_SERVER) == 0)
+        {
+            options->server = true;
+        }
+        else if (strcmp(argv[i], ARG_CLIENT) == 0)
+        {
+            options->client = true;
+        }
+        else if (strcmp(argv[i], ARG_PIPELINED) == 0)
+        {
+            options->pipelined = true;
+        }
+        else if (strcmp(argv[i], ARG_BATCHED) == 0)
+        {
+            options->pipelined = true;
+            options->batched = true;
+        }
+        else if (strcmp(argv[i], ARG_WORKERS) == 0)
+        {
+            if (!parse_option(ARG_WORKERS, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_WORKERS, &options->workerCount))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_QUEUE_DEPTH) == 0)
+        {
+            if (!parse_option(ARG_QUEUE_DEPTH, (i + 1 < argc) ? argv[++i] : NULL, 1, QUEUE_DEPTH_LIMIT, 
+                              &queue->maxMessages))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_MESSAGE_SIZE) == 0)
+        {
+            if (!parse_option(ARG_MESSAGE_SIZE, (i + 1 < argc) ? argv[++i] : NULL, QUEUE_MIN_MESSAGE_SIZE, 
+                              QUEUE_MAX_MESSAGE_SIZE, &queue->messageSize))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_PRIORITY) == 0)
+        {
+            if (!parse_option(ARG_PRIORITY, (i + 1 < argc) ? argv[++i] : NULL, 0, QUEUE_PRIORITY_LIMIT, 
+                              &queue->messagePriority))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_BENCH) == 0)
+        {
+            if (!parse_option(ARG_BENCH, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_BENCH_REQUESTS, 
+                              &options->bench.requestCount))
+            {
+                return false;
+            }
+            options->benchmark = true;
+        }
+        else if (strcmp(argv[i], ARG_CONCURRENCY) == 0)
+        {
+            if (!parse_option(ARG_CONCURRENCY, (i + 1 < argc) ? argv[++i] : NULL, 1, QUEUE_DEPTH_LIMIT, 
+                              &options->bench.concurrency))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_PAYLOAD) == 0)
+        {
+            if (!parse_option(ARG_PAYLOAD, (i + 1 < argc) ? argv[++i] : NULL, 0, QUEUE_MAX_MESSAGE_SIZE, 
+                              &options->bench.payloadSize))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_FORMAT) == 0)
+        {
+            const char* name = (i + 1 < argc) ? argv[++i] : "";
+            unsigned int format = 0;
+            while (format < BENCH_FORMAT_COUNT && strcmp(name, BENCH_FORMAT_NAMES[format]) != 0)
+            {
+                ++format;
+            }
+            if (format == BENCH_FORMAT_COUNT)
+            {
+                std::cerr << "Invalid value for " << ARG_FORMAT << " (expected text, csv, or json)\n" 
+                          << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->bench.format = static_cast<BenchFormat>(format);
+        }
+        else if (strcmp(argv[i], ARG_STATS_FILE) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_STATS_FILE << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->stats.dumpPath = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_STATS_INTERVAL) == 0)
+        {
+            if (!parse_option(ARG_STATS_INTERVAL, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_STATS_INTERVAL, 
+                              &options->stats.dumpInterval))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_PLUGIN) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_PLUGIN << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            if (options->pluginCount == MAX_PLUGINS)
+            {
+                std::cerr << "At most " << MAX_PLUGINS << " plugins can be loaded.\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->plugins[options->pluginCount++] = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_PERSISTENT) == 0)
+        {
+            options->persistent = true;
+        }
+        else if (strcmp(argv[i], ARG_DEADLINE) == 0)
+        {
+            if (!parse_option(ARG_DEADLINE, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_DEADLINE, &options->requestTimeout))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_SHED_AT) == 0)
+        {
+            if (!parse_option(ARG_SHED_AT, (i + 1 < argc) ? argv[++i] : NULL, 1, QUEUE_DEPTH_LIMIT, 
+                              &options->shedThreshold))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_COMPRESS) == 0)
+        {
+            options->compress = true;
+        }
+        else if (strcmp(argv[i], ARG_LISTEN) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_LISTEN << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->listen = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_HOSTS) == 0)
+        {
+            // a comma-separated list of endpoints, none of them empty
+            const char* hosts = (i + 1 < argc) ? argv[++i] : "";
+            unsigned int hostCount = 1;
+            for (const char* comma = strchr(hosts, ','); comma != NULL; comma = strchr(comma + 1, ','))
+            {
+                ++hostCount;
+            }
+            if (hosts[0] == '\0' || hosts[0] == ',' || hosts[strlen(hosts) - 1] == ',' || strstr(hosts, ",,") != NULL ||
+                hostCount > MAX_FANOUT_HOSTS)
+            {
+                std::cerr << "Invalid value for " << ARG_HOSTS << " (expected at most " << MAX_FANOUT_HOSTS 
+                          << " comma-separated endpoints)\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->hosts = hosts;
+        }
+        else if (strcmp(argv[i], ARG_TRACE) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_TRACE << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_TRACE_RATE) == 0)
+        {
+            if (!parse_option(ARG_TRACE_RATE, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_TRACE_INTERVAL, 
+                              &options->traceInterval))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_RECORD) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_RECORD << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_REPLAY) == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0')
+            {
+                std::cerr << "Missing value for " << ARG_REPLAY << "\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+            options->replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], ARG_SPEED) == 0)
+        {
+            replayOptions = true;
+            if (i + 1 < argc && strcmp(argv[i + 1], REPLAY_SPEED_MAX) == 0)
+            {
+                options->replaySpeed = 0;
+                ++i;
+            }
+            else if (!parse_option(ARG_SPEED, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_REPLAY_SPEED, 
+                                   &options->replaySpeed))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_GENERATORS) == 0)
+        {
+            replayOptions = true;
+            if (!parse_option(ARG_GENERATORS, (i + 1 < argc) ? argv[++i] : NULL, 1, MAX_GENERATORS, 
+                              &options->generatorCount))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_AFFINITY) == 0)
+        {
+            int cpus[CPU_SETSIZE];
+            unsigned int cpuCount;
+            options->affinity = (i + 1 < argc) ? argv[++i] : NULL;
+            if (options->affinity == NULL ||
+                (strcmp(options->affinity, AFFINITY_AUTO) != 0 && !parse_cpu_list(options->affinity, cpus, &cpuCount)))
+            {
+                std::cerr << "Invalid value for " << ARG_AFFINITY << " (expected " << AFFINITY_AUTO
+                          << " or a list of CPUs such as 0,2-3)\n" << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], ARG_TRANSPORT) == 0)
+        {
+            if (i + 1 >= argc || (options->transport = find_transport(argv[++i])) == NULL)
+            {
+                std::cerr << "Invalid value for " << ARG_TRANSPORT << " (expected mqueue or shm)\n" 
+                          << MESSAGE_USAGE << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown argument: \"" << argv[i] << "\"\n" << MESSAGE_USAGE << std::endl;
+            return false;
+        }
+    }
+    if (options->server && options->client)
+    {
+        std::cerr << ARG_SERVER << " and " << ARG_CLIENT << " cannot be combined\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->server && options->benchmark)
+    {
+        std::cerr << ARG_BENCH << " cannot be combined with " << ARG_SERVER << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->client && options->pluginCount > 0)
+    {
+        // NOTE: a standalone client sends the commands it does not know as text, which the server looks up by name
+        std::cerr << ARG_PLUGIN << " cannot be combined with " << ARG_CLIENT << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->client && options->stats.dumpPath != NULL)
+    {
+        // NOTE: the statistics belong to the server pool, which a standalone client does not run
+        std::cerr << ARG_STATS_FILE << " cannot be combined with " << ARG_CLIENT << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->persistent && !options->server)
+    {
+        // NOTE: the forked processes share anonymous queues, only the standalone server publishes its command queue
+        std::cerr << ARG_PERSISTENT << " requires " << ARG_SERVER << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->requestTimeout != 0 && (options->server || options->benchmark))
+    {
+        // NOTE: the deadline belongs to the requests of a client, and the benchmark measures every request to the end
+        std::cerr << ARG_DEADLINE << " cannot be combined with " << ARG_SERVER << " or " << ARG_BENCH << "\n" 
+                  << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->server && options->compress)
+    {
+        // NOTE: every client flags its own requests, and the server compresses the replies to those which do
+        std::cerr << ARG_COMPRESS << " cannot be combined with " << ARG_SERVER << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->client && options->shedThreshold != 0)
+    {
+        // NOTE: the load is shed by the server pool, which a standalone client does not run
+        std::cerr << ARG_SHED_AT << " cannot be combined with " << ARG_CLIENT << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->listen != NULL && !options->server)
+    {
+        // NOTE: the gateway serves clients next to the published command queue, which only the standalone server has
+        std::cerr << ARG_LISTEN << " requires " << ARG_SERVER << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->hosts != NULL && (options->server || options->client || options->benchmark || options->pipelined))
+    {
+        // NOTE: the fan-out client sends one command at a time to every host, and runs no server of its own
+        std::cerr << ARG_HOSTS << " cannot be combined with " << ARG_SERVER << ", " << ARG_CLIENT << ", " << ARG_BENCH 
+                  << ", " << ARG_PIPELINED << ", or " << ARG_BATCHED << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->tracePath != NULL && (options->server || options->hosts != NULL))
+    {
+        // NOTE: the client traces its own requests, and the clocks of other hosts cannot be compared with its own
+        std::cerr << ARG_TRACE << " cannot be combined with " << ARG_SERVER << " or " << ARG_HOSTS << "\n" 
+                  << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->traceInterval != 0 && options->tracePath == NULL)
+    {
+        std::cerr << ARG_TRACE_RATE << " requires " << ARG_TRACE << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->tracePath != NULL && options->traceInterval == 0)
+    {
+        options->traceInterval = TRACE_SAMPLE_INTERVAL;
+    }
+    if (options->recordPath != NULL && 
+        (options->server || options->hosts != NULL || options->benchmark || options->replayPath != NULL))
+    {
+        // NOTE: only the commands read by the interactive and pipelined clients are recorded
+        std::cerr << ARG_RECORD << " cannot be combined with " << ARG_SERVER << ", " << ARG_HOSTS << ", " << ARG_BENCH 
+                  << ", or " << ARG_REPLAY << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->replayPath != NULL && (options->server || options->hosts != NULL || options->benchmark || 
+                                        options->pipelined || options->tracePath != NULL || options->affinity != NULL ||
+                                        options->requestTimeout != 0))
+    {
+        // NOTE: the generators keep the pace of the log, one command in every message, and measure every one to the end
+        std::cerr << ARG_REPLAY << " cannot be combined with " << ARG_SERVER << ", " << ARG_HOSTS << ", " << ARG_BENCH 
+                  << ", " << ARG_PIPELINED << ", " << ARG_BATCHED << ", " << ARG_TRACE << ", " << ARG_AFFINITY 
+                  << ", or " << ARG_DEADLINE << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (options->replayPath != NULL && options->transport != &MQUEUE_TRANSPORT)
+    {
+        // NOTE: every generator receives its replies on a private reply queue of its own
+        std::cerr << ARG_TRANSPORT << " " << options->transport->name << " cannot be combined with " << ARG_REPLAY 
+                  << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    if (replayOptions && options->replayPath == NULL)
+    {
+        std::cerr << ARG_SPEED << " and " << ARG_GENERATORS << " require " << ARG_REPLAY << "\n" << MESSAGE_USAGE 
+                  << std::endl;
+        return false;
+    }
+    if ((options->server || options->client) && options->transport != &MQUEUE_TRANSPORT)
+    {
+        // NOTE: standalone processes find each other through the published COMMAND_QUEUE_NAME and private reply queues
+        std::cerr << ARG_TRANSPORT << " " << options->transport->name << " cannot be combined with " << ARG_SERVER 
+                  << " or " << ARG_CLIENT << "\n" << MESSAGE_USAGE << std::endl;
+        return false;
+    }
+    return true;
 }
 
 /********************************************************************************************************************************
@@ -170,6 +7202,16 @@ static void signal_handler(int signalNum)
  * 1/23/2022    Kerby Kaska     Refactored to call close_queues() instead to clean up resources.
  * 2/01/2022    Kerby Kaska     Added waitpid() to end of server loop to avoid child zombie process 
  * 2/05/2022    Kerby Kaska     Refactored to use kill_process() to ensure no zombies are created on error for either client/server
+ * 10/14/2026   Kerby Kaska     Send only the used bytes of each message and use the mq_receive() byte count instead of NUL-termination
+ * 10/14/2026   Kerby Kaska     Moved the client/server loops to run_client() and run_server(). Added the pipelined client mode.
+ * 10/14/2026   Kerby Kaska     The parent process now supervises a pool of server workers with run_supervisor()
+ * 10/14/2026   Kerby Kaska     Added the standalone server and client modes. The forked command queue is now created exclusively.
+ * 10/14/2026   Kerby Kaska     No longer register SIGKILL and SIGSTOP, which can be neither caught nor blocked.
+ * 10/14/2026   Kerby Kaska     Plan the placement of ARG_AFFINITY, and pin the forked client to its CPU.
+ * 10/14/2026   Kerby Kaska     Build the compressionDictionary before anything is forked.
+ * 10/14/2026   Kerby Kaska     Run the fan-out client (ARG_HOSTS), and pass ARG_LISTEN to the standalone server.
+ * 10/14/2026   Kerby Kaska     Named PGM1_MAIN, so the microbenchmarks can include the program without its entry point.
+ * 10/14/2026   Kerby Kaska     Named main again, the microbenchmarks build against protocol.cpp and transport.cpp instead.
  * 
  * Description: Main event loop for a a multi-process client/server program using fork that utilizes message queues to transfer 
  *              requests and results. The client process makes requests to the server, waits for a result, and then prints the 
@@ -177,203 +7219,98 @@ static void signal_handler(int signalNum)
  *              the given command, and returns the result to the client
  *
  * Parameters:
- *     argc    I/P    int      (unused) number of provided command line arguments
- *     argv    I/P    char**   (unused) provided command line arguments 
+ *     argc    I/P    int      number of provided command line arguments
+ *     argv    I/P    char**   provided command line arguments (see MESSAGE_USAGE)
  *     main    O/P    int      EXIT_SUCCESS on success, EXIT_FAILURE on error
  *******************************************************************************************************************************/
 int main(int argc, char* argv[])
 {
-    char inputBuffer[QUEUE_MESSAGE_SIZE]; // input buffer - commands for server, command responses for client
-    char outputBuffer[QUEUE_MESSAGE_SIZE]; // output buffer - command responses for server, commands for client
+    ProgramOptions options;
+    if (!parse_arguments(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // register the commands of every plugin before anything is forked, so every process agrees on their opcodes
+    for (unsigned int i = 0; i < options.pluginCount; ++i)
+    {
+        if (!load_plugin(options.plugins[i]))
+        {
+            return EXIT_FAILURE;
+        }
+    }
     
     // register signals to clean up message queues (just in case user hits CTRL+C)
     signal(SIGINT, signal_handler);
-    signal(SIGKILL, signal_handler);
-    signal(SIGSTOP, signal_handler);
     signal(SIGTERM, signal_handler);
-    
-    // create and configure the message queue attributes
-    mq_attr queueAttributes;
-    queueAttributes.mq_maxmsg = QUEUE_MAX_MESSAGES;
-    queueAttributes.mq_msgsize = QUEUE_MESSAGE_SIZE;
-    queueAttributes.mq_flags = 0; // flag queue to block on mq_send/mq_receive 
-
-    // create or open the message queues for read/write
-    commandQueue = mq_open(COMMAND_QUEUE_NAME, O_RDWR | O_CREAT, QUEUE_PERMISSIONS, &queueAttributes);
-    if (commandQueue == -1)
+
+    // the message queues are created with the configured attributes, so they must be within the limits of the system
+    if (options.transport == &MQUEUE_TRANSPORT && options.hosts == NULL && !check_queue_limits(&options.queue))
     {
-        perror("commandQueue::mq_open()");
         return EXIT_FAILURE;
     }
-    responseQueue = mq_open(RESPONSE_QUEUE_NAME, O_RDWR | O_CREAT, QUEUE_PERMISSIONS, &queueAttributes);
-    if (responseQueue == -1)
+    queueConfig = options.queue;
+    statsConfig = options.stats;
+    requestTimeout = options.requestTimeout;
+    shedThreshold = options.shedThreshold;
+    compressReplies = options.compress;
+    traceInterval = (options.tracePath != NULL) ? options.traceInterval : 0;
+    build_compression_dictionary(); // NOTE: the same in every process, the server compresses and the client expands
+
+    // plan the CPUs of every process, whose affinity signals are blocked before anything is forked (see run_supervisor())
+    if (options.affinity != NULL)
     {
-        perror("responseQueue::mq_open()");
-        if (mq_close(commandQueue) == -1) // close commandQueue (since it opened successfully)
+        if (!plan_placement(options.affinity))
         {
-            perror("commandQueue::mq_close()");
+            return EXIT_FAILURE;
         }
-        if (mq_unlink(COMMAND_QUEUE_NAME) == -1) // unlink commandQueue (so it is deleted)
-        {
-            perror("commandQueue::mq_unlink()");
-        }
-        return EXIT_FAILURE;
+        sigset_t affinitySignals;
+        sigemptyset(&affinitySignals);
+        sigaddset(&affinitySignals, AFFINITY_PIN_SIGNAL);
+        sigaddset(&affinitySignals, AFFINITY_UNPIN_SIGNAL);
+        sigprocmask(SIG_BLOCK, &affinitySignals, NULL);
     }
 
-    // unlink the message queues, so they are deleted on the system when all descriptors lose reference to it
-    if (mq_unlink(COMMAND_QUEUE_NAME) == -1) 
+    // the fan-out client only talks to the gateways of other servers, through sockets
+    if (options.hosts != NULL)
     {
-        perror("commandQueue::mq_unlink()");
-        close_queues();
-        return EXIT_FAILURE;
+        return run_fanout_client(&options);
     }
-    if (mq_unlink(RESPONSE_QUEUE_NAME) == -1) 
+
+    // standalone server/client processes, which attach to each other through the published COMMAND_QUEUE_NAME
+    transport = options.transport;
+    if (options.server)
+    {
+        return run_standalone_server(options.workerCount, options.persistent, options.listen);
+    }
+    if (options.client)
+    {
+        return run_standalone_client(&options);
+    }
+    
+    // create both channels of the selected transport, which are inherited by the forked client and server workers
+    if (!transport->open())
     {
-        perror("responseQueue::mq_unlink()");
-        close_queues();
         return EXIT_FAILURE;
     }
     
+    supervisorProcessID = getpid(); // NOTE: recorded before the fork, so the client only ever signals this process
     const pid_t processID = fork();
-    if (processID > 0) // server/parent process
+    if (processID > 0) // supervisor/parent process
     {
-        bool running = true;
-        while(running)
-        {
-            // wait for a command from the client (blocking) and then process it
-            // NOTE: On failure, getdomainname, gethostname, and uname copy an error message to the output buffer instead
-            if (mq_receive(commandQueue, inputBuffer, sizeof(inputBuffer), NULL) != -1) 
-            {
-                // getdomainname
-                if (strcmp(inputBuffer, CMD_GET_DOMAIN_NAME) == 0)
-                {
-                    if (getdomainname(outputBuffer, sizeof(outputBuffer)) == -1)
-                    {
-                        strncpy(outputBuffer, strerror(errno), sizeof(outputBuffer));
-                    }
-                }
-                // gethostname
-                else if (strcmp(inputBuffer, CMD_GET_HOST_NAME) == 0)
-                {
-                    if (gethostname(outputBuffer, sizeof(outputBuffer)) == -1)
-                    {
-                        strncpy(outputBuffer, strerror(errno), sizeof(outputBuffer));
-                    }
-                }
-                // uname
-                else if (strcmp(inputBuffer, CMD_GET_UNAME) == 0)
-                {
-                    utsname name;
-                    if (uname(&name) == -1)
-                    {
-                        strncpy(outputBuffer, strerror(errno), sizeof(outputBuffer));
-                    }
-                    else
-                    {
-                        // format and copy the uname response to the output buffer
-                        snprintf(outputBuffer, sizeof(outputBuffer), MESSAGE_UNAME, 
-                            name.sysname, name.nodename, name.release, name.version, 
-                            name.machine, name.domainname);
-                    }
-                }
-                // exit
-                else if (strcmp(inputBuffer, CMD_EXIT) == 0)
-                {
-                    strncpy(outputBuffer, MESSAGE_EXIT, sizeof(outputBuffer));
-                    running = false; // stop looping so the server will exit
-                }
-                // help
-                else if (strcmp(inputBuffer, CMD_GET_HELP) == 0)
-                {
-                    strncpy(outputBuffer, MESSAGE_HELP, sizeof(outputBuffer));
-                }
-                // bad command
-                else
-                {
-                    // format and copy invalid command message, including the given message, into output buffer
-                    snprintf(outputBuffer, sizeof(outputBuffer) - strlen(MESSAGE_BAD_COMMAND), 
-                        MESSAGE_BAD_COMMAND, inputBuffer);
-                }
-
-                // send the response back to the child
-                if (mq_send(responseQueue, outputBuffer, sizeof(outputBuffer), QUEUE_MESSAGE_PRIORITY) == -1) 
-                {
-                    perror("server::mq_send()");
-                    close_queues();
-                    kill_process(processID); // kill client process
-                    return EXIT_FAILURE;
-                }
-
-                // clear the buffers
-                inputBuffer[0] = '\0';
-                outputBuffer[0] = '\0';
-            }
-            else 
-            {
-                perror("server::mq_receive()");
-                close_queues();
-                kill_process(processID); // kill client process
-                return EXIT_FAILURE;
-            }
-            
-        } // while(running)
-
-        // wait for the child process to exit normally
-        // if it fails, manually send the SIGKILL to force terminate it
-        if (waitpid(processID, NULL, 0) == -1)
-        {
-            std::cerr << "server::waitpid() - unable to wait for child process (" << processID << ") to exit.\n";
-            kill_process(processID);
-        }
+        return run_supervisor(processID, options.workerCount);
     }
     else if (processID == 0) // client/child process
     {
-        // print help message and prompt on client start
-        std::cout << MESSAGE_HELP << std::endl;
-        std::cout << MESSAGE_PROMPT;
-
-        bool running = true;
-        std::string input;
-        while (running && getline(std::cin, input)) // get console input from user
+        if (!place_process(0))
         {
-            strncpy(outputBuffer, input.c_str(), sizeof(outputBuffer));
-
-            // send the command to the parent/server on the commandQueue
-            if (mq_send(commandQueue, outputBuffer, sizeof(outputBuffer), QUEUE_MESSAGE_PRIORITY) == -1)
-            {
-                perror("client::mq_send()");
-                close_queues();
-                kill_process(getppid()); // kill the server process
-                return EXIT_FAILURE;
-            }
-
-            // wait for the response to the command on the responseQueue (blocking)
-            if (mq_receive(responseQueue, inputBuffer, sizeof(inputBuffer), NULL) != -1)
-            {
-                std::cout << inputBuffer << std::endl; // print the result to the console
-            }
-            else
-            {
-                perror("client::mq_receive()");
-                close_queues();
-                kill_process(getppid()); // kill the server process
-                return EXIT_FAILURE;
-            }
-
-            // stop looping if user input "exit" command
-            // NOTE: at this point, we sent the "exit" command to the server, which will cause the server loop to exit as well
-            if (strcmp(outputBuffer, CMD_EXIT) == 0) 
-            {
-                running = false;
-            }
-            else
-            {
-                std::cout << MESSAGE_PROMPT; // print the prompt again (only if we aren't exiting)
-            }
-
-            // clear the buffers
-            inputBuffer[0] = '\0';
-            outputBuffer[0] = '\0';
+            close_queues();
+            return EXIT_FAILURE;
+        }
+        const int result = run_client_loop(0, &options);
+        if (result == EXIT_FAILURE)
+        {
+            return EXIT_FAILURE; // NOTE: the client has already cleaned up the queues
         }
     }
     else
@@ -384,4 +7321,4 @@ int main(int argc, char* argv[])
     }
 
     return close_queues();
-}
\ No newline at end of file
+}
@@ -0,0 +1,122 @@
+/****************************************************************************************************************************************************
+* File: pgm1.h
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+* 10/14/2026   Kerby Kaska     The library is a client only, built from the protocol of pgm1 (see protocol.h), and any number
+*                              of clients of a process can connect through the command queue.
+* 10/14/2026   Kerby Kaska     Added Pgm1ClientConfig::priority. The library no longer embeds a server (pgm1_serve() was
+*                              removed): run pgm1 --server beside the application.
+*
+* Description: Interface of libpgm1, the client of pgm1 as a library, so an application can make requests in process
+*      instead of spawning the program and parsing its output. A Pgm1Client sends framed commands to a running
+*      standalone server, either through its command queue (like --client) or through its gateway (--listen), and gets the
+*      result of each one back as a Pgm1Reply: synchronously with call(), as a std::future with submit(), or packed
+*      into as few messages as possible with submit_batch() and call_batch(). The library embeds no server (there is no
+*      pgm1_serve()): the server is pgm1 itself, run beside the application as pgm1 --server (with --listen for a
+*      gateway). Build the library and link against it with:
+*
+*          make libpgm1.a
+*          g++ -std=c++14 -pthread -o app app.cpp libpgm1.a -lrt -ldl
+****************************************************************************************************************************************************/
+
+#ifndef PGM1_LIBRARY_H
+#define PGM1_LIBRARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <future>
+#include <string>
+#include <vector>
+
+/********************************************************************************************************************************
+ * struct Pgm1ClientConfig
+ * Description: Configuration of a Pgm1Client, set to the defaults by its constructor.
+ *
+ * Members:
+ * endpoint                 const char*           the gateway of the server to connect to, unix:path or tcp:[host:]port (see
+ *                                                --listen), or NULL for the command queue of the standalone server on this
+ *                                                host, with a private reply queue (the default)
+ * timeout                  unsigned int          milliseconds every request is waited for before it fails (0 for no timeout,
+ *                                                the default). Through the command queue, the server drops a request it could
+ *                                                not serve in time as well (see --deadline)
+ * messageSize              unsigned int          size of the largest message sent to a gateway (default 1024), which must not
+ *                                                exceed that of the server. Through the command queue, the message size of
+ *                                                the server is adopted instead
+ * compress                 bool                  true to have the server compress the large replies (see --compress)
+ * priority                 unsigned int          message priority the commands are sent above by their priority class (see
+ *                                                --priority), from 0 to 32765. Defaults to the PGM1_PRIORITY environment
+ *                                                variable when it is set, else 15, like pgm1
+ *******************************************************************************************************************************/
+struct Pgm1ClientConfig
+{
+    Pgm1ClientConfig();
+
+    const char* endpoint;
+    unsigned int timeout;
+    unsigned int messageSize;
+    bool compress;
+    unsigned int priority;
+};
+
+/********************************************************************************************************************************
+ * struct Pgm1Reply
+ * Description: Result of a request made by a Pgm1Client.
+ *
+ * Members:
+ * ok                       bool                  true if the server answered, false if the request failed (result then holds
+ *                                                the reason: not connected, timed out, or a malformed reply)
+ * requestID                uint32_t              request ID the command was sent with
+ * opcode                   uint16_t              opcode the command was framed as (see the Opcode of pgm1, 0 for text)
+ * result                   std::string           the result of the command, the whole of it for a streamed result, and
+ *                                                the binary uname fields rendered as text
+ *******************************************************************************************************************************/
+struct Pgm1Reply
+{
+    bool ok;
+    uint32_t requestID;
+    uint16_t opcode;
+    std::string result;
+};
+
+/********************************************************************************************************************************
+ * class Pgm1Client
+ * Description: Client of a pgm1 server, speaking the framed protocol. Every request is tagged with its request ID, and a
+ *     receiver thread matches every reply to its request as it arrives, so any number of requests can be in flight at
+ *     once, from any number of threads. The client reaches the server through one connection: the command queue of the
+ *     standalone server, with a private reply queue named after the process ID and the instance of the client (up to
+ *     512 such clients per process), or a gateway connection (any number of them). Commands are the same as typed into pgm1 (see CMD_GET_HELP).
+ *
+ * Methods:
+ * connect                  connects to the server (see Pgm1ClientConfig), false on error (see error())
+ * close                    disconnects from the server, failing every request still in flight (also done on destruction)
+ * call                     sends a command and waits for its reply
+ * submit                   sends a command, and returns the future of its reply right away
+ * submit_batch             sends several commands, packed into as few messages as possible, and returns their futures
+ * call_batch               sends several commands like submit_batch(), and waits for all of their replies
+ * error                    the reason the last connect() failed
+ *******************************************************************************************************************************/
+class Pgm1Client
+{
+public:
+    Pgm1Client();
+    ~Pgm1Client();
+    Pgm1Client(const Pgm1Client&) = delete;
+    Pgm1Client& operator=(const Pgm1Client&) = delete;
+
+    bool connect(const Pgm1ClientConfig& config);
+    void close();
+    Pgm1Reply call(const std::string& command);
+    std::future<Pgm1Reply> submit(const std::string& command);
+    std::vector<std::future<Pgm1Reply> > submit_batch(const std::vector<std::string>& commands);
+    std::vector<Pgm1Reply> call_batch(const std::vector<std::string>& commands);
+    const std::string& error() const;
+
+    struct State;
+
+private:
+    State* state;
+};
+
+#endif
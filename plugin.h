@@ -0,0 +1,122 @@
+/****************************************************************************************************************************************************
+* File: plugin.h
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+* 10/14/2026   Kerby Kaska     Blocking commands (PLUGIN_ABI_VERSION 2).
+* 10/14/2026   Kerby Kaska     Memoized commands (PLUGIN_ABI_VERSION 3).
+*
+* Description: Interface of the command plugins pgm1 loads at startup (--plugin path). A plugin is a shared object which
+*      exports PLUGIN_ENTRY_POINT, returning a PluginModule that lists its commands. Every command is registered in the
+*      dispatch table of the server next to the built-in commands, so it is looked up through the same perfect hash and
+*      dispatched by opcode without any extra cost. Build a plugin with:
+*
+*          g++ -shared -fPIC -o probes.so plugins/probes.cpp
+****************************************************************************************************************************************************/
+
+#ifndef PGM1_PLUGIN_H
+#define PGM1_PLUGIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/********************************************************************************************************************************
+ * Plugin Constants:
+ * PLUGIN_ABI_VERSION       const uint32_t        version of this interface, which a PluginModule must be built against
+ * PLUGIN_ENTRY_POINT       const char*           name of the function every plugin exports (see PluginEntryPoint)
+ *******************************************************************************************************************************/
+static const uint32_t PLUGIN_ABI_VERSION    = 3;
+static const char* const PLUGIN_ENTRY_POINT = "pgm1_plugin";
+
+/********************************************************************************************************************************
+ * enum PluginPriority
+ * Description: Priority class a plugin command is sent with (the same values as the PriorityClass of pgm1).
+ *
+ * Values:
+ * PLUGIN_PRIORITY_BULK     sent at the configured message priority
+ * PLUGIN_PRIORITY_NORMAL   sent one priority above bulk traffic
+ * PLUGIN_PRIORITY_CONTROL  sent two priorities above bulk traffic, for cheap health probes
+ *******************************************************************************************************************************/
+enum PluginPriority : uint16_t
+{
+    PLUGIN_PRIORITY_BULK = 0,
+    PLUGIN_PRIORITY_NORMAL,
+    PLUGIN_PRIORITY_CONTROL
+};
+
+/********************************************************************************************************************************
+ * typedef PluginHandler
+ * Description: Signature of a plugin command handler, the same as every built-in handler. The handler copies its result
+ *     into the output buffer provided by the server and returns the number of bytes copied (never more than outputSize).
+ *     The output buffer holds up to 64 KiB, and a result larger than a message is streamed to the client in chunks (the
+ *     output of a blocking command is limited to a single message).
+ *     It must not allocate, and must not block unless the command is registered as blocking, since the server worker
+ *     serves no other command while it runs. The handler of a blocking command runs on an executor thread instead, so it
+ *     must be thread-safe.
+ *
+ * Parameters:
+ *      arguments          I/P    const char*    the arguments of the command (not NUL-terminated, currently always empty)
+ *      argumentsLength    I/P    size_t         the number of bytes in arguments
+ *      output             O/P    char*          the buffer to copy the result of the command into
+ *      outputSize         I/P    size_t         the size of output in bytes
+ *      running            O/P    bool*          set to false if the server loop should exit (plugins leave it alone)
+ *      PluginHandler      O/P    size_t         the number of bytes of the result copied into output
+ *******************************************************************************************************************************/
+typedef size_t (*PluginHandler)(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                                bool* running);
+
+/********************************************************************************************************************************
+ * struct PluginCommand
+ * Description: Command registered by a plugin.
+ *
+ * Members:
+ * name                     const char*           command string to be entered by the user (unique across all commands)
+ * description              const char*           description listed by the "help" command
+ * handler                  PluginHandler         handler executing the command on the server
+ * cacheable                bool                  true if the response rarely changes and may be served from the response cache
+ *                                                (the handler must then ignore its arguments and have no side effects)
+ * priority                 PluginPriority        priority class the command is sent with
+ * blocking                 bool                  true if the handler may block (on I/O, a lock, or a name lookup), so it runs
+ *                                                on the executor of the server worker (and is never cached)
+ * memoizeSeconds           uint32_t              number of seconds the response may be served again to a request with the same
+ *                                                arguments without calling the handler, or 0 if the command is not idempotent
+ *                                                (responses over 1 KiB are never memoized, blocking ones may be)
+ *******************************************************************************************************************************/
+struct PluginCommand
+{
+    const char* name;
+    const char* description;
+    PluginHandler handler;
+    bool cacheable;
+    PluginPriority priority;
+    bool blocking;
+    uint32_t memoizeSeconds;
+};
+
+/********************************************************************************************************************************
+ * struct PluginModule
+ * Description: Commands of a plugin, returned by its PLUGIN_ENTRY_POINT. The module, and everything it points to, must
+ *     stay valid for as long as the plugin is loaded (static storage).
+ *
+ * Members:
+ * abiVersion               uint32_t              PLUGIN_ABI_VERSION the plugin was built against
+ * commandCount             uint32_t              number of commands in commands
+ * commands                 const PluginCommand*  the commands of the plugin
+ *******************************************************************************************************************************/
+struct PluginModule
+{
+    uint32_t abiVersion;
+    uint32_t commandCount;
+    const PluginCommand* commands;
+};
+
+/********************************************************************************************************************************
+ * typedef PluginEntryPoint
+ * Description: Signature of PLUGIN_ENTRY_POINT, which every plugin exports with C linkage:
+ *
+ *          extern "C" const PluginModule* pgm1_plugin(void);
+ *******************************************************************************************************************************/
+typedef const PluginModule* (*PluginEntryPoint)(void);
+
+#endif // PGM1_PLUGIN_H
@@ -0,0 +1,284 @@
+/****************************************************************************************************************************************************
+* File: probes.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created.
+* 10/14/2026   Kerby Kaska     Added the blocking "fqdn" probe.
+* 10/14/2026   Kerby Kaska     Added the "cpuinfo" probe, whose result is usually larger than a message.
+* 10/14/2026   Kerby Kaska     Memoize the canonical name for CANONICAL_NAME_TTL seconds.
+*
+* Description: Example command plugin (see plugin.h) with a few cheap system probes. Build and load it with:
+*
+*          g++ -shared -fPIC -o probes.so plugins/probes.cpp
+*          ./pgm1 --plugin ./probes.so
+*
+* Procedures:
+* pgm1_plugin          - PLUGIN_ENTRY_POINT, returns the PluginModule listing the probes
+*
+* handle_load_average  - command handler for "loadavg", the 1, 5, and 15 minute load averages of the system
+*
+* handle_free_memory   - command handler for "freemem", the free and total memory of the system
+*
+* handle_cpu_count     - command handler for "cpus", the number of online and configured processors
+*
+* handle_canonical_name - command handler for "fqdn", the canonical name of the host (blocking, resolves the host name)
+*
+* handle_cpu_info      - command handler for "cpuinfo", the processor details of /proc/cpuinfo (streamed, see MessageHeader)
+*
+* format_result        - utility method to convert an snprintf() result into the number of bytes written to the buffer
+****************************************************************************************************************************************************/
+
+#include "../plugin.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/sysinfo.h>
+
+/********************************************************************************************************************************
+ * Probe Constants:
+ * CMD_LOAD_AVERAGE         const char*           command string to be entered by the user for getting the load averages
+ * CMD_FREE_MEMORY          const char*           command string to be entered by the user for getting the free memory
+ * CMD_CPU_COUNT            const char*           command string to be entered by the user for getting the processor count
+ * CMD_CANONICAL_NAME       const char*           command string to be entered by the user for getting the canonical host name
+ * CMD_CPU_INFO             const char*           command string to be entered by the user for getting the processor details
+ * MESSAGE_LOAD_AVERAGE     const char*           message format used to format the result of CMD_LOAD_AVERAGE
+ * MESSAGE_FREE_MEMORY      const char*           message format used to format the result of CMD_FREE_MEMORY
+ * MESSAGE_CPU_COUNT        const char*           message format used to format the result of CMD_CPU_COUNT
+ * MESSAGE_CANONICAL_NAME   const char*           message format used to format the result of CMD_CANONICAL_NAME
+ * HOST_NAME_SIZE           const size_t          size of the buffer the host name is read into
+ * CPU_INFO_PATH            const char*           path of the processor details read by CMD_CPU_INFO
+ * MEBIBYTE                 const unsigned long   number of bytes in a MiB
+ * CANONICAL_NAME_TTL       const uint32_t        number of seconds the server memoizes the canonical name for
+ *******************************************************************************************************************************/
+static const char* CMD_LOAD_AVERAGE     = "loadavg";
+static const char* CMD_FREE_MEMORY      = "freemem";
+static const char* CMD_CPU_COUNT        = "cpus";
+static const char* CMD_CANONICAL_NAME   = "fqdn";
+static const char* CMD_CPU_INFO         = "cpuinfo";
+static const char* MESSAGE_LOAD_AVERAGE = "Load average: %.2f %.2f %.2f";
+static const char* MESSAGE_FREE_MEMORY  = "Free memory: %lu MiB of %lu MiB";
+static const char* MESSAGE_CPU_COUNT    = "Processors: %ld online, %ld configured";
+static const char* MESSAGE_CANONICAL_NAME = "Canonical name: %s";
+static const char* CPU_INFO_PATH        = "/proc/cpuinfo";
+static const unsigned long MEBIBYTE     = 1024 * 1024;
+static const size_t HOST_NAME_SIZE      = 256;
+static const uint32_t CANONICAL_NAME_TTL = 30;
+
+/********************************************************************************************************************************
+ * static size_t format_result(int formatResult, size_t bufferSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to convert an snprintf() result into the number of bytes written to the buffer, without its
+ *      NUL terminator (the result is not NUL-terminated on the wire).
+ *
+ * Parameters:
+ *      formatResult     I/P    int        the value returned by snprintf()
+ *      bufferSize       I/P    size_t     the size of the buffer passed to snprintf()
+ *      format_result    O/P    size_t     the number of bytes written to the buffer, excluding the NUL terminator
+ *******************************************************************************************************************************/
+static size_t format_result(int formatResult, size_t bufferSize)
+{
+    if (formatResult < 0 || bufferSize == 0)
+    {
+        return 0;
+    }
+    return (static_cast<size_t>(formatResult) < bufferSize) ? static_cast<size_t>(formatResult) : bufferSize - 1;
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_load_average(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+ *                                   bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_LOAD_AVERAGE. Formats the 1, 5, and 15 minute load averages of the system with
+ *      MESSAGE_LOAD_AVERAGE into the output buffer. On failure, an error message is copied to the output buffer instead.
+ *
+ * Parameters: (see PluginHandler)
+ *******************************************************************************************************************************/
+static size_t handle_load_average(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                                  bool* running)
+{
+    double loads[3];
+    if (getloadavg(loads, 3) != 3)
+    {
+        return format_result(snprintf(output, outputSize, "%s", "getloadavg() failed"), outputSize);
+    }
+    return format_result(snprintf(output, outputSize, MESSAGE_LOAD_AVERAGE, loads[0], loads[1], loads[2]), outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_free_memory(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+ *                                  bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_FREE_MEMORY. Formats the free and total memory of the system (see sysinfo()) with
+ *      MESSAGE_FREE_MEMORY into the output buffer. On failure, an error message is copied to the output buffer instead.
+ *
+ * Parameters: (see PluginHandler)
+ *******************************************************************************************************************************/
+static size_t handle_free_memory(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                                 bool* running)
+{
+    struct sysinfo info;
+    if (sysinfo(&info) == -1)
+    {
+        return format_result(snprintf(output, outputSize, "%s", strerror(errno)), outputSize);
+    }
+    return format_result(snprintf(output, outputSize, MESSAGE_FREE_MEMORY, info.freeram * info.mem_unit / MEBIBYTE,
+        info.totalram * info.mem_unit / MEBIBYTE), outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_cpu_count(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+ *                                bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_CPU_COUNT. Formats the number of online and configured processors with
+ *      MESSAGE_CPU_COUNT into the output buffer.
+ *
+ * Parameters: (see PluginHandler)
+ *******************************************************************************************************************************/
+static size_t handle_cpu_count(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                               bool* running)
+{
+    return format_result(snprintf(output, outputSize, MESSAGE_CPU_COUNT, sysconf(_SC_NPROCESSORS_ONLN),
+        sysconf(_SC_NPROCESSORS_CONF)), outputSize);
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_canonical_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+ *                                     bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_CANONICAL_NAME. Resolves the host name (see getaddrinfo()), which may wait on DNS,
+ *      and formats its canonical name with MESSAGE_CANONICAL_NAME into the output buffer. On failure, an error message is
+ *      copied to the output buffer instead. Registered as blocking, so it runs on the executor of the server worker.
+ *
+ * Parameters: (see PluginHandler)
+ *******************************************************************************************************************************/
+static size_t handle_canonical_name(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                                    bool* running)
+{
+    char hostName[HOST_NAME_SIZE];
+    if (gethostname(hostName, sizeof(hostName)) == -1)
+    {
+        return format_result(snprintf(output, outputSize, "%s", strerror(errno)), outputSize);
+    }
+    hostName[sizeof(hostName) - 1] = '\0';
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_flags = AI_CANONNAME;
+    addrinfo* addresses = NULL;
+    const int error = getaddrinfo(hostName, NULL, &hints, &addresses);
+    if (error != 0)
+    {
+        return format_result(snprintf(output, outputSize, "%s", gai_strerror(error)), outputSize);
+    }
+    const char* canonicalName = (addresses->ai_canonname != NULL) ? addresses->ai_canonname : hostName;
+    const size_t length = format_result(snprintf(output, outputSize, MESSAGE_CANONICAL_NAME, canonicalName), outputSize);
+    freeaddrinfo(addresses);
+    return length;
+}
+
+/********************************************************************************************************************************
+ * static size_t handle_cpu_info(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+ *                               bool* running)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Command handler for CMD_CPU_INFO. Reads the processor details of CPU_INFO_PATH into the output buffer
+ *      (without its trailing newlines), truncated to its size. This is a few KiB per processor, which the server streams
+ *      to the client in chunks. On failure, an error message is copied to the output buffer instead. Reading procfs never
+ *      waits on a device, so the probe does not block.
+ *
+ * Parameters: (see PluginHandler)
+ *******************************************************************************************************************************/
+static size_t handle_cpu_info(const char* arguments, size_t argumentsLength, char* output, size_t outputSize,
+                              bool* running)
+{
+    const int descriptor = open(CPU_INFO_PATH, O_RDONLY | O_CLOEXEC);
+    if (descriptor == -1)
+    {
+        return format_result(snprintf(output, outputSize, "%s", strerror(errno)), outputSize);
+    }
+    size_t length = 0;
+    ssize_t readLength;
+    while (length < outputSize && (readLength = read(descriptor, output + length, outputSize - length)) > 0)
+    {
+        length += readLength;
+    }
+    close(descriptor);
+    while (length > 0 && output[length - 1] == '\n')
+    {
+        --length;
+    }
+    return length;
+}
+
+/********************************************************************************************************************************
+ * Plugin Module:
+ * PROBE_COMMANDS           const PluginCommand[] the probes registered by this plugin
+ * PROBE_MODULE             const PluginModule    the module returned by pgm1_plugin()
+ *
+ * NOTE: the processor count never changes, so it is served from the response cache of the server. The other probes change
+ *       all the time, so they are never cached. The canonical name may wait on DNS, so it is the only blocking probe, and
+ *       it is memoized for CANONICAL_NAME_TTL seconds, like a DNS answer, so repeated lookups skip the resolver.
+ *******************************************************************************************************************************/
+static const PluginCommand PROBE_COMMANDS[] =
+{
+    { CMD_LOAD_AVERAGE, "get the 1, 5, and 15 minute load averages of the system", handle_load_average, false,
+      PLUGIN_PRIORITY_CONTROL, false, 0 },
+    { CMD_FREE_MEMORY,  "get the free and total memory of the system", handle_free_memory, false, PLUGIN_PRIORITY_NORMAL,
+      false, 0 },
+    { CMD_CPU_COUNT,    "get the number of processors of the system", handle_cpu_count, true, PLUGIN_PRIORITY_NORMAL,
+      false, 0 },
+    { CMD_CANONICAL_NAME, "get the canonical name of the host (may wait on DNS)", handle_canonical_name, false,
+      PLUGIN_PRIORITY_NORMAL, true, CANONICAL_NAME_TTL },
+    { CMD_CPU_INFO,     "get the details of every processor of the system", handle_cpu_info, false, PLUGIN_PRIORITY_BULK,
+      false, 0 },
+};
+static const PluginModule PROBE_MODULE =
+{
+    PLUGIN_ABI_VERSION, sizeof(PROBE_COMMANDS) / sizeof(PROBE_COMMANDS[0]), PROBE_COMMANDS
+};
+
+/********************************************************************************************************************************
+ * const PluginModule* pgm1_plugin(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: PLUGIN_ENTRY_POINT of the plugin, called once by pgm1 when the plugin is loaded.
+ *
+ * Parameters:
+ *      pgm1_plugin    O/P    const PluginModule*    the commands of the plugin
+ *******************************************************************************************************************************/
+extern "C" const PluginModule* pgm1_plugin()
+{
+    return &PROBE_MODULE;
+}
@@ -0,0 +1,1063 @@
+/****************************************************************************************************************************************************
+* File: protocol.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the framing, compression, and rendering of the protocol out of main.cpp.
+* 10/14/2026   Kerby Kaska     Merged find_builtin_command() into find_command() (see dispatch.h), the one lookup of every command.
+* 10/14/2026   Kerby Kaska     Moved parse_count() out of main.cpp.
+*
+* Description: Implementation of the protocol shared by pgm1 and libpgm1 (see protocol.h).
+*
+* Procedures:
+* copy_message         - utility method to copy a message into a buffer and return the number of bytes copied
+*
+* copy_bytes           - utility method to copy a length-delimited message into a buffer and return the number of bytes copied
+*
+* format_length        - utility method to convert an snprintf() result into the number of bytes written to the buffer
+*
+* parse_count          - utility method to parse a command line argument (or environment variable) value as a bounded count
+*
+* monotonic_nanoseconds - utility method to read the CLOCK_MONOTONIC clock in nanoseconds
+*
+* monotonic_milliseconds, realtime_after
+*                      - utility methods to read the CLOCK_MONOTONIC clock in milliseconds, and to find an absolute timeout
+*
+* remaining_timeout, deadline_passed
+*                      - utility methods to check how much of the deadline of a request is left
+*
+* parse_uname_fields   - utility method to parse the field names given after the "uname" command
+*
+* frame_request        - frames a command behind a MessageHeader, the system Unix name as a binary request
+*
+* read_frame           - utility method to copy the MessageHeader of a frame out of a (batched) received message
+*
+* build_compression_dictionary
+*                      - builds the static compressionDictionary from the known response templates, the same in every process
+*
+* compress_payload, expand_payload
+*                      - compress a reply payload against the compressionDictionary, and expand it again on the client
+*
+* expand_reply         - utility method to expand the payload of a compressed reply frame on the client
+*
+* compression_hash, window_byte, emit_literals
+*                      - utility methods of the dictionary compression
+*
+* encode_uname_entry   - utility method to append an entry to a binary CMD_GET_UNAME_FIELDS response
+*
+* render_uname         - utility method to render a binary CMD_GET_UNAME_FIELDS reply as text on the client
+*
+* open_endpoint        - opens a Unix domain or TCP socket endpoint, listening on it (the gateway) or connected to it
+*
+* open_reply_queue     - creates the private reply queue of a client, replacing a stale one
+****************************************************************************************************************************************************/
+
+#include "protocol.h"
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+
+/********************************************************************************************************************************
+ * Compression Constants:
+ * COMPRESSION_MIN_MATCH    const size_t          shortest match encoded as a reference into the window (see compress_payload())
+ * COMPRESSION_MAX_MATCH    const size_t          longest match encoded by a single reference
+ * COMPRESSION_MAX_LITERALS const size_t          longest run of literal bytes encoded by a single control byte
+ * COMPRESSION_MAX_DISTANCE const size_t          largest distance back into the window a reference can encode
+ * COMPRESSION_MATCH_FLAG   const uint8_t         bit of a control byte which marks a reference instead of a literal run
+ * COMPRESSION_HASH_BITS    const unsigned int    number of bits of the hash of COMPRESSION_MIN_MATCH bytes indexing a match
+ * COMPRESSION_HASH_SIZE    const size_t          number of entries of the hash table of compress_payload()
+ * COMPRESSION_DICTIONARY_SIZE const size_t       largest number of bytes of the compressionDictionary
+ * COMPRESSION_PHRASES      const char*           phrases of the statistics report and of the system information which are
+ *                                                common enough to be added to the compressionDictionary
+ *
+ * NOTE: both sides must build the very same dictionary, so it is only made of the built-in templates, never of anything
+ *       which depends on the plugins loaded or on the host
+ *******************************************************************************************************************************/
+static const size_t COMPRESSION_MIN_MATCH           = 4;
+static const size_t COMPRESSION_MAX_MATCH           = COMPRESSION_MIN_MATCH + 127;
+static const size_t COMPRESSION_MAX_LITERALS        = 128;
+static const size_t COMPRESSION_MAX_DISTANCE        = 65535;
+static const uint8_t COMPRESSION_MATCH_FLAG         = 0x80;
+static const unsigned int COMPRESSION_HASH_BITS     = 10;
+static const size_t COMPRESSION_HASH_SIZE           = 1 << COMPRESSION_HASH_BITS;
+static const size_t COMPRESSION_DICTIONARY_SIZE     = 2048;
+static const char* COMPRESSION_PHRASES              = "Server statistics ( worker(s)):\n messages in:  bytes), out: \n"
+                                                      " reply queue full: , replies dropped: \n requests expired: , requests"
+                                                      " shed: \n replies compressed:  bytes saved)\n command queue depth: mean"
+                                                      ", max  samples)\n command      requests   handler (ns)\n (unknown)"
+                                                      "            priority     messages   service (ns)       max (ns)\n"
+                                                      " bulk normal control Linux GNU/Linux x86_64 aarch64 localhost (none)"
+                                                      " #1 SMP PREEMPT_DYNAMIC Mon Tue Wed Thu Fri Sat Sun Jan Feb Mar Apr"
+                                                      " May Jun Jul Aug Sep Oct Nov Dec UTC 20";
+
+/********************************************************************************************************************************
+ * Compression State:
+ * compressionDictionary char[]              the static dictionary every compressed payload refers back into (see
+ *                                           build_compression_dictionary()), built once at startup
+ * compressionDictionaryLength size_t        number of bytes in compressionDictionary
+ * compressionHeads     int32_t[]            position of the last occurrence of each hash of COMPRESSION_MIN_MATCH bytes in
+ *                                           compressionDictionary, or -1 for none
+ *******************************************************************************************************************************/
+static char compressionDictionary[COMPRESSION_DICTIONARY_SIZE];
+static size_t compressionDictionaryLength = 0;
+static int32_t compressionHeads[COMPRESSION_HASH_SIZE];
+
+/********************************************************************************************************************************
+ * size_t copy_message(char* buffer, size_t bufferSize, const char* message)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to copy a NUL-terminated message into a buffer without the NUL terminator. The message is
+ *      truncated to the size of the buffer if it does not fit.
+ *
+ * Parameters:
+ *      buffer          O/P    char*          the buffer to copy the message into
+ *      bufferSize      I/P    size_t         the size of buffer in bytes
+ *      message         I/P    const char*    the NUL-terminated message to copy
+ *      copy_message    O/P    size_t         the number of bytes copied into buffer
+ *******************************************************************************************************************************/
+size_t copy_message(char* buffer, size_t bufferSize, const char* message)
+{
+    const size_t messageLength = strnlen(message, bufferSize);
+    memcpy(buffer, message, messageLength);
+    return messageLength;
+}
+
+/********************************************************************************************************************************
+ * size_t copy_bytes(char* buffer, size_t bufferSize, const char* message, size_t messageLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to copy a length-delimited message (such as a pre-rendered response) into a buffer. The 
+ *      message is truncated to the size of the buffer if it does not fit.
+ *
+ * Parameters:
+ *      buffer           O/P    char*          the buffer to copy the message into
+ *      bufferSize       I/P    size_t         the size of buffer in bytes
+ *      message          I/P    const char*    the message bytes to copy
+ *      messageLength    I/P    size_t         the number of bytes in message
+ *      copy_bytes       O/P    size_t         the number of bytes copied into buffer
+ *******************************************************************************************************************************/
+size_t copy_bytes(char* buffer, size_t bufferSize, const char* message, size_t messageLength)
+{
+    const size_t length = (messageLength < bufferSize) ? messageLength : bufferSize;
+    memcpy(buffer, message, length);
+    return length;
+}
+
+/********************************************************************************************************************************
+ * size_t format_length(int formatResult, size_t bufferSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to convert the return value of snprintf() into the number of bytes actually written to the
+ *      buffer (excluding the NUL terminator). snprintf() returns the length the output would have had if it was not
+ *      truncated, or a negative value on an encoding error.
+ *
+ * Parameters:
+ *      formatResult     I/P    int       the value returned by snprintf()
+ *      bufferSize       I/P    size_t    the size of the buffer given to snprintf()
+ *      format_length    O/P    size_t    the number of bytes written to the buffer, excluding the NUL terminator
+ *******************************************************************************************************************************/
+size_t format_length(int formatResult, size_t bufferSize)
+{
+    if (formatResult < 0 || bufferSize == 0)
+    {
+        return 0;
+    }
+    return (static_cast<size_t>(formatResult) < bufferSize) ? static_cast<size_t>(formatResult) : bufferSize - 1;
+}
+
+/********************************************************************************************************************************
+ * bool parse_count(const char* text, unsigned int minimum, unsigned int maximum, unsigned int* count)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Added the minimum.
+ * 10/14/2026   Kerby Kaska     Moved out of main.cpp, shared with libpgm1.
+ *
+ * Description: Utility method to parse a command line argument value as a count between minimum and maximum (inclusive).
+ *
+ * Parameters:
+ *      text           I/P    const char*      the argument value to parse
+ *      minimum        I/P    unsigned int     the smallest accepted count
+ *      maximum        I/P    unsigned int     the largest accepted count
+ *      count          O/P    unsigned int*    the parsed count (unchanged on error)
+ *      parse_count    O/P    bool             true if text is a valid count, false otherwise
+ *******************************************************************************************************************************/
+bool parse_count(const char* text, unsigned int minimum, unsigned int maximum, unsigned int* count)
+{
+    char* end;
+    errno = 0;
+    const unsigned long value = strtoul(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || value < minimum || value > maximum || text[0] == '-')
+    {
+        return false;
+    }
+    *count = static_cast<unsigned int>(value);
+    return true;
+}
+
+/********************************************************************************************************************************
+ * uint64_t monotonic_nanoseconds(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to read the CLOCK_MONOTONIC clock in nanoseconds, which never jumps with the wall clock.
+ *
+ * Parameters:
+ *      monotonic_nanoseconds    O/P    uint64_t    the current CLOCK_MONOTONIC time in nanoseconds
+ *******************************************************************************************************************************/
+uint64_t monotonic_nanoseconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+/********************************************************************************************************************************
+ * uint32_t monotonic_milliseconds(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to read the CLOCK_MONOTONIC clock in milliseconds, modulo 2^32 (so it wraps every 49 days,
+ *      and two readings are only compared through their signed difference).
+ *
+ * Parameters:
+ *      monotonic_milliseconds    O/P    uint32_t    the current CLOCK_MONOTONIC time in milliseconds, modulo 2^32
+ *******************************************************************************************************************************/
+uint32_t monotonic_milliseconds()
+{
+    return static_cast<uint32_t>(monotonic_nanoseconds() / 1000000ull);
+}
+
+/********************************************************************************************************************************
+ * timespec realtime_after(int milliseconds)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of receive_reply().
+ *
+ * Description: Utility method to find the CLOCK_REALTIME time a number of milliseconds from now, the absolute timeout 
+ *      mq_timedsend() and mq_timedreceive() take.
+ *
+ * Parameters:
+ *      milliseconds      I/P    int         the number of milliseconds from now (at least 0)
+ *      realtime_after    O/P    timespec    the CLOCK_REALTIME time milliseconds from now
+ *******************************************************************************************************************************/
+timespec realtime_after(int milliseconds)
+{
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    const uint64_t nanoseconds = deadline.tv_nsec + (milliseconds % 1000) * 1000000ull;
+    deadline.tv_sec += milliseconds / 1000 + nanoseconds / 1000000000ull;
+    deadline.tv_nsec = nanoseconds % 1000000000ull;
+    return deadline;
+}
+
+/********************************************************************************************************************************
+ * int remaining_timeout(uint32_t deadline)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to find the number of milliseconds left until a deadline, as the timeout of a transport 
+ *      send() or receive().
+ *
+ * Parameters:
+ *      deadline             I/P    uint32_t    the deadline of a request (see MessageHeader), or 0 for none
+ *      remaining_timeout    O/P    int         the milliseconds left (0 once the deadline has passed), or -1 for none
+ *******************************************************************************************************************************/
+int remaining_timeout(uint32_t deadline)
+{
+    if (deadline == 0)
+    {
+        return -1;
+    }
+    const int32_t remaining = static_cast<int32_t>(deadline - monotonic_milliseconds());
+    return (remaining > 0) ? remaining : 0;
+}
+
+/********************************************************************************************************************************
+ * bool deadline_passed(uint32_t deadline)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether the deadline of a request has passed.
+ *
+ * Parameters:
+ *      deadline           I/P    uint32_t    the deadline of a request (see MessageHeader), or 0 for none
+ *      deadline_passed    O/P    bool        true if the request has a deadline which has passed, false otherwise
+ *******************************************************************************************************************************/
+bool deadline_passed(uint32_t deadline)
+{
+    return deadline != 0 && static_cast<int32_t>(monotonic_milliseconds() - deadline) >= 0;
+}
+
+/********************************************************************************************************************************
+ * bool parse_uname_fields(const char* input, size_t inputLength, uint8_t* fieldMask)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Moved to protocol.cpp, shared with libpgm1.
+ *
+ * Description: Utility method to parse a CMD_GET_UNAME command followed by the names of the fields to return (see 
+ *      UNAME_FIELD_NAMES), separated by spaces, such as "uname machine release".
+ *
+ * Parameters:
+ *      input                 I/P    const char*    the command entered by the user (not NUL-terminated)
+ *      inputLength           I/P    size_t         the number of bytes in input
+ *      fieldMask             O/P    uint8_t*       the bit (1 << field) of every field named
+ *      parse_uname_fields    O/P    bool           true if the input is CMD_GET_UNAME followed only by known field names
+ *******************************************************************************************************************************/
+bool parse_uname_fields(const char* input, size_t inputLength, uint8_t* fieldMask)
+{
+    const size_t nameLength = COMMAND_NAMES[OPCODE_GET_UNAME].nameLength;
+    if (inputLength <= nameLength || memcmp(input, CMD_GET_UNAME, nameLength) != 0 || input[nameLength] != ' ')
+    {
+        return false;
+    }
+
+    *fieldMask = 0;
+    size_t offset = nameLength;
+    while (offset < inputLength)
+    {
+        if (input[offset] == ' ')
+        {
+            ++offset;
+            continue;
+        }
+        const char* word = input + offset;
+        const char* wordEnd = static_cast<const char*>(memchr(word, ' ', inputLength - offset));
+        const size_t wordLength = (wordEnd != NULL) ? static_cast<size_t>(wordEnd - word) : inputLength - offset;
+        unsigned int field = 0;
+        while (field < UNAME_FIELD_COUNT && (strlen(UNAME_FIELD_NAMES[field]) != wordLength || 
+               memcmp(UNAME_FIELD_NAMES[field], word, wordLength) != 0))
+        {
+            ++field;
+        }
+        if (field == UNAME_FIELD_COUNT)
+        {
+            return false; // not a field, so the server answers it as an unknown command
+        }
+        *fieldMask |= 1u << field;
+        offset += wordLength;
+    }
+    return *fieldMask != 0;
+}
+
+/********************************************************************************************************************************
+ * size_t frame_request(const char* input, size_t inputLength, uint16_t opcode, uint32_t requestID, int32_t clientID, 
+ *                      uint32_t deadline, uint16_t flags, char* buffer, size_t bufferSize, bool truncate, 
+ *                      uint16_t* framedOpcode)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of frame_command(), so pgm1 and libpgm1 frame alike.
+ *
+ * Description: Frames a command, which the caller has looked up as opcode (see find_command() of dispatch.h), behind a
+ *      MessageHeader carrying the request ID (and its deadline) at the front of the buffer. Known commands are sent as
+ *      just their opcode with an empty payload. The CMD_GET_UNAME command is sent as OPCODE_GET_UNAME_FIELDS instead,
+ *      with a payload selecting the fields named after it (see parse_uname_fields()), if any, and the client renders
+ *      the binary reply (see render_uname()). Anything else is sent as OPCODE_TEXT followed by the command without a
+ *      NUL terminator, so the server can still look it up by name, or reply to it with MESSAGE_BAD_COMMAND. Should the
+ *      frame not fit in the buffer, the command is truncated to fit if truncate is set, and otherwise nothing is framed
+ *      (so it can be sent in the next batch instead).
+ *
+ *      The flags are set in the header as they are given, but for FRAME_TRACED, which appends the TraceStamps of the
+ *      request to the payload, stamped with the time it was framed (see TraceStamps).
+ *
+ * Parameters:
+ *      input            I/P    const char*           the command entered by the user (not NUL-terminated)
+ *      inputLength      I/P    size_t                the number of bytes in input
+ *      opcode           I/P    uint16_t              the opcode the command was looked up as (OPCODE_TEXT if unknown)
+ *      requestID        I/P    uint32_t              the request ID the server will echo back in its reply
+ *      clientID         I/P    int32_t               the client ID naming the reply queue (0 for the shared responseQueue)
+ *      deadline         I/P    uint32_t              the deadline of the request (see monotonic_milliseconds()), or 0
+ *                                                    for none
+ *      flags            I/P    uint16_t              the FrameFlag bits of the request (FRAME_ACCEPTS_COMPRESSED and
+ *                                                    FRAME_TRACED)
+ *      buffer           O/P    char*                 the buffer to frame the command into
+ *      bufferSize       I/P    size_t                the size of buffer in bytes
+ *      truncate         I/P    bool                  true to truncate a command that does not fit, false to refuse it
+ *      framedOpcode     O/P    uint16_t*             the opcode the command was framed as
+ *      frame_request    O/P    size_t                the total number of bytes of the frame, or 0 if it did not fit
+ *******************************************************************************************************************************/
+size_t frame_request(const char* input, size_t inputLength, uint16_t opcode, uint32_t requestID, int32_t clientID, 
+                     uint32_t deadline, uint16_t flags, char* buffer, size_t bufferSize, bool truncate, 
+                     uint16_t* framedOpcode)
+{
+    MessageHeader header;
+    memset(&header, 0, sizeof(header));
+    header.requestID = requestID;
+    header.clientID = clientID;
+    header.deadline = deadline;
+    header.flags = flags & ~FRAME_TRACED;
+    header.opcode = opcode;
+
+    // the system Unix name is requested in binary, selecting only the fields named after the command (if any)
+    uint8_t fieldMask = 0;
+    if (header.opcode == OPCODE_GET_UNAME || 
+        (header.opcode == OPCODE_TEXT && parse_uname_fields(input, inputLength, &fieldMask)))
+    {
+        header.opcode = OPCODE_GET_UNAME_FIELDS;
+    }
+    *framedOpcode = header.opcode;
+
+    // known commands are identified by the opcode alone (and the selected fields), anything else is sent as text
+    const char* command = (header.opcode == OPCODE_TEXT) ? input : reinterpret_cast<const char*>(&fieldMask);
+    const size_t commandLength = (header.opcode == OPCODE_TEXT) ? inputLength : (fieldMask != 0) ? sizeof(fieldMask) : 0;
+
+    // a traced request carries its timestamps at the end of the payload
+    TraceStamps trace;
+    const size_t traceLength = ((flags & FRAME_TRACED) != 0) ? sizeof(trace) : 0;
+    if (bufferSize < sizeof(header) + traceLength || 
+        (!truncate && commandLength > bufferSize - sizeof(header) - traceLength))
+    {
+        return 0;
+    }
+    const size_t room = bufferSize - sizeof(header) - traceLength;
+    header.payloadLength = ((commandLength < room) ? commandLength : room) + traceLength;
+    if (traceLength != 0)
+    {
+        header.flags |= FRAME_TRACED;
+        memset(&trace, 0, sizeof(trace));
+        trace.enqueue = monotonic_nanoseconds();
+        memcpy(buffer + sizeof(header) + header.payloadLength - traceLength, &trace, sizeof(trace));
+    }
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), command, header.payloadLength - traceLength);
+    return sizeof(header) + header.payloadLength;
+}
+
+/********************************************************************************************************************************
+ * bool read_frame(const char* message, size_t messageLength, size_t offset, MessageHeader* header)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Renamed from read_header(). Reads any frame of a batched message, and checks its payload length.
+ *
+ * Description: Utility method to copy the MessageHeader of the frame at the given offset out of a received message. A
+ *      message holds one or more frames back to back (a batch), each made up of a MessageHeader followed by payloadLength
+ *      bytes of payload. The header is copied rather than cast in place, since the receive buffer makes no alignment 
+ *      guarantees.
+ *
+ * Parameters:
+ *      message          I/P    const char*       the received message bytes
+ *      messageLength    I/P    size_t            the number of bytes in message (as returned by mq_receive)
+ *      offset           I/P    size_t            the offset of the frame in message
+ *      header           O/P    MessageHeader*    the header read from the front of the frame
+ *      read_frame       O/P    bool              true if the whole frame (header and payload) fits in the message, 
+ *                                                false otherwise
+ *******************************************************************************************************************************/
+bool read_frame(const char* message, size_t messageLength, size_t offset, MessageHeader* header)
+{
+    if (offset > messageLength || messageLength - offset < sizeof(MessageHeader))
+    {
+        return false;
+    }
+    memcpy(header, message + offset, sizeof(MessageHeader));
+    return header->payloadLength <= messageLength - offset - sizeof(MessageHeader);
+}
+
+/********************************************************************************************************************************
+ * static inline uint32_t compression_hash(const char* bytes)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to hash the COMPRESSION_MIN_MATCH bytes a match starts with into COMPRESSION_HASH_BITS bits
+ *      (a multiplicative hash, the bytes are copied rather than cast in place since they make no alignment guarantees).
+ *
+ * Parameters:
+ *      bytes               I/P    const char*    the COMPRESSION_MIN_MATCH bytes to hash
+ *      compression_hash    O/P    uint32_t       the hash of the bytes, less than COMPRESSION_HASH_SIZE
+ *******************************************************************************************************************************/
+static inline uint32_t compression_hash(const char* bytes)
+{
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return (word * 2654435761u) >> (32 - COMPRESSION_HASH_BITS);
+}
+
+/********************************************************************************************************************************
+ * static inline char window_byte(const char* data, size_t position)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to read a byte of the window a reference points into: the compressionDictionary, followed
+ *      by the payload itself (the uncompressed input while compressing, the output so far while expanding).
+ *
+ * Parameters:
+ *      data           I/P    const char*    the uncompressed payload following the compressionDictionary in the window
+ *      position       I/P    size_t         the position of the byte in the window
+ *      window_byte    O/P    char           the byte at the position
+ *******************************************************************************************************************************/
+static inline char window_byte(const char* data, size_t position)
+{
+    return (position < compressionDictionaryLength) ? compressionDictionary[position] :
+        data[position - compressionDictionaryLength];
+}
+
+/********************************************************************************************************************************
+ * void build_compression_dictionary(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Builds the compressionDictionary from the templates of the built-in responses (MESSAGE_HELP and the other
+ *      fixed messages, and the COMPRESSION_PHRASES of the statistics report and the system information), and indexes it
+ *      in compressionHeads. Every process builds it once at startup, before anything is forked, and since it is only made
+ *      of constants, a standalone client and server always build the very same dictionary. A reply made of a template
+ *      (such as the help message) then compresses to a few references into it.
+ *******************************************************************************************************************************/
+void build_compression_dictionary()
+{
+    const char* templates[] = { COMPRESSION_PHRASES, MESSAGE_SHED, MESSAGE_REFRESH, MESSAGE_EXIT, "Unknown command: \"",
+                                MESSAGE_HELP };
+    compressionDictionaryLength = 0;
+    for (size_t i = 0; i < sizeof(templates) / sizeof(templates[0]); ++i)
+    {
+        compressionDictionaryLength += copy_message(compressionDictionary + compressionDictionaryLength,
+            COMPRESSION_DICTIONARY_SIZE - compressionDictionaryLength, templates[i]);
+    }
+
+    // the later occurrence of the same bytes wins, so the help message at the end is found first
+    for (size_t i = 0; i < COMPRESSION_HASH_SIZE; ++i)
+    {
+        compressionHeads[i] = -1;
+    }
+    for (size_t position = 0; position + COMPRESSION_MIN_MATCH <= compressionDictionaryLength; ++position)
+    {
+        compressionHeads[compression_hash(compressionDictionary + position)] = static_cast<int32_t>(position);
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool emit_literals(const char* literals, size_t literalCount, char* output, size_t* outputLength,
+ *                           size_t outputLimit)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to encode a run of literal bytes into a compressed payload, as runs of at most
+ *      COMPRESSION_MAX_LITERALS bytes, each one behind a control byte holding its length less one.
+ *
+ * Parameters:
+ *      literals         I/P    const char*    the literal bytes
+ *      literalCount     I/P    size_t         the number of bytes in literals
+ *      output           O/P    char*          the compressed payload
+ *      outputLength     I/O    size_t*        the number of bytes in output
+ *      outputLimit      I/P    size_t         the number of bytes the compressed payload must stay below
+ *      emit_literals    O/P    bool           true if the literals were encoded, false if they would reach outputLimit
+ *******************************************************************************************************************************/
+static bool emit_literals(const char* literals, size_t literalCount, char* output, size_t* outputLength,
+                          size_t outputLimit)
+{
+    while (literalCount > 0)
+    {
+        const size_t runLength = std::min(literalCount, COMPRESSION_MAX_LITERALS);
+        if (*outputLength + 1 + runLength >= outputLimit)
+        {
+            return false;
+        }
+        output[(*outputLength)++] = static_cast<char>(runLength - 1);
+        memcpy(output + *outputLength, literals, runLength);
+        *outputLength += runLength;
+        literals += runLength;
+        literalCount -= runLength;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * size_t compress_payload(const char* input, size_t inputLength, char* output)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Compresses a reply payload with a byte-oriented LZ77 against the static compressionDictionary. The window
+ *      is the compressionDictionary followed by the payload itself, and the payload is encoded as a sequence of:
+ *
+ *          0x00-0x7F    a run of (control + 1) literal bytes, which follow the control byte
+ *          0x80-0xFF    a reference to (control - 0x80 + COMPRESSION_MIN_MATCH) bytes of the window, starting at the
+ *                       little-endian 16-bit distance which follows the control byte, back from the current position
+ *
+ *      At every position, the last occurrence of the next COMPRESSION_MIN_MATCH bytes in the payload (hashed on the stack)
+ *      and in the compressionDictionary (see compressionHeads) are both tried, and the longer match wins. This is cheap
+ *      enough to run on every large reply, and the replies made of a template collapse into a few references.
+ *
+ * Parameters:
+ *      input               I/P    const char*    the payload to compress
+ *      inputLength         I/P    size_t         the number of bytes in input
+ *      output              O/P    char*          the compressed payload (room for inputLength bytes)
+ *      compress_payload    O/P    size_t         the number of bytes in output, or 0 if the payload does not get smaller
+ *******************************************************************************************************************************/
+size_t compress_payload(const char* input, size_t inputLength, char* output)
+{
+    int32_t heads[COMPRESSION_HASH_SIZE];
+    memset(heads, 0xFF, sizeof(heads)); // NOTE: every entry -1
+    size_t outputLength = 0;
+    size_t literalStart = 0;
+    size_t position = 0;
+    while (position + COMPRESSION_MIN_MATCH <= inputLength)
+    {
+        // try the last occurrence in the payload, and the last occurrence in the dictionary
+        const uint32_t hash = compression_hash(input + position);
+        const int32_t candidates[2] = { heads[hash], compressionHeads[hash] };
+        const size_t windowBases[2] = { compressionDictionaryLength, 0 };
+        heads[hash] = static_cast<int32_t>(position);
+        const size_t current = compressionDictionaryLength + position; // position in the window
+        const size_t longest = std::min(COMPRESSION_MAX_MATCH, inputLength - position);
+        size_t matchLength = 0;
+        size_t matchDistance = 0;
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            if (candidates[i] < 0 || current - (windowBases[i] + candidates[i]) > COMPRESSION_MAX_DISTANCE)
+            {
+                continue;
+            }
+            const size_t start = windowBases[i] + candidates[i];
+            size_t length = 0;
+            while (length < longest && window_byte(input, start + length) == input[position + length])
+            {
+                ++length;
+            }
+            if (length > matchLength)
+            {
+                matchLength = length;
+                matchDistance = current - start;
+            }
+        }
+        if (matchLength < COMPRESSION_MIN_MATCH)
+        {
+            ++position;
+            continue;
+        }
+
+        // the literals before the match, then the reference (the payload is sent as it is once it does not get smaller)
+        if (!emit_literals(input + literalStart, position - literalStart, output, &outputLength, inputLength) ||
+            outputLength + 3 >= inputLength)
+        {
+            return 0;
+        }
+        output[outputLength++] = static_cast<char>(COMPRESSION_MATCH_FLAG | (matchLength - COMPRESSION_MIN_MATCH));
+        output[outputLength++] = static_cast<char>(matchDistance & 0xFF);
+        output[outputLength++] = static_cast<char>(matchDistance >> 8);
+
+        // index the bytes the match covers, so the matches after it can refer back to them
+        for (size_t covered = position + 1; covered < position + matchLength &&
+                                            covered + COMPRESSION_MIN_MATCH <= inputLength; ++covered)
+        {
+            heads[compression_hash(input + covered)] = static_cast<int32_t>(covered);
+        }
+        position += matchLength;
+        literalStart = position;
+    }
+    if (!emit_literals(input + literalStart, inputLength - literalStart, output, &outputLength, inputLength))
+    {
+        return 0;
+    }
+    return outputLength;
+}
+
+/********************************************************************************************************************************
+ * ssize_t expand_payload(const char* input, size_t inputLength, char* output, size_t outputSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Expands a payload compressed by compress_payload() back into the output buffer. A reference is copied a
+ *      byte at a time, since it may overlap the bytes it produces (a run), or start in the compressionDictionary and
+ *      end in the output. Every control byte, length, and distance is checked, so a corrupt payload never reads or
+ *      writes out of bounds.
+ *
+ * Parameters:
+ *      input             I/P    const char*    the compressed payload
+ *      inputLength       I/P    size_t         the number of bytes in input
+ *      output            O/P    char*          the buffer to expand the payload into
+ *      outputSize        I/P    size_t         the size of output in bytes
+ *      expand_payload    O/P    ssize_t        the number of bytes expanded into output, or -1 if the payload is corrupt
+ *******************************************************************************************************************************/
+ssize_t expand_payload(const char* input, size_t inputLength, char* output, size_t outputSize)
+{
+    size_t inputOffset = 0;
+    size_t outputLength = 0;
+    while (inputOffset < inputLength)
+    {
+        const uint8_t control = static_cast<uint8_t>(input[inputOffset++]);
+        if ((control & COMPRESSION_MATCH_FLAG) == 0)
+        {
+            const size_t runLength = control + 1u;
+            if (runLength > inputLength - inputOffset || runLength > outputSize - outputLength)
+            {
+                return -1;
+            }
+            memcpy(output + outputLength, input + inputOffset, runLength);
+            inputOffset += runLength;
+            outputLength += runLength;
+            continue;
+        }
+
+        const size_t matchLength = (control & ~COMPRESSION_MATCH_FLAG) + COMPRESSION_MIN_MATCH;
+        if (inputLength - inputOffset < 2)
+        {
+            return -1;
+        }
+        const size_t distance = static_cast<uint8_t>(input[inputOffset]) |
+                                (static_cast<size_t>(static_cast<uint8_t>(input[inputOffset + 1])) << 8);
+        inputOffset += 2;
+        if (distance == 0 || distance > compressionDictionaryLength + outputLength ||
+            matchLength > outputSize - outputLength)
+        {
+            return -1;
+        }
+        const size_t start = compressionDictionaryLength + outputLength - distance;
+        for (size_t i = 0; i < matchLength; ++i)
+        {
+            output[outputLength] = window_byte(output, start + i);
+            ++outputLength;
+        }
+    }
+    return static_cast<ssize_t>(outputLength);
+}
+
+/********************************************************************************************************************************
+ * bool expand_reply(const MessageHeader& header, const char** payload, size_t* payloadLength, char* buffer,
+ *                   size_t bufferSize)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method for the clients to expand the payload of a FRAME_COMPRESSED reply frame into the buffer,
+ *      pointing the payload at the expanded bytes instead. Any other frame is left as it is. On a corrupt payload, an
+ *      error message is printed to the console and false is returned.
+ *
+ * Parameters:
+ *      header           I/P    const MessageHeader&    the header of the reply frame
+ *      payload          I/O    const char**            the payload of the frame, then the expanded payload
+ *      payloadLength    I/O    size_t*                 the number of bytes in payload
+ *      buffer           O/P    char*                   the buffer to expand the payload into
+ *      bufferSize       I/P    size_t                  the size of buffer in bytes (the message size)
+ *      expand_reply     O/P    bool                    true if the payload is ready to use, false if it is corrupt
+ *******************************************************************************************************************************/
+bool expand_reply(const MessageHeader& header, const char** payload, size_t* payloadLength, char* buffer,
+                  size_t bufferSize)
+{
+    if ((header.flags & FRAME_COMPRESSED) == 0)
+    {
+        return true;
+    }
+    const ssize_t expandedLength = expand_payload(*payload, *payloadLength, buffer, bufferSize);
+    if (expandedLength == -1)
+    {
+        std::cerr << "client::expand_payload() - received a corrupt compressed reply (" << header.requestID << ").\n";
+        return false;
+    }
+    *payload = buffer;
+    *payloadLength = expandedLength;
+    return true;
+}
+
+/********************************************************************************************************************************
+ * size_t encode_uname_entry(char* output, size_t outputSize, size_t outputLength, uint8_t field, const char* value, 
+ *                           size_t valueLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to append an entry to a binary CMD_GET_UNAME_FIELDS response (see UnameField). An entry 
+ *      that does not fit in the output buffer is left out, and a value is truncated to the 255 bytes its length can hold.
+ *
+ * Parameters:
+ *      output                I/P    char*          the buffer holding the response
+ *      outputSize            I/P    size_t         the size of output in bytes
+ *      outputLength          I/P    size_t         the number of bytes of the response in output so far
+ *      field                 I/P    uint8_t        the UnameField of the entry
+ *      value                 I/P    const char*    the value of the entry (not NUL-terminated)
+ *      valueLength           I/P    size_t         the number of bytes in value
+ *      encode_uname_entry    O/P    size_t         the number of bytes of the response in output with the entry
+ *******************************************************************************************************************************/
+size_t encode_uname_entry(char* output, size_t outputSize, size_t outputLength, uint8_t field, const char* value, 
+                          size_t valueLength)
+{
+    if (valueLength > UINT8_MAX)
+    {
+        valueLength = UINT8_MAX;
+    }
+    if (outputSize - outputLength < UNAME_ENTRY_HEADER_SIZE + valueLength)
+    {
+        return outputLength;
+    }
+    output[outputLength] = static_cast<char>(field);
+    output[outputLength + 1] = static_cast<char>(valueLength);
+    memcpy(output + outputLength + UNAME_ENTRY_HEADER_SIZE, value, valueLength);
+    return outputLength + UNAME_ENTRY_HEADER_SIZE + valueLength;
+}
+
+/********************************************************************************************************************************
+ * bool render_uname(const char* reply, size_t replyLength, char* output, size_t outputSize, size_t* outputLength)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Report a reply which ends inside an entry, rather than skipping the entry.
+ *
+ * Description: Utility method to render a binary CMD_GET_UNAME_FIELDS reply (see UnameField) as text on the client, one
+ *      labelled field per line, exactly as the server formats MESSAGE_UNAME. Fields the client does not know are skipped,
+ *      and the text is truncated to the size of the output buffer if it does not fit. The reply must be whole (every
+ *      chunk of a streamed reply), since its entries span chunks. Should the reply end inside an entry, an error message
+ *      is printed to the console and false is returned, since the fields after it are missing.
+ *
+ * Parameters:
+ *      reply            I/P    const char*    the binary reply (without its MessageHeader)
+ *      replyLength      I/P    size_t         the number of bytes in reply
+ *      output           O/P    char*          the buffer to render the text into
+ *      outputSize       I/P    size_t         the size of output in bytes
+ *      outputLength     O/P    size_t*        the number of bytes of the text rendered into output
+ *      render_uname     O/P    bool           true if the reply was rendered whole, false if it is truncated
+ *******************************************************************************************************************************/
+bool render_uname(const char* reply, size_t replyLength, char* output, size_t outputSize, size_t* outputLength)
+{
+    *outputLength = 0;
+    size_t offset = 0;
+    while (offset < replyLength)
+    {
+        if (replyLength - offset < UNAME_ENTRY_HEADER_SIZE ||
+            replyLength - offset - UNAME_ENTRY_HEADER_SIZE < static_cast<uint8_t>(reply[offset + 1]))
+        {
+            std::cerr << "client::render_uname() - received a truncated uname reply (" << replyLength << " bytes).\n";
+            return false;
+        }
+        const uint8_t field = static_cast<uint8_t>(reply[offset]);
+        const size_t valueLength = static_cast<uint8_t>(reply[offset + 1]);
+        const char* value = reply + offset + UNAME_ENTRY_HEADER_SIZE;
+        offset += UNAME_ENTRY_HEADER_SIZE + valueLength;
+        if (field >= UNAME_FIELD_COUNT && field != UNAME_FIELD_ERROR)
+        {
+            continue; // a field of a newer server
+        }
+        if (*outputLength > 0)
+        {
+            *outputLength += copy_bytes(output + *outputLength, outputSize - *outputLength, "\n", 1);
+        }
+        if (field != UNAME_FIELD_ERROR)
+        {
+            *outputLength += copy_message(output + *outputLength, outputSize - *outputLength, UNAME_FIELD_LABELS[field]);
+        }
+        *outputLength += copy_bytes(output + *outputLength, outputSize - *outputLength, value, valueLength);
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * int open_endpoint(const char* endpoint, bool listening)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Moved to protocol.cpp, the server keeps the path of its socket itself.
+ *
+ * Description: Opens the socket of an endpoint, either GATEWAY_UNIX_PREFIX followed by the path of a Unix domain socket,
+ *      or GATEWAY_TCP_PREFIX followed by [host:]port. A listening socket (the gateway, ARG_LISTEN) is bound to the endpoint
+ *      and non-blocking, for the reactor of the server workers; a TCP one without a host listens on every address. A 
+ *      connected socket (a fan-out host, ARG_HOSTS) is blocking, with TCP_NODELAY set on TCP; a TCP one without a host 
+ *      connects to the local host. A socket file left behind by a crashed server (which nothing listens on anymore) is
+ *      replaced, and unlinked by the server on exit. On error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      endpoint         I/P    const char*    the endpoint to open
+ *      listening        I/P    bool           true to listen on the endpoint, false to connect to it
+ *      open_endpoint    O/P    int            the socket of the endpoint, or -1 on error
+ *******************************************************************************************************************************/
+int open_endpoint(const char* endpoint, bool listening)
+{
+    const int flags = SOCK_STREAM | SOCK_CLOEXEC | (listening ? SOCK_NONBLOCK : 0);
+    if (strncmp(endpoint, GATEWAY_UNIX_PREFIX, strlen(GATEWAY_UNIX_PREFIX)) == 0)
+    {
+        const char* path = endpoint + strlen(GATEWAY_UNIX_PREFIX);
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path[0] == '\0' || strlen(path) >= sizeof(address.sun_path))
+        {
+            std::cerr << "endpoint::open_endpoint() - invalid socket path \"" << path << "\".\n";
+            return -1;
+        }
+        memcpy(address.sun_path, path, strlen(path));
+        const sockaddr* socketAddress = reinterpret_cast<const sockaddr*>(&address);
+
+        const int descriptor = socket(AF_UNIX, flags, 0);
+        if (descriptor == -1)
+        {
+            perror("endpoint::socket()");
+            return -1;
+        }
+        if (!listening)
+        {
+            if (connect(descriptor, socketAddress, sizeof(address)) == -1)
+            {
+                perror("endpoint::connect()");
+                close(descriptor);
+                return -1;
+            }
+            return descriptor;
+        }
+
+        // replace a socket file nothing listens on anymore, but never the socket of a running server
+        int bound = bind(descriptor, socketAddress, sizeof(address));
+        if (bound == -1 && errno == EADDRINUSE)
+        {
+            const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const bool stale = probe != -1 && connect(probe, socketAddress, sizeof(address)) == -1 && 
+                               errno == ECONNREFUSED;
+            if (probe != -1)
+            {
+                close(probe);
+            }
+            errno = EADDRINUSE;
+            if (stale && unlink(path) == 0)
+            {
+                bound = bind(descriptor, socketAddress, sizeof(address));
+            }
+        }
+        if (bound == -1 || listen(descriptor, GATEWAY_BACKLOG) == -1)
+        {
+            perror("endpoint::bind()");
+            close(descriptor);
+            return -1;
+        }
+        return descriptor;
+    }
+    if (strncmp(endpoint, GATEWAY_TCP_PREFIX, strlen(GATEWAY_TCP_PREFIX)) != 0)
+    {
+        std::cerr << "endpoint::open_endpoint() - invalid endpoint \"" << endpoint << "\" (expected " 
+                  << GATEWAY_UNIX_PREFIX << "path or " << GATEWAY_TCP_PREFIX << "[host:]port).\n";
+        return -1;
+    }
+
+    // split [host:]port at the last colon, so an IPv6 address in brackets keeps its own
+    std::string host(endpoint + strlen(GATEWAY_TCP_PREFIX));
+    const size_t colon = host.rfind(':');
+    const std::string port = (colon == std::string::npos) ? host : host.substr(colon + 1);
+    host = (colon == std::string::npos) ? std::string() : host.substr(0, colon);
+    if (host.size() >= 2 && host[0] == '[' && host[host.size() - 1] == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    addrinfo* addresses;
+    const int error = getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &addresses);
+    if (error != 0)
+    {
+        std::cerr << "endpoint::getaddrinfo() - " << endpoint << ": " << gai_strerror(error) << ".\n";
+        return -1;
+    }
+
+    // take the first address which opens
+    int descriptor = -1;
+    int lastError = 0;
+    for (const addrinfo* candidate = addresses; candidate != NULL && descriptor == -1; candidate = candidate->ai_next)
+    {
+        descriptor = socket(candidate->ai_family, flags, candidate->ai_protocol);
+        if (descriptor == -1)
+        {
+            lastError = errno;
+            continue;
+        }
+        const int enabled = 1;
+        const bool opened = listening ?
+            setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled)) == 0 &&
+            bind(descriptor, candidate->ai_addr, candidate->ai_addrlen) == 0 && listen(descriptor, GATEWAY_BACKLOG) == 0 :
+            connect(descriptor, candidate->ai_addr, candidate->ai_addrlen) == 0;
+        if (!opened)
+        {
+            lastError = errno;
+            close(descriptor);
+            descriptor = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (descriptor == -1)
+    {
+        errno = lastError;
+        perror(listening ? "endpoint::bind()" : "endpoint::connect()");
+        return -1;
+    }
+    if (!listening)
+    {
+        const int enabled = 1;
+        setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled)); // NOTE: one command at a time
+    }
+    return descriptor;
+}
+
+/********************************************************************************************************************************
+ * mqd_t open_reply_queue(int32_t clientID, mq_attr* attributes, char* queueName)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of create_reply_queue(), so pgm1 and libpgm1 create it alike.
+ *
+ * Description: Creates the private reply queue of a client (see REPLY_QUEUE_NAME_FORMAT) for reading, replacing one
+ *      left behind by a crashed client with the same client ID. The caller owns the client ID, so a queue which
+ *      already exists under its name can only be stale. On error, -1 is returned with errno set (nothing is printed,
+ *      so the library can report it as it sees fit).
+ *
+ * Parameters:
+ *      clientID            I/P    int32_t     the client ID naming the queue
+ *      attributes          I/P    mq_attr*    the attributes to create the queue with (its depth and message size)
+ *      queueName           O/P    char*       the name of the queue, in REPLY_QUEUE_NAME_SIZE bytes (to unlink it by)
+ *      open_reply_queue    O/P    mqd_t       the reply queue, or -1 on error
+ *******************************************************************************************************************************/
+mqd_t open_reply_queue(int32_t clientID, mq_attr* attributes, char* queueName)
+{
+    snprintf(queueName, REPLY_QUEUE_NAME_SIZE, REPLY_QUEUE_NAME_FORMAT, clientID);
+    mqd_t queue = mq_open(queueName, O_RDONLY | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, attributes);
+    if (queue == -1 && errno == EEXIST && mq_unlink(queueName) == 0)
+    {
+        queue = mq_open(queueName, O_RDONLY | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, attributes);
+    }
+    return queue;
+}
@@ -0,0 +1,538 @@
+/****************************************************************************************************************************************************
+* File: protocol.h
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the framing, compression, and rendering of the protocol out of main.cpp.
+* 10/14/2026   Kerby Kaska     Merged find_builtin_command() into find_command() (see dispatch.h), the one lookup of every command.
+* 10/14/2026   Kerby Kaska     Moved parse_count(), ENV_PRIORITY, and QUEUE_PRIORITY_LIMIT out of main.cpp, so libpgm1 defaults its
+*                              message priority like the client.
+*
+* Description: The protocol pgm1 speaks between its clients and servers, shared by pgm1 and libpgm1 (see pgm1.h): the
+*      names of the queues and commands, the MessageHeader every command and reply is framed behind, the perfect
+*      hash the built-in commands are looked up through, the dictionary compression of the replies, and the binary
+*      uname reply with its rendering. Nothing in it depends on the process state of the program, so any number of
+*      clients can frame and expand through it at once (once build_compression_dictionary() has run).
+****************************************************************************************************************************************************/
+
+#ifndef PGM1_PROTOCOL_H
+#define PGM1_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <mqueue.h>
+#include <time.h>
+
+/********************************************************************************************************************************
+ * Queue Constants:
+ * COMMAND_QUEUE_NAME       const char*           name of the message queue handled by commandQueue
+ * REPLY_QUEUE_NAME_FORMAT  const char*           name format of the private reply queue of a standalone client (by process ID)
+ * REPLY_QUEUE_NAME_SIZE    const unsigned int    number of bytes reserved for a formatted REPLY_QUEUE_NAME_FORMAT name
+ * QUEUE_MAX_MESSAGES       const unsigned int    default maximum number of messages in the queue before blocking new messages
+ * QUEUE_MESSAGE_SIZE       const unsigned int    default number of bytes indicating the size of an individual queue message
+ * QUEUE_PERMISSIONS        const int             octal Unix read/write/execute file permissions granted to the queue on creation
+ * QUEUE_MESSAGE_PRIORITY   const int             default message priority of all messages sent through the message queue
+ * QUEUE_MIN_MESSAGE_SIZE   const unsigned int    smallest message size accepted at startup (room for a header and a reply)
+ * QUEUE_MAX_MESSAGE_SIZE   const unsigned int    largest message size accepted at startup (MessageHeader::payloadLength)
+ * QUEUE_PRIORITY_LIMIT     const unsigned int    largest message priority accepted at startup (MQ_PRIO_MAX - 1 on Linux,
+ *                                                less the PRIORITY_CONTROL class sent above it)
+ * ENV_PRIORITY             const char*           environment variable providing the default message priority (the default
+ *                                                for --priority, and for Pgm1ClientConfig::priority)
+ *******************************************************************************************************************************/
+static const char* const COMMAND_QUEUE_NAME      = "/pgm1_mq_command";
+static const char* const REPLY_QUEUE_NAME_FORMAT = "/pgm1_mq_reply_%d";
+static const unsigned int REPLY_QUEUE_NAME_SIZE  = 32;
+static const unsigned int QUEUE_MAX_MESSAGES     = 10;
+static const unsigned int QUEUE_MESSAGE_SIZE     = 1024;
+static const int QUEUE_PERMISSIONS               = 0777; // read/write/execute for everyone
+static const int QUEUE_MESSAGE_PRIORITY          = 15;
+static const unsigned int QUEUE_MIN_MESSAGE_SIZE = 64;
+static const unsigned int QUEUE_MAX_MESSAGE_SIZE = 65535;
+static const unsigned int QUEUE_PRIORITY_LIMIT   = 32765;
+static const char* const ENV_PRIORITY            = "PGM1_PRIORITY";
+
+/********************************************************************************************************************************
+ * Command Constants:
+ * CMD_GET_DOMAIN_NAME      const char*           command string to be entered by the user for getting the system domain name
+ * CMD_GET_HOST_NAME        const char*           command string to be entered by the user for getting the system host name
+ * CMD_GET_UNAME            const char*           command string to be entered by the user for getting the system Unix name
+ * CMD_GET_HELP             const char*           command string to be entered by the user for getting a useful help message
+ * CMD_EXIT                 const char*           command string to be entered by the user for exiting the program
+ * CMD_REFRESH              const char*           command string to be entered by the user for refreshing the cached responses
+ * CMD_STATS                const char*           command string to be entered by the user for getting the server statistics
+ * CMD_GET_UNAME_FIELDS     const char*           command string for getting the system Unix name as binary UnameField entries
+ *******************************************************************************************************************************/
+static constexpr const char* CMD_GET_DOMAIN_NAME  = "getdomainname";
+static constexpr const char* CMD_GET_HOST_NAME    = "gethostname";
+static constexpr const char* CMD_GET_UNAME        = "uname";
+static constexpr const char* CMD_GET_HELP         = "help";
+static constexpr const char* CMD_EXIT             = "exit";
+static constexpr const char* CMD_REFRESH          = "refresh";
+static constexpr const char* CMD_STATS            = "stats";
+static constexpr const char* CMD_GET_UNAME_FIELDS = "uname-fields";
+
+/********************************************************************************************************************************
+ * enum Opcode
+ * Description: Compact numeric command identifiers sent in the MessageHeader instead of the command string, so the server
+ *     can dispatch a command without scanning any text. Each opcode indexes its entry in COMMAND_NAMES (and in the
+ *     COMMAND_TABLE of the server). The commands of plugins are registered at startup with the opcodes following
+ *     OPCODE_COUNT (see load_plugin() of the server).
+ *
+ * Values:
+ * OPCODE_TEXT              the payload is the command string itself, and is looked up by name on the server
+ * OPCODE_GET_DOMAIN_NAME   CMD_GET_DOMAIN_NAME
+ * OPCODE_GET_HOST_NAME     CMD_GET_HOST_NAME
+ * OPCODE_GET_UNAME         CMD_GET_UNAME
+ * OPCODE_GET_HELP          CMD_GET_HELP
+ * OPCODE_EXIT              CMD_EXIT
+ * OPCODE_REFRESH           CMD_REFRESH
+ * OPCODE_STATS             CMD_STATS
+ * OPCODE_GET_UNAME_FIELDS  CMD_GET_UNAME_FIELDS (the client frames CMD_GET_UNAME as this opcode, see frame_request())
+ * OPCODE_COUNT             number of opcodes (not an opcode)
+ *******************************************************************************************************************************/
+enum Opcode : uint16_t
+{
+    OPCODE_TEXT = 0,
+    OPCODE_GET_DOMAIN_NAME,
+    OPCODE_GET_HOST_NAME,
+    OPCODE_GET_UNAME,
+    OPCODE_GET_HELP,
+    OPCODE_EXIT,
+    OPCODE_REFRESH,
+    OPCODE_STATS,
+    OPCODE_GET_UNAME_FIELDS,
+    OPCODE_COUNT
+};
+
+/********************************************************************************************************************************
+ * enum PriorityClass
+ * Description: Priority class of a command, added to the configured message priority (QueueConfig::messagePriority) so
+ *     that the queues deliver control commands ahead of bulk traffic. A batched message is sent with the highest class
+ *     of its commands, and every reply is sent with the priority of its request.
+ *
+ * Values:
+ * PRIORITY_BULK            text commands (unknown commands and payloads), sent at the configured message priority
+ * PRIORITY_NORMAL          system information and help commands
+ * PRIORITY_CONTROL         session control and health commands, which must never wait behind bulk traffic
+ * PRIORITY_CLASS_COUNT     number of priority classes (not a class)
+ *******************************************************************************************************************************/
+enum PriorityClass : uint16_t
+{
+    PRIORITY_BULK = 0,
+    PRIORITY_NORMAL,
+    PRIORITY_CONTROL,
+    PRIORITY_CLASS_COUNT
+};
+
+/********************************************************************************************************************************
+ * Command Index Constants:
+ * COMMAND_INDEX_SIZE        const unsigned int   number of slots in the perfect hash COMMAND_INDEX (must be a power of two)
+ * COMMAND_HASH_SEARCH_LIMIT const uint32_t       number of seeds tried at compile time to find a perfect hash
+ *******************************************************************************************************************************/
+static constexpr unsigned int COMMAND_INDEX_SIZE        = 64;
+static constexpr uint32_t COMMAND_HASH_SEARCH_LIMIT     = 4096;
+
+/********************************************************************************************************************************
+ * struct CommandIndex
+ * Description: Perfect hash index from command names to opcodes, built at compile time by build_command_index().
+ *
+ * Members:
+ * opcodes                  uint16_t[]            opcode of the command hashed into each slot, or OPCODE_TEXT for an empty slot
+ *******************************************************************************************************************************/
+struct CommandIndex
+{
+    uint16_t opcodes[COMMAND_INDEX_SIZE];
+};
+
+/********************************************************************************************************************************
+ * static constexpr size_t string_length(const char* text)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Compile-time equivalent of strlen(), used to store the length of each command name in COMMAND_NAMES.
+ *
+ * Parameters:
+ *      text             I/P    const char*    the NUL-terminated string to measure
+ *      string_length    O/P    size_t         the number of bytes in text, excluding the NUL terminator
+ *******************************************************************************************************************************/
+static constexpr size_t string_length(const char* text)
+{
+    size_t length = 0;
+    while (text[length] != '\0')
+    {
+        ++length;
+    }
+    return length;
+}
+
+/********************************************************************************************************************************
+ * struct CommandName
+ * Description: Entry of COMMAND_NAMES, the name and priority class of a built-in command, which is all a client needs to
+ *     frame it (the server dispatches it through its own COMMAND_TABLE).
+ *
+ * Members:
+ * name                     const char*           command string to be entered by the user (one of the command constants)
+ * nameLength               size_t                number of bytes in name
+ * priority                 PriorityClass         priority class the command is sent with
+ *******************************************************************************************************************************/
+struct CommandName
+{
+    const char* name;
+    size_t nameLength;
+    PriorityClass priority;
+};
+
+/********************************************************************************************************************************
+ * Command Names:
+ * COMMAND_NAMES            const CommandName[]   name and priority class of every built-in command, indexed by opcode
+ *******************************************************************************************************************************/
+static constexpr CommandName COMMAND_NAMES[OPCODE_COUNT] = 
+{
+    { NULL,                 0,                                   PRIORITY_BULK    }, // OPCODE_TEXT
+    { CMD_GET_DOMAIN_NAME,  string_length(CMD_GET_DOMAIN_NAME),  PRIORITY_NORMAL  }, // OPCODE_GET_DOMAIN_NAME
+    { CMD_GET_HOST_NAME,    string_length(CMD_GET_HOST_NAME),    PRIORITY_CONTROL }, // OPCODE_GET_HOST_NAME
+    { CMD_GET_UNAME,        string_length(CMD_GET_UNAME),        PRIORITY_NORMAL  }, // OPCODE_GET_UNAME
+    { CMD_GET_HELP,         string_length(CMD_GET_HELP),         PRIORITY_NORMAL  }, // OPCODE_GET_HELP
+    { CMD_EXIT,             string_length(CMD_EXIT),             PRIORITY_CONTROL }, // OPCODE_EXIT
+    { CMD_REFRESH,          string_length(CMD_REFRESH),          PRIORITY_CONTROL }, // OPCODE_REFRESH
+    { CMD_STATS,            string_length(CMD_STATS),            PRIORITY_CONTROL }, // OPCODE_STATS
+    { CMD_GET_UNAME_FIELDS, string_length(CMD_GET_UNAME_FIELDS), PRIORITY_NORMAL  }, // OPCODE_GET_UNAME_FIELDS
+};
+
+/********************************************************************************************************************************
+ * static constexpr uint32_t hash_command(const char* name, size_t nameLength, uint32_t seed)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Seeded FNV-1a hash of a command name, used to index COMMAND_INDEX. Usable at compile time.
+ *
+ * Parameters:
+ *      name            I/P    const char*    the command name bytes (not NUL-terminated)
+ *      nameLength      I/P    size_t         the number of bytes in name
+ *      seed            I/P    uint32_t       the seed mixed into the FNV offset basis
+ *      hash_command    O/P    uint32_t       the hash of the command name
+ *******************************************************************************************************************************/
+static constexpr uint32_t hash_command(const char* name, size_t nameLength, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < nameLength; ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return hash;
+}
+
+/********************************************************************************************************************************
+ * static constexpr bool is_perfect_seed(uint32_t seed)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hash the COMMAND_NAMES, which the clients of libpgm1 share.
+ *
+ * Description: Checks whether the given seed hashes every command name of COMMAND_NAMES into a different slot of 
+ *      COMMAND_INDEX. Usable at compile time.
+ *
+ * Parameters:
+ *      seed               I/P    uint32_t    the seed to check
+ *      is_perfect_seed    O/P    bool        true if no two command names hash into the same slot, false otherwise
+ *******************************************************************************************************************************/
+static constexpr bool is_perfect_seed(uint32_t seed)
+{
+    bool used[COMMAND_INDEX_SIZE] = {};
+    for (unsigned int opcode = OPCODE_TEXT + 1; opcode < OPCODE_COUNT; ++opcode)
+    {
+        const uint32_t slot = hash_command(COMMAND_NAMES[opcode].name, COMMAND_NAMES[opcode].nameLength, seed) 
+            & (COMMAND_INDEX_SIZE - 1);
+        if (used[slot])
+        {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static constexpr uint32_t find_perfect_seed(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hash the COMMAND_NAMES, which the clients of libpgm1 share.
+ *
+ * Description: Searches for the first seed which makes hash_command() a perfect hash of the command names in COMMAND_NAMES.
+ *      Evaluated at compile time for COMMAND_HASH_SEED.
+ *
+ * Parameters:
+ *      find_perfect_seed    O/P    uint32_t    the perfect seed, or COMMAND_HASH_SEARCH_LIMIT if none was found
+ *******************************************************************************************************************************/
+static constexpr uint32_t find_perfect_seed()
+{
+    uint32_t seed = 0;
+    while (seed < COMMAND_HASH_SEARCH_LIMIT && !is_perfect_seed(seed))
+    {
+        ++seed;
+    }
+    return seed;
+}
+
+/********************************************************************************************************************************
+ * static constexpr CommandIndex build_command_index(uint32_t seed)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hash the COMMAND_NAMES, which the clients of libpgm1 share.
+ *
+ * Description: Builds the perfect hash index from command names to opcodes, using the given (perfect) seed. Evaluated at
+ *      compile time for COMMAND_INDEX.
+ *
+ * Parameters:
+ *      seed                   I/P    uint32_t        the perfect seed found by find_perfect_seed()
+ *      build_command_index    O/P    CommandIndex    the opcode in each slot of the index (OPCODE_TEXT for an empty slot)
+ *******************************************************************************************************************************/
+static constexpr CommandIndex build_command_index(uint32_t seed)
+{
+    CommandIndex index = {};
+    for (unsigned int opcode = OPCODE_TEXT + 1; opcode < OPCODE_COUNT; ++opcode)
+    {
+        index.opcodes[hash_command(COMMAND_NAMES[opcode].name, COMMAND_NAMES[opcode].nameLength, seed) 
+            & (COMMAND_INDEX_SIZE - 1)] = opcode;
+    }
+    return index;
+}
+
+/********************************************************************************************************************************
+ * Command Index:
+ * COMMAND_HASH_SEED        const uint32_t        seed which makes hash_command() a perfect hash of the command names
+ * COMMAND_INDEX            const CommandIndex    perfect hash index from command names to opcodes
+ *******************************************************************************************************************************/
+static constexpr uint32_t COMMAND_HASH_SEED = find_perfect_seed();
+static_assert(COMMAND_HASH_SEED < COMMAND_HASH_SEARCH_LIMIT, "no perfect seed found, increase COMMAND_INDEX_SIZE");
+static constexpr CommandIndex COMMAND_INDEX = build_command_index(COMMAND_HASH_SEED);
+
+/********************************************************************************************************************************
+ * Message Constants:
+ * MESSAGE_HELP             const char*           message returned to the user as a result of the CMD_GET_HELP command
+ * MESSAGE_EXIT             const char*           message returned to the user as a result of the CMD_EXIT command
+ * MESSAGE_REFRESH          const char*           message returned to the user as a result of the CMD_REFRESH command
+ * MESSAGE_*_LENGTH         const size_t          pre-computed number of bytes in MESSAGE_HELP, MESSAGE_EXIT, and MESSAGE_REFRESH
+ * MESSAGE_NO_SERVER        const char*           console message printed when a standalone client finds no server to attach to
+ * MESSAGE_SHED             const char*           message returned instead of the result of a request shed by a busy server
+ * MESSAGE_TIMED_OUT        const char*           message printed instead of the result of a request whose deadline passed
+ * MESSAGE_NO_CONNECTION    const char*           message printed instead of the result of a fan-out host which is not connected
+ *******************************************************************************************************************************/
+static constexpr const char* MESSAGE_HELP      = "Available Commands:\n"
+                                                 " > getdomainname - get the system domain name and print it to the console\n"
+                                                 " > gethostname - get the system host name and print it to the console\n"
+                                                 " > uname [field...] - get the system Unix name (or only the named fields: system, node,\n"
+                                                 "   release, version, machine, domain) and print it to the console\n"
+                                                 " > refresh - refresh the cached system information of the server\n"
+                                                 " > stats - get the request, traffic, and latency statistics of the server\n"
+                                                 " > help - gets this help message and prints it to the console\n"
+                                                 " > exit - exit the application";
+static constexpr const char* MESSAGE_EXIT      = "Goodbye!";
+static constexpr const char* MESSAGE_REFRESH   = "Cached system information refreshed.";
+static constexpr size_t MESSAGE_HELP_LENGTH    = string_length(MESSAGE_HELP);
+static constexpr size_t MESSAGE_EXIT_LENGTH    = string_length(MESSAGE_EXIT);
+static constexpr size_t MESSAGE_REFRESH_LENGTH = string_length(MESSAGE_REFRESH);
+static const char* const MESSAGE_NO_SERVER     = "No server is running. Start one with \"pgm1 --server\" first.";
+static const char* const MESSAGE_SHED          = "Server busy, try again later.";
+static const char* const MESSAGE_TIMED_OUT     = "Request timed out.";
+static const char* const MESSAGE_NO_CONNECTION = "Not connected to the host.";
+
+/********************************************************************************************************************************
+ * enum UnameField
+ * Description: Field of the system Unix name in the binary response of CMD_GET_UNAME_FIELDS. The response is a sequence of
+ *     entries, each one the field (one byte), the length of its value (one byte), and the value (not NUL-terminated), so
+ *     the client renders the text itself (see render_uname()). The entries run to the end of the payload, so a reply
+ *     which ends inside an entry is truncated, and the client reports it rather than rendering the fields before it
+ *     alone. The request payload is either empty, for every field, or a single byte with the bit (1 << field) set for
+ *     each field to return.
+ *
+ * Values:
+ * UNAME_SYSTEM             utsname::sysname
+ * UNAME_NODE               utsname::nodename
+ * UNAME_RELEASE            utsname::release
+ * UNAME_VERSION            utsname::version
+ * UNAME_MACHINE            utsname::machine
+ * UNAME_DOMAIN             utsname::domainname
+ * UNAME_FIELD_COUNT        number of fields (not a field)
+ * UNAME_FIELD_ERROR        the value is an error message, returned instead of the fields if uname() fails
+ *******************************************************************************************************************************/
+enum UnameField : uint8_t
+{
+    UNAME_SYSTEM = 0,
+    UNAME_NODE,
+    UNAME_RELEASE,
+    UNAME_VERSION,
+    UNAME_MACHINE,
+    UNAME_DOMAIN,
+    UNAME_FIELD_COUNT,
+    UNAME_FIELD_ERROR = 0xFF
+};
+
+/********************************************************************************************************************************
+ * Uname Constants:
+ * UNAME_FIELD_NAMES        const char*[]         names of the fields accepted after CMD_GET_UNAME, indexed by UnameField
+ * UNAME_FIELD_LABELS       const char*[]         labels the client renders each field with (as in MESSAGE_UNAME)
+ * UNAME_ENTRY_HEADER_SIZE  const size_t          number of bytes in front of the value of each entry (field and length)
+ * UNAME_TEXT_SIZE          const size_t          number of bytes reserved for rendering the binary response as text
+ *******************************************************************************************************************************/
+static const char* const UNAME_FIELD_NAMES[UNAME_FIELD_COUNT] = { "system", "node", "release", "version", "machine", "domain" };
+static const char* const UNAME_FIELD_LABELS[UNAME_FIELD_COUNT] = { " System: ", "   Node: ", "Release: ", "Version: ", 
+                                                                   "Machine: ", " Domain: " };
+static const size_t UNAME_ENTRY_HEADER_SIZE = 2;
+static const size_t UNAME_TEXT_SIZE         = 1024;
+static_assert(UNAME_FIELD_COUNT <= 8, "the field selection of CMD_GET_UNAME_FIELDS is a single byte");
+
+/********************************************************************************************************************************
+ * Gateway Constants:
+ * GATEWAY_UNIX_PREFIX      const char*           prefix of a Unix domain socket endpoint, followed by the path of the socket
+ * GATEWAY_TCP_PREFIX       const char*           prefix of a TCP endpoint, followed by [host:]port (a host name, an IPv4
+ *                                                address, or an IPv6 address in brackets)
+ * GATEWAY_BACKLOG          const int             number of connections the listening socket queues before they are accepted
+ * GATEWAY_LENGTH_SIZE      const size_t          number of bytes of the length prefixed to every message on a connection
+ *******************************************************************************************************************************/
+static const char* const GATEWAY_UNIX_PREFIX = "unix:";
+static const char* const GATEWAY_TCP_PREFIX  = "tcp:";
+static const int GATEWAY_BACKLOG             = 64;
+static const size_t GATEWAY_LENGTH_SIZE      = sizeof(uint32_t);
+
+/********************************************************************************************************************************
+ * Compression Constants:
+ * COMPRESSION_MIN_LENGTH   const size_t          smallest reply payload worth compressing (shorter ones are sent as they are)
+ *******************************************************************************************************************************/
+static const size_t COMPRESSION_MIN_LENGTH          = 64;
+
+/********************************************************************************************************************************
+ * enum FrameFlag
+ * Description: Flags of a frame, carried in the flags of its MessageHeader (and echoed back in the reply like the rest of
+ *     the header).
+ *
+ * Values:
+ * FRAME_ACCEPTS_COMPRESSED the client of the request can expand a compressed reply (ARG_COMPRESS)
+ * FRAME_COMPRESSED         the payload of the reply is compressed against the compressionDictionary (see expand_payload())
+ * FRAME_MORE               the reply is streamed, and more chunks of it follow this one (see stream_reply())
+ * FRAME_TRACED             the last sizeof(TraceStamps) bytes of the payload are the TraceStamps of the request (ARG_TRACE)
+ *******************************************************************************************************************************/
+enum FrameFlag : uint16_t
+{
+    FRAME_ACCEPTS_COMPRESSED = 1 << 0,
+    FRAME_COMPRESSED = 1 << 1,
+    FRAME_MORE = 1 << 2,
+    FRAME_TRACED = 1 << 3
+};
+
+/********************************************************************************************************************************
+ * struct MessageHeader
+ * Description: Header framed in front of every command and reply sent through the message queues. The server echoes the 
+ *     header of each command back in front of its response, so the client can match replies to outstanding requests.
+ *     A message may hold a batch of several frames back to back, each one a header followed by payloadLength bytes.
+ *
+ * Members:
+ * requestID                uint32_t              client-assigned ID of the request, echoed back by the server in the reply
+ * clientID                 int32_t               process ID naming the private reply queue of a standalone client 
+ *                                                (see REPLY_QUEUE_NAME_FORMAT), or 0 to reply on the shared responseQueue
+ * opcode                   uint16_t              Opcode of the command (OPCODE_TEXT if the payload is the command string), 
+ *                                                echoed back by the server in the reply
+ * payloadLength            uint16_t              number of payload bytes following the header in this frame
+ * deadline                 uint32_t              CLOCK_MONOTONIC time in milliseconds (modulo 2^32) at which the client gives
+ *                                                up on the request, and the server drops it unanswered, or 0 for none
+ * flags                    uint16_t              FrameFlag bits of the frame
+ * sequence                 uint16_t              number of the chunk of a streamed reply, counting from 0 (0 for every other
+ *                                                frame)
+ *
+ * NOTE: the deadline is only meaningful between processes of the same host, which share the CLOCK_MONOTONIC clock
+ *******************************************************************************************************************************/
+struct MessageHeader
+{
+    uint32_t requestID;
+    int32_t clientID;
+    uint16_t opcode;
+    uint16_t payloadLength;
+    uint32_t deadline;
+    uint16_t flags;
+    uint16_t sequence;
+};
+static_assert(QUEUE_MIN_MESSAGE_SIZE > sizeof(MessageHeader), "every chunk of a streamed reply must carry some payload");
+
+/********************************************************************************************************************************
+ * struct TraceStamps
+ * Description: Timestamps of the stages of a traced request (FRAME_TRACED), as CLOCK_MONOTONIC times in nanoseconds. They
+ *     travel at the end of the payload of the request, which the server strips them off, stamps, and appends them to the
+ *     end of the reply, so the frames of the requests which are not traced stay as small as ever.
+ *
+ * Members:
+ * enqueue                  uint64_t              time the client framed the request for the command queue
+ * dequeue                  uint64_t              time the server worker started serving the message of the request
+ * handlerStart             uint64_t              time the handler of the command started running
+ * handlerEnd               uint64_t              time the handler of the command returned
+ * replyDequeue             uint64_t              time the client received the reply
+ *
+ * NOTE: like the deadline, the stamps are only meaningful between processes of the same host, which share the clock
+ *******************************************************************************************************************************/
+struct TraceStamps
+{
+    uint64_t enqueue;
+    uint64_t dequeue;
+    uint64_t handlerStart;
+    uint64_t handlerEnd;
+    uint64_t replyDequeue;
+};
+
+/********************************************************************************************************************************
+ * Protocol Procedures (see protocol.cpp):
+ * copy_message, copy_bytes, format_length
+ *                          utility methods to copy into a buffer, and to convert an snprintf() result into a length
+ * parse_count              utility method to parse a command line argument (or environment variable) value as a bounded count
+ * monotonic_nanoseconds, monotonic_milliseconds, realtime_after
+ *                          utility methods to read the CLOCK_MONOTONIC clock, and to find an absolute timeout
+ * remaining_timeout, deadline_passed
+ *                          utility methods to check how much of the deadline of a request is left
+ * parse_uname_fields       utility method to parse the field names given after the "uname" command
+ * frame_request            frames a command (and its opcode) behind a MessageHeader
+ * read_frame               utility method to copy the MessageHeader of a frame out of a (batched) received message
+ * build_compression_dictionary
+ *                          builds the static compressionDictionary, the same in every process (once, before any
+ *                          payload is compressed or expanded)
+ * compress_payload, expand_payload, expand_reply
+ *                          compress a reply payload against the compressionDictionary, and expand it again on the
+ *                          client
+ * encode_uname_entry       utility method to append an entry to a binary CMD_GET_UNAME_FIELDS response
+ * render_uname             renders a whole binary CMD_GET_UNAME_FIELDS reply as text on the client
+ * open_endpoint            opens a Unix domain or TCP socket endpoint, listening on it or connected to it
+ * open_reply_queue         creates the private reply queue of a client (see REPLY_QUEUE_NAME_FORMAT)
+ *******************************************************************************************************************************/
+size_t copy_message(char* buffer, size_t bufferSize, const char* message);
+size_t copy_bytes(char* buffer, size_t bufferSize, const char* message, size_t messageLength);
+size_t format_length(int formatResult, size_t bufferSize);
+bool parse_count(const char* text, unsigned int minimum, unsigned int maximum, unsigned int* count);
+uint64_t monotonic_nanoseconds();
+uint32_t monotonic_milliseconds();
+timespec realtime_after(int milliseconds);
+int remaining_timeout(uint32_t deadline);
+bool deadline_passed(uint32_t deadline);
+bool parse_uname_fields(const char* input, size_t inputLength, uint8_t* fieldMask);
+size_t frame_request(const char* input, size_t inputLength, uint16_t opcode, uint32_t requestID, int32_t clientID, 
+                     uint32_t deadline, uint16_t flags, char* buffer, size_t bufferSize, bool truncate, 
+                     uint16_t* framedOpcode);
+bool read_frame(const char* message, size_t messageLength, size_t offset, MessageHeader* header);
+void build_compression_dictionary();
+size_t compress_payload(const char* input, size_t inputLength, char* output);
+ssize_t expand_payload(const char* input, size_t inputLength, char* output, size_t outputSize);
+bool expand_reply(const MessageHeader& header, const char** payload, size_t* payloadLength, char* buffer,
+                  size_t bufferSize);
+size_t encode_uname_entry(char* output, size_t outputSize, size_t outputLength, uint8_t field, const char* value, 
+                          size_t valueLength);
+bool render_uname(const char* reply, size_t replyLength, char* output, size_t outputSize, size_t* outputLength);
+int open_endpoint(const char* endpoint, bool listening);
+mqd_t open_reply_queue(int32_t clientID, mq_attr* attributes, char* queueName);
+
+#endif
@@ -0,0 +1,707 @@
+/****************************************************************************************************************************************************
+* File: transport.cpp
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the message queue and shared memory transports out of main.cpp.
+*
+* Description: Implementation of the transports of pgm1 (see transport.h).
+*
+* Procedures:
+* queue_attributes     - utility method to create and configure the message queue attributes
+*
+* close_queues         - utility method to close the queue descriptors (and unlink and unmap what this process owns)
+*
+* open_queues, mqueue_send, mqueue_receive
+*                      - MQUEUE_TRANSPORT, which exchanges messages through the commandQueue and responseQueue
+*
+* open_rings, ring_send, ring_receive
+*                      - RING_TRANSPORT, which exchanges messages through lock-free rings in shared memory
+*
+* ring_slot, ring_readable, ring_writable, ring_wait, ring_notify, ring_try_enqueue, ring_try_dequeue
+*                      - utility methods of the lock-free shared rings and their futex wake ups
+*
+* find_transport       - utility method to look up a transport by the name given to ARG_TRANSPORT
+****************************************************************************************************************************************************/
+
+#include "transport.h"
+#include <iostream>
+#include <new>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/********************************************************************************************************************************
+ * Transport Constants:
+ * PRIVATE_QUEUE_NAME_FORMAT const char*          name format of the private queues of a forked pair (by role and process ID)
+ * SHARED_RINGS_NAME_FORMAT const char*           name format of the shared memory object holding the rings (by process ID)
+ * SHARED_RINGS_NAME_SIZE   const unsigned int    number of bytes reserved for a formatted SHARED_RINGS_NAME_FORMAT name
+ * RING_SPIN_LIMIT          const unsigned int    number of times an empty (or full) ring is polled before sleeping on it
+ *******************************************************************************************************************************/
+static const char* PRIVATE_QUEUE_NAME_FORMAT        = "/pgm1_mq_%s_%d";
+static const char* SHARED_RINGS_NAME_FORMAT         = "/pgm1_shm_rings_%d";
+static const unsigned int SHARED_RINGS_NAME_SIZE    = 32;
+static const unsigned int RING_SPIN_LIMIT           = 128;
+
+/********************************************************************************************************************************
+ * Queue Configuration (see transport.h):
+ *******************************************************************************************************************************/
+QueueConfig queueConfig = { QUEUE_MAX_MESSAGES, QUEUE_MESSAGE_SIZE, QUEUE_MESSAGE_PRIORITY };
+
+/********************************************************************************************************************************
+ * Queue Descriptors (see transport.h):
+ *******************************************************************************************************************************/
+mqd_t commandQueue = -1;
+mqd_t responseQueue = -1;
+
+/********************************************************************************************************************************
+ * Transport State (see transport.h):
+ *******************************************************************************************************************************/
+const Transport* transport = NULL;
+SharedRing* sharedRings[CHANNEL_COUNT];
+void* sharedRegion = NULL;
+size_t sharedRegionSize = 0;
+
+/********************************************************************************************************************************
+ * Process State (see transport.h):
+ *******************************************************************************************************************************/
+char ownedQueueName[REPLY_QUEUE_NAME_SIZE] = "";
+
+/********************************************************************************************************************************
+ * mq_attr queue_attributes(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved the message queue attributes out of main().
+ * 10/14/2026   Kerby Kaska     Use the queueConfig set at startup.
+ *
+ * Description: Utility method to create and configure the message queue attributes every queue is created with, from
+ *      the queueConfig of this process.
+ *
+ * Parameters:
+ *      queue_attributes    O/P    mq_attr    the attributes to create a message queue with
+ *******************************************************************************************************************************/
+mq_attr queue_attributes()
+{
+    mq_attr queueAttributes;
+    memset(&queueAttributes, 0, sizeof(queueAttributes));
+    queueAttributes.mq_maxmsg = queueConfig.maxMessages;
+    queueAttributes.mq_msgsize = queueConfig.messageSize;
+    queueAttributes.mq_flags = 0; // flag queue to block on mq_send/mq_receive 
+    return queueAttributes;
+}
+
+/********************************************************************************************************************************
+ * int close_queues(void)
+ * Author: Kerby Kaska
+ * Date: 1/23/2022
+ * Modification History:
+ * 1/23/2022    Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Skip queues that were never opened, and unlink the queue published by this process (if any).
+ * 10/14/2026   Kerby Kaska     Unmap the shared rings of the shared memory transport (if any).
+ *
+ * Description: Utility method to close queue descriptors to avoid code redundancy.
+ *     Attempts to close the message queue descriptors held by commandQueue and responseQueue, and to unlink the queue
+ *     named by ownedQueueName (if any), and to unmap the sharedRegion (if any). On error, an error message is printed to
+ *     the console and EXIT_FAILURE is returned.
+ *     On success, EXIT_SUCCESS is returned.
+ *
+ * Parameters:
+ *     close_queues    O/P    int    EXIT_FAILURE on error, EXIT_SUCCESS on success
+ *******************************************************************************************************************************/
+int close_queues()
+{
+    int result = EXIT_SUCCESS;
+    if ((commandQueue != -1 && mq_close(commandQueue) == -1) || (responseQueue != -1 && mq_close(responseQueue) == -1)) 
+    {
+        perror("close_queues::mq_close()");
+        result = EXIT_FAILURE;
+    }
+    if (ownedQueueName[0] != '\0' && mq_unlink(ownedQueueName) == -1)
+    {
+        perror("close_queues::mq_unlink()");
+        result = EXIT_FAILURE;
+    }
+    if (sharedRegion != NULL && munmap(sharedRegion, sharedRegionSize) == -1)
+    {
+        perror("close_queues::munmap()");
+        result = EXIT_FAILURE;
+    }
+    sharedRegion = NULL;
+    return result;
+}
+
+/********************************************************************************************************************************
+ * static bool open_queues(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created. Moved out of main().
+ * 10/14/2026   Kerby Kaska     Name both queues privately (PRIVATE_QUEUE_NAME_FORMAT), apart from the published one.
+ *
+ * Description: Opens the commandQueue and the responseQueue of the message queue transport for read/write, and unlinks
+ *      them right away, so they are deleted on the system once every process has closed them. Both queues are private to
+ *      the forked client and server pool, so they are named after this process (never COMMAND_QUEUE_NAME), and never 
+ *      collide with the queue published by a standalone server, or left behind by a persistent one. On error, an error 
+ *      message is printed to the console and every queue which did open is closed (and unlinked) again.
+ *
+ * Parameters:
+ *      open_queues    O/P    bool    true on success, false on error
+ *******************************************************************************************************************************/
+static bool open_queues()
+{
+    // create and configure the message queue attributes
+    mq_attr queueAttributes = queue_attributes();
+
+    // create the message queues for read/write
+    char commandQueueName[REPLY_QUEUE_NAME_SIZE];
+    char responseQueueName[REPLY_QUEUE_NAME_SIZE];
+    snprintf(commandQueueName, sizeof(commandQueueName), PRIVATE_QUEUE_NAME_FORMAT, "command", getpid());
+    snprintf(responseQueueName, sizeof(responseQueueName), PRIVATE_QUEUE_NAME_FORMAT, "response", getpid());
+    commandQueue = mq_open(commandQueueName, O_RDWR | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, &queueAttributes);
+    if (commandQueue == -1)
+    {
+        perror("commandQueue::mq_open()");
+        return false;
+    }
+    responseQueue = mq_open(responseQueueName, O_RDWR | O_CREAT | O_EXCL, QUEUE_PERMISSIONS, &queueAttributes);
+    if (responseQueue == -1)
+    {
+        perror("responseQueue::mq_open()");
+        if (mq_close(commandQueue) == -1) // close commandQueue (since it opened successfully)
+        {
+            perror("commandQueue::mq_close()");
+        }
+        if (mq_unlink(commandQueueName) == -1) // unlink commandQueue (so it is deleted)
+        {
+            perror("commandQueue::mq_unlink()");
+        }
+        commandQueue = -1;
+        return false;
+    }
+
+    // unlink the message queues, so they are deleted on the system when all descriptors lose reference to it
+    if (mq_unlink(commandQueueName) == -1) 
+    {
+        perror("commandQueue::mq_unlink()");
+        mq_unlink(responseQueueName);
+        close_queues();
+        return false;
+    }
+    if (mq_unlink(responseQueueName) == -1) 
+    {
+        perror("responseQueue::mq_unlink()");
+        close_queues();
+        return false;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static int mqueue_send(Channel channel, const char* message, size_t messageLength, unsigned int priority, int timeout)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Send with the priority of the message.
+ * 10/14/2026   Kerby Kaska     Wait for room for at most timeout milliseconds (mq_timedsend()).
+ *
+ * Description: Sends a message on a channel of the message queue transport, through commandQueue or responseQueue. The 
+ *      queue delivers messages of a higher priority first. Should the queue be full, the send waits for room for at most
+ *      timeout milliseconds.
+ *
+ * Parameters:
+ *      channel          I/P    Channel         the channel to send the message on
+ *      message          I/P    const char*     the message to send
+ *      messageLength    I/P    size_t          the number of bytes in message
+ *      priority         I/P    unsigned int    the message priority to send the message with
+ *      timeout          I/P    int             the milliseconds to wait for room at most, or -1 to block
+ *      mqueue_send      O/P    int             0 on success, -1 on error (see mq_timedsend())
+ *******************************************************************************************************************************/
+static int mqueue_send(Channel channel, const char* message, size_t messageLength, unsigned int priority, int timeout)
+{
+    const mqd_t queue = (channel == CHANNEL_COMMAND) ? commandQueue : responseQueue;
+    if (timeout < 0)
+    {
+        return mq_send(queue, message, messageLength, priority);
+    }
+    const timespec deadline = realtime_after(timeout);
+    return mq_timedsend(queue, message, messageLength, priority, &deadline);
+}
+
+/********************************************************************************************************************************
+ * static ssize_t mqueue_receive(Channel channel, char* buffer, size_t bufferSize, unsigned int* priority, int timeout)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hand back the priority of the message.
+ * 10/14/2026   Kerby Kaska     Wait for a message for at most timeout milliseconds (mq_timedreceive()).
+ *
+ * Description: Receives a message from a channel of the message queue transport, through commandQueue or responseQueue.
+ *      Should the queue be empty, the receive waits for a message for at most timeout milliseconds.
+ *
+ * Parameters:
+ *      channel           I/P    Channel          the channel to receive the message from
+ *      buffer            O/P    char*            the buffer to receive the message into
+ *      bufferSize        I/P    size_t           the size of buffer in bytes
+ *      priority          O/P    unsigned int*    the priority the message was sent with (may be NULL)
+ *      timeout           I/P    int              the milliseconds to wait for a message at most, or -1 to block
+ *      mqueue_receive    O/P    ssize_t          the number of bytes of the message, -1 on error (see mq_timedreceive())
+ *******************************************************************************************************************************/
+static ssize_t mqueue_receive(Channel channel, char* buffer, size_t bufferSize, unsigned int* priority, int timeout)
+{
+    const mqd_t queue = (channel == CHANNEL_COMMAND) ? commandQueue : responseQueue;
+    if (timeout < 0)
+    {
+        return mq_receive(queue, buffer, bufferSize, priority);
+    }
+    const timespec deadline = realtime_after(timeout);
+    return mq_timedreceive(queue, buffer, bufferSize, priority, &deadline);
+}
+
+/********************************************************************************************************************************
+ * static RingSlot* ring_slot(SharedRing* ring, uint32_t position)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to find the slot of a shared ring a position maps to.
+ *
+ * Parameters:
+ *      ring         I/P    SharedRing*    the shared ring
+ *      position     I/P    uint32_t       the (unbounded) position in the ring
+ *      ring_slot    O/P    RingSlot*      the slot the position maps to
+ *******************************************************************************************************************************/
+static RingSlot* ring_slot(SharedRing* ring, uint32_t position)
+{
+    char* slots = reinterpret_cast<char*>(ring) + sizeof(SharedRing);
+    return reinterpret_cast<RingSlot*>(slots + static_cast<size_t>(position & (ring->capacity - 1)) * ring->slotSize);
+}
+
+/********************************************************************************************************************************
+ * static bool ring_readable(SharedRing* ring)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether a shared ring may hold a message to receive, which is true as long as the
+ *      slot at the receive position has been written (or another receiver has already moved past it).
+ *
+ * Parameters:
+ *      ring             I/P    SharedRing*    the shared ring
+ *      ring_readable    O/P    bool           false if the ring is empty, true otherwise
+ *******************************************************************************************************************************/
+static bool ring_readable(SharedRing* ring)
+{
+    const uint32_t position = ring->dequeuePosition.load(std::memory_order_relaxed);
+    const uint32_t sequence = ring_slot(ring, position)->sequence.load(std::memory_order_acquire);
+    return static_cast<int32_t>(sequence - (position + 1)) >= 0;
+}
+
+/********************************************************************************************************************************
+ * static bool ring_writable(SharedRing* ring)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to check whether a shared ring may have a free slot to send to, which is true as long as the
+ *      slot at the send position has been received (or another sender has already moved past it).
+ *
+ * Parameters:
+ *      ring             I/P    SharedRing*    the shared ring
+ *      ring_writable    O/P    bool           false if the ring is full, true otherwise
+ *******************************************************************************************************************************/
+static bool ring_writable(SharedRing* ring)
+{
+    const uint32_t position = ring->enqueuePosition.load(std::memory_order_relaxed);
+    const uint32_t sequence = ring_slot(ring, position)->sequence.load(std::memory_order_acquire);
+    return static_cast<int32_t>(sequence - position) >= 0;
+}
+
+/********************************************************************************************************************************
+ * static int ring_wait(SharedRing* ring, RingEvent* event, bool (*ready)(SharedRing*), uint64_t deadline)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Sleep no later than a deadline.
+ *
+ * Description: Utility method to sleep on an event of a shared ring until it is ready. The caller is registered as a 
+ *      waiter before the ring is checked one last time, so a wake up sent in between can never be lost: either the other
+ *      side sees the waiter and changes the futex word (so FUTEX_WAIT returns right away), or this side sees the ring
+ *      ready and does not sleep at all. Waking up does not guarantee the ring is ready, the caller has to retry.
+ *
+ * Parameters:
+ *      ring         I/P    SharedRing*              the shared ring
+ *      event        I/P    RingEvent*               the event to sleep on (readable or writable)
+ *      ready        I/P    bool (*)(SharedRing*)    checks whether the ring is ready (ring_readable or ring_writable)
+ *      deadline     I/P    uint64_t                 the CLOCK_MONOTONIC time in nanoseconds to sleep until at most, or 0
+ *                                                   to sleep for as long as it takes
+ *      ring_wait    O/P    int                      0 once woken up, -1 on error (ETIMEDOUT once the deadline has passed,
+ *                                                   or EINTR if interrupted by a signal)
+ *******************************************************************************************************************************/
+static int ring_wait(SharedRing* ring, RingEvent* event, bool (*ready)(SharedRing*), uint64_t deadline)
+{
+    // NOTE: FUTEX_WAIT takes a relative timeout
+    timespec timeout = { 0, 0 };
+    if (deadline != 0)
+    {
+        const uint64_t now = monotonic_nanoseconds();
+        if (now >= deadline)
+        {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        timeout.tv_sec = (deadline - now) / 1000000000ull;
+        timeout.tv_nsec = (deadline - now) % 1000000000ull;
+    }
+
+    const uint32_t sequence = event->sequence.load();
+    event->waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // NOTE: pairs with the fence in ring_notify()
+
+    int result = 0;
+    if (!ready(ring) && syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event->sequence), FUTEX_WAIT, sequence, 
+        (deadline != 0) ? &timeout : NULL, NULL, 0) == -1 && errno != EAGAIN) // EAGAIN: woken up before falling asleep
+    {
+        result = -1;
+    }
+    event->waiters.fetch_sub(1);
+    return result;
+}
+
+/********************************************************************************************************************************
+ * static void ring_notify(RingEvent* event)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to wake up a process waiting on an event of a shared ring, after a message was sent to (or
+ *      received from) it. The futex system call is only made when a process is actually waiting, so a busy ring costs no
+ *      system calls at all.
+ *
+ * Parameters:
+ *      event    I/P    RingEvent*    the event to wake up a waiter of (readable or writable)
+ *******************************************************************************************************************************/
+static void ring_notify(RingEvent* event)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst); // NOTE: pairs with the fence in ring_wait()
+    if (event->waiters.load(std::memory_order_relaxed) != 0)
+    {
+        event->sequence.fetch_add(1);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&event->sequence), FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+/********************************************************************************************************************************
+ * static bool ring_try_enqueue(SharedRing* ring, const char* message, size_t messageLength, unsigned int priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Store the priority of the message in the slot.
+ *
+ * Description: Utility method to send a message to a shared ring without blocking. The slot at the send position is 
+ *      claimed by advancing the position (racing any other sender), the message is copied in, and the slot is published 
+ *      to the receivers by its sequence number.
+ *
+ * Parameters:
+ *      ring                I/P    SharedRing*    the shared ring
+ *      message             I/P    const char*    the message to send (at most messageSize bytes)
+ *      messageLength       I/P    size_t         the number of bytes in message
+ *      priority            I/P    unsigned int   the priority to store with the message
+ *      ring_try_enqueue    O/P    bool           true if the message was sent, false if the ring is full
+ *******************************************************************************************************************************/
+static bool ring_try_enqueue(SharedRing* ring, const char* message, size_t messageLength, unsigned int priority)
+{
+    uint32_t position = ring->enqueuePosition.load(std::memory_order_relaxed);
+    RingSlot* slot;
+    while (true)
+    {
+        slot = ring_slot(ring, position);
+        const int32_t difference = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0 && ring->enqueuePosition.compare_exchange_weak(position, position + 1, 
+            std::memory_order_relaxed))
+        {
+            break; // claimed the slot
+        }
+        if (difference < 0)
+        {
+            return false; // the slot has not been received yet, the ring is full
+        }
+        if (difference > 0)
+        {
+            position = ring->enqueuePosition.load(std::memory_order_relaxed); // another sender claimed it first
+        }
+    }
+
+    memcpy(reinterpret_cast<char*>(slot) + sizeof(RingSlot), message, messageLength);
+    slot->length = messageLength;
+    slot->priority = priority;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static ssize_t ring_try_dequeue(SharedRing* ring, char* buffer, unsigned int* priority)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hand back the priority stored in the slot.
+ *
+ * Description: Utility method to receive a message from a shared ring without blocking. The slot at the receive position
+ *      is claimed by advancing the position (racing any other receiver), the message is copied out, and the slot is 
+ *      handed back to the senders by its sequence number.
+ *
+ * Parameters:
+ *      ring                I/P    SharedRing*    the shared ring
+ *      buffer              O/P    char*          the buffer to receive the message into (at least messageSize bytes)
+ *      priority            O/P    unsigned int*  the priority the message was sent with (may be NULL)
+ *      ring_try_dequeue    O/P    ssize_t        the number of bytes of the message, or -1 if the ring is empty
+ *******************************************************************************************************************************/
+static ssize_t ring_try_dequeue(SharedRing* ring, char* buffer, unsigned int* priority)
+{
+    uint32_t position = ring->dequeuePosition.load(std::memory_order_relaxed);
+    RingSlot* slot;
+    while (true)
+    {
+        slot = ring_slot(ring, position);
+        const int32_t difference = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - (position + 1));
+        if (difference == 0 && ring->dequeuePosition.compare_exchange_weak(position, position + 1, 
+            std::memory_order_relaxed))
+        {
+            break; // claimed the slot
+        }
+        if (difference < 0)
+        {
+            return -1; // the slot has not been written yet, the ring is empty
+        }
+        if (difference > 0)
+        {
+            position = ring->dequeuePosition.load(std::memory_order_relaxed); // another receiver claimed it first
+        }
+    }
+
+    const ssize_t messageLength = slot->length;
+    memcpy(buffer, reinterpret_cast<char*>(slot) + sizeof(RingSlot), messageLength);
+    if (priority != NULL)
+    {
+        *priority = slot->priority;
+    }
+    slot->sequence.store(position + ring->capacity, std::memory_order_release);
+    return messageLength;
+}
+
+/********************************************************************************************************************************
+ * static bool open_rings(void)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Creates the shared rings of the shared memory transport, one for each channel, in a single shared memory 
+ *      object. Each ring has room for at least the queue depth of messages of the message size in queueConfig (rounded 
+ *      up to a power of two). Like the message queues, the shared memory object is unlinked right away, so it is deleted on the 
+ *      system once every process has unmapped it. The mapping is inherited by the forked client and server workers. On 
+ *      error, an error message is printed to the console.
+ *
+ * Parameters:
+ *      open_rings    O/P    bool    true on success, false on error
+ *******************************************************************************************************************************/
+static bool open_rings()
+{
+    uint32_t capacity = 1;
+    while (capacity < queueConfig.maxMessages)
+    {
+        capacity *= 2;
+    }
+    const uint32_t slotSize = (sizeof(RingSlot) + queueConfig.messageSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * 
+        CACHE_LINE_SIZE;
+    const size_t ringSize = sizeof(SharedRing) + static_cast<size_t>(capacity) * slotSize;
+
+    // create the shared memory object, size it, and map it into this process
+    char regionName[SHARED_RINGS_NAME_SIZE];
+    snprintf(regionName, sizeof(regionName), SHARED_RINGS_NAME_FORMAT, getpid());
+    const int descriptor = shm_open(regionName, O_RDWR | O_CREAT | O_EXCL, QUEUE_PERMISSIONS);
+    if (descriptor == -1)
+    {
+        perror("sharedRings::shm_open()");
+        return false;
+    }
+    if (shm_unlink(regionName) == -1) // unlink the shared memory object, so it is deleted when it is no longer mapped
+    {
+        perror("sharedRings::shm_unlink()");
+        close(descriptor);
+        return false;
+    }
+    if (ftruncate(descriptor, ringSize * CHANNEL_COUNT) == -1)
+    {
+        perror("sharedRings::ftruncate()");
+        close(descriptor);
+        return false;
+    }
+    void* region = mmap(NULL, ringSize * CHANNEL_COUNT, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor); // NOTE: the mapping keeps the shared memory object alive
+    if (region == MAP_FAILED)
+    {
+        perror("sharedRings::mmap()");
+        return false;
+    }
+    sharedRegion = region;
+    sharedRegionSize = ringSize * CHANNEL_COUNT;
+
+    // lay out the rings, with every slot ready to be written at its own position
+    for (unsigned int channel = 0; channel < CHANNEL_COUNT; ++channel)
+    {
+        SharedRing* ring = new (static_cast<char*>(region) + channel * ringSize) SharedRing();
+        ring->capacity = capacity;
+        ring->slotSize = slotSize;
+        ring->messageSize = queueConfig.messageSize;
+        for (uint32_t position = 0; position < capacity; ++position)
+        {
+            new (ring_slot(ring, position)) RingSlot();
+            ring_slot(ring, position)->sequence.store(position, std::memory_order_relaxed);
+        }
+        sharedRings[channel] = ring;
+    }
+    return true;
+}
+
+/********************************************************************************************************************************
+ * static int ring_send(Channel channel, const char* message, size_t messageLength, unsigned int priority, int timeout)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Carry the priority of the message.
+ * 10/14/2026   Kerby Kaska     Sleep for at most timeout milliseconds.
+ *
+ * Description: Sends a message on a channel of the shared memory transport. Should the ring be full, it is polled up to
+ *      RING_SPIN_LIMIT times before sleeping until a receiver frees a slot (for at most timeout milliseconds in all, like
+ *      mq_timedsend()). Receivers are only
+ *      woken up through the futex if they are waiting. The priority is carried along with the message, but the ring
+ *      stays first in, first out (a single forked client has nothing to overtake).
+ *
+ * Parameters:
+ *      channel          I/P    Channel         the channel to send the message on
+ *      message          I/P    const char*     the message to send
+ *      messageLength    I/P    size_t          the number of bytes in message
+ *      priority         I/P    unsigned int    the priority to send the message with
+ *      timeout          I/P    int             the milliseconds to wait for a free slot at most, or -1 to block
+ *      ring_send        O/P    int             0 on success, -1 on error (EMSGSIZE if the message is too large, ETIMEDOUT,
+ *                                              or EINTR)
+ *******************************************************************************************************************************/
+static int ring_send(Channel channel, const char* message, size_t messageLength, unsigned int priority, int timeout)
+{
+    SharedRing* ring = sharedRings[channel];
+    if (messageLength > ring->messageSize)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    uint64_t deadline = 0; // NOTE: only read the clock once the ring turns out to be full
+    for (unsigned int polls = 1; !ring_try_enqueue(ring, message, messageLength, priority); ++polls)
+    {
+        if (polls == RING_SPIN_LIMIT && timeout >= 0)
+        {
+            deadline = monotonic_nanoseconds() + timeout * 1000000ull;
+        }
+        if (polls >= RING_SPIN_LIMIT && ring_wait(ring, &ring->writable, ring_writable, deadline) == -1)
+        {
+            return -1;
+        }
+    }
+    ring_notify(&ring->readable);
+    return 0;
+}
+
+/********************************************************************************************************************************
+ * static ssize_t ring_receive(Channel channel, char* buffer, size_t bufferSize, unsigned int* priority, int timeout)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ * 10/14/2026   Kerby Kaska     Hand back the priority of the message.
+ * 10/14/2026   Kerby Kaska     Sleep for at most timeout milliseconds.
+ *
+ * Description: Receives a message from a channel of the shared memory transport. Should the ring be empty, it is polled
+ *      up to RING_SPIN_LIMIT times before sleeping until a sender sends a message (for at most timeout milliseconds in 
+ *      all, like mq_timedreceive()). Senders are only woken up through the futex if they are waiting.
+ *
+ * Parameters:
+ *      channel         I/P    Channel          the channel to receive the message from
+ *      buffer          O/P    char*            the buffer to receive the message into
+ *      bufferSize      I/P    size_t           the size of buffer in bytes
+ *      priority        O/P    unsigned int*    the priority the message was sent with (may be NULL)
+ *      timeout         I/P    int              the milliseconds to wait for a message at most, or -1 to block
+ *      ring_receive    O/P    ssize_t          the number of bytes of the message, -1 on error (EMSGSIZE if the buffer is 
+ *                                              too small, ETIMEDOUT, or EINTR)
+ *******************************************************************************************************************************/
+static ssize_t ring_receive(Channel channel, char* buffer, size_t bufferSize, unsigned int* priority, int timeout)
+{
+    SharedRing* ring = sharedRings[channel];
+    if (bufferSize < ring->messageSize)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    ssize_t messageLength;
+    uint64_t deadline = 0; // NOTE: only read the clock once the ring turns out to be empty
+    for (unsigned int polls = 1; (messageLength = ring_try_dequeue(ring, buffer, priority)) == -1; ++polls)
+    {
+        if (polls == RING_SPIN_LIMIT && timeout >= 0)
+        {
+            deadline = monotonic_nanoseconds() + timeout * 1000000ull;
+        }
+        if (polls >= RING_SPIN_LIMIT && ring_wait(ring, &ring->readable, ring_readable, deadline) == -1)
+        {
+            return -1;
+        }
+    }
+    ring_notify(&ring->writable);
+    return messageLength;
+}
+
+/********************************************************************************************************************************
+ * Transports (see transport.h):
+ *******************************************************************************************************************************/
+const Transport MQUEUE_TRANSPORT                      = { "mqueue", open_queues, mqueue_send, mqueue_receive };
+const Transport RING_TRANSPORT                        = { "shm", open_rings, ring_send, ring_receive };
+const Transport* const TRANSPORTS[TRANSPORT_COUNT]    = { &MQUEUE_TRANSPORT, &RING_TRANSPORT };
+
+/********************************************************************************************************************************
+ * const Transport* find_transport(const char* name)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to look up a transport of TRANSPORTS by its name (the value of ARG_TRANSPORT).
+ *
+ * Parameters:
+ *      name              I/P    const char*         the name of the transport
+ *      find_transport    O/P    const Transport*    the transport, or NULL if there is none by that name
+ *******************************************************************************************************************************/
+const Transport* find_transport(const char* name)
+{
+    for (const Transport* candidate : TRANSPORTS)
+    {
+        if (strcmp(candidate->name, name) == 0)
+        {
+            return candidate;
+        }
+    }
+    return NULL;
+}
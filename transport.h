@@ -0,0 +1,223 @@
+/****************************************************************************************************************************************************
+* File: transport.h
+* Author: Kerby Kaska
+*
+* Modification History:
+* 10/14/2026   Kerby Kaska     Created. Moved the message queue and shared memory transports out of main.cpp.
+*
+* Description: The transports pgm1 exchanges framed messages through between its client and its server pool (see
+*      Transport), and the queue state they share with the client and the server: the commandQueue and the
+*      responseQueue, the queueConfig, and the shared rings. This is process state, so only pgm1 (and its
+*      microbenchmarks) build from it; libpgm1 talks to a standalone server through protocol.h instead (dispatch.h only
+*      uses its constants).
+****************************************************************************************************************************************************/
+
+#ifndef PGM1_TRANSPORT_H
+#define PGM1_TRANSPORT_H
+
+#include "protocol.h"
+#include <atomic>
+#include <mqueue.h>
+
+/********************************************************************************************************************************
+ * Transport Constants:
+ * CACHE_LINE_SIZE          const unsigned int    number of bytes in a cache line, used to keep the ring positions (and the
+ *                                                buffers of the BufferPools) apart
+ *******************************************************************************************************************************/
+static constexpr unsigned int CACHE_LINE_SIZE = 64;
+
+/********************************************************************************************************************************
+ * struct QueueConfig
+ * Description: Queue configuration of this process, set once at startup from ARG_QUEUE_DEPTH, ARG_MESSAGE_SIZE, and
+ *     ARG_PRIORITY (or their environment variables), and from the queue constants otherwise. Every message buffer is
+ *     allocated to match messageSize.
+ *
+ * Members:
+ * maxMessages              unsigned int          maximum number of messages in each queue (and outstanding pipelined requests)
+ * messageSize              unsigned int          number of bytes of the largest message, and of every message buffer
+ * messagePriority          unsigned int          message priority of PRIORITY_BULK messages, every other class is sent 
+ *                                                that many priorities above it (see PriorityClass)
+ *******************************************************************************************************************************/
+struct QueueConfig
+{
+    unsigned int maxMessages;
+    unsigned int messageSize;
+    unsigned int messagePriority;
+};
+
+/********************************************************************************************************************************
+ * Queue Configuration:
+ * queueConfig          QueueConfig          queue configuration of this process (see QueueConfig)
+ *******************************************************************************************************************************/
+extern QueueConfig queueConfig;
+
+/********************************************************************************************************************************
+ * Queue Descriptors:
+ * commandQueue         mqd_t                message queue descriptor used to identify the server input message queue
+ * responseQueue        mqd_t                message queue descriptor used to identify the server output message queue
+ *                                           (the private reply queue of a standalone client, unused by a standalone server)
+ *******************************************************************************************************************************/
+extern mqd_t commandQueue;
+extern mqd_t responseQueue;
+
+/********************************************************************************************************************************
+ * enum Channel
+ * Description: The two one-way channels every transport provides between the client and the server pool.
+ *
+ * Values:
+ * CHANNEL_COMMAND          framed commands from the client to the server pool (commandQueue)
+ * CHANNEL_RESPONSE         framed replies from the server pool to the client (responseQueue)
+ * CHANNEL_COUNT            number of channels
+ *******************************************************************************************************************************/
+enum Channel
+{
+    CHANNEL_COMMAND = 0,
+    CHANNEL_RESPONSE,
+    CHANNEL_COUNT
+};
+
+/********************************************************************************************************************************
+ * struct Transport
+ * Description: Interface of a message transport between the client and the server pool. Every function follows the
+ *     conventions of the message queue function it replaces: send() and receive() block until they succeed, or for at
+ *     most timeout milliseconds (-1 to block, like poll()), and return -1 with errno set on error (ETIMEDOUT once the 
+ *     timeout expires, EINTR if interrupted by a signal, EMSGSIZE if the message or buffer size is wrong). Every message
+ *     carries a priority, which receive() hands back (the priority pointer may be NULL).
+ *
+ * Members:
+ * name                     const char*           name of the transport, as given to ARG_TRANSPORT
+ * open                     bool (*)()            creates both channels before the client is forked, false on error
+ * send                     int (*)(...)          sends a message on a channel, like mq_timedsend()
+ * receive                  ssize_t (*)(...)      receives a message from a channel, like mq_timedreceive()
+ *******************************************************************************************************************************/
+struct Transport
+{
+    const char* name;
+    bool (*open)();
+    int (*send)(Channel channel, const char* message, size_t messageLength, unsigned int priority, int timeout);
+    ssize_t (*receive)(Channel channel, char* buffer, size_t bufferSize, unsigned int* priority, int timeout);
+};
+
+/********************************************************************************************************************************
+ * struct RingEvent
+ * Description: Futex the processes waiting on a shared ring sleep on. Waiters register themselves before sleeping, so the 
+ *     other side only makes the futex system call when somebody is actually waiting.
+ *
+ * Members:
+ * sequence                 std::atomic<uint32_t> futex word, incremented on every wake up
+ * waiters                  std::atomic<uint32_t> number of processes waiting (or about to wait) on sequence
+ *******************************************************************************************************************************/
+struct RingEvent
+{
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> waiters;
+};
+
+/********************************************************************************************************************************
+ * struct RingSlot
+ * Description: Header of a slot of a shared ring. The message bytes of the slot follow it directly.
+ *
+ * Members:
+ * sequence                 std::atomic<uint32_t> position the slot can next be written at (or read at, when one past it)
+ * length                   uint32_t              number of bytes of the message stored in the slot
+ * priority                 uint32_t              priority the message was sent with (the ring itself is first in, first out)
+ *******************************************************************************************************************************/
+struct RingSlot
+{
+    std::atomic<uint32_t> sequence;
+    uint32_t length;
+    uint32_t priority;
+};
+
+/********************************************************************************************************************************
+ * struct SharedRing
+ * Description: Bounded lock-free ring of messages in shared memory, which any number of processes can send to and receive
+ *     from at once (each slot carries a sequence number, so senders and receivers only ever race on the positions). The
+ *     capacity slots of slotSize bytes follow it directly. The positions and events each get their own cache line, so
+ *     the senders and receivers do not false share.
+ *
+ * Members:
+ * enqueuePosition          std::atomic<uint32_t> position of the next message to be sent
+ * dequeuePosition          std::atomic<uint32_t> position of the next message to be received
+ * readable                 RingEvent             receivers waiting for a message to arrive
+ * writable                 RingEvent             senders waiting for a free slot
+ * capacity                 uint32_t              number of slots (a power of two)
+ * slotSize                 uint32_t              number of bytes of each slot (RingSlot and message, a multiple of a cache line)
+ * messageSize              uint32_t              largest number of bytes of a message
+ *******************************************************************************************************************************/
+struct SharedRing
+{
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> enqueuePosition;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> dequeuePosition;
+    alignas(CACHE_LINE_SIZE) RingEvent readable;
+    alignas(CACHE_LINE_SIZE) RingEvent writable;
+    uint32_t capacity;
+    uint32_t slotSize;
+    uint32_t messageSize;
+};
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the shared rings need lock-free (address-free) atomics");
+
+/********************************************************************************************************************************
+ * Transport State:
+ * transport            const Transport*     the transport the client and the server pool exchange messages through 
+ *                                           (selected by ARG_TRANSPORT, the message queues by default)
+ * sharedRings          SharedRing*[]        the shared rings of every channel, when using the shared memory transport
+ * sharedRegion         void*                the shared memory mapping holding sharedRings, unmapped by close_queues()
+ * sharedRegionSize     size_t               number of bytes of sharedRegion
+ *******************************************************************************************************************************/
+extern const Transport* transport;
+extern SharedRing* sharedRings[CHANNEL_COUNT];
+extern void* sharedRegion;
+extern size_t sharedRegionSize;
+
+/********************************************************************************************************************************
+ * Process State:
+ * ownedQueueName       char[]               name of the queue published by this process, unlinked by close_queues() (the
+ *                                           standalone server's command queue, or the standalone client's reply queue)
+ * NOTE: this is global so that signal_handler() can unlink it
+ *******************************************************************************************************************************/
+extern char ownedQueueName[REPLY_QUEUE_NAME_SIZE];
+
+/********************************************************************************************************************************
+ * Transports:
+ * MQUEUE_TRANSPORT         const Transport       POSIX message queues (commandQueue and responseQueue), the default
+ * RING_TRANSPORT           const Transport       lock-free rings in shared memory, with futex wake ups only when idle
+ * TRANSPORT_COUNT          const unsigned int    number of transports in TRANSPORTS
+ * TRANSPORTS               const Transport*[]    every transport which can be selected by ARG_TRANSPORT
+ *******************************************************************************************************************************/
+static const unsigned int TRANSPORT_COUNT = 2;
+extern const Transport MQUEUE_TRANSPORT;
+extern const Transport RING_TRANSPORT;
+extern const Transport* const TRANSPORTS[TRANSPORT_COUNT];
+
+/********************************************************************************************************************************
+ * static inline size_t align_to_cache_line(size_t size)
+ * Author: Kerby Kaska
+ * Date: 10/14/2026
+ * Modification History:
+ * 10/14/2026   Kerby Kaska     Created.
+ *
+ * Description: Utility method to round a buffer size up to whole cache lines, so the buffer after it starts on a line of
+ *      its own.
+ *
+ * Parameters:
+ *      size                   I/P    size_t    the number of bytes of the buffer
+ *      align_to_cache_line    O/P    size_t    the number of bytes rounded up to a multiple of CACHE_LINE_SIZE
+ *******************************************************************************************************************************/
+static inline size_t align_to_cache_line(size_t size)
+{
+    return (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+/********************************************************************************************************************************
+ * Transport Procedures (see transport.cpp):
+ * queue_attributes         utility method to create the message queue attributes from the queueConfig
+ * close_queues             closes the commandQueue and the responseQueue, unlinks the ownedQueueName, and unmaps the
+ *                          sharedRegion (whichever of them are open)
+ * find_transport           utility method to look up a transport of TRANSPORTS by its name
+ *******************************************************************************************************************************/
+mq_attr queue_attributes();
+int close_queues();
+const Transport* find_transport(const char* name);
+
+#endif